@@ -32,6 +32,7 @@
 #include "util/sorted-array.h"
 #include "tty/tty.h"
 #include "tty/tty-linemode.h"
+#include "screen-buffer.h"
 
 /* handle types */
 enum {
@@ -84,10 +85,21 @@ failed:
 static int
 foil_handle_event(pcmcth_renderer *rdr, unsigned long long timeout_usec)
 {
-    if (rdr->impl->term_mode == FOIL_TERM_MODE_LINE) {
-        if (tty_got_winch(timeout_usec)) {
-            // TODO: handle change of terminal size
-        }
+    /* do not sleep past the frame skipped for the limit of frame rate */
+    if (rdr->impl->scrbuf) {
+        long pending = foil_scrbuf_pending_usec(rdr->impl->scrbuf);
+        if (pending >= 0 && (unsigned long long)pending < timeout_usec)
+            timeout_usec = pending;
+    }
+
+    /* the SIGWINCH pipe is created in both the line and full-screen modes */
+    if (tty_got_winch(timeout_usec)) {
+        // TODO: handle change of terminal size
+    }
+
+    if (rdr->impl->scrbuf) {
+        /* write the frame skipped for the limit of frame rate */
+        foil_scrbuf_flush(rdr->impl->scrbuf, false);
     }
 
     return 0;
@@ -99,6 +111,11 @@ static void foil_cleanup(pcmcth_renderer *rdr)
         tty_linemode_shutdown();
     }
 
+    if (rdr->impl->scrbuf) {
+        foil_scrbuf_flush(rdr->impl->scrbuf, true);
+        foil_scrbuf_delete(rdr->impl->scrbuf);
+    }
+
     free(rdr->impl);
 
     foil_wsp_module_cleanup(rdr);
@@ -390,12 +407,14 @@ static int foil_update_udom(pcmcth_session *sess, pcmcth_udom *udom,
     }
 
     foil_rdrbox *rdrbox = foil_udom_find_rdrbox(udom, element_handle);
-    if (rdrbox == NULL) {
-        retv = PCRDR_SC_NOT_FOUND;
-        goto failed;
+    if (rdrbox) {
+        retv = foil_udom_update_rdrbox(udom, rdrbox, op, property, ref_info);
+    }
+    else {
+        /* e.g., the element or an ancestor has `display: none` */
+        retv = foil_udom_update_boxless_element(udom, element_handle,
+                op, property, ref_info);
     }
-
-    retv = foil_udom_update_rdrbox(udom, rdrbox, op, property, ref_info);
 
 failed:
     return retv;
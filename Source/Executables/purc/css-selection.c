@@ -1359,6 +1359,8 @@ static css_error node_presentational_hint( void *pw, void *n,
     return CSS_OK;
 }
 
+extern css_select_handler foil_css_select_handler;
+
 static css_error
 set_node_data(void *pw, void *n, void *node_data)
 {
@@ -1370,7 +1372,21 @@ set_node_data(void *pw, void *n, void *node_data)
 
     /* we save the node data in udom->ele2nodedata in order to manage
        the changes of documment and release the node data when we are done. */
-    sorted_array_add(udom->elem2nodedata, PTR2U64(n), node_data);
+    if (node_data == NULL) {
+        /* CSSEng destroyed the node data when the node was modified */
+        sorted_array_remove(udom->elem2nodedata, PTR2U64(n));
+        return CSS_OK;
+    }
+
+    void *old_data;
+    if (sorted_array_find(udom->elem2nodedata, PTR2U64(n), &old_data) >= 0
+            && old_data != node_data) {
+        /* the node data left by an erased element at the same address */
+        css_node_data_handler(&foil_css_select_handler, CSS_NODE_DELETED,
+                udom, n, NULL, old_data);
+    }
+
+    sorted_array_add_or_replace(udom->elem2nodedata, PTR2U64(n), node_data);
     return CSS_OK;
 }
 
@@ -138,9 +138,14 @@ enum {
     FOIL_CHAR_ATTR_REVERSE      = 0x10,
 };
 
+struct foil_scrbuf;
+
 struct pcmcth_rdr_data {
     int term_mode;
     int rows, cols;
+
+    /* the screen buffer used in full-screen mode; created on demand */
+    struct foil_scrbuf *scrbuf;
 };
 
 #ifdef __cplusplus
@@ -390,6 +390,63 @@ done:
     return false;
 }
 
+struct foil_tty_cell *foil_page_save_content(pcmcth_page *page)
+{
+    struct foil_tty_cell *saved;
+
+    saved = malloc(sizeof(struct foil_tty_cell) * page->rows * page->cols);
+    if (saved == NULL)
+        return NULL;
+
+    for (int y = 0; y < page->rows; y++) {
+        memcpy(saved + y * page->cols, page->cells[y],
+                sizeof(struct foil_tty_cell) * page->cols);
+    }
+
+    return saved;
+}
+
+static inline bool
+is_same_cell(const struct foil_tty_cell *a, const struct foil_tty_cell *b)
+{
+    return a->uc == b->uc && a->attrs == b->attrs && a->fgc == b->fgc &&
+        a->bgc == b->bgc && a->latter_half == b->latter_half;
+}
+
+void foil_page_diff_content(pcmcth_page *page,
+        const struct foil_tty_cell *saved)
+{
+    foil_rect dirty;
+    foil_rect_empty(&dirty);
+
+    for (int y = 0; y < page->rows; y++) {
+        const struct foil_tty_cell *old_line = saved + y * page->cols;
+        const struct foil_tty_cell *line = page->cells[y];
+
+        int left = 0;
+        while (left < page->cols && is_same_cell(line + left, old_line + left))
+            left++;
+        if (left == page->cols)
+            continue;
+
+        int right = page->cols;
+        while (right > left &&
+                is_same_cell(line + right - 1, old_line + right - 1))
+            right--;
+
+        /* do not split a wide character */
+        if (left > 0 && line[left].latter_half)
+            left--;
+        if (right < page->cols && line[right].latter_half)
+            right++;
+
+        foil_rect rc = { left, y, right, y + 1 };
+        foil_rect_get_bound(&dirty, &dirty, &rc);
+    }
+
+    page->dirty_rect = dirty;
+}
+
 bool foil_page_expose(pcmcth_page *page)
 {
     foil_widget *widget = foil_widget_from_page(page);
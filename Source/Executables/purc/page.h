@@ -130,6 +130,13 @@ bool foil_page_fill_rect(pcmcth_page *page, const foil_rect *rc, uint32_t uc);
 bool foil_page_erase_rect(pcmcth_page *page, const foil_rect *rc);
 bool foil_page_expose(pcmcth_page *page);
 
+/* save a copy of the contents; the caller should free the returned buffer */
+struct foil_tty_cell *foil_page_save_content(pcmcth_page *page);
+/* set the bounding rectangle of the cells changed since the contents
+   were saved as the dirty rectangle */
+void foil_page_diff_content(pcmcth_page *page,
+        const struct foil_tty_cell *saved);
+
 #ifdef __cplusplus
 }
 #endif
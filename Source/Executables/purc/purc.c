@@ -166,6 +166,11 @@ static void print_usage(FILE *fp)
         "  -l --parallel\n"
         "        Execute multiple programs in parallel.\n"
         "\n"
+        "  -w --workers=< number >\n"
+        "        Create a pool of worker runners; the coroutines loaded or called within\n"
+        "        the runner `_workers` will be placed onto the least loaded workers.\n"
+        "        Use 0 for the number of the online processors.\n"
+        "\n"
         "  -v --verbose\n"
         "        Execute the program(s) with verbose output.\n"
         "\n"
@@ -194,6 +199,8 @@ struct my_opts {
     pcutils_array_t *contents;
     char *app_info;
 
+    long nr_workers;    // -1 for no worker pool
+
     bool parallel;
     bool verbose;
 };
@@ -261,6 +268,8 @@ static struct my_opts *my_opts_new(void)
 
     opts->contents = pcutils_array_create();
     pcutils_array_init(opts->contents, 1);
+
+    opts->nr_workers = -1;
     return opts;
 }
 
@@ -384,7 +393,7 @@ static bool validate_url(struct my_opts *opts, const char *url)
 
 static int read_option_args(struct my_opts *opts, int argc, char **argv)
 {
-    static const char short_options[] = "a:r:d:c:u:j:q:lvCVh";
+    static const char short_options[] = "a:r:d:c:u:j:q:lw:vCVh";
     static const struct option long_opts[] = {
         { "app"            , required_argument , NULL , 'a' },
         { "runner"         , required_argument , NULL , 'r' },
@@ -394,6 +403,7 @@ static int read_option_args(struct my_opts *opts, int argc, char **argv)
         { "request"        , required_argument , NULL , 'j' },
         { "query"          , required_argument , NULL , 'q' },
         { "parallel"       , no_argument       , NULL , 'l' },
+        { "workers"        , required_argument , NULL , 'w' },
         { "verbose"        , no_argument       , NULL , 'v' },
         { "copying"        , no_argument       , NULL , 'C' },
         { "version"        , no_argument       , NULL , 'V' },
@@ -500,6 +510,14 @@ static int read_option_args(struct my_opts *opts, int argc, char **argv)
             opts->parallel = true;
             break;
 
+        case 'w': {
+            char *end;
+            opts->nr_workers = strtol(optarg, &end, 10);
+            if (end == optarg || *end || opts->nr_workers < 0)
+                goto bad_arg;
+            break;
+        }
+
         case 'v':
             opts->verbose = true;
             break;
@@ -1507,6 +1525,12 @@ int main(int argc, char** argv)
 
     purc_enable_log(true, false);
 
+    if (opts->nr_workers >= 0 &&
+            purc_inst_create_workers((size_t)opts->nr_workers) == 0) {
+        if (opts->verbose)
+            fprintf(stderr, "Failed to create the worker runners\n");
+    }
+
     purc_variant_t request = PURC_VARIANT_INVALID;
     if (opts->request) {
         if ((request = get_request_data(opts)) == PURC_VARIANT_INVALID) {
@@ -0,0 +1,488 @@
+/*
+ * @file screen-buffer.c
+ * @date 2026/10/19
+ * @brief The implementation of the screen buffer used in full-screen mode.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of purc, which is an HVML interpreter with
+ * a command line interface (CLI).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "screen-buffer.h"
+#include "purc/purc-utils.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* two changed runs separated by less cells than this will be merged,
+   because moving the cursor costs more than rewriting the cells. */
+#define MIN_GAP_TO_SPLIT    8
+
+/* the time to wait for a full terminal to accept more output */
+#define WRITE_TIMEOUT_MS    1000
+
+/* the dirty span of a row: [left, right) */
+struct row_span {
+    int left, right;
+};
+
+struct foil_scrbuf {
+    int rows, cols;
+
+    /* the content being composed */
+    struct foil_tty_cell *back;
+    /* the content on the screen */
+    struct foil_tty_cell *front;
+    /* the dirty spans of the rows of the back buffer */
+    struct row_span *spans;
+    /* the first and the last dirty rows: [dirty_top, dirty_bottom) */
+    int dirty_top, dirty_bottom;
+
+    /* the minimal interval between two frames in microseconds */
+    int64_t min_interval;
+    /* the time when the last frame written */
+    int64_t last_frame;
+    /* the number of exposures since the last frame */
+    size_t nr_pending;
+
+    /* the tracked cursor position and rendition on the terminal;
+       -1 for unknown. */
+    int cur_x, cur_y;
+    int cur_attrs, cur_fgc, cur_bgc;
+
+    /* the buffer reused to compose the escape sequences of a frame */
+    struct pcutils_mystring out;
+
+    foil_scrbuf_write_cb writer;
+    void *ctxt;
+
+    struct foil_scrbuf_stats stats;
+};
+
+static int64_t
+now_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void
+reset_tracked_state(foil_scrbuf *scrbuf)
+{
+    scrbuf->cur_x = -1;
+    scrbuf->cur_y = -1;
+    scrbuf->cur_attrs = -1;
+    scrbuf->cur_fgc = -1;
+    scrbuf->cur_bgc = -1;
+}
+
+/* make the front buffer different from any valid cell,
+   so that the whole screen will be written in the next frame. */
+static void
+invalidate_front(foil_scrbuf *scrbuf)
+{
+    size_t n = (size_t)scrbuf->rows * scrbuf->cols;
+    for (size_t i = 0; i < n; i++) {
+        scrbuf->front[i].uc = 0xFFFFFFFF;
+    }
+
+    for (int y = 0; y < scrbuf->rows; y++) {
+        scrbuf->spans[y].left = 0;
+        scrbuf->spans[y].right = scrbuf->cols;
+    }
+    scrbuf->dirty_top = 0;
+    scrbuf->dirty_bottom = scrbuf->rows;
+    reset_tracked_state(scrbuf);
+}
+
+static bool
+alloc_buffers(foil_scrbuf *scrbuf, int rows, int cols)
+{
+    size_t n = (size_t)rows * cols;
+    struct foil_tty_cell *back = calloc(n, sizeof(struct foil_tty_cell));
+    struct foil_tty_cell *front = calloc(n, sizeof(struct foil_tty_cell));
+    struct row_span *spans = calloc(rows, sizeof(struct row_span));
+    if (back == NULL || front == NULL || spans == NULL) {
+        free(back);
+        free(front);
+        free(spans);
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        back[i].uc = ' ';
+    }
+
+    free(scrbuf->back);
+    free(scrbuf->front);
+    free(scrbuf->spans);
+    scrbuf->back = back;
+    scrbuf->front = front;
+    scrbuf->spans = spans;
+    scrbuf->rows = rows;
+    scrbuf->cols = cols;
+    invalidate_front(scrbuf);
+    return true;
+}
+
+foil_scrbuf *foil_scrbuf_new(int rows, int cols, unsigned max_fps,
+        foil_scrbuf_write_cb writer, void *ctxt)
+{
+    if (rows <= 0 || cols <= 0)
+        return NULL;
+
+    foil_scrbuf *scrbuf = calloc(1, sizeof(*scrbuf));
+    if (scrbuf == NULL)
+        return NULL;
+
+    if (!alloc_buffers(scrbuf, rows, cols)) {
+        free(scrbuf);
+        return NULL;
+    }
+
+    scrbuf->min_interval = max_fps ? 1000000 / max_fps : 0;
+    scrbuf->last_frame = 0;
+    pcutils_mystring_init(&scrbuf->out);
+    scrbuf->writer = writer;
+    scrbuf->ctxt = ctxt;
+    return scrbuf;
+}
+
+void foil_scrbuf_delete(foil_scrbuf *scrbuf)
+{
+    pcutils_mystring_free(&scrbuf->out);
+    free(scrbuf->back);
+    free(scrbuf->front);
+    free(scrbuf->spans);
+    free(scrbuf);
+}
+
+bool foil_scrbuf_resize(foil_scrbuf *scrbuf, int rows, int cols)
+{
+    if (rows <= 0 || cols <= 0)
+        return false;
+
+    if (rows == scrbuf->rows && cols == scrbuf->cols) {
+        invalidate_front(scrbuf);
+        return true;
+    }
+
+    return alloc_buffers(scrbuf, rows, cols);
+}
+
+void foil_scrbuf_put_cells(foil_scrbuf *scrbuf, int x, int y,
+        const struct foil_tty_cell *cells, int nr_cells)
+{
+    if (y < 0 || y >= scrbuf->rows)
+        return;
+
+    if (x < 0) {
+        cells -= x;
+        nr_cells += x;
+        x = 0;
+    }
+    if (x + nr_cells > scrbuf->cols)
+        nr_cells = scrbuf->cols - x;
+    if (nr_cells <= 0)
+        return;
+
+    memcpy(scrbuf->back + (size_t)y * scrbuf->cols + x, cells,
+            sizeof(struct foil_tty_cell) * nr_cells);
+
+    struct row_span *span = scrbuf->spans + y;
+    if (span->left >= span->right) {
+        span->left = x;
+        span->right = x + nr_cells;
+    }
+    else {
+        if (x < span->left)
+            span->left = x;
+        if (x + nr_cells > span->right)
+            span->right = x + nr_cells;
+    }
+
+    if (scrbuf->dirty_top >= scrbuf->dirty_bottom) {
+        scrbuf->dirty_top = y;
+        scrbuf->dirty_bottom = y + 1;
+    }
+    else {
+        if (y < scrbuf->dirty_top)
+            scrbuf->dirty_top = y;
+        if (y + 1 > scrbuf->dirty_bottom)
+            scrbuf->dirty_bottom = y + 1;
+    }
+
+    scrbuf->nr_pending++;
+}
+
+static inline bool
+is_same_cell(const struct foil_tty_cell *a, const struct foil_tty_cell *b)
+{
+    return a->uc == b->uc && a->attrs == b->attrs &&
+        a->fgc == b->fgc && a->bgc == b->bgc &&
+        a->latter_half == b->latter_half;
+}
+
+static void
+append_str(foil_scrbuf *scrbuf, const char *str, size_t len)
+{
+    pcutils_mystring_append_mchar(&scrbuf->out,
+            (const unsigned char *)str, len);
+}
+
+static void
+move_cursor(foil_scrbuf *scrbuf, int x, int y)
+{
+    if (scrbuf->cur_x == x && scrbuf->cur_y == y)
+        return;
+
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "\x1b[%d;%dH", y + 1, x + 1);
+    append_str(scrbuf, buf, len);
+    scrbuf->cur_x = x;
+    scrbuf->cur_y = y;
+}
+
+static inline int
+fgc_to_sgr(uint8_t fgc)
+{
+    return (fgc < 8) ? (30 + fgc) : (90 + (fgc & 0x07));
+}
+
+static inline int
+bgc_to_sgr(uint8_t bgc)
+{
+    return (bgc < 8) ? (40 + bgc) : (100 + (bgc & 0x07));
+}
+
+/* emit one SGR sequence for all changed parts of the rendition */
+static void
+change_rendition(foil_scrbuf *scrbuf, const struct foil_tty_cell *cell)
+{
+    char buf[64];
+    int len = 2;
+    bool reset = (scrbuf->cur_attrs != cell->attrs);
+
+    buf[0] = '\x1b';
+    buf[1] = '[';
+
+    if (reset) {
+        /* no way to turn off a single attribute portably */
+        buf[len++] = '0';
+        if (cell->attrs & FOIL_CHAR_ATTR_BOLD)
+            len += snprintf(buf + len, sizeof(buf) - len, ";1");
+        if (cell->attrs & FOIL_CHAR_ATTR_UNDERLINE)
+            len += snprintf(buf + len, sizeof(buf) - len, ";4");
+        if (cell->attrs & FOIL_CHAR_ATTR_BLINK)
+            len += snprintf(buf + len, sizeof(buf) - len, ";5");
+        if (cell->attrs & FOIL_CHAR_ATTR_REVERSE)
+            len += snprintf(buf + len, sizeof(buf) - len, ";7");
+        if (cell->attrs & FOIL_CHAR_ATTR_STRIKEOUT)
+            len += snprintf(buf + len, sizeof(buf) - len, ";9");
+        scrbuf->cur_attrs = cell->attrs;
+    }
+
+    if (reset || scrbuf->cur_fgc != cell->fgc) {
+        len += snprintf(buf + len, sizeof(buf) - len, "%s%d",
+                (len > 2) ? ";" : "", fgc_to_sgr(cell->fgc));
+        scrbuf->cur_fgc = cell->fgc;
+    }
+
+    if (reset || scrbuf->cur_bgc != cell->bgc) {
+        len += snprintf(buf + len, sizeof(buf) - len, "%s%d",
+                (len > 2) ? ";" : "", bgc_to_sgr(cell->bgc));
+        scrbuf->cur_bgc = cell->bgc;
+    }
+
+    if (len > 2) {
+        buf[len++] = 'm';
+        append_str(scrbuf, buf, len);
+    }
+}
+
+static void
+emit_run(foil_scrbuf *scrbuf, int y, int left, int right)
+{
+    const struct foil_tty_cell *cell = scrbuf->back +
+        (size_t)y * scrbuf->cols + left;
+
+    move_cursor(scrbuf, left, y);
+    for (int x = left; x < right; x++, cell++) {
+        if (cell->latter_half)
+            continue;
+
+        if (cell->attrs != scrbuf->cur_attrs ||
+                cell->fgc != scrbuf->cur_fgc ||
+                cell->bgc != scrbuf->cur_bgc) {
+            change_rendition(scrbuf, cell);
+        }
+
+        pcutils_mystring_append_uchar(&scrbuf->out, cell->uc, 1);
+
+        /* a wide character occupies two columns */
+        if (x + 1 < scrbuf->cols && cell[1].latter_half)
+            scrbuf->cur_x += 2;
+        else
+            scrbuf->cur_x += 1;
+        scrbuf->stats.nr_cells++;
+    }
+
+    /* the cursor position is unspecified after writing the last column */
+    if (scrbuf->cur_x >= scrbuf->cols)
+        scrbuf->cur_x = -1;
+
+    memcpy(scrbuf->front + (size_t)y * scrbuf->cols + left,
+            scrbuf->back + (size_t)y * scrbuf->cols + left,
+            sizeof(struct foil_tty_cell) * (right - left));
+}
+
+static void
+compose_row(foil_scrbuf *scrbuf, int y)
+{
+    struct row_span *span = scrbuf->spans + y;
+    const struct foil_tty_cell *back = scrbuf->back + (size_t)y * scrbuf->cols;
+    const struct foil_tty_cell *front = scrbuf->front +
+        (size_t)y * scrbuf->cols;
+
+    int run_left = -1, run_right = -1;
+    for (int x = span->left; x < span->right; x++) {
+        if (is_same_cell(back + x, front + x))
+            continue;
+
+        int left = x;
+        /* never start a run with the latter half of a wide character */
+        if (back[left].latter_half && left > 0)
+            left--;
+
+        int right = x + 1;
+        /* never end a run with the former half of a wide character */
+        if (right < scrbuf->cols && back[right].latter_half)
+            right++;
+
+        if (run_left < 0) {
+            run_left = left;
+            run_right = right;
+        }
+        else if (left - run_right < MIN_GAP_TO_SPLIT) {
+            run_right = right;
+        }
+        else {
+            emit_run(scrbuf, y, run_left, run_right);
+            run_left = left;
+            run_right = right;
+        }
+
+        x = right - 1;
+    }
+
+    if (run_left >= 0)
+        emit_run(scrbuf, y, run_left, run_right);
+
+    span->left = span->right = 0;
+}
+
+static bool
+write_out(foil_scrbuf *scrbuf)
+{
+    const char *buf = scrbuf->out.buff;
+    size_t left = scrbuf->out.nr_bytes;
+
+    while (left > 0) {
+        ssize_t n;
+        if (scrbuf->writer)
+            n = scrbuf->writer(scrbuf->ctxt, buf, left);
+        else
+            n = write(STDOUT_FILENO, buf, left);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+
+            /* wait for the terminal instead of spinning on a non-blocking
+               stdout; the file of a custom writer is unknown, so its frame
+               is dropped and the next one repaints the screen. */
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) &&
+                    scrbuf->writer == NULL) {
+                struct pollfd pfd = { STDOUT_FILENO, POLLOUT, 0 };
+                int r = poll(&pfd, 1, WRITE_TIMEOUT_MS);
+                if (r > 0 || (r < 0 && errno == EINTR))
+                    continue;
+            }
+
+            /* the screen is out of sync now */
+            invalidate_front(scrbuf);
+            return false;
+        }
+
+        buf += n;
+        left -= n;
+    }
+
+    return true;
+}
+
+bool foil_scrbuf_flush(foil_scrbuf *scrbuf, bool force)
+{
+    if (scrbuf->dirty_top >= scrbuf->dirty_bottom)
+        return false;
+
+    int64_t now = now_usec();
+    if (!force && now - scrbuf->last_frame < scrbuf->min_interval)
+        return false;
+
+    scrbuf->out.nr_bytes = 0;
+    for (int y = scrbuf->dirty_top; y < scrbuf->dirty_bottom; y++) {
+        struct row_span *span = scrbuf->spans + y;
+        if (span->left < span->right)
+            compose_row(scrbuf, y);
+    }
+    scrbuf->dirty_top = scrbuf->dirty_bottom = 0;
+
+    scrbuf->last_frame = now;
+    scrbuf->stats.nr_coalesced += scrbuf->nr_pending;
+    scrbuf->nr_pending = 0;
+    if (scrbuf->out.nr_bytes == 0)
+        return false;
+
+    write_out(scrbuf);
+    scrbuf->stats.nr_frames++;
+    scrbuf->stats.nr_bytes += scrbuf->out.nr_bytes;
+    return true;
+}
+
+long foil_scrbuf_pending_usec(foil_scrbuf *scrbuf)
+{
+    if (scrbuf->dirty_top >= scrbuf->dirty_bottom)
+        return -1;
+
+    int64_t elapsed = now_usec() - scrbuf->last_frame;
+    if (elapsed >= scrbuf->min_interval)
+        return 0;
+    return (long)(scrbuf->min_interval - elapsed);
+}
+
+const struct foil_scrbuf_stats *foil_scrbuf_get_stats(foil_scrbuf *scrbuf)
+{
+    return &scrbuf->stats;
+}
+
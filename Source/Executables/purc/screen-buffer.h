@@ -0,0 +1,84 @@
+/*
+ * @file screen-buffer.h
+ * @date 2026/10/19
+ * @brief The header for the screen buffer used in full-screen mode.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of purc, which is an HVML interpreter with
+ * a command line interface (CLI).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef purc_foil_screen_buffer_h
+#define purc_foil_screen_buffer_h
+
+#include "page.h"
+
+#include <sys/types.h>
+
+/* the default maximal frames per second */
+#define FOIL_SCRBUF_DEF_MAX_FPS     60
+
+/* the callback to write the escape sequences of a frame; NULL for stdout */
+typedef ssize_t (*foil_scrbuf_write_cb)(void *ctxt,
+        const void *buf, size_t len);
+
+struct foil_scrbuf_stats {
+    /* the number of frames written */
+    size_t nr_frames;
+    /* the number of exposures coalesced into the written frames */
+    size_t nr_coalesced;
+    /* the number of cells written */
+    size_t nr_cells;
+    /* the number of bytes written */
+    size_t nr_bytes;
+};
+
+struct foil_scrbuf;
+typedef struct foil_scrbuf foil_scrbuf;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* create a screen buffer; max_fps is 0 for no limit */
+foil_scrbuf *foil_scrbuf_new(int rows, int cols, unsigned max_fps,
+        foil_scrbuf_write_cb writer, void *ctxt);
+void foil_scrbuf_delete(foil_scrbuf *scrbuf);
+
+/* resize the screen buffer and repaint the whole screen in the next frame */
+bool foil_scrbuf_resize(foil_scrbuf *scrbuf, int rows, int cols);
+
+/* put the cells to the back buffer and mark the changed area */
+void foil_scrbuf_put_cells(foil_scrbuf *scrbuf, int x, int y,
+        const struct foil_tty_cell *cells, int nr_cells);
+
+/* write the changed cells to the terminal if the next frame is due or
+   `force` is true; returns true if a frame is written. */
+bool foil_scrbuf_flush(foil_scrbuf *scrbuf, bool force);
+
+/* return the microseconds to wait for the pending frame being due;
+   -1 if there is no pending frame. */
+long foil_scrbuf_pending_usec(foil_scrbuf *scrbuf);
+
+const struct foil_scrbuf_stats *foil_scrbuf_get_stats(foil_scrbuf *scrbuf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* purc_foil_screen_buffer_h */
+
@@ -504,3 +504,46 @@ void foil_udom_render_to_page(pcmcth_udom *udom, pcmcth_page *page)
     render_rdrbox_with_stacking_ctxt(&rdr_ctxt, root->stacking_ctxt, root);
 }
 
+/* Paints the backgrounds of the ancestors over the rectangle in the order
+   they are painted when the whole tree is rendered. */
+static void
+render_ancestor_backgrounds(struct foil_render_ctxt *ctxt,
+        struct foil_rdrbox *box, const foil_rect *page_rc)
+{
+    if (box->is_initial) {
+        foil_page_set_attrs(ctxt->page, FOIL_CHAR_ATTR_NULL);
+        foil_page_set_fgc(ctxt->page, box->color);
+        foil_page_set_bgc(ctxt->page, box->background_color);
+        foil_page_fill_rect(ctxt->page, page_rc, FOIL_UCHAR_SPACE);
+        return;
+    }
+
+    render_ancestor_backgrounds(ctxt, box->parent, page_rc);
+
+    foil_rect rc = *page_rc;
+    if (!box->is_root) {
+        foil_rect ctnt_rc;
+        map_rdrbox_rect_to_page(&box->ctnt_rect, &ctnt_rc);
+        if (!foil_rect_intersect(&rc, &rc, &ctnt_rc))
+            return;
+    }
+
+    foil_page_set_bgc(ctxt->page, box->background_color);
+    foil_page_erase_rect(ctxt->page, &rc);
+}
+
+void foil_udom_render_rdrbox_to_page(pcmcth_udom *udom, pcmcth_page *page,
+        foil_rdrbox *box)
+{
+    foil_render_ctxt rdr_ctxt = { udom, { NULL } };
+    rdr_ctxt.page = page;
+
+    /* the box is laid out at its old position, so only the cells in its
+       margin box change */
+    foil_rect rc, page_rc;
+    foil_rdrbox_margin_box(box, &rc);
+    map_rdrbox_rect_to_page(&rc, &page_rc);
+
+    render_ancestor_backgrounds(&rdr_ctxt, box->parent, &page_rc);
+    render_normal_boxes_in_tree_order(&rdr_ctxt, box);
+}
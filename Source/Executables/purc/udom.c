@@ -258,6 +258,8 @@ pcmcth_udom *foil_udom_new(pcmcth_page *page)
         goto failed;
     }
 
+    udom->page = page;
+
     foil_widget *widget = foil_widget_from_page(page);
     int cols = foil_widget_client_width(widget);
     int rows = foil_widget_client_height(widget);
@@ -703,6 +705,9 @@ make_rdrtree(struct foil_create_ctxt *ctxt, pcdoc_element_t ancestor)
             goto done;
         }
 
+        /* register the principal box to locate the changes of eDOM */
+        sorted_array_add(ctxt->udom->elem2rdrbox, PTR2U64(ancestor), box);
+
         /* handle :before pseudo element */
         if (result->styles[CSS_PSEUDO_ELEMENT_BEFORE]) {
             if (foil_rdrbox_create_before(ctxt, box) == NULL) {
@@ -1244,17 +1249,597 @@ failed:
     return NULL;
 }
 
+static int
+invalidate_node_data(purc_document_t doc, pcdoc_element_t element, void *ctxt)
+{
+    pcmcth_udom *udom = ctxt;
+    void *node_data;
+
+    (void)doc;
+    if (sorted_array_find(udom->elem2nodedata, PTR2U64(element),
+                &node_data) >= 0 && node_data) {
+        /* this will call set_node_data() with NULL */
+        css_node_data_handler(&foil_css_select_handler, CSS_NODE_MODIFIED,
+                udom, element, NULL, node_data);
+    }
+
+    return PCDOC_TRAVEL_GOON;
+}
+
+/* Unregisters the boxes in the subtree and deletes the stacking contexts
+   created by them. Note that the owner of a box may have been erased from
+   the eDOM; do not access the owner here. */
+static void
+unregister_rdrtree(pcmcth_udom *udom, foil_rdrbox *box)
+{
+    if (box->stacking_ctxt) {
+        if (box->stacking_ctxt == udom->root_stk_ctxt)
+            udom->root_stk_ctxt = NULL;
+        /* this also deletes the stacking contexts of the descendants */
+        foil_stacking_context_delete(box->stacking_ctxt);
+    }
+
+    if (box->is_principal) {
+        void *data;
+
+        if (sorted_array_find(udom->elem2rdrbox, PTR2U64(box->owner),
+                    &data) >= 0 && data == box)
+            sorted_array_remove(udom->elem2rdrbox, PTR2U64(box->owner));
+
+        /* the node data of the live elements have been invalidated,
+           so the left one belongs to an erased element. */
+        if (sorted_array_find(udom->elem2nodedata, PTR2U64(box->owner),
+                    &data) >= 0) {
+            css_node_data_handler(&foil_css_select_handler, CSS_NODE_DELETED,
+                    udom, box->owner, NULL, data);
+            sorted_array_remove(udom->elem2nodedata, PTR2U64(box->owner));
+        }
+    }
+
+    foil_rdrbox *child = box->first;
+    while (child) {
+        unregister_rdrtree(udom, child);
+        child = child->next;
+    }
+}
+
+/* Finds the nearest box which can be rebuilt in place: a block-level
+   principal box which is a child of the principal box of the parent element.
+   Returns NULL if the whole rendering tree should be rebuilt. */
+static foil_rdrbox *
+find_rebuildable_box(pcmcth_udom *udom, foil_rdrbox *box)
+{
+    while (box && !box->is_initial) {
+        if (box->is_principal && box->is_block_level) {
+            if (box->is_root)
+                return box;
+
+            pcdoc_node node = { PCDOC_NODE_ELEMENT, { box->owner } };
+            pcdoc_element_t parent = pcdoc_node_get_parent(udom->doc, node);
+            if (box->parent->is_principal && box->parent->owner == parent)
+                return box;
+        }
+
+        box = box->parent;
+    }
+
+    return NULL;
+}
+
+/* Rebuilds the boxes for the element `elem` and replaces the boxes
+   from `first` to `last` (the children of `parent`) with the new ones. */
+static int
+rebuild_rdrtree(pcmcth_udom *udom, foil_rdrbox *parent,
+        foil_rdrbox *first, foil_rdrbox *last, pcdoc_element_t elem)
+{
+    int list_item_index = -1;
+    foil_rdrbox *box = first;
+    while (box) {
+        if (box->is_principal && box->type == FOIL_RDRBOX_TYPE_LIST_ITEM)
+            list_item_index = box->list_item_data->index;
+        box = (box == last) ? NULL : box->next;
+    }
+
+    /* the styles of the elements will be selected again */
+    if (elem) {
+        invalidate_node_data(udom->doc, elem, udom);
+        size_t n;
+        pcdoc_travel_descendant_elements(udom->doc, elem,
+                invalidate_node_data, udom, &n);
+    }
+
+    /* remove the old boxes */
+    foil_rdrbox *anchor = first ? first->prev : parent->last;
+    box = first;
+    while (box) {
+        foil_rdrbox *next = (box == last) ? NULL : box->next;
+
+        unregister_rdrtree(udom, box);
+        foil_rdrbox_delete_deep(box);
+        box = next;
+    }
+
+    if (elem == NULL)
+        return 0;
+
+    foil_rdrbox *root_box = NULL;
+    for (box = udom->initial_cblock->first; box; box = box->next) {
+        if (box->is_root) {
+            root_box = box;
+            break;
+        }
+    }
+
+    /* the new boxes will be appended to the parent */
+    foil_rdrbox *tail = parent->last;
+    foil_create_ctxt ctxt = { udom,
+        udom->initial_cblock,           /* initial box */
+        root_box,                       /* root box */
+        parent,                         /* parent box */
+        purc_document_root(udom->doc),  /* root element */
+        purc_document_body(udom->doc),  /* body element */
+        NULL, NULL, NULL, NULL };
+    if (make_rdrtree(&ctxt, elem))
+        goto failed;
+
+    /* move the new boxes to the position of the old ones */
+    bool has_inlines = false;
+    box = tail ? tail->next : parent->first;
+    while (box) {
+        foil_rdrbox *next = box->next;
+
+        foil_rdrbox_remove_from_tree(box);
+        if (anchor)
+            foil_rdrbox_insert_after(anchor, box);
+        else
+            foil_rdrbox_prepend_child(parent, box);
+        anchor = box;
+
+        if (box->is_principal && box->type == FOIL_RDRBOX_TYPE_LIST_ITEM &&
+                list_item_index >= 0) {
+            /* make_rdrtree() counted the box as the last list item */
+            box->list_item_data->index = list_item_index;
+            parent->nr_child_list_items--;
+        }
+
+        if (box->is_inline_level)
+            has_inlines = true;
+
+        if (box->first && normalize_rdrtree(&ctxt, box))
+            goto failed;
+
+        box = next;
+    }
+
+    /* the element generates inline-level boxes now */
+    if (has_inlines && parent->is_block_container &&
+            create_anonymous_blocks_for_block_container(&ctxt, parent))
+        goto failed;
+
+    return 0;
+
+failed:
+    return -1;
+}
+
+/* Resets the layout fields of the boxes in the subtree. */
+static void
+reset_layout_rdrtree(struct foil_rdrbox *box)
+{
+    struct _inline_fmt_ctxt *lfmt_ctxt = foil_rdrbox_inline_fmt_ctxt(box);
+    if (lfmt_ctxt) {
+        box->extra_data_cleaner(box->extra_data);
+        box->extra_data_cleaner = NULL;
+
+        if (box->type == FOIL_RDRBOX_TYPE_BLOCK)
+            box->block_data->lfmt_ctxt = NULL;
+        else if (box->type == FOIL_RDRBOX_TYPE_LIST_ITEM)
+            box->list_item_data->lfmt_ctxt = NULL;
+        else
+            box->inline_block_data->lfmt_ctxt = NULL;
+    }
+
+    if (box->block_fmt_ctxt) {
+        foil_rdrbox_block_fmt_ctxt_delete(box->block_fmt_ctxt);
+        box->block_fmt_ctxt = NULL;
+    }
+
+    box->nr_block_level_children = 0;
+    box->nr_inline_level_children = 0;
+    box->nr_floating_children = 0;
+    box->nr_abspos_children = 0;
+    box->is_in_flow = 0;
+    box->is_in_normal_flow = 0;
+    box->is_height_resolved = 0;
+
+    if (!box->is_initial) {
+        box->is_width_resolved = 0;
+        box->width = 0;
+        box->height = 0;
+        box->cblock_creator = NULL;
+        foil_rect_empty(&box->ctnt_rect);
+    }
+
+    foil_rdrbox *child = box->first;
+    while (child) {
+        reset_layout_rdrtree(child);
+        child = child->next;
+    }
+}
+
+static int
+relayout_and_render(pcmcth_udom *udom)
+{
+    pcmcth_page *page = udom->page;
+
+    /* The used values of the boxes depend on the sizes and the positions of
+       the preceding boxes, so we lay out the tree again. However, the
+       styles, the texts, and the break opportunities of the unchanged boxes
+       are reused. */
+    reset_layout_rdrtree(udom->initial_cblock);
+    udom->initial_cblock->height = udom->vh;
+    foil_rect_set(&udom->initial_cblock->ctnt_rect, 0, 0, udom->vw, udom->vh);
+
+    foil_layout_ctxt layout_ctxt = { udom, udom->initial_cblock };
+    pre_layout_rdrtree(&layout_ctxt, udom->initial_cblock);
+    resolve_widths(&layout_ctxt, udom->initial_cblock);
+    resolve_heights(&layout_ctxt, udom->initial_cblock);
+    layout_rdrtree(&layout_ctxt, udom->initial_cblock);
+
+    assert(udom->initial_cblock->width % FOIL_PX_GRID_CELL_W == 0);
+    assert(udom->initial_cblock->height % FOIL_PX_GRID_CELL_H == 0);
+
+    int cols = udom->initial_cblock->width / FOIL_PX_GRID_CELL_W;
+    int rows = udom->initial_cblock->height / FOIL_PX_GRID_CELL_H;
+
+    /* keep the old contents to find out the changed area */
+    struct foil_tty_cell *saved = NULL;
+    if (cols == page->cols && rows == page->rows)
+        saved = foil_page_save_content(page);
+
+    if (saved) {
+        foil_page_set_attrs(page, FOIL_CHAR_ATTR_NULL);
+        foil_page_set_fgc(page, udom->initial_cblock->color);
+        foil_page_set_bgc(page, udom->initial_cblock->background_color);
+        foil_page_fill_rect(page, NULL, FOIL_UCHAR_SPACE);
+    }
+    else {
+        if (!foil_page_content_init(page, cols, rows,
+                    udom->initial_cblock->color,
+                    udom->initial_cblock->background_color)) {
+            LOG_ERROR("Failed to initialize page content\n");
+            return -1;
+        }
+        foil_page_set_udom(page, udom);
+    }
+
+    if (udom->initial_cblock->first)
+        foil_udom_render_to_page(udom, page);
+
+    if (saved) {
+        foil_page_diff_content(page, saved);
+        free(saved);
+    }
+
+    foil_page_expose(page);
+    return 0;
+}
+
+/* The geometry of a box which decides the positions of the other boxes. */
+struct box_geometry {
+    foil_rect ctnt_rect;
+    int32_t width, height;
+    int32_t mt, ml, mr, mb;
+    int32_t bt, bl, br, bb;
+    int32_t pt, pl, pr, pb;
+};
+
+static void
+save_geometry(const foil_rdrbox *box, struct box_geometry *geom)
+{
+    geom->ctnt_rect = box->ctnt_rect;
+    geom->width = box->width;
+    geom->height = box->height;
+    geom->mt = box->mt; geom->ml = box->ml; geom->mr = box->mr;
+    geom->mb = box->mb;
+    geom->bt = box->bt; geom->bl = box->bl; geom->br = box->br;
+    geom->bb = box->bb;
+    geom->pt = box->pt; geom->pl = box->pl; geom->pr = box->pr;
+    geom->pb = box->pb;
+}
+
+static bool
+is_same_geometry(const foil_rdrbox *box, const struct box_geometry *geom)
+{
+    return box->width == geom->width && box->height == geom->height &&
+        box->mt == geom->mt && box->ml == geom->ml &&
+        box->mr == geom->mr && box->mb == geom->mb &&
+        box->bt == geom->bt && box->bl == geom->bl &&
+        box->br == geom->br && box->bb == geom->bb &&
+        box->pt == geom->pt && box->pl == geom->pl &&
+        box->pr == geom->pr && box->pb == geom->pb;
+}
+
+static bool
+has_out_of_flow_boxes(const foil_rdrbox *box)
+{
+    if (box->position != FOIL_RDRBOX_POSITION_STATIC ||
+            box->floating != FOIL_RDRBOX_FLOAT_NONE)
+        return true;
+
+    const foil_rdrbox *child = box->first;
+    while (child) {
+        if (has_out_of_flow_boxes(child))
+            return true;
+        child = child->next;
+    }
+
+    return false;
+}
+
+/* Checks whether the box can be laid out again at its old position:
+   a block box laid out as a block by its parent, and having no marker or
+   boxes of pseudo elements as its siblings. */
+static bool
+is_relayoutable_in_place(const foil_rdrbox *box)
+{
+    if (box->is_initial || box->type != FOIL_RDRBOX_TYPE_BLOCK ||
+            !box->is_block_level)
+        return false;
+
+    if (!box->parent->is_block_container ||
+            box->parent->nr_inline_level_children > 0)
+        return false;
+
+    if ((box->prev && box->prev->principal == box) ||
+            (box->next && box->next->principal == box))
+        return false;
+
+    return true;
+}
+
+/* Lays out the subtree of the box again. If the geometry of the box does
+   not change, the box is placed at its old position and true is returned;
+   otherwise, the containing block of the box should be laid out again. */
+static bool
+relayout_rdrbox(pcmcth_udom *udom, foil_rdrbox *box,
+        const struct box_geometry *old)
+{
+    foil_rdrbox *parent = box->parent;
+    unsigned nr_block_level_children = parent->nr_block_level_children;
+    unsigned nr_inline_level_children = parent->nr_inline_level_children;
+    unsigned nr_floating_children = parent->nr_floating_children;
+    unsigned nr_abspos_children = parent->nr_abspos_children;
+
+    reset_layout_rdrtree(box);
+
+    foil_layout_ctxt layout_ctxt = { udom, udom->initial_cblock };
+    pre_layout_rdrtree(&layout_ctxt, box);
+
+    /* the box has been counted by the parent */
+    parent->nr_block_level_children = nr_block_level_children;
+    parent->nr_inline_level_children = nr_inline_level_children;
+    parent->nr_floating_children = nr_floating_children;
+    parent->nr_abspos_children = nr_abspos_children;
+
+    resolve_widths(&layout_ctxt, box);
+    resolve_heights(&layout_ctxt, box);
+    if (!is_same_geometry(box, old))
+        return false;
+
+    box->ctnt_rect = old->ctnt_rect;
+    layout_rdrtree(&layout_ctxt, box);
+    return true;
+}
+
+/* Rebuilds the boxes of the rebuildable box (the whole tree if it is NULL),
+   then lays out and renders again the boxes along the chain of the
+   containing blocks up to the first one whose geometry does not change. */
+static int
+rebuild_and_render(pcmcth_udom *udom, foil_rdrbox *box)
+{
+    int ret;
+    struct box_geometry old;
+    bool in_place = false;
+    foil_rdrbox *parent = NULL;
+    pcdoc_element_t elem = NULL;
+
+    if (box) {
+        /* the boxes of the pseudo elements and the marker are siblings */
+        foil_rdrbox *first = box, *last = box;
+        while (first->prev && first->prev->principal == box)
+            first = first->prev;
+        while (last->next && last->next->principal == box)
+            last = last->next;
+
+        in_place = is_relayoutable_in_place(box);
+        if (in_place)
+            save_geometry(box, &old);
+
+        parent = box->parent;
+        elem = box->owner;
+        ret = rebuild_rdrtree(udom, parent, first, last, elem);
+    }
+    else {
+        /* rebuild the whole tree */
+        foil_rdrbox *initial = udom->initial_cblock;
+        initial->nr_child_list_items = 0;
+        udom->nr_open_quotes = 0;
+        udom->nr_close_quotes = 0;
+
+        ret = rebuild_rdrtree(udom, initial, initial->first, initial->last,
+                purc_document_root(udom->doc));
+    }
+
+    if (ret)
+        return -1;
+
+    /* the positioned and the floating boxes are laid out and stacked
+       regardless of the tree order */
+    if (in_place && has_out_of_flow_boxes(udom->initial_cblock))
+        in_place = false;
+
+    foil_rdrbox *dirty = NULL;
+    if (in_place) {
+        box = foil_udom_find_rdrbox(udom, PTR2U64(elem));
+        if (box && box->parent == parent && is_relayoutable_in_place(box) &&
+                relayout_rdrbox(udom, box, &old))
+            dirty = box;
+
+        for (box = parent; dirty == NULL && is_relayoutable_in_place(box);
+                box = box->parent) {
+            save_geometry(box, &old);
+            if (relayout_rdrbox(udom, box, &old))
+                dirty = box;
+        }
+    }
+
+    if (dirty == NULL)
+        return relayout_and_render(udom);
+
+    foil_udom_render_rdrbox_to_page(udom, udom->page, dirty);
+    foil_page_expose(udom->page);
+    return 0;
+}
+
 int foil_udom_update_rdrbox(pcmcth_udom *udom, foil_rdrbox *rdrbox,
         int op, const char *property, purc_variant_t ref_info)
 {
-    (void)udom;
-    (void)rdrbox;
-    (void)op;
-    (void)property;
+    foil_rdrbox *box;
+
     (void)ref_info;
 
-    /* TODO */
-    return PCRDR_SC_NOT_IMPLEMENTED;
+    /* The eDOM has been changed by the interpreter, so we rebuild the boxes
+       of the nearest rebuildable box containing the change. */
+    switch (op) {
+    case PCRDR_K_OPERATION_INSERTBEFORE:
+    case PCRDR_K_OPERATION_INSERTAFTER:
+        /* the content of the parent element changed */
+        box = find_rebuildable_box(udom, rdrbox->parent);
+        break;
+
+    case PCRDR_K_OPERATION_ERASE:
+        if (property == NULL) {
+            /* the element has been erased */
+            box = find_rebuildable_box(udom, rdrbox->parent);
+            break;
+        }
+        /* fall through: an attribute is removed */
+
+    case PCRDR_K_OPERATION_APPEND:
+    case PCRDR_K_OPERATION_PREPEND:
+    case PCRDR_K_OPERATION_DISPLACE:
+    case PCRDR_K_OPERATION_UPDATE:
+    case PCRDR_K_OPERATION_CLEAR:
+        /* the content or the attributes of the element changed */
+        box = find_rebuildable_box(udom, rdrbox);
+        break;
+
+    default:
+        return PCRDR_SC_BAD_REQUEST;
+    }
+
+    if (rebuild_and_render(udom, box))
+        return PCRDR_SC_INTERNAL_SERVER_ERROR;
+
+    return PCRDR_SC_OK;
+}
+
+struct element_finder {
+    pcdoc_element_t elem;
+    bool found;
+};
+
+static int
+find_element(purc_document_t doc, pcdoc_element_t element, void *ctxt)
+{
+    struct element_finder *finder = ctxt;
+
+    (void)doc;
+    if (element == finder->elem) {
+        finder->found = true;
+        return PCDOC_TRAVEL_STOP;
+    }
+
+    return PCDOC_TRAVEL_GOON;
+}
+
+int foil_udom_update_boxless_element(pcmcth_udom *udom,
+        uint64_t element_handle, int op, const char *property,
+        purc_variant_t ref_info)
+{
+    (void)ref_info;
+
+    /* the element may generate boxes now if it is moved or erased, or its
+       attributes (e.g., the style) changed; the changed content of it
+       generates no box either. */
+    bool may_generate_boxes;
+    switch (op) {
+    case PCRDR_K_OPERATION_INSERTBEFORE:
+    case PCRDR_K_OPERATION_INSERTAFTER:
+        may_generate_boxes = true;
+        break;
+
+    case PCRDR_K_OPERATION_ERASE:
+        may_generate_boxes = (property == NULL ||
+                strncmp(property, "attr.", 5) == 0);
+        break;
+
+    case PCRDR_K_OPERATION_UPDATE:
+        may_generate_boxes = (property && strncmp(property, "attr.", 5) == 0);
+        break;
+
+    case PCRDR_K_OPERATION_APPEND:
+    case PCRDR_K_OPERATION_PREPEND:
+    case PCRDR_K_OPERATION_DISPLACE:
+    case PCRDR_K_OPERATION_CLEAR:
+        may_generate_boxes = false;
+        break;
+
+    default:
+        return PCRDR_SC_BAD_REQUEST;
+    }
+
+    /* The handle is not dereferenced before the element is found in the
+       document, because the element may have been erased. */
+    struct element_finder finder = { NULL, false };
+    finder.elem = (pcdoc_element_t)(uintptr_t)element_handle;
+
+    pcdoc_element_t root = purc_document_root(udom->doc);
+    if (root == finder.elem)
+        finder.found = true;
+    else if (root)
+        pcdoc_travel_descendant_elements(udom->doc, root, find_element,
+                &finder, NULL);
+
+    if (!finder.found) {
+        /* an erased element which generated no box leaves nothing */
+        if (op == PCRDR_K_OPERATION_ERASE && property == NULL)
+            return PCRDR_SC_OK;
+        return PCRDR_SC_NOT_FOUND;
+    }
+
+    if (!may_generate_boxes)
+        return PCRDR_SC_OK;
+
+    foil_rdrbox *box = NULL;
+    if (finder.elem != root) {
+        pcdoc_node node = { PCDOC_NODE_ELEMENT, { finder.elem } };
+        pcdoc_element_t parent = pcdoc_node_get_parent(udom->doc, node);
+
+        /* the element is in a subtree which is not rendered */
+        foil_rdrbox *parent_box = foil_udom_find_rdrbox(udom,
+                PTR2U64(parent));
+        if (parent_box == NULL)
+            return PCRDR_SC_OK;
+
+        box = find_rebuildable_box(udom, parent_box);
+    }
+
+    if (rebuild_and_render(udom, box))
+        return PCRDR_SC_INTERNAL_SERVER_ERROR;
+
+    return PCRDR_SC_OK;
 }
 
 purc_variant_t foil_udom_call_method(pcmcth_udom *udom, foil_rdrbox *rdrbox,
@@ -47,6 +47,9 @@ struct pcmcth_udom {
     /* purc_document */
     purc_document_t doc;
 
+    /* the page rendering this uDOM */
+    pcmcth_page *page;
+
     struct purc_broken_down_url *base;
 
     /* author-defined style sheet */
@@ -132,6 +135,12 @@ uint8_t foil_udom_get_langcode(purc_document_t doc, pcdoc_element_t elem);
 int foil_udom_update_rdrbox(pcmcth_udom *udom, foil_rdrbox *rdrbox,
         int op, const char *property, purc_variant_t ref_info);
 
+/* Updates the uDOM for an element which generates no box,
+   e.g., one with `display: none`. */
+int foil_udom_update_boxless_element(pcmcth_udom *udom,
+        uint64_t element_handle, int op, const char *property,
+        purc_variant_t ref_info);
+
 purc_variant_t foil_udom_call_method(pcmcth_udom *udom, foil_rdrbox *rdrbox,
         const char *method, purc_variant_t arg);
 
@@ -145,6 +154,11 @@ void foil_udom_dump(pcmcth_udom *udom);
 void foil_udom_render_to_file(pcmcth_udom *udom, FILE *fp);
 void foil_udom_render_to_page(pcmcth_udom *udom, pcmcth_page *page);
 
+/* Renders the box and its in-flow descendants again; the caller should make
+   sure that no positioned or floating box is in the rendering tree. */
+void foil_udom_render_rdrbox_to_page(pcmcth_udom *udom, pcmcth_page *page,
+        foil_rdrbox *box);
+
 #ifdef __cplusplus
 }
 #endif
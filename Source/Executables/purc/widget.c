@@ -27,6 +27,7 @@
 
 #include "widget.h"
 #include "workspace.h"
+#include "screen-buffer.h"
 
 #include "purc/purc-utils.h"
 #include <assert.h>
@@ -356,6 +357,57 @@ static void print_dirty_page_area_line_mode(foil_widget *widget)
     }
 }
 
+static void
+put_dirty_page_area_fullscreen_mode(struct pcmcth_rdr_data *impl,
+        foil_widget *widget)
+{
+    pcmcth_page *page = &widget->page;
+
+    if (foil_rect_is_empty(&page->dirty_rect)) {
+        return;
+    }
+
+    if (impl->scrbuf == NULL) {
+        impl->scrbuf = foil_scrbuf_new(impl->rows, impl->cols,
+                FOIL_SCRBUF_DEF_MAX_FPS, NULL, NULL);
+        if (impl->scrbuf == NULL) {
+            LOG_ERROR("Failed to create the screen buffer\n");
+            return;
+        }
+    }
+
+    /* the origin of the client area on the screen */
+    int org_x = widget->client_rc.left;
+    int org_y = widget->client_rc.top;
+    for (foil_widget *p = widget->parent; p; p = p->parent) {
+        org_x += p->rect.left;
+        org_y += p->rect.top;
+    }
+
+    int client_w = foil_rect_width(&widget->client_rc);
+    int client_h = foil_rect_height(&widget->client_rc);
+    for (int y = page->dirty_rect.top; y < page->dirty_rect.bottom; y++) {
+        int row = y + widget->vy;
+        if (row < 0 || row >= client_h)
+            continue;
+
+        int left = page->dirty_rect.left;
+        int right = page->dirty_rect.right;
+        if (left + widget->vx < 0)
+            left = -widget->vx;
+        if (right + widget->vx > client_w)
+            right = client_w - widget->vx;
+        if (left >= right)
+            continue;
+
+        foil_scrbuf_put_cells(impl->scrbuf, org_x + left + widget->vx,
+                org_y + row, page->cells[y] + left, right - left);
+    }
+
+    /* the frame may be deferred for the limit of frame rate */
+    foil_scrbuf_flush(impl->scrbuf, false);
+}
+
 void foil_widget_expose(foil_widget *widget)
 {
     foil_widget *root = foil_widget_get_root(widget);
@@ -365,7 +417,7 @@ void foil_widget_expose(foil_widget *widget)
         print_dirty_page_area_line_mode(widget);
     }
     else {
-        // TODO
+        put_dirty_page_area_fullscreen_mode(workspace->rdr->impl, widget);
     }
 }
 
@@ -1092,47 +1092,46 @@ purc_dvobj_unpack_real(const unsigned char *bytes, size_t nr_bytes,
         }
     }
     else {
-        purc_variant_t retv;
-
-        retv = purc_variant_make_array(0, PURC_VARIANT_INVALID);
-        if (retv == PURC_VARIANT_INVALID) {
+        /* keep the reals in a packed array instead of making a variant
+           for each of them */
+        purc_variant_type type = PURC_VARIANT_TYPE_ULONGINT;
+        if (real_info[real_id].real_type == PURC_VARIANT_TYPE_LONGINT)
+            type = PURC_VARIANT_TYPE_LONGINT;
+
+        void *reals = malloc(sizeof(uint64_t) * quantity);
+        if (reals == NULL) {
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             goto fatal;
         }
 
+        int64_t *i64s = reals;
+        uint64_t *u64s = reals;
         for (size_t i = 0; i < quantity; i++) {
-            purc_variant_t vrt = PURC_VARIANT_INVALID;
             purc_real_t real = real_info[real_id].fetcher(bytes);
             switch (real_info[real_id].real_type) {
                 case PURC_VARIANT_TYPE_LONGINT:
-                    vrt = purc_variant_make_longint(real.i64);
+                    i64s[i] = real.i64;
                     break;
                 case PURC_VARIANT_TYPE_ULONGINT:
-                    vrt = purc_variant_make_ulongint(real.u64);
+                    u64s[i] = real.u64;
                     break;
                 case PURC_VARIANT_TYPE_NUMBER:
-                    vrt = purc_variant_make_ulongint(real.d);
+                    u64s[i] = real.d;
                     break;
                 case PURC_VARIANT_TYPE_LONGDOUBLE:
-                    vrt = purc_variant_make_ulongint(real.ld);
+                    u64s[i] = real.ld;
                     break;
                 default:
                     assert(0);
                     break;
             }
 
-            if (vrt == PURC_VARIANT_INVALID)
-                goto fatal;
-
-            bool ok = purc_variant_array_append(retv, vrt);
-            purc_variant_unref(vrt);
-            if (!ok) {
-                purc_variant_unref(retv);
-                goto fatal;
-            }
-
             bytes += real_info[real_id].length;
         }
 
+        purc_variant_t retv;
+        retv = pcvariant_array_make_packed(type, reals, quantity);
+        free(reals);
         return retv;
     }
 
@@ -1565,48 +1564,65 @@ purc_dvobj_pack_real(struct pcdvobj_bytes_buff *bf, purc_variant_t item,
     enum purc_variant_type vt = purc_variant_get_type(item);
     bool is_linear_container = ((vt == PURC_VARIANT_TYPE_ARRAY) ||
             (vt == PURC_VARIANT_TYPE_SET) || (vt == PURC_VARIANT_TYPE_TUPLE));
-    for (size_t n = 0; n < quantity; n++) {
-        purc_variant_t real_item;
 
-        if (is_linear_container) {
-            real_item = purc_variant_linear_container_get(item, n);
-            if (real_item == PURC_VARIANT_INVALID) {
-                purc_set_error(PURC_ERROR_ARGUMENT_MISSED);
-                goto failed;
-            }
-        }
-        else {
-            // just repeat the item.
-            real_item = item;
-        }
+    /* the members of a packed array of the same type are taken as is */
+    const void *packed = NULL;
+    purc_variant_type packed_type;
+    size_t nr_packed = 0;
+    if (vt == PURC_VARIANT_TYPE_ARRAY) {
+        packed = pcvariant_array_get_packed(item, &packed_type, &nr_packed);
+        if (packed && packed_type != real_info[real_id].real_type)
+            packed = NULL;
+    }
 
+    for (size_t n = 0; n < quantity; n++) {
         purc_real_t real;
         bool ret;
-        switch (real_info[real_id].real_type) {
-            case PURC_VARIANT_TYPE_LONGINT:
-                ret = purc_variant_cast_to_longint(real_item,
-                        &real.i64, false);
-                break;
-            case PURC_VARIANT_TYPE_ULONGINT:
-                ret = purc_variant_cast_to_ulongint(real_item,
-                        &real.u64, false);
-                break;
-            case PURC_VARIANT_TYPE_NUMBER:
-                ret = purc_variant_cast_to_number(real_item,
-                        &real.d, false);
-                break;
-            case PURC_VARIANT_TYPE_LONGDOUBLE:
-                ret = purc_variant_cast_to_longdouble(real_item,
-                        &real.ld, false);
-                break;
-            default:
-                ret = false;
-                break;
+
+        if (packed && n < nr_packed) {
+            memcpy(&real, (const uint64_t *)packed + n, sizeof(uint64_t));
         }
+        else {
+            purc_variant_t real_item;
 
-        if (!ret) {
-            purc_set_error(PURC_ERROR_WRONG_DATA_TYPE);
-            goto failed;
+            if (is_linear_container) {
+                real_item = purc_variant_linear_container_get(item, n);
+                if (real_item == PURC_VARIANT_INVALID) {
+                    purc_set_error(PURC_ERROR_ARGUMENT_MISSED);
+                    goto failed;
+                }
+            }
+            else {
+                // just repeat the item.
+                real_item = item;
+            }
+
+            switch (real_info[real_id].real_type) {
+                case PURC_VARIANT_TYPE_LONGINT:
+                    ret = purc_variant_cast_to_longint(real_item,
+                            &real.i64, false);
+                    break;
+                case PURC_VARIANT_TYPE_ULONGINT:
+                    ret = purc_variant_cast_to_ulongint(real_item,
+                            &real.u64, false);
+                    break;
+                case PURC_VARIANT_TYPE_NUMBER:
+                    ret = purc_variant_cast_to_number(real_item,
+                            &real.d, false);
+                    break;
+                case PURC_VARIANT_TYPE_LONGDOUBLE:
+                    ret = purc_variant_cast_to_longdouble(real_item,
+                            &real.ld, false);
+                    break;
+                default:
+                    ret = false;
+                    break;
+            }
+
+            if (!ret) {
+                purc_set_error(PURC_ERROR_WRONG_DATA_TYPE);
+                goto failed;
+            }
         }
 
         if (!real_info[real_id].dumper(bf->bytes + bf->nr_bytes, real,
@@ -1934,9 +1950,11 @@ shuffle_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
         ssize_t sz = purc_variant_array_get_size(argv[0]);
 
         if (sz > 1) {
-            struct pcutils_array_list *al = variant_array_get_data(argv[0]);
-            struct pcutils_array_list_node *p;
-            array_list_for_each(al, p) {
+            variant_arr_t data = variant_array_get_data(argv[0]);
+            if (pcvariant_array_unpack(argv[0]))
+                goto failed;
+
+            for (size_t i = 0; i < data->nr; i++) {
 
                 size_t new_idx;
                 if (sz < RAND_MAX) {
@@ -1947,8 +1965,11 @@ shuffle_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
                     new_idx = new_idx * sz / RAND_MAX;
                 }
 
-                if (new_idx != p->idx)
-                    pcutils_array_list_swap(al, p->idx, new_idx);
+                if (new_idx != i) {
+                    purc_variant_t tmp = data->members[i];
+                    data->members[i] = data->members[new_idx];
+                    data->members[new_idx] = tmp;
+                }
             }
         }
     }
@@ -2202,6 +2223,42 @@ static struct crc32algo_to_atom {
     { PURC_ALGO_CRC32Q,         0 }, // "CRC-32Q"
 };
 
+#define SZ_HASH_CHUNK       (64 * 1024)
+
+/* Feeds the data to a hash function. A stream entity of $STREAM is read to
+   the end in chunks, so a large file is hashed without being loaded in
+   memory; other variants are hashed as they are stringified. */
+static bool
+feed_hash(purc_variant_t data, void *ctxt, pcrws_cb_write cb)
+{
+    purc_rwstream_t reader = pcdvobjs_stream_get_reader(data);
+    if (reader) {
+        char *buf = malloc(SZ_HASH_CHUNK);
+        if (buf == NULL) {
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+
+        ssize_t nr_read;
+        while ((nr_read = purc_rwstream_read(reader, buf, SZ_HASH_CHUNK)) > 0)
+            cb(ctxt, buf, nr_read);
+
+        free(buf);
+        return nr_read == 0;
+    }
+
+    purc_rwstream_t stream = purc_rwstream_new_for_dump(ctxt, cb);
+    if (stream == NULL) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+
+    ssize_t ret = purc_variant_stringify(stream, data,
+            PCVRNT_STRINGIFY_OPT_BSEQUENCE_BAREBYTES, NULL);
+    purc_rwstream_destroy(stream);
+    return ret >= 0;
+}
+
 static ssize_t cb_calc_crc32(void *ctxt, const void *buf, size_t count)
 {
     pcutils_crc32_update(ctxt, buf, count);
@@ -2214,8 +2271,6 @@ crc32_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
 {
     UNUSED_PARAM(root);
 
-    purc_rwstream_t stream = NULL;
-
     if (nr_args == 0) {
         purc_set_error(PURC_ERROR_ARGUMENT_MISSED);
         goto failed;
@@ -2279,21 +2334,11 @@ crc32_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
     }
 
     pcutils_crc32_ctxt ctxt;
-    stream = purc_rwstream_new_for_dump(&ctxt, cb_calc_crc32);
-    if (stream == NULL) {
-        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        goto fatal;
-    }
-
     pcutils_crc32_begin(&ctxt, algo);
-
-    if (purc_variant_stringify(stream, argv[0],
-            PCVRNT_STRINGIFY_OPT_BSEQUENCE_BAREBYTES, NULL) < 0) {
+    if (!feed_hash(argv[0], &ctxt, cb_calc_crc32)) {
         goto fatal;
     }
 
-    purc_rwstream_destroy(stream);
-
     uint32_t crc32;
     pcutils_crc32_end(&ctxt, &crc32);
     purc_log_info("%08x\n", crc32);
@@ -2319,8 +2364,6 @@ failed:
         return purc_variant_make_undefined();
 
 fatal:
-    if (stream)
-        purc_rwstream_destroy(stream);
     return PURC_VARIANT_INVALID;
 }
 
@@ -2337,8 +2380,6 @@ md5_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
 {
     UNUSED_PARAM(root);
 
-    purc_rwstream_t stream = NULL;
-
     if (nr_args == 0) {
         purc_set_error(PURC_ERROR_ARGUMENT_MISSED);
         goto failed;
@@ -2364,20 +2405,11 @@ md5_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
     }
 
     pcutils_md5_ctxt md5_ctxt;
-    stream = purc_rwstream_new_for_dump(&md5_ctxt, cb_calc_md5);
-    if (stream == NULL) {
-        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        goto fatal;
-    }
-
     pcutils_md5_begin(&md5_ctxt);
-    if (purc_variant_stringify(stream, argv[0],
-            PCVRNT_STRINGIFY_OPT_BSEQUENCE_BAREBYTES, NULL) < 0) {
+    if (!feed_hash(argv[0], &md5_ctxt, cb_calc_md5)) {
         goto fatal;
     }
 
-    purc_rwstream_destroy(stream);
-
     unsigned char md5[MD5_DIGEST_SIZE];
     pcutils_md5_end(&md5_ctxt, md5);
 
@@ -2400,8 +2432,6 @@ failed:
         return purc_variant_make_undefined();
 
 fatal:
-    if (stream)
-        purc_rwstream_destroy(stream);
     return PURC_VARIANT_INVALID;
 }
 
@@ -2418,8 +2448,6 @@ sha1_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
 {
     UNUSED_PARAM(root);
 
-    purc_rwstream_t stream = NULL;
-
     if (nr_args == 0) {
         purc_set_error(PURC_ERROR_ARGUMENT_MISSED);
         goto failed;
@@ -2445,20 +2473,11 @@ sha1_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
     }
 
     pcutils_sha1_ctxt sha1_ctxt;
-    stream = purc_rwstream_new_for_dump(&sha1_ctxt, cb_calc_sha1);
-    if (stream == NULL) {
-        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        goto fatal;
-    }
-
     pcutils_sha1_begin(&sha1_ctxt);
-    if (purc_variant_stringify(stream, argv[0],
-            PCVRNT_STRINGIFY_OPT_BSEQUENCE_BAREBYTES, NULL) < 0) {
+    if (!feed_hash(argv[0], &sha1_ctxt, cb_calc_sha1)) {
         goto fatal;
     }
 
-    purc_rwstream_destroy(stream);
-
     unsigned char sha1[SHA1_DIGEST_SIZE];
     pcutils_sha1_end(&sha1_ctxt, sha1);
 
@@ -2482,8 +2501,6 @@ failed:
         return purc_variant_make_undefined();
 
 fatal:
-    if (stream)
-        purc_rwstream_destroy(stream);
     return PURC_VARIANT_INVALID;
 }
 
@@ -2593,7 +2610,7 @@ hex2bin_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
     }
 
     size_t converted;
-    if (pcutils_hex2bin(string, bytes, &converted) < 0 ||
+    if (pcutils_hex2bin_ex(string, len, bytes, &converted) < 0 ||
             converted < expected) {
         free(bytes);
         purc_set_error(PURC_ERROR_BAD_ENCODING);
@@ -2694,7 +2711,7 @@ base64_decode_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
         goto fatal;
     }
 
-    ssize_t converted = pcutils_b64_decode(string, bytes, expected);
+    ssize_t converted = pcutils_b64_decode_ex(string, len, bytes, expected);
     if (converted < 0) {
         free(bytes);
         purc_set_error(PURC_ERROR_BAD_ENCODING);
@@ -165,6 +165,22 @@ uri_getter(purc_variant_t root,
     return purc_variant_make_string(inst->endpoint_name, false);
 }
 
+static purc_variant_t
+stats_getter(purc_variant_t root,
+        size_t nr_args, purc_variant_t *argv, unsigned call_flags)
+{
+    UNUSED_PARAM(root);
+    UNUSED_PARAM(nr_args);
+    UNUSED_PARAM(argv);
+
+    purc_variant_t stats = purc_get_instance_stats();
+    if (stats == PURC_VARIANT_INVALID &&
+            (call_flags & PCVRT_CALL_FLAG_SILENTLY))
+        return purc_variant_make_undefined();
+
+    return stats;
+}
+
 static purc_variant_t
 chan_getter(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
         unsigned call_flags)
@@ -259,6 +275,7 @@ purc_dvobj_runner_new(void)
         { "rid",    rid_getter,     NULL },
         { "uri",    uri_getter,     NULL },
         { "chan",   chan_getter,    chan_setter },
+        { "stats",  stats_getter,   NULL },
 #if ENABLE(CHINESE_NAMES)
         { "用户",   user_getter,    user_setter },
         { "应用名", app_getter,     NULL },
@@ -266,6 +283,7 @@ purc_dvobj_runner_new(void)
         { "行者标识符", rid_getter,     NULL },
         { "统一资源标识符",    uri_getter,     NULL },
         { "通道",   chan_getter,    chan_setter },
+        { "统计",   stats_getter,   NULL },
 #endif
     };
 
@@ -30,6 +30,7 @@
 
 #include "private/debug.h"
 #include "private/dvobjs.h"
+#include "private/variant.h"
 #include "private/atom-buckets.h"
 #include "private/interpreter.h"
 
@@ -423,32 +424,58 @@ out:
 }
 
 #define LINE_FLAG           "\n"
+
+/* The lines are the slices of the chunk read; a line flag following a line
+   is replaced by a null byte, so the slices are null-terminated. */
 static int read_lines(purc_rwstream_t stream, int line_num,
         purc_variant_t array)
 {
-    unsigned char buffer[BUFFER_SIZE];
     ssize_t read_size = 0;
     size_t length = 0;
     const char *head = NULL;
     const char *end = NULL;
 
     while (line_num) {
+        char *buffer = malloc(BUFFER_SIZE + 1);
+        if (buffer == NULL) {
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return -1;
+        }
+
         read_size = purc_rwstream_read(stream, buffer, BUFFER_SIZE);
-        if (read_size < 0)
+        if (read_size <= 0) {
+            free(buffer);
             break;
+        }
+        buffer[read_size] = 0;
 
-        end = (const char*)(buffer + read_size);
+        purc_variant_t chunk = purc_variant_make_byte_sequence_reuse_buff(
+                buffer, read_size + 1, BUFFER_SIZE + 1);
+        if (!chunk) {
+            free(buffer);
+            return -1;
+        }
 
-        head = pcutils_get_next_token_len((const char*)buffer, read_size,
-                LINE_FLAG, &length);
+        size_t nr_bytes;
+        char *bytes = (char *)purc_variant_get_bytes_const(chunk, &nr_bytes);
+        end = bytes + read_size;
+
+        head = pcutils_get_next_token_len(bytes, read_size, LINE_FLAG,
+                &length);
         while (head && head < end) {
-            purc_variant_t var = purc_variant_make_string_ex(head, length,
-                    false);
+            char *next = (char *)head + length;
+            if (next < end && *next == LINE_FLAG[0])
+                *next++ = 0;
+
+            purc_variant_t var = pcvariant_make_string_slice(chunk,
+                    head, length, false);
             if (!var) {
+                purc_variant_unref(chunk);
                 return -1;
             }
             if (!purc_variant_array_append(array, var)) {
                 purc_variant_unref(var);
+                purc_variant_unref(chunk);
                 return -1;
             }
             purc_variant_unref(var);
@@ -457,9 +484,11 @@ static int read_lines(purc_rwstream_t stream, int line_num,
             if (line_num == 0)
                 break;
 
-            head = pcutils_get_next_token_len(head + length, end - head - length,
+            head = pcutils_get_next_token_len(next, end - next,
                 LINE_FLAG, &length);
         }
+        purc_variant_unref(chunk);
+
         if (read_size < BUFFER_SIZE)           // to the end
             break;
 
@@ -1070,6 +1099,21 @@ on_release(void *native_entity)
     native_stream_destroy((struct pcdvobjs_stream *)native_entity);
 }
 
+purc_rwstream_t
+pcdvobjs_stream_get_reader(purc_variant_t v)
+{
+    if (!purc_variant_is_native(v))
+        return NULL;
+
+    /* all stream entities share the callback to release them */
+    struct purc_native_ops *ops = purc_variant_native_get_ops(v);
+    if (ops == NULL || ops->on_release != on_release)
+        return NULL;
+
+    struct pcdvobjs_stream *stream = purc_variant_native_get_entity(v);
+    return stream ? stream->stm4r : NULL;
+}
+
 static purc_nvariant_method
 property_getter(void *entity, const char *name)
 {
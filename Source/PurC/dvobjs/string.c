@@ -625,7 +625,6 @@ explode_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
 
     purc_variant_t ret_var = PURC_VARIANT_INVALID;
     purc_variant_t val = PURC_VARIANT_INVALID;
-    char *buf = NULL;
 
     if ((argv == NULL) || (nr_args < 2)) {
         purc_set_error (PURC_ERROR_ARGUMENT_MISSED);
@@ -652,16 +651,13 @@ explode_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
     ret_var = purc_variant_make_array (0, PURC_VARIANT_INVALID);
 
     while (head) {
-        buf = malloc (length + 1);
-        if (buf == NULL) {
-            purc_set_error (PURC_ERROR_OUT_OF_MEMORY);
+        /* the segments refer to the buffer of the source string */
+        val = pcvariant_make_string_slice (argv[0], head, length, true);
+        if (val == PURC_VARIANT_INVALID) {
             purc_variant_unref (ret_var);
             return PURC_VARIANT_INVALID;
         }
 
-        strncpy (buf, head, length + 1);
-        *(buf + length)= 0x00;
-        val = purc_variant_make_string_reuse_buff (buf, length, true);
         purc_variant_array_append (ret_var, val);
         purc_variant_unref (val);
 
@@ -1167,8 +1163,9 @@ substr_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
         return PURC_VARIANT_INVALID;
     }
     size_t str_len = 0;
-    purc_variant_string_bytes (argv[0], &str_len);
-    const char * src = purc_variant_get_string_const (argv[0]);
+    /* a string slice needs not to be null-terminated here */
+    const char * src = pcvariant_get_bytes_const (argv[0], &str_len);
+    str_len++;      // including the terminating null byte
 
     if (argv[1] == NULL || !(purc_variant_is_longint (argv[1])
             || purc_variant_is_number (argv[1]))) {
@@ -1216,17 +1213,8 @@ substr_getter (purc_variant_t root, size_t nr_args, purc_variant_t *argv,
     length = end - start;
     if (length == 0)
         return purc_variant_make_string("", false);
-    else {
-        char *buf = malloc (length + 1);
-        if (buf == NULL) {
-            purc_set_error (PURC_ERROR_OUT_OF_MEMORY);
-            return PURC_VARIANT_INVALID;
-        }
-
-        strncpy (buf, start, length);
-        buf[length] = 0x00;
-        ret_var = purc_variant_make_string_reuse_buff (buf, length, false);
-    }
+    else
+        ret_var = pcvariant_make_string_slice (argv[0], start, length, false);
 
     return ret_var;
 }
@@ -0,0 +1,109 @@
+/*
+ * @file fetcher-connection.cpp
+ * @date 2026/10/19
+ * @brief The impl of the connection to the fetcher process.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#if ENABLE(REMOTE_FETCHER)
+
+#include "fetcher-connection.h"
+#include "fetcher-request.h"
+
+using namespace PurCFetcher;
+
+PcFetcherConnection::PcFetcherConnection(
+        IPC::Connection::Identifier identifier, WorkQueue *queue)
+    : m_workQueue(queue)
+    , m_connection(IPC::Connection::createClientConnection(identifier,
+                *this, queue))
+{
+    m_connection->open();
+}
+
+PcFetcherConnection::~PcFetcherConnection()
+{
+    close();
+}
+
+void PcFetcherConnection::close()
+{
+    m_closed = true;
+    if (m_connection) {
+        m_connection->invalidate();
+        m_connection = nullptr;
+    }
+}
+
+bool PcFetcherConnection::addRequest(uint64_t reqId,
+        PcFetcherRequest *request)
+{
+    auto locker = holdLock(m_requestLock);
+    return m_requestMap.add(reqId, request).isNewEntry;
+}
+
+void PcFetcherConnection::removeRequest(uint64_t reqId)
+{
+    auto locker = holdLock(m_requestLock);
+    m_requestMap.remove(reqId);
+}
+
+size_t PcFetcherConnection::load()
+{
+    auto locker = holdLock(m_requestLock);
+    return m_requestMap.size();
+}
+
+void PcFetcherConnection::didClose(IPC::Connection&)
+{
+    /* the pool will drop this connection once it is found closed;
+       the requests in flight time out as before. */
+    m_closed = true;
+}
+
+void PcFetcherConnection::didReceiveInvalidMessage(IPC::Connection&,
+        IPC::MessageName)
+{
+}
+
+void PcFetcherConnection::didReceiveMessage(IPC::Connection& connection,
+        IPC::Decoder& decoder)
+{
+    /* Keep the lock while dispatching, so that a request will not be
+       destroyed by its own thread in the middle of the dispatching. */
+    auto locker = holdLock(m_requestLock);
+    auto it = m_requestMap.find(decoder.destinationID());
+    if (it == m_requestMap.end())
+        return;
+
+    it->value->didReceiveMessage(connection, decoder);
+}
+
+void PcFetcherConnection::didReceiveSyncMessage(IPC::Connection& connection,
+        IPC::Decoder& decoder, std::unique_ptr<IPC::Encoder>& replyEncoder)
+{
+    UNUSED_PARAM(connection);
+    UNUSED_PARAM(decoder);
+    UNUSED_PARAM(replyEncoder);
+}
+
+#endif // ENABLE(REMOTE_FETCHER)
+
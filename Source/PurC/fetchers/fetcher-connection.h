@@ -0,0 +1,93 @@
+/*
+ * @file fetcher-connection.h
+ * @date 2026/10/19
+ * @brief The long-lived connection to the fetcher process shared by
+ *      the requests.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PURC_FETCHER_CONNECTION_H
+#define PURC_FETCHER_CONNECTION_H
+
+#if ENABLE(REMOTE_FETCHER)
+
+#include "Connection.h"
+
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/ThreadSafeRefCounted.h>
+
+#include <atomic>
+
+using namespace PurCFetcher;
+
+class PcFetcherRequest;
+
+/* A connection multiplexes the requests by their identifiers: the fetcher
+   process sends the messages of a resource load with the identifier of
+   the load as the destination. */
+class PcFetcherConnection : public IPC::Connection::Client,
+        public ThreadSafeRefCounted<PcFetcherConnection> {
+    WTF_MAKE_NONCOPYABLE(PcFetcherConnection);
+
+public:
+    static Ref<PcFetcherConnection> create(
+            IPC::Connection::Identifier identifier, WorkQueue *queue)
+    {
+        return adoptRef(*new PcFetcherConnection(identifier, queue));
+    }
+
+    ~PcFetcherConnection();
+
+    /* NULL once the connection is closed */
+    IPC::Connection* connection() const { return m_connection.get(); }
+
+    void close();
+    bool isClosed() const { return m_closed; }
+
+    bool addRequest(uint64_t reqId, PcFetcherRequest *request);
+    void removeRequest(uint64_t reqId);
+
+    /* the number of the requests in flight */
+    size_t load();
+
+protected:
+    void didClose(IPC::Connection&);
+    void didReceiveInvalidMessage(IPC::Connection&, IPC::MessageName);
+    const char* connectionName(void) { return "PcFetcherConnection"; }
+
+    void didReceiveMessage(IPC::Connection&, IPC::Decoder&);
+    void didReceiveSyncMessage(IPC::Connection&, IPC::Decoder&,
+            std::unique_ptr<IPC::Encoder>&);
+
+private:
+    PcFetcherConnection(IPC::Connection::Identifier, WorkQueue *queue);
+
+    RefPtr<WorkQueue> m_workQueue;
+    RefPtr<IPC::Connection> m_connection;
+    std::atomic<bool> m_closed { false };
+
+    Lock m_requestLock;
+    HashMap<uint64_t, PcFetcherRequest*> m_requestMap;
+};
+
+#endif // ENABLE(REMOTE_FETCHER)
+
+#endif /* not defined PURC_FETCHER_CONNECTION_H */
+
@@ -29,6 +29,19 @@
 
 #define PCFETCHER_INITIAL_PROGRESS  0.1
 
+/* the requests in flight on a connection before opening another one */
+#define PCFETCHER_REQUESTS_PER_CONN 8
+
+/* the bytes of a streamed body queued before the receiver is held back */
+#define PCFETCHER_STREAM_HIGH_WATER (256 * 1024)
+
+/* the bodies not less than this size are passed in shared memory;
+   keep in sync with sharedMemoryTransferThreshold of the fetcher */
+#define PCFETCHER_SHARED_MEMORY_THRESHOLD   (64 * 1024)
+
+/* the milliseconds the fetcher buffers the body before sending it */
+#define PCFETCHER_MAX_BUFFERING_TIME_MS     100
+
 #ifdef __cplusplus
 extern "C" {
 #endif  /* __cplusplus */
@@ -73,6 +86,14 @@ typedef purc_rwstream_t (*pcfetcher_request_sync_fn)(
         uint32_t timeout,
         struct pcfetcher_resp_header *resp_header);
 
+typedef purc_rwstream_t (*pcfetcher_request_stream_fn)(
+        struct pcfetcher* fetcher,
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        struct pcfetcher_resp_header *resp_header);
+
 typedef void (*pcfetcher_cancel_async_fn)(struct pcfetcher* fetcher,
         purc_variant_t request);
 
@@ -91,6 +112,8 @@ struct pcfetcher {
     pcfetcher_cookie_remove_fn cookie_remove;
     pcfetcher_request_async_fn request_async;
     pcfetcher_request_sync_fn request_sync;
+    /* nullable; falls back to request_sync */
+    pcfetcher_request_stream_fn request_stream;
     pcfetcher_cancel_async_fn cancel_async;
     pcfetcher_check_response_fn check_response;
 };
@@ -192,6 +215,14 @@ purc_rwstream_t pcfetcher_remote_request_sync(
         uint32_t timeout,
         struct pcfetcher_resp_header *resp_header);
 
+purc_rwstream_t pcfetcher_remote_request_stream(
+        struct pcfetcher* fetcher,
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        struct pcfetcher_resp_header *resp_header);
+
 void pcfetcher_remote_cancel_async(struct pcfetcher* fetcher,
         purc_variant_t request);
 
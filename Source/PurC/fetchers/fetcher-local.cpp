@@ -83,6 +83,7 @@ struct pcfetcher* pcfetcher_local_init(size_t max_conns, size_t cache_quota)
     fetcher->cookie_remove = pcfetcher_cookie_loccal_remove;
     fetcher->request_async = pcfetcher_local_request_async;
     fetcher->request_sync = pcfetcher_local_request_sync;
+    fetcher->request_stream = NULL;
     fetcher->cancel_async = pcfetcher_local_cancel_async;
     fetcher->check_response = pcfetcher_local_check_response;
 
@@ -55,6 +55,8 @@ PcFetcherProcess::~PcFetcherProcess()
 
 void PcFetcherProcess::reset(void)
 {
+    closeConnections();
+
     if (m_connection) {
         m_connection->invalidate();
         m_connection = nullptr;
@@ -252,7 +254,8 @@ void PcFetcherProcess::setProcessSuppressionEnabled(bool processSuppressionEnabl
     UNUSED_PARAM(processSuppressionEnabled);
 }
 
-PcFetcherRequest* PcFetcherProcess::createRequest(void)
+RefPtr<PcFetcherConnection> PcFetcherProcess::createConnection(
+        WorkQueue *queue)
 {
     PurCFetcher::ProcessIdentifier pid = ProcessIdentifier::generate();
 //    PAL::SessionID sid(ProcessIdentifier::generate().toUInt64());
@@ -260,12 +263,89 @@ PcFetcherRequest* PcFetcherProcess::createRequest(void)
     uint64_t destinationID = ProcessIdentifier::generate().toUInt64();
     Optional<IPC::Attachment> attachment;
     PurCFetcher::HTTPCookieAcceptPolicy cookieAcceptPolicy;
-    sendSync(
+    if (!sendSync(
         Messages::NetworkProcess::CreateNetworkConnectionToWebProcess { pid, sid },
         Messages::NetworkProcess::CreateNetworkConnectionToWebProcess::Reply(
-            attachment, cookieAcceptPolicy), destinationID);
-    PcFetcherRequest *request  = new PcFetcherRequest(sid.toUInt64(),
-            attachment->releaseFileDescriptor(), m_workQueue.get(), this);
+            attachment, cookieAcceptPolicy), destinationID) || !attachment) {
+        return nullptr;
+    }
+
+    return PcFetcherConnection::create(attachment->releaseFileDescriptor(),
+            queue);
+}
+
+/* Select the least loaded connection in the pool. A new connection is
+   created only if all connections are busy and the pool is not full. */
+RefPtr<PcFetcherConnection> PcFetcherProcess::acquireConnection(void)
+{
+    auto locker = holdLock(m_connectionLock);
+
+    m_connectionPool.removeAllMatching([] (auto& conn) {
+        return conn->isClosed();
+    });
+
+    RefPtr<PcFetcherConnection> selected;
+    size_t minLoad = SIZE_MAX;
+    for (auto& conn : m_connectionPool) {
+        size_t load = conn->load();
+        if (load < minLoad) {
+            minLoad = load;
+            selected = conn;
+        }
+    }
+
+    size_t maxConns = m_fetcher->max_conns ? m_fetcher->max_conns : 1;
+    if (selected && (minLoad < PCFETCHER_REQUESTS_PER_CONN ||
+                m_connectionPool.size() >= maxConns)) {
+        return selected;
+    }
+
+    RefPtr<PcFetcherConnection> conn = createConnection(m_workQueue.get());
+    if (!conn) {
+        return selected;
+    }
+
+    m_connectionPool.append(conn);
+    return conn;
+}
+
+void PcFetcherProcess::dropConnection(PcFetcherConnection *conn)
+{
+    auto locker = holdLock(m_connectionLock);
+    m_connectionPool.removeFirstMatching([conn] (auto& pooled) {
+        return pooled.get() == conn;
+    });
+    conn->close();
+}
+
+void PcFetcherProcess::closeConnections(void)
+{
+    auto locker = holdLock(m_connectionLock);
+    for (auto& conn : m_connectionPool) {
+        conn->close();
+    }
+    m_connectionPool.clear();
+}
+
+/* A dedicated connection has its own work queue which may be held back by
+   the request without stalling the requests on the pooled connections. */
+PcFetcherRequest* PcFetcherProcess::createRequest(bool dedicated)
+{
+    RefPtr<PcFetcherConnection> conn;
+    if (dedicated) {
+        auto queue = WorkQueue::create("PcFetcherStream_Queue");
+        conn = createConnection(queue.ptr());
+    }
+    else {
+        conn = acquireConnection();
+    }
+
+    if (!conn) {
+        return NULL;
+    }
+
+    PcFetcherRequest *request = new PcFetcherRequest(conn.releaseNonNull(),
+            this);
     if (!request) {
         return NULL;
     }
@@ -323,10 +403,33 @@ purc_rwstream_t PcFetcherProcess::requestSync(
         struct pcfetcher_resp_header *resp_header)
 {
     PcFetcherRequest* session = createRequest();
+    if (!session) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
     return session->requestSync(base_uri, url, method,
             params, timeout, resp_header);
 }
 
+purc_rwstream_t PcFetcherProcess::requestStream(
+        const char* base_uri,
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        struct pcfetcher_resp_header *resp_header)
+{
+    PcFetcherRequest* session = createRequest(true);
+    if (!session) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    return session->requestStream(base_uri, url, method,
+            params, timeout, resp_header);
+}
+
 void PcFetcherProcess::cancelAsyncRequest(purc_variant_t request_id)
 {
     if (!request_id) {
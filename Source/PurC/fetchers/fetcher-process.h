@@ -28,6 +28,7 @@
 #if ENABLE(REMOTE_FETCHER)
 
 #include "fetcher-request.h"
+#include "fetcher-connection.h"
 #include "fetcher-messages-basic.h"
 
 #include "Connection.h"
@@ -123,12 +124,23 @@ public:
         uint32_t timeout,
         struct pcfetcher_resp_header *resp_header);
 
+    purc_rwstream_t requestStream(
+        const char* base_uri,
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        struct pcfetcher_resp_header *resp_header);
+
     void cancelAsyncRequest(purc_variant_t request_id);
 
     int checkResponse(uint32_t timeout_ms);
 
     void requestFinished(PcFetcherRequest *request);
 
+    /* removes a closed connection from the pool */
+    void dropConnection(PcFetcherConnection *conn);
+
     bool isReadyToTerm();
 
 protected:
@@ -155,7 +167,11 @@ protected:
     const char* connectionName(void) override { return "PcFetcherProcess"; }
 
 private:
-    PcFetcherRequest* createRequest(void);
+    RefPtr<PcFetcherConnection> createConnection(WorkQueue *queue);
+    RefPtr<PcFetcherConnection> acquireConnection(void);
+    void closeConnections(void);
+
+    PcFetcherRequest* createRequest(bool dedicated = false);
     void removeRequest(PcFetcherRequest *request);
 
 private:
@@ -174,6 +190,11 @@ private:
 
     Lock m_requestLock;
     Vector<PcFetcherRequest*> m_requestVec;
+
+    /* the long-lived connections shared by the requests;
+       no more than `max_conns` of the fetcher. */
+    Lock m_connectionLock;
+    Vector<RefPtr<PcFetcherConnection>> m_connectionPool;
 };
 
 template<typename T>
@@ -54,6 +54,7 @@ struct pcfetcher* pcfetcher_remote_init(size_t max_conns, size_t cache_quota)
     fetcher->cookie_remove = pcfetcher_cookie_remote_remove;
     fetcher->request_async = pcfetcher_remote_request_async;
     fetcher->request_sync = pcfetcher_remote_request_sync;
+    fetcher->request_stream = pcfetcher_remote_request_stream;
     fetcher->cancel_async = pcfetcher_remote_cancel_async;
     fetcher->check_response = pcfetcher_remote_check_response;
 
@@ -170,6 +171,20 @@ purc_rwstream_t pcfetcher_remote_request_sync(
             url, method, params, timeout, resp_header);
 }
 
+purc_rwstream_t pcfetcher_remote_request_stream(
+        struct pcfetcher* fetcher,
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        struct pcfetcher_resp_header *resp_header)
+{
+    struct pcfetcher_remote* remote = (struct pcfetcher_remote*)fetcher;
+    return remote->process->requestStream(
+            remote->base_uri,
+            url, method, params, timeout, resp_header);
+}
+
 void pcfetcher_remote_cancel_async(struct pcfetcher* fetcher,
         purc_variant_t request)
 {
@@ -35,6 +35,7 @@
 #include "ResourceResponse.h"
 
 #include "private/url.h"
+#include "private/rwstream.h"
 
 #include <wtf/RunLoop.h>
 
@@ -54,23 +55,15 @@ using namespace PurCFetcher;
 
 extern "C"  struct pcinst* pcinst_current(void);
 
-PcFetcherRequest::PcFetcherRequest(uint64_t sessionId,
-        IPC::Connection::Identifier identifier,
-        WorkQueue *queue, PcFetcherProcess *process)
-    : m_sessionId(sessionId)
-    , m_req_id(0)
+PcFetcherRequest::PcFetcherRequest(Ref<PcFetcherConnection>&& connection,
+        PcFetcherProcess *process)
+    : m_req_id(0)
     , m_is_async(false)
-    , m_connection(IPC::Connection::createClientConnection(identifier, *this, queue))
-    , m_workQueue(queue)
+    , m_connection(WTFMove(connection))
     , m_fetcherProcess(process)
 {
     auto locker = holdLock(m_callbackLock);
     m_callback = pcfetcher_create_callback_info();
-    if (m_callback == NULL) {
-        return;
-    }
-
-    m_connection->open();
     m_runloop = &RunLoop::current();
 }
 
@@ -85,9 +78,10 @@ PcFetcherRequest::~PcFetcherRequest()
 
 void PcFetcherRequest::close()
 {
-    if (m_connection) {
-        m_connection->invalidate();
-        m_connection = nullptr;
+    /* the connection is shared and long-lived; only stop the routing */
+    if (m_req_id) {
+        m_connection->removeRequest(m_req_id);
+        m_req_id = 0;
     }
 }
 
@@ -109,33 +103,104 @@ static const char* transMethod(enum pcfetcher_request_method method)
     }
 }
 
-purc_variant_t PcFetcherRequest::requestAsync(
-        const char* base_uri,
-        const char* url,
-        enum pcfetcher_request_method method,
-        purc_variant_t params,
-        uint32_t timeout,
-        pcfetcher_response_handler handler,
-        void* ctxt,
-        pcfetcher_progress_tracker tracker,
-        void* tracker_ctxt)
+void PcFetcherStream::push(const uint8_t *data, size_t size)
 {
-    // TODO send params with http request
-    UNUSED_PARAM(params);
+    auto locker = holdLock(m_lock);
 
-    auto locker = holdLock(m_callbackLock);
-    m_callback->handler = handler;
-    m_callback->ctxt = ctxt;
-    m_callback->tracker = tracker;
-    m_callback->tracker_ctxt = tracker_ctxt;
-    m_is_async = true;
+    /* Hold the receiver back while the reader falls behind: the socket
+       of the connection then fills up and the fetcher process is no longer
+       drained. Give up waiting after the timeout to avoid a dead lock. */
+    m_condition.waitFor(m_lock, m_timeout, [this] {
+        return m_closed || m_queued < m_highWater;
+    });
 
+    if (m_closed) {
+        return;
+    }
+
+    Vector<uint8_t> chunk;
+    chunk.append(data, size);
+    m_chunks.append(WTFMove(chunk));
+    m_queued += size;
+    m_condition.notifyAll();
+}
+
+void PcFetcherStream::finish(bool failed)
+{
+    auto locker = holdLock(m_lock);
+    m_finished = true;
+    m_failed = failed;
+    m_condition.notifyAll();
+}
+
+ssize_t PcFetcherStream::read(void *buf, size_t count)
+{
+    auto locker = holdLock(m_lock);
+
+    if (!m_condition.waitFor(m_lock, m_timeout, [this] {
+                return !m_chunks.isEmpty() || m_finished;
+            })) {
+        purc_set_error(PURC_ERROR_TIMEOUT);
+        return -1;
+    }
+
+    if (m_chunks.isEmpty()) {
+        if (m_failed) {
+            purc_set_error(PURC_ERROR_REQUEST_FAILED);
+            return -1;
+        }
+        return 0;
+    }
+
+    size_t copied = 0;
+    while (copied < count && !m_chunks.isEmpty()) {
+        Vector<uint8_t>& chunk = m_chunks.first();
+        size_t n = std::min(count - copied, chunk.size() - m_offset);
+        memcpy((uint8_t *)buf + copied, chunk.data() + m_offset, n);
+        copied += n;
+        m_offset += n;
+        if (m_offset == chunk.size()) {
+            m_chunks.removeFirst();
+            m_offset = 0;
+        }
+    }
+
+    m_queued -= copied;
+    m_condition.notifyAll();
+    return copied;
+}
+
+void PcFetcherStream::close()
+{
+    auto locker = holdLock(m_lock);
+    m_closed = true;
+    m_chunks.clear();
+    m_queued = 0;
+    m_condition.notifyAll();
+}
+
+static ssize_t stream_read(void *ctxt, void *buf, size_t count)
+{
+    return static_cast<PcFetcherStream *>(ctxt)->read(buf, count);
+}
+
+static void stream_release(void *ctxt)
+{
+    PcFetcherStream *stream = static_cast<PcFetcherStream *>(ctxt);
+    stream->close();
+    stream->deref();
+}
+
+bool PcFetcherRequest::scheduleLoad(const char* base_uri, const char* url,
+        enum pcfetcher_request_method method, purc_variant_t params,
+        uint32_t timeout)
+{
     const char *encode_p = NULL;
     purc_variant_t encode_val = PURC_VARIANT_INVALID;
     if (params) {
         encode_val = pcutils_url_build_query(params, NULL, '&', 0);
         if (!encode_val) {
-            return NULL;
+            return false;
         }
 
         encode_p = purc_variant_get_string_const(encode_val);
@@ -178,10 +243,56 @@ purc_variant_t PcFetcherRequest::requestAsync(
     loadParameters.webPageID = PageIdentifier::generate();
     loadParameters.webFrameID = FrameIdentifier::generate();
     loadParameters.parentPID = getpid();
+    if (!m_stream) {
+        /* let the fetcher coalesce the chunks, so that a large body comes
+           in a few shared memory segments */
+        loadParameters.maximumBufferingTime =
+            Seconds::fromMilliseconds(PCFETCHER_MAX_BUFFERING_TIME_MS);
+    }
 
-    m_connection->send(
+    IPC::Connection *conn = connection();
+    if (!conn) {
+        /* the connection is closed; do not hand it out again */
+        m_fetcherProcess->dropConnection(m_connection.ptr());
+        purc_set_error(PURC_ERROR_REQUEST_FAILED);
+        return false;
+    }
+
+    m_connection->addRequest(m_req_id, this);
+    if (!conn->send(
             Messages::NetworkConnectionToWebProcess::ScheduleResourceLoad(
-                loadParameters), 0);
+                loadParameters), 0)) {
+        close();
+        m_fetcherProcess->dropConnection(m_connection.ptr());
+        purc_set_error(PURC_ERROR_REQUEST_FAILED);
+        return false;
+    }
+    return true;
+}
+
+purc_variant_t PcFetcherRequest::requestAsync(
+        const char* base_uri,
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        pcfetcher_response_handler handler,
+        void* ctxt,
+        pcfetcher_progress_tracker tracker,
+        void* tracker_ctxt)
+{
+    auto locker = holdLock(m_callbackLock);
+    m_callback->handler = handler;
+    m_callback->ctxt = ctxt;
+    m_callback->tracker = tracker;
+    m_callback->tracker_ctxt = tracker_ctxt;
+    m_is_async = true;
+
+    if (!scheduleLoad(base_uri, url, method, params, timeout)) {
+        locker.unlockEarly();
+        m_fetcherProcess->requestFinished(this);
+        return NULL;
+    }
 
     m_callback->req_id = purc_variant_make_native(this, NULL);
     return m_callback->req_id;
@@ -195,64 +306,13 @@ purc_rwstream_t PcFetcherRequest::requestSync(
         uint32_t timeout,
         struct pcfetcher_resp_header *resp_header)
 {
-    // TODO send params with http request
-    UNUSED_PARAM(params);
-
     m_is_async = false;
 
-    const char *encode_p = NULL;
-    purc_variant_t encode_val = PURC_VARIANT_INVALID;
-    if (params) {
-        encode_val = pcutils_url_build_query(params, NULL, '&', 0);
-        if (!encode_val) {
-            return NULL;
-        }
-
-        encode_p = purc_variant_get_string_const(encode_val);
-    }
-
-    URL tmp(URL(), url);
-
-    String uri;
-    if (base_uri && !tmp.isValid() &&
-            strncmp(url, base_uri, strlen(base_uri)) != 0) {
-        uri.append(base_uri);
-    }
-    uri.append(url);
-    std::unique_ptr<PurCWTF::URL> wurl = makeUnique<URL>(URL(), uri);
-
-
-    ResourceRequest request;
-    if (encode_p && encode_p[0]) {
-        if (method == PCFETCHER_REQUEST_METHOD_GET) {
-            wurl->setQuery(encode_p);
-        }
-        else {
-            request.setHTTPBody(FormData::create(encode_p, strlen(encode_p)));
-            request.setHTTPContentType("application/x-www-form-urlencoded");
-        }
-    }
-    request.setURL(*wurl);
-    request.setHTTPMethod(transMethod(method));
-    request.setTimeoutInterval(timeout);
-
-    if (encode_val) {
-        purc_variant_unref(encode_val);
+    if (!scheduleLoad(base_uri, url, method, params, timeout)) {
+        m_fetcherProcess->requestFinished(this);
+        return NULL;
     }
 
-    m_req_id = ProcessIdentifier::generate().toUInt64();
-    NetworkResourceLoadParameters loadParameters;
-    loadParameters.identifier = m_req_id;
-    loadParameters.request = request;
-    loadParameters.webPageProxyID = WebPageProxyIdentifier::generate();
-    loadParameters.webPageID = PageIdentifier::generate();
-    loadParameters.webFrameID = FrameIdentifier::generate();
-    loadParameters.parentPID = getpid();
-
-    m_connection->send(
-            Messages::NetworkConnectionToWebProcess::ScheduleResourceLoad(
-                loadParameters), 0);
-
     wait(timeout);
 
     purc_rwstream_t rws = NULL;
@@ -262,6 +322,7 @@ purc_rwstream_t PcFetcherRequest::requestSync(
             return NULL;
         }
 
+        adoptSharedBody();
         if (!m_callback->header.sz_resp && m_callback->rws) {
             size_t sz_content = 0;
             size_t sz_buffer = 0;
@@ -292,6 +353,67 @@ purc_rwstream_t PcFetcherRequest::requestSync(
     return rws;
 }
 
+purc_rwstream_t PcFetcherRequest::requestStream(
+        const char* base_uri,
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        struct pcfetcher_resp_header *resp_header)
+{
+    m_is_async = false;
+    m_stream = PcFetcherStream::create(PCFETCHER_STREAM_HIGH_WATER,
+            timeout ? Seconds(timeout) : Seconds::infinity());
+
+    if (!scheduleLoad(base_uri, url, method, params, timeout)) {
+        m_fetcherProcess->requestFinished(this);
+        return NULL;
+    }
+
+    /* woken up once the response header arrives */
+    wait(timeout);
+
+    purc_rwstream_t rws = NULL;
+    bool finished;
+    {
+        auto locker = holdLock(m_callbackLock);
+        if (resp_header) {
+            resp_header->ret_code = m_callback->header.ret_code;
+            if (m_callback->header.mime_type) {
+                resp_header->mime_type = strdup(m_callback->header.mime_type);
+            }
+            else {
+                resp_header->mime_type = NULL;
+            }
+            resp_header->sz_resp = m_callback->header.sz_resp;
+        }
+
+        if (m_responseReceived) {
+            m_stream->ref();
+            rws = pcrwstream_new_for_read_ex(m_stream.get(),
+                    stream_read, stream_release);
+            if (rws == NULL) {
+                m_stream->deref();
+            }
+        }
+
+        if (rws) {
+            m_streamDelivered = true;
+            finished = m_streamDone;
+        }
+        else {
+            m_stream->close();
+            finished = true;
+        }
+    }
+
+    /* otherwise, the request finishes with the load */
+    if (finished) {
+        m_fetcherProcess->requestFinished(this);
+    }
+    return rws;
+}
+
 void PcFetcherRequest::stop()
 {
     auto locker = holdLock(m_callbackLock);
@@ -343,15 +465,6 @@ void PcFetcherRequest::wakeUp(void)
     m_waitForSyncReplySemaphore.signal();
 }
 
-void PcFetcherRequest::didClose(IPC::Connection&)
-{
-}
-
-void PcFetcherRequest::didReceiveInvalidMessage(IPC::Connection&,
-        IPC::MessageName)
-{
-}
-
 void PcFetcherRequest::didReceiveMessage(IPC::Connection&,
         IPC::Decoder& decoder)
 {
@@ -365,6 +478,11 @@ void PcFetcherRequest::didReceiveMessage(IPC::Connection&,
                 decoder, this, &PcFetcherRequest::didReceiveSharedBuffer);
         return;
     }
+    if (decoder.messageName() == Messages::WebResourceLoader::DidReceiveSharedMemory::name()) {
+        IPC::handleMessage<Messages::WebResourceLoader::DidReceiveSharedMemory>(
+                decoder, this, &PcFetcherRequest::didReceiveSharedMemory);
+        return;
+    }
     if (decoder.messageName() == Messages::WebResourceLoader::DidFinishResourceLoad::name()) {
         IPC::handleMessage<Messages::WebResourceLoader::DidFinishResourceLoad>(
                 decoder, this, &PcFetcherRequest::didFinishResourceLoad);
@@ -382,14 +500,6 @@ void PcFetcherRequest::didReceiveMessage(IPC::Connection&,
     }
 }
 
-void PcFetcherRequest::didReceiveSyncMessage(IPC::Connection& connection,
-        IPC::Decoder& decoder, std::unique_ptr<IPC::Encoder>& replyEncoder)
-{
-    UNUSED_PARAM(connection);
-    UNUSED_PARAM(decoder);
-    UNUSED_PARAM(replyEncoder);
-}
-
 void PcFetcherRequest::didReceiveResponse(
         const PurCFetcher::ResourceResponse& response,
         bool needsContinueDidReceiveResponseMessage)
@@ -411,7 +521,16 @@ void PcFetcherRequest::didReceiveResponse(
     }
     const CString &utf8 = response.mimeType().utf8();
     m_callback->header.mime_type = strdup((const char*)utf8.data());
-    m_callback->header.sz_resp = response.expectedContentLength();
+    /* -1 for an unknown length; counted when the body is complete */
+    long long expectedLength = response.expectedContentLength();
+    m_callback->header.sz_resp = (expectedLength > 0) ? expectedLength : 0;
+    if (m_stream) {
+        /* the body will be pulled from the stream */
+        m_responseReceived = true;
+        wakeUp();
+        return;
+    }
+
     if (m_callback->rws) {
         purc_rwstream_destroy(m_callback->rws);
     }
@@ -422,7 +541,9 @@ void PcFetcherRequest::didReceiveResponse(
         m_estimatedLength = progressItemDefaultEstimatedLength;
     }
     else {
-        init = m_callback->header.sz_resp;
+        /* a large body will come in shared memory and need no buffer */
+        init = (m_callback->header.sz_resp >= PCFETCHER_SHARED_MEMORY_THRESHOLD)
+            ? DEF_RWS_SIZE : m_callback->header.sz_resp;
         m_estimatedLength = m_callback->header.sz_resp;
     }
     m_bytesReceived = 0;
@@ -441,18 +562,70 @@ void PcFetcherRequest::didReceiveSharedBuffer(
         IPC::SharedBufferDataReference&& data, int64_t encodedDataLength)
 {
     UNUSED_PARAM(encodedDataLength);
+    if (m_stream) {
+        /* no lock held: the stream may block for the backpressure */
+        m_stream->push((const uint8_t *)data.data(), data.size());
+        return;
+    }
+
     auto locker = holdLock(m_callbackLock);
     if (m_callback == NULL) {
         return;
     }
-    m_bytesReceived += data.size();
+
+    updateProgress(data.size());
+    writeBody(data.data(), data.size());
+}
+
+static void shared_body_release(void *ctxt)
+{
+    static_cast<SharedMemory *>(ctxt)->deref();
+}
+
+void PcFetcherRequest::didReceiveSharedMemory(SharedMemory::Handle&& handle,
+        uint64_t size, int64_t encodedDataLength)
+{
+    UNUSED_PARAM(encodedDataLength);
+    auto memory = SharedMemory::map(handle, SharedMemory::Protection::ReadOnly);
+    if (!memory || memory->size() < size) {
+        LOG_ERROR("Failed to map the shared memory of the body (%llu bytes)",
+                (unsigned long long)size);
+        return;
+    }
+
+    if (m_stream) {
+        m_stream->push((const uint8_t *)memory->data(), size);
+        return;
+    }
+
+    auto locker = holdLock(m_callbackLock);
+    if (m_callback == NULL) {
+        return;
+    }
+
+    updateProgress(size);
+    if (!m_sharedBody && m_callback->rws
+            && purc_rwstream_tell(m_callback->rws) == 0) {
+        /* keep the mapping; it may turn out to be the whole body */
+        m_sharedBody = WTFMove(memory);
+        m_sharedBodySize = size;
+        return;
+    }
+
+    writeBody(memory->data(), size);
+}
+
+/* called with m_callbackLock held */
+void PcFetcherRequest::updateProgress(size_t size)
+{
+    m_bytesReceived += size;
     if (m_bytesReceived > m_estimatedLength) {
         m_estimatedLength = m_bytesReceived * 2;
     }
     double increment, percentOfRemainingBytes;
     long long remainingBytes = m_estimatedLength - m_bytesReceived;
     if (remainingBytes > 0)  // Prevent divide by 0.
-         percentOfRemainingBytes = (double)data.size() / (double)remainingBytes;
+         percentOfRemainingBytes = (double)size / (double)remainingBytes;
     else
         percentOfRemainingBytes = 1.0;
 
@@ -467,8 +640,48 @@ void PcFetcherRequest::didReceiveSharedBuffer(
             }
         );
     }
+}
+
+/* called with m_callbackLock held */
+void PcFetcherRequest::writeBody(const void *data, size_t size)
+{
+    if (m_sharedBody) {
+        /* not the whole body; copy the kept segment first */
+        purc_rwstream_write(m_callback->rws, m_sharedBody->data(),
+                m_sharedBodySize);
+        m_sharedBody = nullptr;
+        m_sharedBodySize = 0;
+    }
+
+    purc_rwstream_write(m_callback->rws, data, size);
+}
+
+/* called with m_callbackLock held, when the body is complete */
+void PcFetcherRequest::adoptSharedBody()
+{
+    if (!m_sharedBody) {
+        return;
+    }
 
-    purc_rwstream_write(m_callback->rws, data.data(), data.size());
+    /* the whole body is in the shared memory: wrap the mapping in
+       a read-only rwstream without copying it */
+    SharedMemory *memory = m_sharedBody.get();
+    purc_rwstream_t rws = pcrwstream_new_from_mem_ex(memory->data(),
+            m_sharedBodySize, memory, shared_body_release);
+    if (rws == NULL) {
+        purc_rwstream_write(m_callback->rws, memory->data(), m_sharedBodySize);
+        m_sharedBody = nullptr;
+        m_sharedBodySize = 0;
+        return;
+    }
+
+    if (m_callback->rws) {
+        purc_rwstream_destroy(m_callback->rws);
+    }
+    m_callback->rws = rws;
+    /* the reference is owned by the rwstream now */
+    m_sharedBody.leakRef();
+    m_sharedBodySize = 0;
 }
 
 void PcFetcherRequest::didFinishResourceLoad(
@@ -481,6 +694,11 @@ void PcFetcherRequest::didFinishResourceLoad(
         return;
     }
 
+    if (m_stream) {
+        finishStream(false);
+        return;
+    }
+
     if (!m_is_async) {
         wakeUp();
         return;
@@ -497,6 +715,8 @@ void PcFetcherRequest::didFinishResourceLoad(
     if (!m_callback->handler) {
         return;
     }
+
+    adoptSharedBody();
     if (!m_callback->header.sz_resp && m_callback->rws) {
         size_t sz_content = 0;
         size_t sz_buffer = 0;
@@ -529,6 +749,11 @@ void PcFetcherRequest::didFailResourceLoad(const ResourceError& error)
     // TODO : trans error code
     m_callback->header.ret_code = 408;
 
+    if (m_stream) {
+        finishStream(true);
+        return;
+    }
+
     if (!m_is_async) {
         wakeUp();
         return;
@@ -538,6 +763,7 @@ void PcFetcherRequest::didFailResourceLoad(const ResourceError& error)
         return;
     }
 
+    adoptSharedBody();
     if (!m_callback->header.sz_resp && m_callback->rws) {
         size_t sz_content = 0;
         size_t sz_buffer = 0;
@@ -560,6 +786,24 @@ void PcFetcherRequest::didFailResourceLoad(const ResourceError& error)
         );
 }
 
+/* called with m_callbackLock held */
+void PcFetcherRequest::finishStream(bool failed)
+{
+    m_stream->finish(failed);
+    m_streamDone = true;
+
+    if (!m_streamDelivered) {
+        /* requestStream() is still waiting, and will finish the request */
+        wakeUp();
+        return;
+    }
+
+    m_runloop->dispatch([request=this] {
+            request->m_fetcherProcess->requestFinished(request);
+            }
+        );
+}
+
 void PcFetcherRequest::willSendRequest(ResourceRequest&& proposedRequest,
         IPC::FormDataReference&& proposedRequestBody,
         ResourceResponse&& redirectResponse)
@@ -567,7 +811,11 @@ void PcFetcherRequest::willSendRequest(ResourceRequest&& proposedRequest,
     UNUSED_PARAM(proposedRequestBody);
     UNUSED_PARAM(redirectResponse);
     proposedRequest.setHTTPBody(proposedRequestBody.takeData());
-    m_connection->send(
+    IPC::Connection *conn = connection();
+    if (!conn) {
+        return;
+    }
+    conn->send(
             Messages::NetworkResourceLoader::ContinueWillSendRequest(
                 proposedRequest, true), m_req_id);
 }
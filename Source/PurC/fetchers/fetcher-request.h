@@ -29,14 +29,18 @@
 
 #include "fetcher-internal.h"
 #include "fetcher-messages-basic.h"
+#include "fetcher-connection.h"
 
 #include "WebCoreArgumentCoders.h"
 #include "SharedBufferDataReference.h"
+#include "SharedMemory.h"
 #include "Connection.h"
 #include "MessageReceiverMap.h"
 #include "ProcessLauncher.h"
 #include "FormDataReference.h"
 
+#include <wtf/Condition.h>
+#include <wtf/Deque.h>
 #include <wtf/ProcessID.h>
 #include <wtf/SystemTracing.h>
 #include <wtf/ThreadSafeRefCounted.h>
@@ -44,21 +48,60 @@
 
 using namespace PurCFetcher;
 
+/* A bounded queue of the chunks of a response body: the fetcher pushes the
+   chunks while receiving them, and the interpreter pulls them through
+   a read-only rwstream. */
+class PcFetcherStream : public ThreadSafeRefCounted<PcFetcherStream> {
+    WTF_MAKE_NONCOPYABLE(PcFetcherStream);
+
+public:
+    static Ref<PcFetcherStream> create(size_t highWater, Seconds timeout)
+    {
+        return adoptRef(*new PcFetcherStream(highWater, timeout));
+    }
+
+    /* blocks while more than `highWater` bytes are queued */
+    void push(const uint8_t *data, size_t size);
+    void finish(bool failed);
+
+    /* blocks until some data arrive; returns 0 at the end of the body */
+    ssize_t read(void *buf, size_t count);
+
+    /* called when the reader goes away */
+    void close();
+
+private:
+    PcFetcherStream(size_t highWater, Seconds timeout)
+        : m_highWater(highWater)
+        , m_timeout(timeout)
+    {
+    }
+
+    Lock m_lock;
+    Condition m_condition;
+    Deque<Vector<uint8_t>> m_chunks;
+    size_t m_offset { 0 };
+    size_t m_queued { 0 };
+    size_t m_highWater;
+    Seconds m_timeout;
+    bool m_finished { false };
+    bool m_failed { false };
+    bool m_closed { false };
+};
+
 class PcFetcherProcess;
-class PcFetcherRequest : public IPC::Connection::Client {
+class PcFetcherRequest {
     WTF_MAKE_NONCOPYABLE(PcFetcherRequest);
 
 public:
-    PcFetcherRequest(uint64_t sessionId,
-            IPC::Connection::Identifier connectionIdentifier, WorkQueue *queue,
+    PcFetcherRequest(Ref<PcFetcherConnection>&& connection,
             PcFetcherProcess *process);
 
     ~PcFetcherRequest();
 
     IPC::Connection* connection() const
     {
-        ASSERT(m_connection);
-        return m_connection.get();
+        return m_connection->connection();
     }
 
     void close();
@@ -82,6 +125,14 @@ public:
         uint32_t timeout,
         struct pcfetcher_resp_header *resp_header);
 
+    purc_rwstream_t requestStream(
+        const char* base_uri,
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        struct pcfetcher_resp_header *resp_header);
+
     void stop();
     void cancel();
     purc_variant_t getRequestId()
@@ -95,36 +146,36 @@ public:
     RunLoop *getRunLoop() { return m_runloop; }
 
 protected:
-    bool dispatchMessage(IPC::Connection&, IPC::Decoder&);
-    bool dispatchSyncMessage(IPC::Connection&, IPC::Decoder&,
-            std::unique_ptr<IPC::Encoder>&);
-
-    void didClose(IPC::Connection&);
-    void didReceiveInvalidMessage(IPC::Connection&, IPC::MessageName);
-    const char* connectionName(void) { return "PcFetcherRequest"; }
+    friend class PcFetcherConnection;
 
     void didReceiveMessage(IPC::Connection&, IPC::Decoder&);
-    void didReceiveSyncMessage(IPC::Connection&, IPC::Decoder&,
-            std::unique_ptr<IPC::Encoder>&);
 
     void didReceiveResponse(const PurCFetcher::ResourceResponse&, bool);
     void didReceiveSharedBuffer(IPC::SharedBufferDataReference&&,
             int64_t encodedDataLength);
+    void didReceiveSharedMemory(SharedMemory::Handle&&, uint64_t size,
+            int64_t encodedDataLength);
     void didFinishResourceLoad(const PurCFetcher::NetworkLoadMetrics&);
     void didFailResourceLoad(const ResourceError& error);
     void willSendRequest(ResourceRequest&&,
             IPC::FormDataReference&& requestBody, ResourceResponse&&);
 
 private:
-    uint64_t m_sessionId;
+    bool scheduleLoad(const char* base_uri, const char* url,
+            enum pcfetcher_request_method method, purc_variant_t params,
+            uint32_t timeout);
+    void finishStream(bool failed);
+    void updateProgress(size_t size);
+    void writeBody(const void *data, size_t size);
+    void adoptSharedBody();
+
     uint64_t m_req_id;
     bool m_is_async;
 
-    RefPtr<IPC::Connection> m_connection;
+    Ref<PcFetcherConnection> m_connection;
     BinarySemaphore m_waitForSyncReplySemaphore;
 
     RunLoop* m_runloop;
-    WorkQueue* m_workQueue;
 
     Lock m_callbackLock;
     struct pcfetcher_callback_info *m_callback;
@@ -135,6 +186,16 @@ private:
     long long m_bytesReceived {0};
     double m_progressValue;
 
+    /* for the request of which the body is streamed */
+    RefPtr<PcFetcherStream> m_stream;
+    bool m_responseReceived { false };
+    bool m_streamDelivered { false };
+    bool m_streamDone { false };
+
+    /* the body received in a shared memory, not copied yet */
+    RefPtr<SharedMemory> m_sharedBody;
+    size_t m_sharedBodySize { 0 };
+
 };
 
 
@@ -26,6 +26,7 @@
 
 #include "private/fetcher.h"
 #include "private/instance.h"
+#include "private/stats.h"
 
 #include "fetcher-internal.h"
 
@@ -91,8 +92,15 @@ purc_variant_t pcfetcher_request_async(
         void* tracker_ctxt)
 {
     struct pcfetcher* fetcher = get_fetcher();
-    return fetcher ? fetcher->request_async(fetcher, url, method,
-            params, timeout, handler, ctxt, tracker, tracker_ctxt) : PURC_VARIANT_INVALID;
+    if (fetcher == NULL) {
+        return PURC_VARIANT_INVALID;
+    }
+
+#if ENABLE(RUNTIME_STATS)
+    pcinst_stats_add(pcinst_current(), PCINST_STATS_FETCHER_ASYNC, 1);
+#endif
+    return fetcher->request_async(fetcher, url, method,
+            params, timeout, handler, ctxt, tracker, tracker_ctxt);
 }
 
 purc_rwstream_t pcfetcher_request_sync(
@@ -103,8 +111,52 @@ purc_rwstream_t pcfetcher_request_sync(
         struct pcfetcher_resp_header *resp_header)
 {
     struct pcfetcher* fetcher = get_fetcher();
-    return fetcher ? fetcher->request_sync(fetcher, url, method,
-            params, timeout, resp_header) : NULL;
+    if (fetcher == NULL) {
+        return NULL;
+    }
+
+#if ENABLE(RUNTIME_STATS)
+    uint64_t begin = pcinst_stats_now_ns();
+#endif
+    purc_rwstream_t resp = fetcher->request_sync(fetcher, url, method,
+            params, timeout, resp_header);
+#if ENABLE(RUNTIME_STATS)
+    pcinst_stats_record(pcinst_current(), PCINST_STATS_FETCHER_SYNC,
+            pcinst_stats_now_ns() - begin);
+#endif
+    return resp;
+}
+
+purc_rwstream_t pcfetcher_request_stream(
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        struct pcfetcher_resp_header *resp_header)
+{
+    struct pcfetcher* fetcher = get_fetcher();
+    if (fetcher == NULL) {
+        return NULL;
+    }
+
+#if ENABLE(RUNTIME_STATS)
+    uint64_t begin = pcinst_stats_now_ns();
+#endif
+    purc_rwstream_t resp;
+    if (fetcher->request_stream) {
+        resp = fetcher->request_stream(fetcher, url, method,
+                params, timeout, resp_header);
+    }
+    else {
+        resp = fetcher->request_sync(fetcher, url, method,
+                params, timeout, resp_header);
+    }
+#if ENABLE(RUNTIME_STATS)
+    /* the time to get the response header for a streamed response */
+    pcinst_stats_record(pcinst_current(), PCINST_STATS_FETCHER_SYNC,
+            pcinst_stats_now_ns() - begin);
+#endif
+    return resp;
 }
 
 
@@ -3723,6 +3723,8 @@ const char* description(MessageName name)
         return "WebResourceLoader::DidReceiveData";
     case MessageName::WebResourceLoader_DidReceiveSharedBuffer:
         return "WebResourceLoader::DidReceiveSharedBuffer";
+    case MessageName::WebResourceLoader_DidReceiveSharedMemory:
+        return "WebResourceLoader::DidReceiveSharedMemory";
     case MessageName::WebResourceLoader_DidFinishResourceLoad:
         return "WebResourceLoader::DidFinishResourceLoad";
     case MessageName::WebResourceLoader_DidFailResourceLoad:
@@ -7330,6 +7332,7 @@ ReceiverName receiverName(MessageName messageName)
     case MessageName::WebResourceLoader_DidReceiveResponse:
     case MessageName::WebResourceLoader_DidReceiveData:
     case MessageName::WebResourceLoader_DidReceiveSharedBuffer:
+    case MessageName::WebResourceLoader_DidReceiveSharedMemory:
     case MessageName::WebResourceLoader_DidFinishResourceLoad:
     case MessageName::WebResourceLoader_DidFailResourceLoad:
     case MessageName::WebResourceLoader_DidFailServiceWorkerLoad:
@@ -12376,6 +12379,8 @@ bool isValidMessageName(MessageName messageName)
         return true;
     if (messageName == IPC::MessageName::WebResourceLoader_DidReceiveSharedBuffer)
         return true;
+    if (messageName == IPC::MessageName::WebResourceLoader_DidReceiveSharedMemory)
+        return true;
     if (messageName == IPC::MessageName::WebResourceLoader_DidFinishResourceLoad)
         return true;
     if (messageName == IPC::MessageName::WebResourceLoader_DidFailResourceLoad)
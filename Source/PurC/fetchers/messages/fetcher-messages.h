@@ -31,6 +31,7 @@
 #include "Attachment.h"
 #include "Connection.h"
 #include "MessageNames.h"
+#include "SharedMemory.h"
 
 #include <wtf/Optional.h>
 #include <wtf/Forward.h>
@@ -305,6 +306,27 @@ private:
     Arguments m_arguments;
 };
 
+class DidReceiveSharedMemory {
+public:
+    using Arguments = std::tuple<const PurCFetcher::SharedMemory::Handle&, uint64_t, int64_t>;
+
+    static IPC::MessageName name() { return IPC::MessageName::WebResourceLoader_DidReceiveSharedMemory; }
+    static const bool isSync = false;
+
+    DidReceiveSharedMemory(const PurCFetcher::SharedMemory::Handle& handle, uint64_t size, int64_t encodedDataLength)
+        : m_arguments(handle, size, encodedDataLength)
+    {
+    }
+
+    const Arguments& arguments() const
+    {
+        return m_arguments;
+    }
+
+private:
+    Arguments m_arguments;
+};
+
 class DidFinishResourceLoad {
 public:
     using Arguments = std::tuple<const PurCFetcher::NetworkLoadMetrics&>;
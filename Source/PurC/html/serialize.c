@@ -43,6 +43,10 @@
 #define PCHTML_TOKENIZER_CHARS_MAP
 #include "str_res.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define html_serialize_send(data, len, ctx)                                 \
     do {                                                                    \
         status = cb((const unsigned char *) data, len, ctx);                \
@@ -291,6 +295,85 @@ html_escape_unichar_no_quotes(uint32_t uc,
     return status;
 }
 
+/*
+ * Flags of the bytes which may start a character needing special handling
+ * when sending an escaped string: NUL and `&<>`, the lead bytes of the
+ * multibyte characters having entities (U+00A0 and U+200B-U+2063), and
+ * optionally the quotes and the C0 control characters. All other bytes
+ * are copied as is, so the scanner below only has to find these.
+ */
+#define HTML_SCAN_QUOTES        0x01
+#define HTML_SCAN_C0CTRLS       0x02
+
+static inline bool
+html_is_special_byte(unsigned char c, unsigned flags)
+{
+    switch (c) {
+    case 0x00:
+    case '&':
+    case '<':
+    case '>':
+    case 0xC2:
+    case 0xE2:
+        return true;
+
+    case '"':
+    case '\'':
+        return (flags & HTML_SCAN_QUOTES);
+
+    default:
+        return (c < 0x20 && (flags & HTML_SCAN_C0CTRLS));
+    }
+}
+
+/* Returns the first byte in [data, end) which may need special handling. */
+static const unsigned char *
+html_scan_special_byte(const unsigned char *data, const unsigned char *end,
+        unsigned flags)
+{
+#if defined(__SSE2__)
+    const __m128i v_amp = _mm_set1_epi8('&');
+    const __m128i v_lt = _mm_set1_epi8('<');
+    const __m128i v_gt = _mm_set1_epi8('>');
+    const __m128i v_c2 = _mm_set1_epi8((char)0xC2);
+    const __m128i v_e2 = _mm_set1_epi8((char)0xE2);
+    const __m128i v_dq = _mm_set1_epi8('"');
+    const __m128i v_sq = _mm_set1_epi8('\'');
+    const __m128i v_us = _mm_set1_epi8(0x1F);
+    const __m128i v_nul = _mm_setzero_si128();
+
+    while (end - data >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)data);
+        __m128i m = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, v_amp), _mm_cmpeq_epi8(v, v_lt)),
+                _mm_or_si128(_mm_cmpeq_epi8(v, v_gt), _mm_cmpeq_epi8(v, v_nul)));
+        m = _mm_or_si128(m,
+                _mm_or_si128(_mm_cmpeq_epi8(v, v_c2), _mm_cmpeq_epi8(v, v_e2)));
+        if (flags & HTML_SCAN_QUOTES) {
+            m = _mm_or_si128(m,
+                _mm_or_si128(_mm_cmpeq_epi8(v, v_dq), _mm_cmpeq_epi8(v, v_sq)));
+        }
+        if (flags & HTML_SCAN_C0CTRLS) {
+            /* v <= 0x1F (unsigned) iff max(v, 0x1F) == 0x1F */
+            m = _mm_or_si128(m,
+                _mm_cmpeq_epi8(_mm_max_epu8(v, v_us), v_us));
+        }
+
+        int mask = _mm_movemask_epi8(m);
+        if (mask) {
+            return data + __builtin_ctz(mask);
+        }
+        data += 16;
+    }
+#endif
+
+    while (data < end && !html_is_special_byte(*data, flags)) {
+        data++;
+    }
+
+    return data;
+}
+
 unsigned int
 pchtml_html_serialize_cb(pcdom_node_t *node,
                       pchtml_html_serialize_cb_f cb, void *ctx)
@@ -725,7 +808,16 @@ html_serialize_send_escaping_attribute_string(
     unsigned int status;
 
     const unsigned char *end = data + len;
-    while (data != end) {
+    while (data < end) {
+        const unsigned char *stop = html_scan_special_byte(data, end,
+                HTML_SCAN_QUOTES);
+        if (stop > data) {
+            html_serialize_send(data, (stop - data), ctx);
+            data = stop;
+            if (data == end)
+                break;
+        }
+
         const unsigned char *next =
             (const unsigned char *)pcutils_utf8_next_char(data);
         uint32_t uc = pcutils_utf8_to_unichar(data);
@@ -750,7 +842,15 @@ html_serialize_send_escaping_string(const unsigned char *data,
 
     const unsigned char *end = data + len;
 
-    while (data != end) {
+    while (data < end) {
+        const unsigned char *stop = html_scan_special_byte(data, end, 0);
+        if (stop > data) {
+            html_serialize_send(data, (stop - data), ctx);
+            data = stop;
+            if (data == end)
+                break;
+        }
+
         const unsigned char *next =
             (const unsigned char *)pcutils_utf8_next_char(data);
         uint32_t uc = pcutils_utf8_to_unichar(data);
@@ -1531,7 +1631,16 @@ html_serialize_pretty_send_escaping_string(
         html_serialize_send_indent(indent, ctx);
     }
 
-    while (data != end) {
+    while (data < end) {
+        const unsigned char *stop = html_scan_special_byte(data, end,
+                HTML_SCAN_C0CTRLS);
+        if (stop > data) {
+            html_serialize_send(data, (stop - data), ctx);
+            data = stop;
+            if (data == end)
+                break;
+        }
+
         const unsigned char *next =
             (const unsigned char *)pcutils_utf8_next_char(data);
         uint32_t uc = pcutils_utf8_to_unichar(data);
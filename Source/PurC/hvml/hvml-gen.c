@@ -334,6 +334,7 @@ create_element(struct pcvdom_gen *gen, struct pchvml_token *token)
         goto end;
 
     elem->self_closing = pchvml_token_is_self_closing(token);
+    pchvml_token_get_position(token, &elem->line, &elem->column);
     return elem;
 
 end:
@@ -78,6 +78,10 @@ struct pchvml_token {
     struct tkz_buffer* system_information;
 
     struct pchvml_token_attr* curr_attr;
+
+    /* the position of the token in the source; 0 if unknown */
+    int line;
+    int column;
 };
 
 struct pchvml_token_attr* pchvml_token_attr_new()
@@ -381,6 +385,20 @@ void pchvml_token_set_self_closing(struct pchvml_token* token, bool b)
     token->self_closing = b;
 }
 
+void pchvml_token_set_position(struct pchvml_token* token,
+        int line, int column)
+{
+    token->line = line;
+    token->column = column;
+}
+
+void pchvml_token_get_position(struct pchvml_token* token,
+        int *line, int *column)
+{
+    *line = token->line;
+    *column = token->column;
+}
+
 bool pchvml_token_is_self_closing(struct pchvml_token* token)
 {
     return token->self_closing;
@@ -125,6 +125,12 @@ void pchvml_token_set_self_closing(struct pchvml_token* token, bool b);
 
 bool pchvml_token_is_self_closing(struct pchvml_token* token);
 
+void pchvml_token_set_position(struct pchvml_token* token,
+        int line, int column);
+
+void pchvml_token_get_position(struct pchvml_token* token,
+        int *line, int *column);
+
 void pchvml_token_set_force_quirks(struct pchvml_token* token, bool b);
 
 bool pchvml_token_is_force_quirks(struct pchvml_token* token);
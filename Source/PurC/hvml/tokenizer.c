@@ -689,6 +689,9 @@ BEGIN_STATE(TKZ_STATE_TAG_OPEN)
     }
     if (is_ascii_alpha(character)) {
         parser->token = pchvml_token_new_start_tag ();
+        /* the position of `<` */
+        pchvml_token_set_position(parser->token, parser->curr_uc->line,
+                parser->curr_uc->column - 1);
         RECONSUME_IN(TKZ_STATE_TAG_NAME);
     }
     if (character == '?') {
@@ -0,0 +1,72 @@
+/*
+ * @file cpu.h
+ * @date 2026/10/19
+ * @brief The detection of the optional instruction sets of the processor
+ *      for the accelerated kernels.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PURC_PRIVATE_CPU_H
+#define PURC_PRIVATE_CPU_H
+
+#include "config.h"
+#include "purc-macros.h"
+
+#include <stdbool.h>
+
+/* The kernels for x86-64 are compiled with the target attributes and
+   selected at runtime, so that the library still runs on the processors
+   without the instruction sets. */
+#if CPU(X86_64) && COMPILER(GCC_COMPATIBLE)
+#define PCUTILS_X86_SIMD        1
+#define PCUTILS_TARGET(isa)     __attribute__((target(isa)))
+#else
+#define PCUTILS_X86_SIMD        0
+#define PCUTILS_TARGET(isa)
+#endif
+
+enum {
+    PCUTILS_CPU_SSSE3   = 0x0001,
+    PCUTILS_CPU_SSE41   = 0x0002,
+    PCUTILS_CPU_SSE42   = 0x0004,
+    PCUTILS_CPU_PCLMUL  = 0x0008,
+    PCUTILS_CPU_AVX2    = 0x0010,
+    PCUTILS_CPU_SHA     = 0x0020,
+};
+
+PCA_EXTERN_C_BEGIN
+
+/* Returns the instruction sets available, as a bitwise OR of the flags
+   above; always zero on the processors other than x86-64. */
+unsigned pcutils_cpu_features(void) WTF_INTERNAL;
+
+/* Disables the given instruction sets instead of the ones disabled by the
+   last call (zero enables all), for testing the fallbacks; returns the
+   features available before the call. */
+unsigned pcutils_cpu_disable_features(unsigned features);
+
+static inline bool pcutils_cpu_has(unsigned features)
+{
+    return (pcutils_cpu_features() & features) == features;
+}
+
+PCA_EXTERN_C_END
+
+#endif /* not defined PURC_PRIVATE_CPU_H */
+
@@ -231,6 +231,11 @@ pcdvobjs_elements_by_css(purc_document_t doc, const char *css);
 pcdoc_element_t
 pcdvobjs_get_element_from_elements(purc_variant_t elems, size_t idx);
 
+/* return the stream for read if v is a stream entity of $STREAM,
+   otherwise NULL */
+purc_rwstream_t
+pcdvobjs_stream_get_reader(purc_variant_t v);
+
 /* return the number of left characters cannot be decoded */
 size_t pcdvobj_url_decode_in_place(char *string, size_t length, int rfc);
 
@@ -93,6 +93,20 @@ purc_rwstream_t pcfetcher_request_sync(
         uint32_t timeout,
         struct pcfetcher_resp_header *resp_header);
 
+/*
+ * Like pcfetcher_request_sync(), but returns as soon as the response header
+ * arrives. The body is pulled from the returned read-only stream while it
+ * is being received: a read blocks until more data arrives, and returns 0
+ * at the end of the body. The fetchers which cannot stream the body fall
+ * back to pcfetcher_request_sync().
+ */
+purc_rwstream_t pcfetcher_request_stream(
+        const char* url,
+        enum pcfetcher_request_method method,
+        purc_variant_t params,
+        uint32_t timeout,
+        struct pcfetcher_resp_header *resp_header);
+
 void pcfetcher_cancel_async(purc_variant_t request);
 
 int pcfetcher_check_response(uint32_t timeout_ms);
@@ -103,6 +103,12 @@ struct pcinst {
     struct pcintr_heap     *intr_heap;
     purc_runloop_t          running_loop;
 
+    /* the runtime performance counters; NULL if disabled */
+    struct pcinst_stats    *stats;
+
+    /* the dynamic values found by the constant keys; created on demand */
+    struct pcvcm_method_cache *vcm_method_cache;
+
     /* FIXME: enable the fields ONLY when NDEBUG is undefined */
     struct pcdebug_backtrace  *bt;
 };
@@ -133,10 +133,15 @@ struct pcintr_heap {
 
     purc_atom_t         move_buff;
     pcintr_timer_t     *event_timer;    // 10ms
+    pcintr_timer_wheel_t timer_wheel;   // for $TIMERS
 
     purc_cond_handler   cond_handler;
     unsigned int        keep_alive:1;
     double              timestamp;
+
+    struct pcintr_profiler *profiler;   // NULL if never started
+    struct pcrun_worker    *worker;     // NULL if not a pool worker
+    size_t              nr_arrived_crtns;   // created since the last report
 };
 
 struct pcintr_stack_frame;
@@ -354,6 +359,11 @@ struct pcintr_coroutine {
     unsigned long               run_idx;
     time_t                      stopped_timeout;
 
+    /* the runtime statistics; the CPU time is in nanoseconds */
+    uint64_t                    cpu_time;
+    uint64_t                    nr_steps;
+    uint64_t                    nr_slices;
+
     uint32_t                    is_main:1;
 };
 
@@ -817,6 +827,14 @@ pcintr_is_variable_token(const char *str);
 pcrdr_msg_data_type
 pcintr_rdr_retrieve_data_type(const char *type_name);
 
+/* Serializes the document and loads it into the page of the renderer by
+   `load`, or by `writeBegin`, `writeMore`, and `writeEnd` if the contents
+   do not fit in one chunk. Returns the response of the last request. */
+pcrdr_msg *
+pcintr_rdr_load_page_contents(struct pcrdr_conn *conn,
+        pcrdr_msg_target target, uint64_t target_value,
+        pcrdr_msg_data_type data_type, purc_document_t doc, unsigned opts);
+
 
 /* return true to ignore eval */
 typedef bool (before_eval_attr_fn)(pcintr_stack_t stack,
@@ -53,6 +53,8 @@ struct pcinst_msg_queue {
 
     uint64_t            state;
     size_t              nr_msgs;
+    /* the maximal number of the messages ever queued */
+    size_t              max_nr_msgs;
 };
 
 /* Make sure the size of `struct list_head` is two times of sizeof(void *) */
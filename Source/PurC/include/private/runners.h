@@ -54,9 +54,11 @@ enum {
 #define PCRUN_OPERATION_resumeCoroutine     "resumeCoroutine"
     PCRUN_K_OPERATION_shutdownInstance,
 #define PCRUN_OPERATION_shutdownInstance    "shutdownInstance"
+    PCRUN_K_OPERATION_prewarmInstances,
+#define PCRUN_OPERATION_prewarmInstances    "prewarmInstances"
 
     /* XXX: change this when you append a new operation */
-    PCRUN_K_OPERATION_LAST = PCRUN_K_OPERATION_shutdownInstance,
+    PCRUN_K_OPERATION_LAST = PCRUN_K_OPERATION_prewarmInstances,
 };
 
 #define PCRUN_NR_OPERATIONS \
@@ -64,10 +66,26 @@ enum {
 
 #define PCRUN_EVENT_inst_stopped            "inst:stopped"
 
+/* the runners of the worker pool are named `_worker0`, `_worker1`, ... */
+#define PCRUN_WORKER_NAME_PREFIX    "_worker"
+#define PCRUN_MAX_WORKERS           256
+
+struct pcrun_worker;
+
+#define PCRUN_MAX_SPARES            64
+
 struct instmgr_info {
     purc_atom_t     rid_main;
     unsigned        nr_insts;
     struct sorted_array *sa_insts;
+
+    /* the pre-warmed instances, which are not counted in nr_insts
+       until they are handed out */
+    char           *spare_app;
+    purc_variant_t  spare_params;
+    size_t          nr_spares_wanted;
+    unsigned        spare_serial;
+    struct sorted_array *sa_spares;
 };
 
 PCA_EXTERN_C_BEGIN
@@ -89,6 +107,32 @@ pcrun_instmgr_handle_message(void *ctxt) WTF_INTERNAL;
 void
 pcrun_notify_instmgr(const char* event, purc_atom_t inst_crtn_id) WTF_INTERNAL;
 
+/* Asks the pre-warmed instances to shut down and forgets them. */
+void
+pcrun_instmgr_drop_spares(struct instmgr_info *info) WTF_INTERNAL;
+
+/* Returns the slot of the worker pool if the instance is a worker. */
+struct pcrun_worker *
+pcrun_worker_attach(const char *app_name, const char *runner_name) WTF_INTERNAL;
+
+/* Called by a worker after every scheduling round; nr_arrived is the number
+   of the coroutines created on the worker since the last call. */
+void
+pcrun_worker_set_load(struct pcrun_worker *worker, size_t nr_ready,
+        size_t nr_arrived) WTF_INTERNAL;
+
+/* Forgets the worker pool if it was created by the instance owner; called
+   when the instance is cleaned up. The worker runners are left running;
+   their lifetime is up to the app, see purc_inst_create_workers(). */
+void
+pcrun_workers_reset(purc_atom_t owner) WTF_INTERNAL;
+
+/* Picks the least loaded worker of the app for a new coroutine; returns its
+   rid and copies its runner name to the buffer, or returns 0 if the app
+   has no worker pool. */
+purc_atom_t
+pcrun_workers_pick(const char *app_name, char *runner_name, size_t sz);
+
 PCA_EXTERN_C_END
 
 #endif /* not defined PURC_PRIVATE_RUNNERS_H */
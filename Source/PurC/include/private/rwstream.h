@@ -25,5 +25,26 @@
 #ifndef PURC_PRIVATE_RWSTREAM_H
 #define PURC_PRIVATE_RWSTREAM_H
 
+#include "purc-rwstream.h"
+
+typedef void (*pcrws_cb_release)(void *ctxt);
+
+PCA_EXTERN_C_BEGIN
+
+/* Creates a read-only rwstream like purc_rwstream_new_for_read() does;
+   `release` (nullable) is called with `ctxt` when the stream is destroyed. */
+purc_rwstream_t
+pcrwstream_new_for_read_ex(void *ctxt, pcrws_cb_read fn,
+        pcrws_cb_release release);
+
+/* Creates a read-only rwstream on the memory which is not owned by
+   the stream; `release` (nullable) is called with `ctxt` when the stream
+   is destroyed. */
+purc_rwstream_t
+pcrwstream_new_from_mem_ex(const void *mem, size_t sz, void *ctxt,
+        pcrws_cb_release release);
+
+PCA_EXTERN_C_END
+
 #endif /* not defined PURC_PRIVATE_RWSTREAM_H */
 
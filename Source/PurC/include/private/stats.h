@@ -0,0 +1,144 @@
+/*
+ * @file stats.h
+ * @date 2026/10/19
+ * @brief The runtime performance counters of an instance.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PURC_PRIVATE_STATS_H
+#define PURC_PRIVATE_STATS_H
+
+#include "purc.h"
+
+#include "config.h"
+
+#include <stdint.h>
+#include <time.h>
+
+/* The number of the buckets of a histogram; the bucket `i` counts the
+   durations in [2^i, 2^(i+1)) nanoseconds, and the last one counts all
+   durations longer than about two seconds. */
+#define PCINST_STATS_NR_BUCKETS     32
+
+enum pcinst_stats_counter {
+    /* the rounds of the scheduler */
+    PCINST_STATS_SCHED_ROUNDS = 0,
+    /* the steps executed for the coroutines */
+    PCINST_STATS_SCHED_STEPS,
+    /* the time slices given to the coroutines */
+    PCINST_STATS_SCHED_SLICES,
+    /* the time slices ended because the time was used up */
+    PCINST_STATS_SCHED_PREEMPTIONS,
+    /* the sleeps of the scheduler because nothing to do */
+    PCINST_STATS_SCHED_IDLE_SLEEPS,
+    /* the messages dispatched to the coroutines */
+    PCINST_STATS_MSGS_DISPATCHED,
+    /* the asynchronous requests to the fetcher */
+    PCINST_STATS_FETCHER_ASYNC,
+
+    PCINST_STATS_NR_COUNTERS,
+};
+
+enum pcinst_stats_timer {
+    /* the time an event waited in the message queue */
+    PCINST_STATS_MSG_LATENCY = 0,
+    /* the time to evaluate a VCM tree */
+    PCINST_STATS_VCM_EVAL,
+    /* the time of a synchronous request to the fetcher */
+    PCINST_STATS_FETCHER_SYNC,
+    /* the time of a round trip to the renderer */
+    PCINST_STATS_RDR_REQUEST,
+
+    PCINST_STATS_NR_TIMERS,
+};
+
+struct pcinst;
+struct pcinst_stats;
+
+PCA_EXTERN_C_BEGIN
+
+#if ENABLE(RUNTIME_STATS)
+
+struct pcinst_stats *pcinst_stats_new(void) WTF_INTERNAL;
+void pcinst_stats_delete(struct pcinst_stats *stats) WTF_INTERNAL;
+
+/* Adds to a counter of the instance; nothing if inst is NULL. */
+void pcinst_stats_add(struct pcinst *inst,
+        enum pcinst_stats_counter id, uint64_t n) WTF_INTERNAL;
+
+/* Records a duration in nanoseconds to a histogram of the instance. */
+void pcinst_stats_record(struct pcinst *inst,
+        enum pcinst_stats_timer id, uint64_t ns) WTF_INTERNAL;
+
+/* Makes an object variant of the statistics of the instance. */
+purc_variant_t pcinst_stats_snapshot(struct pcinst *inst) WTF_INTERNAL;
+
+static inline uint64_t
+pcinst_stats_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The CPU time of the calling thread, i.e., the instance. */
+static inline uint64_t
+pcinst_stats_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+#else   /* ENABLE(RUNTIME_STATS) */
+
+static inline struct pcinst_stats *pcinst_stats_new(void) { return NULL; }
+static inline void pcinst_stats_delete(struct pcinst_stats *stats)
+{
+    (void)stats;
+}
+
+static inline void pcinst_stats_add(struct pcinst *inst,
+        enum pcinst_stats_counter id, uint64_t n)
+{
+    (void)inst; (void)id; (void)n;
+}
+
+static inline void pcinst_stats_record(struct pcinst *inst,
+        enum pcinst_stats_timer id, uint64_t ns)
+{
+    (void)inst; (void)id; (void)ns;
+}
+
+static inline purc_variant_t pcinst_stats_snapshot(struct pcinst *inst)
+{
+    (void)inst;
+    purc_set_error(PURC_ERROR_NOT_SUPPORTED);
+    return PURC_VARIANT_INVALID;
+}
+
+static inline uint64_t pcinst_stats_now_ns(void) { return 0; }
+static inline uint64_t pcinst_stats_cpu_ns(void) { return 0; }
+
+#endif  /* !ENABLE(RUNTIME_STATS) */
+
+PCA_EXTERN_C_END
+
+#endif /* not defined PURC_PRIVATE_STATS_H */
+
@@ -34,6 +34,7 @@
 #include "purc-runloop.h"
 
 typedef void* pcintr_timer_t;
+typedef void* pcintr_timer_wheel_t;
 typedef void (*pcintr_timer_fire_func)(pcintr_timer_t timer, const char* id,
         void *data);
 
@@ -43,6 +44,11 @@ pcintr_timer_t
 pcintr_timer_create(purc_runloop_t runloop, const char* id,
         pcintr_timer_fire_func func, void *data);
 
+/* create a timer which lives in the given timer wheel */
+pcintr_timer_t
+pcintr_timer_create_in_wheel(pcintr_timer_wheel_t wheel, const char* id,
+        pcintr_timer_fire_func func, void *data);
+
 void
 pcintr_timer_set_interval(pcintr_timer_t timer, uint32_t interval);
 
@@ -58,9 +64,23 @@ pcintr_timer_start_oneshot(pcintr_timer_t timer);
 void
 pcintr_timer_stop(pcintr_timer_t timer);
 
+bool
+pcintr_timer_is_active(pcintr_timer_t timer);
+
 void
 pcintr_timer_destroy(pcintr_timer_t timer);
 
+/* a hierarchical timing wheel driven by a single runloop timer */
+pcintr_timer_wheel_t
+pcintr_timer_wheel_create(purc_runloop_t runloop);
+
+/* the number of active timers in the wheel */
+size_t
+pcintr_timer_wheel_count(pcintr_timer_wheel_t wheel);
+
+void
+pcintr_timer_wheel_destroy(pcintr_timer_wheel_t wheel);
+
 PCA_EXTERN_C_END
 
 #endif /* not defined PURC_PRIVATE_TIMER_H */
@@ -36,6 +36,11 @@
 extern "C" {
 #endif  /* __cplusplus */
 
+/* Returns the number of the leading ASCII characters in the first len bytes
+   of str; stops at the null byte. */
+size_t
+pcutils_string_ascii_prefix(const char *str, size_t len);
+
 #ifdef __cplusplus
 }
 #endif  /* __cplusplus */
@@ -149,6 +149,13 @@ typedef struct pcutils_crc32_ctxt {
         const uint32_t *table_static;
         uint32_t       *table_alloc;
     };
+
+    /* the tables to process eight bytes a time; NULL if not available */
+    const uint32_t (*slices)[256];
+
+    /* the polynomial if it can be computed by the special instructions
+       of the processor; zero for none */
+    uint32_t    accel_poly;
 } pcutils_crc32_ctxt;
 
 void
@@ -206,6 +213,10 @@ void pcutils_bin2hex(const unsigned char *bin, size_t len, char *hex,
    return 0 on success, < 0 for error */
 int pcutils_hex2bin(const char *hex, unsigned char *bin, size_t *converted);
 
+/* the heximal string is not null-terminated but has the length of len */
+int pcutils_hex2bin_ex(const char *hex, size_t len, unsigned char *bin,
+        size_t *converted);
+
 /* convert two heximal characters to a byte.
    return 0 on success, < 0 for bad input string */
 int pcutils_hex2byte(const char *hex, unsigned char *byte);
@@ -224,6 +235,10 @@ ssize_t pcutils_b64_encode(const void *src, size_t src_len,
         void *dst, size_t sz_dst);
 ssize_t pcutils_b64_decode(const void *src, void *dst, size_t sz_dst);
 
+/* the source is not null-terminated but has the length of src_len */
+ssize_t pcutils_b64_decode_ex(const void *src, size_t src_len,
+        void *dst, size_t sz_dst);
+
 int pcutils_parse_int32(const char *buf, size_t len, int32_t *retval);
 int pcutils_parse_uint32(const char *buf, size_t len, uint32_t *retval);
 int pcutils_parse_int64(const char *buf, size_t len, int64_t *retval);
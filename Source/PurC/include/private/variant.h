@@ -40,6 +40,8 @@ PCA_EXTERN_C_BEGIN
 #define PCVRNT_FLAG_NOFREE          PCVRNT_FLAG_CONSTANT
 #define PCVRNT_FLAG_EXTRA_SIZE      (0x01 << 1)  // when use extra space
 #define PCVRNT_FLAG_STRING_STATIC   (0x01 << 2)  // make_string_static
+#define PCVRNT_FLAG_INTERNED        (0x01 << 3)  // interned object key
+#define PCVRNT_FLAG_STRING_SLICE    (0x01 << 4)  // refers to another buffer
 
 #define PVT(t)          (PURC_VARIANT_TYPE##t)
 #define IS_CONTAINER(t) (t == PURC_VARIANT_TYPE_OBJECT || \
@@ -124,6 +126,10 @@ struct purc_variant {
 
         /* the list node for reserved variants. */
         struct list_head    reserved;
+
+        /* the variant holding the buffer of a string or byte sequence
+           slice; see pcvariant_make_string_slice(). */
+        purc_variant_t      parent;
     };
 
     /* value */
@@ -193,6 +199,23 @@ struct purc_variant {
 
 #define USE_LOOP_BUFFER_FOR_RESERVED    0
 
+/* The size classes of the slab allocator: 16, 32, ..., 128 bytes. */
+#define PCVARIANT_SLAB_GRANULARITY      16
+#define PCVARIANT_SLAB_NR_CLASSES       8
+#define PCVARIANT_SLAB_MAX_CHUNK_SIZE   \
+    (PCVARIANT_SLAB_GRANULARITY * PCVARIANT_SLAB_NR_CLASSES)
+
+struct pcvariant_slab;
+
+struct pcvariant_slab_class {
+    // the slab to allocate chunks from.
+    struct pcvariant_slab  *curr;
+    // the slabs having free chunks.
+    struct list_head        partial;
+    // the slabs having no free chunk.
+    struct list_head        full;
+};
+
 struct pcvariant_heap {
     // the constant values.
     struct purc_variant v_undefined;
@@ -211,6 +234,15 @@ struct pcvariant_heap {
 #else
     struct list_head    v_reserved;
 #endif
+
+    // the interned object keys indexed by the sequence of the atoms
+    // in ATOM_BUCKET_OBJKEY; only used when `intern_keys` is true.
+    bool                intern_keys;
+    size_t              nr_interned_keys;
+    purc_variant_t     *interned_keys;
+
+    // the slab allocator for the variants and the nodes of containers.
+    struct pcvariant_slab_class slab_classes[PCVARIANT_SLAB_NR_CLASSES];
 };
 
 // internal interfaces for moving variant.
@@ -224,6 +256,22 @@ purc_variant *pcvariant_alloc(void) WTF_INTERNAL;
 purc_variant *pcvariant_alloc_0(void) WTF_INTERNAL;
 void pcvariant_free(purc_variant *v) WTF_INTERNAL;
 
+/*
+ * The slab allocator for the small fixed-size blocks such as variants and
+ * the nodes of containers. A block can be freed in any instance; the
+ * size passed to pcvariant_slab_free() must be the one used to allocate it.
+ */
+void *pcvariant_slab_alloc(size_t size) WTF_INTERNAL;
+void *pcvariant_slab_alloc_0(size_t size) WTF_INTERNAL;
+void pcvariant_slab_free(void *p, size_t size) WTF_INTERNAL;
+
+// hand the empty slabs of the current instance back to the system.
+void pcvariant_slab_trim(void) WTF_INTERNAL;
+
+int pcvariant_slab_init_once(void) WTF_INTERNAL;
+void pcvariant_slab_init_heap(struct pcvariant_heap *heap) WTF_INTERNAL;
+void pcvariant_slab_cleanup_heap(struct pcvariant_heap *heap) WTF_INTERNAL;
+
 struct pcinst;
 struct tuple_node;
 
@@ -274,6 +322,10 @@ struct variant_obj {
     struct rb_root          kvs;  // struct obj_node*
     size_t                  size;
 
+    /* Changed whenever a member is added, removed or replaced; no two
+       objects or states of an object share a stamp in the process. */
+    uint64_t                stamp;
+
     // key: arr_node/obj_node/set_node
     // val: parent
     pcutils_map                     *rev_update_chain;
@@ -282,13 +334,27 @@ struct variant_obj {
 // internal struct used by variant-arr
 typedef struct variant_arr      *variant_arr_t;
 
-struct arr_node {
-    struct pcutils_array_list_node       node;
-    purc_variant_t   val;
-};
+/* The members of an array are stored contiguously without any node;
+   `struct arr_node` is only an opaque key of the reverse update edges. */
+struct arr_node;
 
 struct variant_arr {
-    struct pcutils_array_list     al;  // struct arr_node*
+    purc_variant_t               *members;
+    size_t                        nr;   // the number of the members
+    size_t                        sz;   // the capacity of members
+
+    /* A packed array keeps all members as plain numbers of packed_type
+       (number, longint, or ulongint) in the column, and members is NULL;
+       the variants of the members are materialized as temporaries on
+       demand. packed_type is PURC_VARIANT_TYPE_UNDEFINED (0) for
+       an ordinary array. */
+    purc_variant_type             packed_type;
+    union {
+        void                     *packed;
+        double                   *packed_f64;
+        int64_t                  *packed_i64;
+        uint64_t                 *packed_u64;
+    };
 
     // key: arr_node/obj_node/set_node
     // val: parent
@@ -314,6 +380,110 @@ struct variant_tuple {
 
 int pcvariant_array_sort(purc_variant_t value, void *ud,
         int (*cmp)(purc_variant_t l, purc_variant_t r, void *ud));
+
+/* Makes a packed array of nr numbers of the type (number, longint, or
+   ulongint) copied from reals, which is an array of double, int64_t,
+   or uint64_t accordingly. */
+purc_variant_t pcvariant_array_make_packed(purc_variant_type type,
+        const void *reals, size_t nr);
+
+/* Packs an array if it is large enough and all members are numbers of
+   the same type; returns true if the array is packed. */
+bool pcvariant_array_pack(purc_variant_t arr);
+
+/* Materializes all members of a packed array and makes it an ordinary
+   one; returns 0 on success. */
+int pcvariant_array_unpack(purc_variant_t arr);
+
+/* Returns a new reference to the member at idx, or PURC_VARIANT_INVALID
+   if idx is out of range; the member of a packed array is materialized
+   for the caller, and the array is kept packed. */
+purc_variant_t pcvariant_array_get_member(purc_variant_t arr, size_t idx);
+
+/* Returns the member at idx for the body of the foreach macros of array;
+   the one of a packed array is materialized as a temporary held by *tmp,
+   which replaces the temporary of the previous member. */
+static inline purc_variant_t
+pcvariant_array_loop_member(purc_variant_t arr, size_t idx,
+        purc_variant_t *tmp)
+{
+    variant_arr_t data = (variant_arr_t)arr->sz_ptr[1];
+
+    if (*tmp != PURC_VARIANT_INVALID) {
+        purc_variant_unref(*tmp);
+        *tmp = PURC_VARIANT_INVALID;
+    }
+
+    if (!data->packed_type)
+        return data->members[idx];
+
+    *tmp = pcvariant_array_get_member(arr, idx);
+    return *tmp;
+}
+
+/* Releases the temporary member when a foreach loop of array is left. */
+static inline void
+pcvariant_array_loop_release(purc_variant_t *tmp)
+{
+    if (*tmp != PURC_VARIANT_INVALID)
+        purc_variant_unref(*tmp);
+}
+
+/* Returns the column of a packed array, and the type and the number of
+   the members in it; or NULL if the array is not packed. */
+const void *pcvariant_array_get_packed(purc_variant_t arr,
+        purc_variant_type *type, size_t *nr);
+
+/* Returns the stamp of the current state of an object; the stamp changes
+   whenever a member is added, removed or replaced. */
+static inline uint64_t pcvariant_object_get_stamp(purc_variant_t obj)
+{
+    return ((variant_obj_t)obj->sz_ptr[1])->stamp;
+}
+/* Makes a string which refers to the len bytes at str in the buffer of
+   parent, a string or a byte sequence, instead of copying them; the byte
+   following the slice must be in the buffer of parent too. The slice
+   holds a reference to the variant which owns the buffer, and counts its
+   characters only when asked. A short slice is copied like
+   purc_variant_make_string_ex() does. */
+purc_variant_t pcvariant_make_string_slice(purc_variant_t parent,
+        const char *str, size_t len, bool check_encoding);
+
+/* Makes a byte sequence which refers to the nr_bytes bytes at bytes in
+   the buffer of parent, a string or a byte sequence. */
+purc_variant_t pcvariant_make_byte_sequence_slice(purc_variant_t parent,
+        const void *bytes, size_t nr_bytes);
+
+/* Copies the bytes of a slice to a buffer of its own and releases the
+   parent; does nothing for other variants. Returns false if out of
+   memory. */
+bool pcvariant_slice_detach(purc_variant_t v);
+
+/* Returns the bytes of a string or a byte sequence and the number of them
+   without the terminating null byte of a string, which a string slice
+   may not have. */
+static inline const void *
+pcvariant_get_bytes_const(purc_variant_t v, size_t *nr_bytes)
+{
+    const void *bytes;
+    size_t nr;
+
+    if (v->flags & (PCVRNT_FLAG_EXTRA_SIZE | PCVRNT_FLAG_STRING_STATIC |
+                PCVRNT_FLAG_STRING_SLICE)) {
+        bytes = (const void *)v->sz_ptr[1];
+        nr = (size_t)v->sz_ptr[0];
+    }
+    else {
+        bytes = v->bytes;
+        nr = v->size;
+    }
+
+    if (v->type == PURC_VARIANT_TYPE_STRING)
+        nr--;
+    *nr_bytes = nr;
+    return bytes;
+}
+
 int pcvariant_set_sort(purc_variant_t value, void *ud,
         int (*cmp)(purc_variant_t l, purc_variant_t r, void *ud));
 
@@ -499,65 +669,110 @@ do {                                            \
 
 // purc_variant_t _arr;
 #define variant_array_get_data(_arr)        \
-    &(((variant_arr_t)_arr->sz_ptr[1])->al)
+    ((variant_arr_t)_arr->sz_ptr[1])
 
+/* The index forms do not materialize the members of a packed array. */
 // purc_variant_t _arr;
-// struct arr_node *_p;
-#define foreach_in_variant_array(_arr, _p)                               \
-    array_list_for_each_entry(variant_array_get_data(_arr),              \
-            _p, node)
+// size_t _i;
+#define foreach_in_variant_array(_arr, _i)                               \
+    for (_i = 0; _i < variant_array_get_data(_arr)->nr; _i++)
 
+/* The index does not advance if the number of the members decreased
+   in the body, i.e., the current member was removed. */
 // purc_variant_t _arr;
-// struct arr_node *_p, *_n;
-#define foreach_in_variant_array_safe(_arr, _p, _n)                      \
-    array_list_for_each_entry_safe(variant_array_get_data(_arr),         \
-            _p, _n, node)
+// size_t _i, _n;
+#define foreach_in_variant_array_safe(_arr, _i, _n)                      \
+    for (_i = 0;                                                         \
+        ({ _n = variant_array_get_data(_arr)->nr; _i < _n; });           \
+        _i += (variant_array_get_data(_arr)->nr < _n) ? 0 : 1)
 
 // purc_variant_t _arr;
-// struct arr_node *_p;
-#define foreach_in_variant_array_reverse(_arr, _p)                       \
-    array_list_for_each_entry_reverse(variant_array_get_data(_arr),      \
-            _p, node)
+// size_t _i;
+#define foreach_in_variant_array_reverse(_arr, _i)                       \
+    for (_i = variant_array_get_data(_arr)->nr; _i-- > 0; )
 
 // purc_variant_t _arr;
-// struct arr_node *_p, *_n;
-#define foreach_in_variant_array_reverse_safe(_arr, _p, _n)              \
-    array_list_for_each_entry_reverse_safe(variant_array_get_data(_arr), \
-            _p, _n, node)
-
+// size_t _i, _n;
+#define foreach_in_variant_array_reverse_safe(_arr, _i, _n)              \
+    for (_i = variant_array_get_data(_arr)->nr;                          \
+        ({ _n = variant_array_get_data(_arr)->nr;                        \
+         _i = (_i > _n) ? _n : _i; _i-- > 0; }); )
+
+/* `_p` points to the slot of the current member in the loop body, or is
+   NULL for a packed array: its members are materialized one by one as
+   temporaries, which are released when the loop advances or is left, and
+   the loop stops with the error set if a member can not be materialized.
+   Do not keep `_val` of a packed array beyond the iteration without
+   a reference. */
 #define foreach_value_in_variant_array(_arr, _val, _idx)              \
     do {                                                              \
-        struct arr_node *_p;                                          \
-        foreach_in_variant_array(_arr, _p) {                          \
-            _val = _p->val;                                           \
-            _idx = _p->node.idx;                                      \
+        variant_arr_t _data = variant_array_get_data(_arr);           \
+        purc_variant_t _tmp                                           \
+            __attribute__((cleanup(pcvariant_array_loop_release))) =  \
+            PURC_VARIANT_INVALID;                                     \
+        purc_variant_t *_p;                                           \
+        size_t _i;                                                    \
+        foreach_in_variant_array(_arr, _i) {                          \
+            _val = pcvariant_array_loop_member(_arr, _i, &_tmp);      \
+            if (_val == PURC_VARIANT_INVALID)                         \
+                break;                                                \
+            _p = _data->packed_type ? NULL : _data->members + _i;     \
+            (void)_p;                                                 \
+            _idx = _i;                                                \
      /* } */                                                          \
  /* } while (0) */
 
 #define foreach_value_in_variant_array_safe(_arr, _val, _idx)      \
     do {                                                           \
-        struct arr_node *_p, *_n;                                  \
-        foreach_in_variant_array_safe(_arr, _p, _n) {              \
-            _val = _p->val;                                        \
-            _idx = _p->node.idx;                                   \
+        variant_arr_t _data = variant_array_get_data(_arr);        \
+        purc_variant_t _tmp                                        \
+            __attribute__((cleanup(pcvariant_array_loop_release))) = \
+            PURC_VARIANT_INVALID;                                  \
+        purc_variant_t *_p;                                        \
+        size_t _i, _n;                                             \
+        foreach_in_variant_array_safe(_arr, _i, _n) {              \
+            _val = pcvariant_array_loop_member(_arr, _i, &_tmp);   \
+            if (_val == PURC_VARIANT_INVALID)                      \
+                break;                                             \
+            _p = _data->packed_type ? NULL : _data->members + _i;  \
+            (void)_p;                                              \
+            _idx = _i;                                             \
      /* } */                                                       \
  /* } while (0) */
 
 #define foreach_value_in_variant_array_reverse(_arr, _val, _idx)      \
     do {                                                              \
-        struct arr_node *_p;                                          \
-        foreach_in_variant_array_reverse(_arr, _p) {                  \
-            _val = _p->val;                                           \
-            _idx = _p->node.idx;                                      \
+        variant_arr_t _data = variant_array_get_data(_arr);           \
+        purc_variant_t _tmp                                           \
+            __attribute__((cleanup(pcvariant_array_loop_release))) =  \
+            PURC_VARIANT_INVALID;                                     \
+        purc_variant_t *_p;                                           \
+        size_t _i;                                                    \
+        foreach_in_variant_array_reverse(_arr, _i) {                  \
+            _val = pcvariant_array_loop_member(_arr, _i, &_tmp);      \
+            if (_val == PURC_VARIANT_INVALID)                         \
+                break;                                                \
+            _p = _data->packed_type ? NULL : _data->members + _i;     \
+            (void)_p;                                                 \
+            _idx = _i;                                                \
      /* } */                                                          \
  /* } while (0) */
 
 #define foreach_value_in_variant_array_reverse_safe(_arr, _val, _idx)   \
     do {                                                                \
-        struct arr_node *_p, *_n;                                       \
-        foreach_in_variant_array_reverse_safe(_arr, _p, _n) {           \
-            _val = _p->val;                                             \
-            _idx = _p->node.idx;                                        \
+        variant_arr_t _data = variant_array_get_data(_arr);             \
+        purc_variant_t _tmp                                             \
+            __attribute__((cleanup(pcvariant_array_loop_release))) =    \
+            PURC_VARIANT_INVALID;                                       \
+        purc_variant_t *_p;                                             \
+        size_t _i, _n;                                                  \
+        foreach_in_variant_array_reverse_safe(_arr, _i, _n) {           \
+            _val = pcvariant_array_loop_member(_arr, _i, &_tmp);        \
+            if (_val == PURC_VARIANT_INVALID)                           \
+                break;                                                  \
+            _p = _data->packed_type ? NULL : _data->members + _i;       \
+            (void)_p;                                                   \
+            _idx = _i;                                                  \
      /* } */                                                            \
  /* } while (0) */
 
@@ -259,6 +259,13 @@ char *pcvcm_node_serialize(struct pcvcm_node *node, size_t *nr_bytes);
  */
 void pcvcm_node_destroy(struct pcvcm_node *root);
 
+struct pcvcm_method_cache;
+
+/*
+ * Frees the method cache of an instance built by the evaluation.
+ */
+void pcvcm_method_cache_delete(struct pcvcm_method_cache *cache);
+
 
 typedef purc_variant_t(*find_var_fn) (void *ctxt, const char *name);
 
@@ -277,6 +284,11 @@ struct pcintr_stack;
 purc_variant_t pcvcm_eval(struct pcvcm_node *tree, struct pcintr_stack *stack,
         bool silently);
 
+/* Evaluates a tree which is destroyed right after the evaluation, e.g.,
+   the one parsed from a JSON text, without variables; the buffers of the
+   constant strings in the tree may be handed over to the result. */
+purc_variant_t pcvcm_eval_once(struct pcvcm_node *tree, bool silently);
+
 purc_variant_t pcvcm_eval_again(struct pcvcm_node *tree,
         struct pcintr_stack *stack, bool silently, bool timeout);
 
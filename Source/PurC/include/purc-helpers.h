@@ -321,6 +321,10 @@ char *purc_load_file_contents(const char *file, size_t *length);
 
 #define PURC_LOG_FILE_PATH_FORMAT   "/var/tmp/purc-%s-%s.log"
 
+#define PURC_ENVV_PROFILER          "PURC_PROFILER"
+
+#define PURC_PROFILER_FILE_PATH_FORMAT  "/var/tmp/purc-%s-%s.folded"
+
 // TODO for Windows:
 // #define LOG_FILE_PATH_FORMAT    "C:\\tmp\\purc-%s\\%s.log"
 
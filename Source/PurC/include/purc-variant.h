@@ -1298,6 +1298,29 @@ PCA_EXPORT ssize_t
 purc_variant_object_overwrite(purc_variant_t dst, purc_variant_t src,
         pcvrnt_nr_method_k nr_method);
 
+/**
+ * purc_variant_object_intern_keys:
+ *
+ * @enable: Whether to intern the keys of object variants.
+ *
+ * Enables or disables interning the keys of object variants in the current
+ * instance. When enabled, the keys of the properties added to any object
+ * afterwards are interned from their second use on: all objects share
+ * a single string variant for the same key, and the key can be matched
+ * by pointer. The interned variant is a copy; the key variants passed by
+ * the caller are not changed.
+ *
+ * Note that the interned key names are kept as atoms during the life of
+ * the process; after 65536 distinct keys, the new keys are no longer
+ * interned. So do not enable this if the keys are arbitrary data.
+ *
+ * Returns: The old setting; %false if there is no PurC instance.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT bool
+purc_variant_object_intern_keys(bool enable);
+
 /**
  * pcvrnt_object_iterator:
  *
@@ -3151,6 +3174,11 @@ struct purc_variant_stat {
     size_t sz_total_mem;
     size_t nr_reserved;
     size_t nr_max_reserved;
+
+    /* the slabs for variants and the nodes of containers */
+    size_t nr_slabs;
+    size_t sz_slabs;
+    size_t nr_slab_chunks;
 };
 
 /**
@@ -437,6 +437,98 @@ purc_load_hvml_from_rwstream(purc_rwstream_t stream);
 PCA_EXPORT struct pcrdr_conn *
 purc_get_conn_to_renderer(void);
 
+/**
+ * purc_get_instance_stats:
+ *
+ * Retrieves a snapshot of the runtime performance counters of the current
+ * PurC instance. The snapshot is an object with the following properties:
+ *
+ *  - `scheduler`: the counters of the rounds, the steps, the time slices,
+ *      the preemptions, and the idle sleeps of the scheduler.
+ *  - `messages`: the number of the dispatched messages and the histogram
+ *      of the latency of the events in the message queues.
+ *  - `vcm_eval`: the histogram of the time to evaluate VCM trees.
+ *  - `fetcher`: the number of the asynchronous requests and the histogram
+ *      of the time of the synchronous requests.
+ *  - `renderer`: the histogram of the time of the round trips to
+ *      the renderer.
+ *  - `coroutines`: an array of the coroutines with their CPU time, steps,
+ *      time slices, and the current and maximal depths of their message
+ *      queues.
+ *
+ * A histogram is an object with `count`, `sum_ns`, `max_ns`, the estimated
+ * `p50_ns`, `p90_ns`, `p99_ns`, and `buckets`, in which the element `i`
+ * counts the durations in [2^i, 2^(i+1)) nanoseconds.
+ *
+ * Returns: The object variant; %PURC_VARIANT_INVALID for no instance or
+ *      the statistics is disabled (%PURC_ERROR_NOT_SUPPORTED).
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT purc_variant_t
+purc_get_instance_stats(void);
+
+/**
+ * purc_profiler_start:
+ *
+ * @frequency: The number of the samples per second of CPU time;
+ *      0 for the default (99).
+ *
+ * Starts the sampling profiler of the current PurC instance, or changes
+ * the frequency if it is running. A timer on the CPU time of the instance
+ * thread raises %SIGPROF, and the ticks are taken as the samples at the
+ * boundaries of the steps of the coroutines. Every sample is charged to
+ * the vDOM element executed by the step and its ancestors, identified by
+ * the tag names and the positions in the HVML source.
+ *
+ * The profiler can also be started when the instance is initialized by
+ * setting the environment variable `PURC_PROFILER` to `1` or a frequency;
+ * in this case, the samples will be written to
+ * `/var/tmp/purc-<app>-<runner>.folded` when the instance exits.
+ *
+ * Returns: %PURC_ERROR_OK for success, %PURC_ERROR_NO_INSTANCE,
+ *      %PURC_ERROR_BAD_SYSTEM_CALL, or %PURC_ERROR_NOT_SUPPORTED
+ *      on the platforms other than Linux.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT int
+purc_profiler_start(unsigned int frequency);
+
+/**
+ * purc_profiler_stop:
+ *
+ * Stops the sampling profiler of the current PurC instance. The samples
+ * collected are kept until they are dumped with @reset being %true.
+ *
+ * Returns: %PURC_ERROR_OK or %PURC_ERROR_NO_INSTANCE.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT int
+purc_profiler_stop(void);
+
+/**
+ * purc_profiler_dump:
+ *
+ * @stm: The stream to write the samples to.
+ * @reset: Whether to discard the samples after dumping them.
+ *
+ * Writes the samples collected by the profiler of the current PurC instance
+ * as the collapsed stacks, one line per stack:
+ *
+ *     <coroutine URI>;<tag>@<line>:<column>;... <count>
+ *
+ * The output can be fed to the flame graph tools directly. The samples
+ * taken out of the steps of coroutines are charged to `[scheduler]`.
+ *
+ * Returns: The number of the stacks written; -1 for failure.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT ssize_t
+purc_profiler_dump(purc_rwstream_t stm, bool reset);
+
 /**
  * purc_renderer_extra_info:
  *
@@ -850,6 +942,12 @@ purc_get_instmgr_rid(void);
  * Creates a new PurC instance or gets the atom value of the existing
  * PurC instance.
  *
+ * If @runner_name is `_spare` (%PURC_RUNNER_NAME_SPARE), the instance
+ * manager hands out one of the instances pre-warmed for the app by
+ * @purc_inst_prewarm, and @cond_handler and @extra_info are ignored;
+ * if there is none left, it creates a new instance with a generated
+ * runner name. Either way, the atom returned is of a new runner.
+ *
  * Returns: The atom representing the new PurC instance, 0 for error.
  *
  * Since 0.2.0
@@ -859,6 +957,79 @@ purc_inst_create_or_get(const char *app_name, const char *runner_name,
         purc_cond_handler cond_handler,
         const purc_instance_extra_info* extra_info);
 
+#define PURC_RUNNER_NAME_WORKERS        "_workers"
+
+/**
+ * purc_inst_create_workers:
+ *
+ * @nr_workers: The number of the worker runners to create; zero for the
+ *      number of the online processors.
+ *
+ * Creates a pool of worker runners for the app of the current instance.
+ * The workers are ordinary runners named `_worker0`, `_worker1`, and so on,
+ * each with its own thread. Once the pool exists, a coroutine loaded or
+ * called within the runner `_workers` (%PURC_RUNNER_NAME_WORKERS) is placed
+ * onto the worker which has the fewest ready coroutines, and stays there
+ * until it exits; the data are exchanged with it through the move buffers
+ * as with any other runner. Without a pool, `_workers` means the current
+ * runner.
+ *
+ * There is at most one pool in a process; calling this function again from
+ * the same app returns the number of the existing workers. The pool is
+ * forgotten when the instance which created it is cleaned up, but the
+ * workers are not shut down: they are runners of the app owned by the
+ * caller, which should ask every worker to shut down by calling
+ * @purc_inst_ask_to_shutdown with its atom, the one of the runner
+ * `_worker<N>`, before cleaning up.
+ *
+ * Returns: The number of the workers in the pool, 0 for error.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT size_t
+purc_inst_create_workers(size_t nr_workers);
+
+/**
+ * purc_inst_get_nr_workers:
+ *
+ * Returns: The number of the workers in the pool of the process, 0 if
+ *      there is no pool.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT size_t
+purc_inst_get_nr_workers(void);
+
+#define PURC_RUNNER_NAME_SPARE          "_spare"
+
+/**
+ * purc_inst_prewarm:
+ *
+ * @app_name: A pointer to the string contains the app name.
+ * @nr_spares: The number of the instances to keep ready.
+ * @cond_handler (nullable): A pointer to the condition handler for the
+ *      pre-warmed instances.
+ * @extra_info (nullable): A pointer to the extra information for the
+ *      pre-warmed instances, e.g., the type and the URI of the renderer.
+ *
+ * Asks the instance manager to keep @nr_spares instances of the app fully
+ * initialized, so that @purc_inst_create_or_get with the runner name
+ * `_spare` returns one of them at the cost of a message round trip. The
+ * instances are created when the instance manager is idle, and refilled
+ * after they are handed out. They are named `_spare0`, `_spare1`, and
+ * so on. Zero stops refilling.
+ *
+ * Only one app of the process can have pre-warmed instances.
+ *
+ * Returns: The number of the instances to keep, -1 for error.
+ *
+ * Since: 0.9.6
+ */
+PCA_EXPORT ssize_t
+purc_inst_prewarm(const char *app_name, size_t nr_spares,
+        purc_cond_handler cond_handler,
+        const purc_instance_extra_info* extra_info);
+
 /**
  * purc_inst_ask_to_shutdown:
  *
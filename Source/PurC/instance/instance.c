@@ -43,6 +43,7 @@
 #include "private/pcrdr.h"
 #include "private/msg-queue.h"
 #include "private/runners.h"
+#include "private/stats.h"
 #include "purc-runloop.h"
 
 #include "../interpreter/internal.h"
@@ -419,6 +420,16 @@ static void cleanup_instance(struct pcinst *curr_inst)
         curr_inst->bt = NULL;
     }
 
+    if (curr_inst->stats) {
+        pcinst_stats_delete(curr_inst->stats);
+        curr_inst->stats = NULL;
+    }
+
+    if (curr_inst->vcm_method_cache) {
+        pcvcm_method_cache_delete(curr_inst->vcm_method_cache);
+        curr_inst->vcm_method_cache = NULL;
+    }
+
     purc_atom_remove_string_ex(PURC_ATOM_BUCKET_DEF,
             curr_inst->endpoint_name);
 
@@ -541,6 +552,7 @@ int purc_init_ex(unsigned int modules,
     curr_inst->app_name = strdup(app_name);
     curr_inst->runner_name = strdup(runner_name);
     curr_inst->endpoint_atom = atom;
+    curr_inst->stats = pcinst_stats_new();
 
     enable_log_on_demand();
 
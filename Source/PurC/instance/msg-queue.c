@@ -30,6 +30,7 @@
 #include "private/utils.h"
 #include "private/variant.h"
 #include "private/msg-queue.h"
+#include "private/stats.h"
 
 #if HAVE(GLIB)
     #include <gmodule.h>
@@ -56,6 +57,7 @@ pcinst_msg_queue_create(void)
 
     queue->state = 0;
     queue->nr_msgs = 0;
+    queue->max_nr_msgs = 0;
     list_head_init(&queue->req_msgs);
     list_head_init(&queue->res_msgs);
     list_head_init(&queue->event_msgs);
@@ -223,6 +225,9 @@ pcinst_msg_queue_append(struct pcinst_msg_queue *queue, pcrdr_msg *msg)
         break;
     }
 
+    if (queue->nr_msgs > queue->max_nr_msgs)
+        queue->max_nr_msgs = queue->nr_msgs;
+
     purc_rwlock_writer_unlock(&queue->lock);
     return 0;
 }
@@ -272,6 +277,9 @@ pcinst_msg_queue_prepend(struct pcinst_msg_queue *queue, pcrdr_msg *msg)
         break;
     }
 
+    if (queue->nr_msgs > queue->max_nr_msgs)
+        queue->max_nr_msgs = queue->nr_msgs;
+
     purc_rwlock_writer_unlock(&queue->lock);
     return 0;
 }
@@ -328,6 +336,18 @@ pcinst_msg_queue_get_msg(struct pcinst_msg_queue *queue)
 
 done:
     purc_rwlock_writer_unlock(&queue->lock);
+
+#if ENABLE(RUNTIME_STATS)
+    /* the timestamp of an event is kept in resultValue when queued */
+    if (msg && msg->type == PCRDR_MSG_TYPE_EVENT && msg->resultValue) {
+        uint64_t now = get_timestamp_us();
+        if (now >= msg->resultValue) {
+            pcinst_stats_record(pcinst_current(), PCINST_STATS_MSG_LATENCY,
+                    (now - msg->resultValue) * 1000);
+        }
+    }
+#endif
+
     return msg;
 }
 
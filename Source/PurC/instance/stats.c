@@ -0,0 +1,363 @@
+/*
+ * @file stats.c
+ * @date 2026/10/19
+ * @brief The runtime performance counters of an instance.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "purc.h"
+#include "config.h"
+
+#include "private/errors.h"
+#include "private/instance.h"
+#include "private/interpreter.h"
+#include "private/msg-queue.h"
+#include "private/stats.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#if ENABLE(RUNTIME_STATS)
+
+/* The counters are updated by the instance thread only, but they may be
+   read by others; relaxed atomics are enough for both. */
+struct pcinst_histogram {
+    atomic_uint_fast64_t    count;
+    atomic_uint_fast64_t    sum;
+    atomic_uint_fast64_t    max;
+    atomic_uint_fast64_t    buckets[PCINST_STATS_NR_BUCKETS];
+};
+
+struct pcinst_stats {
+    atomic_uint_fast64_t    counters[PCINST_STATS_NR_COUNTERS];
+    struct pcinst_histogram timers[PCINST_STATS_NR_TIMERS];
+};
+
+static const char *counter_names[] = {
+    "rounds",
+    "steps",
+    "slices",
+    "preemptions",
+    "idle_sleeps",
+    "dispatched",
+    "async_requests",
+};
+
+/* Make sure the number of names matches the number of counters */
+#define _COMPILE_TIME_ASSERT(name, x)               \
+       typedef int _dummy_ ## name[(x) * 2 - 1]
+_COMPILE_TIME_ASSERT(counters,
+        PCA_TABLESIZE(counter_names) == PCINST_STATS_NR_COUNTERS);
+#undef _COMPILE_TIME_ASSERT
+
+struct pcinst_stats *
+pcinst_stats_new(void)
+{
+    struct pcinst_stats *stats = calloc(1, sizeof(*stats));
+    if (stats == NULL) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+    }
+    return stats;
+}
+
+void
+pcinst_stats_delete(struct pcinst_stats *stats)
+{
+    free(stats);
+}
+
+void
+pcinst_stats_add(struct pcinst *inst, enum pcinst_stats_counter id,
+        uint64_t n)
+{
+    if (inst == NULL || inst->stats == NULL)
+        return;
+
+    atomic_fetch_add_explicit(&inst->stats->counters[id], n,
+            memory_order_relaxed);
+}
+
+void
+pcinst_stats_record(struct pcinst *inst, enum pcinst_stats_timer id,
+        uint64_t ns)
+{
+    if (inst == NULL || inst->stats == NULL)
+        return;
+
+    struct pcinst_histogram *hist = inst->stats->timers + id;
+    unsigned idx = ns ? (63 - __builtin_clzll(ns)) : 0;
+    if (idx >= PCINST_STATS_NR_BUCKETS)
+        idx = PCINST_STATS_NR_BUCKETS - 1;
+
+    atomic_fetch_add_explicit(&hist->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->sum, ns, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->buckets[idx], 1, memory_order_relaxed);
+
+    uint_fast64_t max = atomic_load_explicit(&hist->max, memory_order_relaxed);
+    while (ns > max && !atomic_compare_exchange_weak_explicit(&hist->max,
+                &max, ns, memory_order_relaxed, memory_order_relaxed));
+}
+
+static bool
+object_set_ulongint(purc_variant_t obj, const char *key, uint64_t u64)
+{
+    purc_variant_t val = purc_variant_make_ulongint(u64);
+    if (val == PURC_VARIANT_INVALID)
+        return false;
+
+    bool ok = purc_variant_object_set_by_static_ckey(obj, key, val);
+    purc_variant_unref(val);
+    return ok;
+}
+
+static bool
+object_set_and_unref(purc_variant_t obj, const char *key, purc_variant_t val)
+{
+    if (val == PURC_VARIANT_INVALID)
+        return false;
+
+    bool ok = purc_variant_object_set_by_static_ckey(obj, key, val);
+    purc_variant_unref(val);
+    return ok;
+}
+
+/* The estimated percentile is the upper bound of the bucket in which it
+   falls, but not greater than the maximum. */
+static uint64_t
+estimate_percentile(const uint64_t *buckets, uint64_t count, uint64_t max,
+        unsigned percent)
+{
+    uint64_t rank = (count * percent + 99) / 100;
+    uint64_t acc = 0;
+
+    for (unsigned i = 0; i < PCINST_STATS_NR_BUCKETS; i++) {
+        acc += buckets[i];
+        if (acc >= rank) {
+            if (i + 1 >= PCINST_STATS_NR_BUCKETS)
+                break;
+            uint64_t bound = ((uint64_t)1 << (i + 1)) - 1;
+            return bound < max ? bound : max;
+        }
+    }
+
+    return max;
+}
+
+static purc_variant_t
+make_histogram(struct pcinst_histogram *hist)
+{
+    uint64_t buckets[PCINST_STATS_NR_BUCKETS];
+    uint64_t count = atomic_load_explicit(&hist->count, memory_order_relaxed);
+    uint64_t sum = atomic_load_explicit(&hist->sum, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&hist->max, memory_order_relaxed);
+
+    purc_variant_t obj = purc_variant_make_object_0();
+    purc_variant_t arr = purc_variant_make_array_0();
+    if (obj == PURC_VARIANT_INVALID || arr == PURC_VARIANT_INVALID)
+        goto failed;
+
+    for (unsigned i = 0; i < PCINST_STATS_NR_BUCKETS; i++) {
+        buckets[i] = atomic_load_explicit(&hist->buckets[i],
+                memory_order_relaxed);
+
+        purc_variant_t val = purc_variant_make_ulongint(buckets[i]);
+        if (val == PURC_VARIANT_INVALID)
+            goto failed;
+        purc_variant_array_append(arr, val);
+        purc_variant_unref(val);
+    }
+
+    if (!object_set_ulongint(obj, "count", count) ||
+            !object_set_ulongint(obj, "sum_ns", sum) ||
+            !object_set_ulongint(obj, "max_ns", max) ||
+            !object_set_ulongint(obj, "p50_ns",
+                estimate_percentile(buckets, count, max, 50)) ||
+            !object_set_ulongint(obj, "p90_ns",
+                estimate_percentile(buckets, count, max, 90)) ||
+            !object_set_ulongint(obj, "p99_ns",
+                estimate_percentile(buckets, count, max, 99)) ||
+            !purc_variant_object_set_by_static_ckey(obj, "buckets", arr))
+        goto failed;
+
+    purc_variant_unref(arr);
+    return obj;
+
+failed:
+    if (arr)
+        purc_variant_unref(arr);
+    if (obj)
+        purc_variant_unref(obj);
+    return PURC_VARIANT_INVALID;
+}
+
+static uint64_t
+get_counter(struct pcinst_stats *stats, enum pcinst_stats_counter id)
+{
+    return atomic_load_explicit(&stats->counters[id], memory_order_relaxed);
+}
+
+static purc_variant_t
+make_counters(struct pcinst_stats *stats,
+        enum pcinst_stats_counter first, enum pcinst_stats_counter last)
+{
+    purc_variant_t obj = purc_variant_make_object_0();
+    if (obj == PURC_VARIANT_INVALID)
+        return PURC_VARIANT_INVALID;
+
+    for (int id = first; id <= (int)last; id++) {
+        if (!object_set_ulongint(obj, counter_names[id],
+                    get_counter(stats, id))) {
+            purc_variant_unref(obj);
+            return PURC_VARIANT_INVALID;
+        }
+    }
+
+    return obj;
+}
+
+static purc_variant_t
+make_coroutine(pcintr_coroutine_t co)
+{
+    purc_variant_t obj = purc_variant_make_object_0();
+    if (obj == PURC_VARIANT_INVALID)
+        return PURC_VARIANT_INVALID;
+
+    const char *uri = purc_atom_to_string(co->cid);
+    if (!object_set_and_unref(obj, "uri",
+                purc_variant_make_string(uri ? uri : "", false)) ||
+            !object_set_and_unref(obj, "token",
+                purc_variant_make_string(co->token, false)) ||
+            !object_set_ulongint(obj, "cpu_ns", co->cpu_time) ||
+            !object_set_ulongint(obj, "steps", co->nr_steps) ||
+            !object_set_ulongint(obj, "slices", co->nr_slices) ||
+            !object_set_ulongint(obj, "queue_depth",
+                co->mq ? pcinst_msg_queue_count(co->mq) : 0) ||
+            !object_set_ulongint(obj, "max_queue_depth",
+                co->mq ? co->mq->max_nr_msgs : 0)) {
+        purc_variant_unref(obj);
+        return PURC_VARIANT_INVALID;
+    }
+
+    return obj;
+}
+
+static bool
+append_coroutines(purc_variant_t arr, struct list_head *crtns)
+{
+    pcintr_coroutine_t co;
+    list_for_each_entry(co, crtns, ln) {
+        purc_variant_t obj = make_coroutine(co);
+        if (obj == PURC_VARIANT_INVALID)
+            return false;
+
+        purc_variant_array_append(arr, obj);
+        purc_variant_unref(obj);
+    }
+
+    return true;
+}
+
+static purc_variant_t
+make_coroutines(struct pcinst *inst)
+{
+    purc_variant_t arr = purc_variant_make_array_0();
+    if (arr == PURC_VARIANT_INVALID)
+        return PURC_VARIANT_INVALID;
+
+    struct pcintr_heap *heap = inst->intr_heap;
+    if (heap && (!append_coroutines(arr, &heap->crtns) ||
+                !append_coroutines(arr, &heap->stopped_crtns))) {
+        purc_variant_unref(arr);
+        return PURC_VARIANT_INVALID;
+    }
+
+    return arr;
+}
+
+purc_variant_t
+pcinst_stats_snapshot(struct pcinst *inst)
+{
+    if (inst == NULL) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return PURC_VARIANT_INVALID;
+    }
+
+    struct pcinst_stats *stats = inst->stats;
+    if (stats == NULL) {
+        purc_set_error(PURC_ERROR_NOT_SUPPORTED);
+        return PURC_VARIANT_INVALID;
+    }
+
+    purc_variant_t obj = purc_variant_make_object_0();
+    if (obj == PURC_VARIANT_INVALID)
+        return PURC_VARIANT_INVALID;
+
+    purc_variant_t messages = make_counters(stats,
+            PCINST_STATS_MSGS_DISPATCHED, PCINST_STATS_MSGS_DISPATCHED);
+    purc_variant_t fetcher = make_counters(stats,
+            PCINST_STATS_FETCHER_ASYNC, PCINST_STATS_FETCHER_ASYNC);
+    purc_variant_t renderer = purc_variant_make_object_0();
+
+    if (messages == PURC_VARIANT_INVALID || fetcher == PURC_VARIANT_INVALID ||
+            renderer == PURC_VARIANT_INVALID
+            || !object_set_and_unref(obj, "scheduler", make_counters(stats,
+                    PCINST_STATS_SCHED_ROUNDS, PCINST_STATS_SCHED_IDLE_SLEEPS))
+            || !object_set_and_unref(messages, "latency",
+                make_histogram(stats->timers + PCINST_STATS_MSG_LATENCY))
+            || !object_set_and_unref(fetcher, "sync_requests",
+                make_histogram(stats->timers + PCINST_STATS_FETCHER_SYNC))
+            || !object_set_and_unref(renderer, "requests",
+                make_histogram(stats->timers + PCINST_STATS_RDR_REQUEST))
+            || !object_set_and_unref(obj, "vcm_eval",
+                make_histogram(stats->timers + PCINST_STATS_VCM_EVAL))
+            || !purc_variant_object_set_by_static_ckey(obj, "messages",
+                messages)
+            || !purc_variant_object_set_by_static_ckey(obj, "fetcher",
+                fetcher)
+            || !purc_variant_object_set_by_static_ckey(obj, "renderer",
+                renderer)
+            || !object_set_and_unref(obj, "coroutines",
+                make_coroutines(inst))) {
+        purc_variant_unref(obj);
+        obj = PURC_VARIANT_INVALID;
+    }
+
+    if (messages)
+        purc_variant_unref(messages);
+    if (fetcher)
+        purc_variant_unref(fetcher);
+    if (renderer)
+        purc_variant_unref(renderer);
+    return obj;
+}
+
+#endif  /* ENABLE(RUNTIME_STATS) */
+
+purc_variant_t
+purc_get_instance_stats(void)
+{
+    struct pcinst *inst = pcinst_current();
+    if (inst == NULL) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return PURC_VARIANT_INVALID;
+    }
+
+    return pcinst_stats_snapshot(inst);
+}
+
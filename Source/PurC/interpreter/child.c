@@ -33,6 +33,7 @@
 #include "private/instance.h"
 #include "private/utils.h"
 #include "private/variant.h"
+#include "private/runners.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -169,9 +170,16 @@ pcintr_schedule_child_co(purc_vdom_t vdom, purc_atom_t curator,
     struct pcinst *inst = pcinst_current();
     const char *app_name = inst->app_name;
     const char *runner_name = runner;
+    char worker_name[PURC_LEN_RUNNER_NAME + 1];
     if (!runner || strcmp(runner, DEFAULT_RUNNER_NAME) == 0) {
         runner_name = inst->runner_name;
     }
+    else if (strcmp(runner, PURC_RUNNER_NAME_WORKERS) == 0) {
+        if (pcrun_workers_pick(app_name, worker_name, sizeof(worker_name)))
+            runner_name = worker_name;
+        else
+            runner_name = inst->runner_name;
+    }
 
     purc_assemble_endpoint_name_ex(PCRDR_LOCALHOST,
             app_name, runner_name,
@@ -296,19 +296,23 @@ purc_load_hvml_from_url(const char* url)
     vdom = find_vdom_in_cache(md5);
     if (vdom == NULL) {
         struct pcfetcher_resp_header resp_header = {0};
-        purc_rwstream_t resp = pcfetcher_request_sync(
+        purc_rwstream_t resp = pcfetcher_request_stream(
                 url,
                 PCFETCHER_REQUEST_METHOD_GET,
                 NULL,
                 10,
                 &resp_header);
 
-        if (resp_header.ret_code == 200) {
+        if (resp_header.ret_code == 200 && resp) {
+            /* the parser pulls the body while it is being received */
             vdom = purc_load_hvml_from_rwstream(resp);
             if (vdom) {
                 size_t length = purc_rwstream_tell(resp);
                 cache_vdom(md5, 60, length, vdom);
             }
+        }
+
+        if (resp) {
             purc_rwstream_destroy(resp);
         }
 
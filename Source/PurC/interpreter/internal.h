@@ -641,6 +641,26 @@ pcintr_crtn_observed_get_cid(purc_variant_t v);
 bool
 pcintr_crtn_observed_is_match(purc_variant_t observed, purc_variant_t v);
 
+struct pcintr_profiler;
+
+/* Starts the profiler if PURC_PROFILER is set in the environment. */
+void
+pcintr_profiler_init(struct pcintr_heap *heap);
+
+/* Blocks SIGPROF in the calling thread, which is not profiled until its
+   profiler starts; called by the threads the runners start. */
+void
+pcintr_profiler_block_signal(void);
+
+void
+pcintr_profiler_cleanup(struct pcintr_heap *heap,
+        struct pcintr_profiler *prof);
+
+/* Takes the pending ticks of the profiler as the samples of the element;
+   charges them to the scheduler itself if co is NULL. */
+void
+pcintr_profiler_take_samples(struct pcintr_profiler *prof,
+        pcintr_coroutine_t co, pcvdom_element_t elem);
 
 PCA_EXTERN_C_END
 
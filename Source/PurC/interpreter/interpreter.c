@@ -480,6 +480,9 @@ coroutine_destroy(pcintr_coroutine_t co)
     if (co) {
         coroutine_release(co);
         free(co);
+
+        /* hand the slabs emptied by the coroutine back to the system */
+        pcvariant_slab_trim();
     }
 }
 
@@ -505,6 +508,12 @@ static void _cleanup_instance(struct pcinst* inst)
     if (!heap)
         return;
 
+    if (heap->profiler) {
+        pcintr_profiler_cleanup(heap, heap->profiler);
+    }
+
+    pcrun_workers_reset(inst->endpoint_atom);
+
     struct list_head *crtns = &heap->crtns;
     pcintr_coroutine_t pco, qco;
     list_for_each_entry_safe(pco, qco, crtns, ln) {
@@ -531,6 +540,11 @@ static void _cleanup_instance(struct pcinst* inst)
         heap->event_timer = NULL;
     }
 
+    if (heap->timer_wheel) {
+        pcintr_timer_wheel_destroy(heap->timer_wheel);
+        heap->timer_wheel = NULL;
+    }
+
     if (heap->name_chan_map) {
         pcutils_map_destroy(heap->name_chan_map);
         heap->name_chan_map = NULL;
@@ -574,6 +588,15 @@ static int _init_instance(struct pcinst* inst,
         return purc_get_last_error();
     }
 
+    /* created before the heap is published, so a failure leaves nothing
+       to clean up but the move buffer */
+    heap->timer_wheel = pcintr_timer_wheel_create(NULL);
+    if (!heap->timer_wheel) {
+        purc_inst_destroy_move_buffer();
+        free(heap);
+        return PURC_ERROR_OUT_OF_MEMORY;
+    }
+
     inst->running_loop = purc_runloop_get_current();
     inst->intr_heap = heap;
     heap->owner     = inst;
@@ -604,6 +627,8 @@ static int _init_instance(struct pcinst* inst,
     pcintr_timer_set_interval(heap->event_timer, EVENT_TIMER_INTRVAL);
     pcintr_timer_start(heap->event_timer);
 
+    pcintr_profiler_init(heap);
+    heap->worker = pcrun_worker_attach(inst->app_name, inst->runner_name);
     return 0;
 }
 
@@ -1904,6 +1929,9 @@ coroutine_create(purc_vdom_t vdom, pcintr_coroutine_t parent,
 
     co->stopped_timeout = -1;
 
+    if (heap->worker)
+        heap->nr_arrived_crtns++;
+
     return co;
 
 fail_variables:
@@ -2154,18 +2182,17 @@ pcintr_load_from_uri(pcintr_stack_t stack, const char* uri)
     purc_variant_t ret = PURC_VARIANT_INVALID;
     struct pcfetcher_resp_header resp_header = {0};
     uint32_t timeout = stack->co->timeout.tv_sec;
-    purc_rwstream_t resp = pcfetcher_request_sync(
+    /* parse the body while it is being received */
+    purc_rwstream_t resp = pcfetcher_request_stream(
             uri,
             PCFETCHER_REQUEST_METHOD_GET,
             NULL,
             timeout,
             &resp_header);
-    if (resp_header.ret_code == 200) {
-        size_t sz_content = 0;
-        char* buf = (char*)purc_rwstream_get_mem_buffer(resp, &sz_content);
+    if (resp_header.ret_code == 200 && resp) {
         // FIXME:
         purc_clr_error();
-        ret = purc_variant_make_from_json_string(buf, sz_content);
+        ret = purc_variant_load_from_json_stream(resp);
     }
 
     if (resp_header.mime_type) {
@@ -0,0 +1,518 @@
+/*
+ * @file profiler.c
+ * @date 2026/10/19
+ * @brief The sampling profiler of the coroutines.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The profiler arms a timer which ticks on the CPU time of the instance
+ * thread and delivers SIGPROF to that thread. The signal handler only
+ * counts the ticks; the scheduler takes the pending ticks as samples
+ * after every step of a coroutine, and charges them to the element
+ * executed by the step together with its ancestors in the vDOM tree.
+ *
+ * The samples are aggregated by the collapsed stacks, i.e., the lines
+ * like `<coroutine URI>;hvml@1:1;body@3:5;iterate@4:9 42`, which can be
+ * turned into a flame graph by the usual tools directly.
+ *
+ * The handler of SIGPROF is installed for the whole process, and a signal
+ * makes poll(), epoll_wait(), nanosleep() and the like fail with EINTR
+ * even with SA_RESTART. So the threads of the instances and the instance
+ * manager start with SIGPROF blocked, and a thread unblocks it only while
+ * it is profiled. In a profiled thread, the timer ticks only when the
+ * thread runs, so a wait is rarely interrupted; the GLib main loop polls
+ * again on EINTR, and the scheduler only sleeps shorter.
+ */
+
+#include "purc.h"
+
+#include "config.h"
+
+#include "internal.h"
+
+#include "private/debug.h"
+#include "private/errors.h"
+#include "private/instance.h"
+#include "private/map.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if OS(LINUX)
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define PROFILER_DEF_FREQUENCY      99      /* avoid lockstep with timers */
+#define PROFILER_MAX_FREQUENCY      10000
+#define PROFILER_MAX_DEPTH          64
+#define PROFILER_STACK_BUF_SIZE     4096
+
+#define PROFILER_FRAME_SCHEDULER    "[scheduler]"
+
+struct pcintr_profiler {
+    /* the ticks not taken as samples yet; updated by the signal handler */
+    atomic_uint     ticks;
+
+#if OS(LINUX)
+    timer_t         timer;
+    /* SIGPROF was blocked in the thread before the profiler started */
+    bool            sig_was_blocked;
+#endif
+    unsigned int    frequency;
+    bool            running;
+
+    /* the collapsed stack to the number of samples */
+    pcutils_map    *samples;
+    uint64_t        nr_samples;
+
+    /* dump the samples to this file when the instance exits */
+    char           *dump_file;
+};
+
+#if OS(LINUX)
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id  _sigev_un._tid
+#endif
+
+static void
+on_sigprof(int signo, siginfo_t *info, void *uctxt)
+{
+    UNUSED_PARAM(signo);
+    UNUSED_PARAM(uctxt);
+
+    /* ignore SIGPROF raised by anything other than our timers */
+    if (info->si_code != SI_TIMER)
+        return;
+
+    struct pcintr_profiler *prof = info->si_value.sival_ptr;
+    if (prof)
+        atomic_fetch_add_explicit(&prof->ticks, 1, memory_order_relaxed);
+}
+
+/* Blocks or unblocks SIGPROF in the calling thread; returns whether it
+   was blocked before. */
+static bool
+mask_sigprof(int how)
+{
+    sigset_t set, old;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPROF);
+    if (pthread_sigmask(how, &set, &old))
+        return false;
+    return sigismember(&old, SIGPROF) == 1;
+}
+
+void
+pcintr_profiler_block_signal(void)
+{
+    mask_sigprof(SIG_BLOCK);
+}
+
+static pthread_once_t handler_once = PTHREAD_ONCE_INIT;
+static int handler_errno;
+
+static void
+install_handler(void)
+{
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = on_sigprof;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGPROF, &sa, NULL))
+        handler_errno = errno;
+}
+
+static int
+arm_timer(struct pcintr_profiler *prof)
+{
+    pthread_once(&handler_once, install_handler);
+    if (handler_errno) {
+        purc_set_error_with_info(PURC_ERROR_BAD_SYSTEM_CALL,
+                "sigaction: %s", strerror(handler_errno));
+        return -1;
+    }
+
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGPROF;
+    sev.sigev_value.sival_ptr = prof;
+    sev.sigev_notify_thread_id = (pid_t)syscall(SYS_gettid);
+
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &prof->timer)) {
+        purc_set_error_with_info(PURC_ERROR_BAD_SYSTEM_CALL,
+                "timer_create: %s", strerror(errno));
+        return -1;
+    }
+
+    long interval = 1000000000L / prof->frequency;
+    struct itimerspec its;
+    its.it_interval.tv_sec = interval / 1000000000L;
+    its.it_interval.tv_nsec = interval % 1000000000L;
+    its.it_value = its.it_interval;
+    if (timer_settime(prof->timer, 0, &its, NULL)) {
+        purc_set_error_with_info(PURC_ERROR_BAD_SYSTEM_CALL,
+                "timer_settime: %s", strerror(errno));
+        timer_delete(prof->timer);
+        return -1;
+    }
+
+    prof->sig_was_blocked = mask_sigprof(SIG_UNBLOCK);
+    return 0;
+}
+
+static void
+disarm_timer(struct pcintr_profiler *prof)
+{
+    /* the ticks generated before are delivered when returning from
+       timer_delete(), so none is left pending with a stale pointer */
+    timer_delete(prof->timer);
+    if (prof->sig_was_blocked)
+        mask_sigprof(SIG_BLOCK);
+}
+
+#else   /* OS(LINUX) */
+
+void
+pcintr_profiler_block_signal(void)
+{
+}
+
+static int
+arm_timer(struct pcintr_profiler *prof)
+{
+    UNUSED_PARAM(prof);
+    purc_set_error(PURC_ERROR_NOT_SUPPORTED);
+    return -1;
+}
+
+static void
+disarm_timer(struct pcintr_profiler *prof)
+{
+    UNUSED_PARAM(prof);
+}
+
+#endif  /* !OS(LINUX) */
+
+static struct pcintr_profiler *
+profiler_new(void)
+{
+    struct pcintr_profiler *prof = calloc(1, sizeof(*prof));
+    if (prof == NULL) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    atomic_init(&prof->ticks, 0);
+    prof->samples = pcutils_map_create(copy_key_string, free_key_string,
+            NULL, NULL, comp_key_string, false);
+    if (prof->samples == NULL) {
+        free(prof);
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    return prof;
+}
+
+static void
+profiler_stop(struct pcintr_profiler *prof)
+{
+    if (prof->running) {
+        disarm_timer(prof);
+        prof->running = false;
+    }
+}
+
+static int
+profiler_start(struct pcintr_profiler *prof, unsigned int frequency)
+{
+    if (frequency == 0)
+        frequency = PROFILER_DEF_FREQUENCY;
+    else if (frequency > PROFILER_MAX_FREQUENCY)
+        frequency = PROFILER_MAX_FREQUENCY;
+
+    if (prof->running && prof->frequency == frequency)
+        return 0;
+
+    profiler_stop(prof);
+    prof->frequency = frequency;
+    if (arm_timer(prof))
+        return -1;
+
+    prof->running = true;
+    return 0;
+}
+
+static void
+add_samples(struct pcintr_profiler *prof, const char *stack, unsigned n)
+{
+    pcutils_map_entry *entry = pcutils_map_find(prof->samples, stack);
+    if (entry) {
+        entry->val = (void *)((uintptr_t)entry->val + n);
+    }
+    else if (pcutils_map_insert(prof->samples, stack,
+                (void *)(uintptr_t)n)) {
+        /* drop the samples silently if out of memory */
+        return;
+    }
+
+    prof->nr_samples += n;
+}
+
+/* Appends a frame to the stack; returns false if no room left. */
+static bool
+append_frame(char *buf, size_t *len, const char *frame,
+        int line, int column)
+{
+    size_t room = PROFILER_STACK_BUF_SIZE - *len;
+    int n;
+
+    if (line > 0)
+        n = snprintf(buf + *len, room, ";%s@%d:%d", frame, line, column);
+    else
+        n = snprintf(buf + *len, room, ";%s", frame);
+
+    if (n < 0 || (size_t)n >= room) {
+        buf[*len] = 0;
+        return false;
+    }
+
+    *len += n;
+    return true;
+}
+
+void
+pcintr_profiler_take_samples(struct pcintr_profiler *prof,
+        pcintr_coroutine_t co, pcvdom_element_t elem)
+{
+    unsigned n = atomic_exchange_explicit(&prof->ticks, 0,
+            memory_order_relaxed);
+    if (n == 0)
+        return;
+
+    char buf[PROFILER_STACK_BUF_SIZE];
+    size_t len;
+
+    if (co == NULL) {
+        add_samples(prof, PROFILER_FRAME_SCHEDULER, n);
+        return;
+    }
+
+    const char *uri = purc_atom_to_string(co->cid);
+    len = snprintf(buf, sizeof(buf), "%s", uri ? uri : co->token);
+    if (len >= sizeof(buf))
+        len = sizeof(buf) - 1;
+
+    /* collect the ancestors first, then emit them from the root */
+    pcvdom_element_t chain[PROFILER_MAX_DEPTH];
+    int depth = 0;
+    while (elem && depth < PROFILER_MAX_DEPTH) {
+        chain[depth++] = elem;
+        elem = pcvdom_element_parent(elem);
+    }
+
+    for (int i = depth - 1; i >= 0; i--) {
+        const char *tag = pcvdom_element_get_tagname(chain[i]);
+        if (!append_frame(buf, &len, tag ? tag : "?",
+                    chain[i]->line, chain[i]->column))
+            break;
+    }
+
+    add_samples(prof, buf, n);
+}
+
+struct dump_ctxt {
+    purc_rwstream_t stm;
+    ssize_t         nr_stacks;
+};
+
+static int
+dump_stack(void *key, void *val, void *ud)
+{
+    struct dump_ctxt *ctxt = ud;
+    char count[32];
+
+    int n = snprintf(count, sizeof(count), " %llu\n",
+            (unsigned long long)(uintptr_t)val);
+    if (purc_rwstream_write(ctxt->stm, key, strlen(key)) < 0 ||
+            purc_rwstream_write(ctxt->stm, count, n) < 0) {
+        ctxt->nr_stacks = -1;
+        return -1;
+    }
+
+    ctxt->nr_stacks++;
+    return 0;
+}
+
+static ssize_t
+profiler_dump(struct pcintr_profiler *prof, purc_rwstream_t stm, bool reset)
+{
+    struct dump_ctxt ctxt = { stm, 0 };
+
+    pcutils_map_traverse(prof->samples, &ctxt, dump_stack);
+    if (ctxt.nr_stacks < 0) {
+        purc_set_error(PURC_ERROR_OUTPUT);
+        return -1;
+    }
+
+    if (reset) {
+        pcutils_map_clear(prof->samples);
+        prof->nr_samples = 0;
+    }
+
+    return ctxt.nr_stacks;
+}
+
+static void
+dump_to_file(struct pcintr_profiler *prof)
+{
+    purc_rwstream_t stm = purc_rwstream_new_from_file(prof->dump_file, "w");
+    if (stm == NULL) {
+        PC_WARN("Failed to open the profile file: %s\n", prof->dump_file);
+        return;
+    }
+
+    ssize_t n = profiler_dump(prof, stm, false);
+    purc_rwstream_destroy(stm);
+    PC_INFO("%lld stacks of %llu samples written to %s\n",
+            (long long)n, (unsigned long long)prof->nr_samples,
+            prof->dump_file);
+}
+
+void
+pcintr_profiler_init(struct pcintr_heap *heap)
+{
+    const char *env_value = getenv(PURC_ENVV_PROFILER);
+    if (env_value == NULL || *env_value == '0' ||
+            pcutils_strcasecmp(env_value, "false") == 0)
+        return;
+
+    /* `1` or `true` for the default frequency */
+    unsigned int frequency = 0;
+    if (pcutils_strcasecmp(env_value, "true"))
+        frequency = (unsigned int)strtoul(env_value, NULL, 10);
+    if (frequency == 1)
+        frequency = 0;
+
+    struct pcintr_profiler *prof = profiler_new();
+    if (prof == NULL)
+        return;
+
+    struct pcinst *inst = heap->owner;
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), PURC_PROFILER_FILE_PATH_FORMAT,
+            inst->app_name, inst->runner_name);
+    prof->dump_file = strdup(path);
+
+    if (profiler_start(prof, frequency)) {
+        PC_WARN("Failed to start the profiler: %s\n",
+                purc_get_error_message(purc_get_last_error()));
+        pcintr_profiler_cleanup(heap, prof);
+        return;
+    }
+
+    heap->profiler = prof;
+}
+
+void
+pcintr_profiler_cleanup(struct pcintr_heap *heap, struct pcintr_profiler *prof)
+{
+    if (prof == NULL)
+        return;
+
+    profiler_stop(prof);
+    if (prof->dump_file) {
+        if (prof->nr_samples)
+            dump_to_file(prof);
+        free(prof->dump_file);
+    }
+
+    pcutils_map_destroy(prof->samples);
+    free(prof);
+
+    if (heap && heap->profiler == prof)
+        heap->profiler = NULL;
+}
+
+int
+purc_profiler_start(unsigned int frequency)
+{
+    struct pcintr_heap *heap = pcintr_get_heap();
+    if (heap == NULL)
+        return PURC_ERROR_NO_INSTANCE;
+
+    if (heap->profiler == NULL) {
+        heap->profiler = profiler_new();
+        if (heap->profiler == NULL)
+            return PURC_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (profiler_start(heap->profiler, frequency))
+        return purc_get_last_error();
+
+    return PURC_ERROR_OK;
+}
+
+int
+purc_profiler_stop(void)
+{
+    struct pcintr_heap *heap = pcintr_get_heap();
+    if (heap == NULL)
+        return PURC_ERROR_NO_INSTANCE;
+
+    /* keep the samples for purc_profiler_dump() */
+    if (heap->profiler)
+        profiler_stop(heap->profiler);
+
+    return PURC_ERROR_OK;
+}
+
+ssize_t
+purc_profiler_dump(purc_rwstream_t stm, bool reset)
+{
+    struct pcintr_heap *heap = pcintr_get_heap();
+    if (heap == NULL) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return -1;
+    }
+
+    if (stm == NULL) {
+        purc_set_error(PURC_ERROR_INVALID_VALUE);
+        return -1;
+    }
+
+    if (heap->profiler == NULL)
+        return 0;
+
+    return profiler_dump(heap->profiler, stm, reset);
+}
+
@@ -31,6 +31,7 @@
 #include "private/utils.h"
 #include "private/variant.h"
 #include "private/pcrdr.h"
+#include "private/stats.h"
 #include "pcrdr/connect.h"
 
 #include <string.h>
@@ -42,8 +43,6 @@
 #define LAYOUT_STYLE_KEY        "layoutStyle"
 #define TOOLKIT_STYLE_KEY       "toolkitStyle"
 
-#define BUFF_MIN                1024
-#define BUFF_MAX                1024 * 1024 * 4
 #define LEN_BUFF_LONGLONGINT    128
 
 #define DEF_LEN_ONE_WRITE       1024 * 10
@@ -150,8 +149,15 @@ pcrdr_msg *pcintr_rdr_send_request_and_wait_response(struct pcrdr_conn *conn,
         pcrdr_send_request(conn, msg, PCRDR_TIME_DEF_EXPECTED, NULL, NULL);
     }
     else {
+#if ENABLE(RUNTIME_STATS)
+        uint64_t begin = pcinst_stats_now_ns();
+#endif
         pcrdr_send_request_and_wait_response(conn,
                 msg, PCRDR_TIME_DEF_EXPECTED, &response_msg);
+#if ENABLE(RUNTIME_STATS)
+        pcinst_stats_record(pcinst_current(), PCINST_STATS_RDR_REQUEST,
+                pcinst_stats_now_ns() - begin);
+#endif
     }
     pcrdr_release_message(msg);
     msg = NULL;
@@ -951,111 +957,183 @@ out:
     return ret;
 }
 
-static pcrdr_msg *
-rdr_page_control_load_large_page(struct pcrdr_conn *conn,
-        pcrdr_msg_target target, uint64_t target_value,
-        pcrdr_msg_data_type data_type,
-        const char *doc_content, size_t len_content)
-{
-    pcrdr_msg *response_msg = NULL;
-    pcrdr_msg_element_type element_type = PCRDR_MSG_ELEMENT_TYPE_VOID;
-    purc_variant_t data = PURC_VARIANT_INVALID;
-    size_t len_wrotten;
-    size_t len_to_write = 0;
+/*
+ * The writer used to load a page: the serializer writes the document into
+ * a buffer of two chunks; once more than one chunk is pending, the first
+ * chunk (cut at a UTF-8 character boundary) is sent to the renderer by
+ * `writeBegin` or `writeMore`. Every request waits for the response of
+ * the renderer before the serializer continues, so the memory used is
+ * bounded by the buffer whatever the size of the document is.
+ *
+ * If the whole document fits in one chunk, it is sent by `load` instead.
+ */
+struct rdr_page_writer {
+    struct pcrdr_conn      *conn;
+    pcrdr_msg_target        target;
+    uint64_t                target_value;
+    pcrdr_msg_data_type     data_type;
+
+    pcrdr_msg              *response_msg;
+    size_t                  nr_chunks;
+    bool                    failed;
+
+    size_t                  len;
+    char                    buff[DEF_LEN_ONE_WRITE * 2];
+};
 
-    // writeBegin
-    const char *start = doc_content;
-    const char *end;
-    pcutils_string_check_utf8_len(start, DEF_LEN_ONE_WRITE, NULL, &end);
-    if (end > start) {
-        len_to_write = end - start;
+static int
+rdr_page_writer_send(struct rdr_page_writer *writer, const char *operation,
+        size_t len)
+{
+    purc_variant_t data;
 
-        data = purc_variant_make_string_static(start, false);
-        len_wrotten = len_to_write;
+    data = purc_variant_make_string_ex(writer->buff, len, false);
+    if (data == PURC_VARIANT_INVALID) {
+        return -1;
     }
-    else {
-        LOG_ERROR("No valid character in document content\n");
-        goto failed;
+
+    if (writer->response_msg) {
+        pcrdr_release_message(writer->response_msg);
     }
 
-    response_msg = pcintr_rdr_send_request_and_wait_response(
-            conn, target, target_value, PCRDR_OPERATION_WRITEBEGIN, NULL,
-            element_type, NULL, NULL, data_type, data, len_to_write);
+    writer->response_msg = pcintr_rdr_send_request_and_wait_response(
+            writer->conn, writer->target, writer->target_value, operation,
+            NULL, PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL, writer->data_type,
+            data, len);
     purc_variant_unref(data);
-    if (response_msg == NULL) {
-        goto failed;
+    if (writer->response_msg == NULL) {
+        return -1;
     }
 
-    if (response_msg->retCode != PCRDR_SC_OK) {
+    if (writer->response_msg->retCode != PCRDR_SC_OK) {
         PC_ERROR("failed to write content to rdr\n");
-        goto failed;
+        return -1;
     }
 
-    if (len_wrotten == len_content) {
-        goto done;
+    writer->nr_chunks++;
+    writer->len -= len;
+    if (writer->len > 0) {
+        memmove(writer->buff, writer->buff + len, writer->len);
     }
+    return 0;
+}
 
-writting:
-    len_to_write = 0;
-    if (len_wrotten + DEF_LEN_ONE_WRITE > len_content) {
-        // writeEnd
-        data = purc_variant_make_string_static(doc_content + len_wrotten,
-                false);
-        response_msg = pcintr_rdr_send_request_and_wait_response(
-                conn, target, target_value, PCRDR_OPERATION_WRITEEND, NULL,
-                element_type, NULL, NULL, data_type, data, 0);
-        purc_variant_unref(data);
-        if (response_msg == NULL) {
-            goto failed;
-        }
+static ssize_t
+rdr_page_writer_write(void *ctxt, const void *buf, size_t count)
+{
+    struct rdr_page_writer *writer = (struct rdr_page_writer *)ctxt;
+    const char *data = (const char *)buf;
+    size_t left = count;
+
+    if (writer->failed) {
+        return -1;
+    }
+
+    while (left > 0) {
+        size_t n = sizeof(writer->buff) - writer->len;
+        if (n > left)
+            n = left;
+
+        memcpy(writer->buff + writer->len, data, n);
+        writer->len += n;
+        data += n;
+        left -= n;
+
+        while (writer->len > DEF_LEN_ONE_WRITE) {
+            const char *end;
+            pcutils_string_check_utf8_len(writer->buff, DEF_LEN_ONE_WRITE,
+                    NULL, &end);
+            if (end == writer->buff) {
+                PC_WARN("no valid character for rdr\n");
+                writer->failed = true;
+                return -1;
+            }
 
-        if (response_msg->retCode != PCRDR_SC_OK) {
-            PC_ERROR("failed to write content to rdr\n");
-            goto failed;
+            if (rdr_page_writer_send(writer, writer->nr_chunks ?
+                        PCRDR_OPERATION_WRITEMORE : PCRDR_OPERATION_WRITEBEGIN,
+                        end - writer->buff)) {
+                writer->failed = true;
+                return -1;
+            }
         }
-        goto done;
     }
-    else {
-        // writeMore
-        start = doc_content + len_wrotten;
-        pcutils_string_check_utf8_len(start, DEF_LEN_ONE_WRITE, NULL, &end);
-        if (end > start) {
-            len_to_write = end - start;
-            len_wrotten += len_to_write;
-            data = purc_variant_make_string_static(start, false);
-        }
-        else {
-            PC_WARN("no valid character for rdr\n");
-            goto failed;
-        }
 
-        response_msg = pcintr_rdr_send_request_and_wait_response(
-                conn, target, target_value, PCRDR_OPERATION_WRITEMORE, NULL,
-                element_type, NULL, NULL, data_type, data, len_to_write);
-        purc_variant_unref(data);
-        if (response_msg == NULL) {
-            goto failed;
-        }
+    return count;
+}
 
-        if (response_msg->retCode != PCRDR_SC_OK) {
-            PC_ERROR("failed to write content to rdr\n");
-            goto failed;
-        }
+static pcrdr_msg *
+rdr_page_writer_finish(struct rdr_page_writer *writer)
+{
+    pcrdr_msg *response_msg = NULL;
+
+    if (writer->failed) {
+        goto done;
+    }
 
-        if (len_wrotten == len_content) {
+    if (writer->nr_chunks == 0) {
+        if (rdr_page_writer_send(writer, PCRDR_OPERATION_LOAD, writer->len))
+            goto done;
+    }
+    else {
+        if (rdr_page_writer_send(writer, PCRDR_OPERATION_WRITEEND,
+                    writer->len))
             goto done;
-        }
-        goto writting;
     }
 
+    response_msg = writer->response_msg;
+    writer->response_msg = NULL;
+
 done:
+    if (writer->response_msg) {
+        pcrdr_release_message(writer->response_msg);
+        writer->response_msg = NULL;
+    }
     return response_msg;
+}
 
-failed:
-    if (response_msg) {
-        pcrdr_release_message(response_msg);
+pcrdr_msg *
+pcintr_rdr_load_page_contents(struct pcrdr_conn *conn,
+        pcrdr_msg_target target, uint64_t target_value,
+        pcrdr_msg_data_type data_type, purc_document_t doc, unsigned opts)
+{
+    pcrdr_msg *response_msg = NULL;
+    purc_rwstream_t out = NULL;
+    struct rdr_page_writer *writer;
+
+    writer = calloc(1, sizeof(*writer));
+    if (writer == NULL) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        goto done;
     }
-    return NULL;
+
+    writer->conn = conn;
+    writer->target = target;
+    writer->target_value = target_value;
+    writer->data_type = data_type;
+
+    out = purc_rwstream_new_for_dump(writer, rdr_page_writer_write);
+    if (out == NULL) {
+        goto done;
+    }
+
+    if (0 != purc_document_serialize_contents_to_stream(doc, opts, out)) {
+        goto done;
+    }
+
+    response_msg = rdr_page_writer_finish(writer);
+
+done:
+    if (out) {
+        purc_rwstream_destroy(out);
+    }
+
+    if (writer) {
+        if (writer->response_msg)
+            pcrdr_release_message(writer->response_msg);
+        free(writer);
+    }
+
+    return response_msg;
 }
 
 bool
@@ -1076,7 +1154,6 @@ pcintr_rdr_page_control_load(pcintr_stack_t stack)
     const pcrdr_msg_element_type element_type = PCRDR_MSG_ELEMENT_TYPE_VOID;
     pcrdr_msg_data_type data_type = doc->def_text_type;// VW
     purc_variant_t req_data = PURC_VARIANT_INVALID;
-    purc_rwstream_t out = NULL;
 
     switch (stack->co->target_page_type) {
     case PCRDR_PAGE_TYPE_NULL:
@@ -1112,48 +1189,14 @@ pcintr_rdr_page_control_load(pcintr_stack_t stack)
     else {
         unsigned opt = 0;
 
-        out = purc_rwstream_new_buffer(BUFF_MIN, BUFF_MAX);
-        if (out == NULL) {
-            goto failed;
-        }
-
         opt |= PCDOC_SERIALIZE_OPT_UNDEF;
         opt |= PCDOC_SERIALIZE_OPT_SKIP_WS_NODES;
         opt |= PCDOC_SERIALIZE_OPT_WITHOUT_TEXT_INDENT;
         opt |= PCDOC_SERIALIZE_OPT_FULL_DOCTYPE;
         opt |= PCDOC_SERIALIZE_OPT_WITH_HVML_HANDLE;
 
-        if (0 != purc_document_serialize_contents_to_stream(doc, opt, out)) {
-            goto failed;
-        }
-
-        size_t sz_content = 0;
-        size_t sz_buff = 0;
-        char *p = (char*)purc_rwstream_get_mem_buffer_ex(out, &sz_content,
-                &sz_buff,true);
-        req_data = purc_variant_make_string_reuse_buff(p, sz_content, false);
-        if (req_data == PURC_VARIANT_INVALID) {
-            free(p);
-            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-            goto failed;
-        }
-
-        if (sz_content > DEF_LEN_ONE_WRITE) {
-            response_msg = rdr_page_control_load_large_page(inst->conn_to_rdr,
-                        target, target_value, data_type,
-                        p, sz_content);
-        }
-        else {
-            response_msg = pcintr_rdr_send_request_and_wait_response(
-                    inst->conn_to_rdr, target, target_value, operation, NULL,
-                    element_type, NULL, NULL, data_type, req_data, 0);
-        }
-        purc_variant_unref(req_data);
-
-        if (out) {
-            purc_rwstream_destroy(out);
-            out = NULL;
-        }
+        response_msg = pcintr_rdr_load_page_contents(inst->conn_to_rdr,
+                target, target_value, data_type, doc, opt);
     }
 
     if (response_msg == NULL) {
@@ -1175,10 +1218,6 @@ pcintr_rdr_page_control_load(pcintr_stack_t stack)
     return true;
 
 failed:
-    if (out) {
-        purc_rwstream_destroy(out);
-    }
-
     /* VW: double free here
     if (req_data != PURC_VARIANT_INVALID) {
         purc_variant_unref(req_data);
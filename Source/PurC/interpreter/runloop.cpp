@@ -188,6 +188,7 @@ pcrun_create_inst_thread(const char *app_name, const char *runner_name,
 
     RefPtr<Thread> inst_th =
         Thread::create("hvml-instance", [&] {
+                pcintr_profiler_block_signal();
                 int ret = purc_init_ex(PURC_MODULE_HVML,
                         app_name, runner_name, extra_info);
 
@@ -252,6 +253,7 @@ static void _runloop_init_main(void)
     PC_ASSERT(rid_main);
 
     _main_thread = Thread::create(MAIN_RUNLOOP_THREAD_NAME, [&] {
+            pcintr_profiler_block_signal();
             PC_ASSERT(RunLoop::isMainInitizlized() == false);
             RunLoop::initializeMain();
             RunLoop& runloop = RunLoop::main();
@@ -288,6 +290,7 @@ static void _runloop_init_main(void)
 
             runloop.run();
 
+            pcrun_instmgr_drop_spares(&info);
             pcutils_sorted_array_destroy(info.sa_insts);
 
             size_t n = purc_inst_destroy_move_buffer();
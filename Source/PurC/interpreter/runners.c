@@ -366,6 +366,152 @@ pcrun_notify_instmgr(const char* event_name, purc_atom_t inst_crtn_id)
     pcrdr_release_message(event);
 }
 
+static purc_cond_handler
+get_instance_params(purc_variant_t data, struct purc_instance_extra_info *info)
+{
+    purc_variant_t tmp;
+
+    purc_cond_handler cond_handler = NULL;
+    tmp = purc_variant_object_get_by_ckey(data, "condHandler");
+    if (tmp) {
+        uint64_t u64;
+        purc_variant_cast_to_ulongint(tmp, &u64, false);
+        cond_handler = (purc_cond_handler)(uintptr_t)u64;
+    }
+
+    tmp = purc_variant_object_get_by_ckey(data, "rendererProt");
+    if (tmp && purc_variant_is_ulongint(tmp)) {
+        uint64_t u64;
+        purc_variant_cast_to_ulongint(tmp, &u64, false);
+        info->renderer_comm = (purc_rdrcomm_t)u64;
+    }
+
+    tmp = purc_variant_object_get_by_ckey(data, "rendererURI");
+    if (tmp) {
+        info->renderer_uri = purc_variant_get_string_const(tmp);
+    }
+
+    tmp = purc_variant_object_get_by_ckey(data, "sslCert");
+    if (tmp) {
+        info->ssl_cert = purc_variant_get_string_const(tmp);
+    }
+
+    tmp = purc_variant_object_get_by_ckey(data, "sslKey");
+    if (tmp) {
+        info->ssl_key = purc_variant_get_string_const(tmp);
+    }
+
+    tmp = purc_variant_object_get_by_ckey(data, "workspaceName");
+    if (tmp) {
+        info->workspace_name = purc_variant_get_string_const(tmp);
+    }
+
+    tmp = purc_variant_object_get_by_ckey(data, "workspaceTitle");
+    if (tmp) {
+        info->workspace_title = purc_variant_get_string_const(tmp);
+    }
+
+    tmp = purc_variant_object_get_by_ckey(data, "workspaceLayout");
+    if (tmp) {
+        info->workspace_layout = purc_variant_get_string_const(tmp);
+    }
+
+    return cond_handler;
+}
+
+static void
+make_spare_name(struct instmgr_info *info, char *buf, size_t sz)
+{
+    snprintf(buf, sz, "%s%u", PURC_RUNNER_NAME_SPARE, info->spare_serial++);
+}
+
+/* Hands out a pre-warmed instance of the app; it is managed as the others
+   since now. */
+static purc_atom_t
+take_spare_instance(struct instmgr_info *info, const char *app_name)
+{
+    if (info->spare_app == NULL || strcmp(info->spare_app, app_name) ||
+            pcutils_sorted_array_count(info->sa_spares) == 0)
+        return 0;
+
+    void *th;
+    purc_atom_t atom = (purc_atom_t)(uintptr_t)
+        pcutils_sorted_array_get(info->sa_spares, 0, &th);
+    pcutils_sorted_array_delete(info->sa_spares, 0);
+
+    pcutils_sorted_array_add(info->sa_insts, (void *)(uintptr_t)atom, th, NULL);
+    info->nr_insts++;
+    return atom;
+}
+
+/* Creates one pre-warmed instance if the pool is short of. This is called
+   when the instance manager is idle, so the requests are not delayed. */
+static bool
+refill_spare_instances(struct instmgr_info *info)
+{
+    if (info->spare_app == NULL ||
+            pcutils_sorted_array_count(info->sa_spares) >=
+            info->nr_spares_wanted)
+        return false;
+
+    struct purc_instance_extra_info extra_info = {};
+    purc_cond_handler cond_handler =
+        get_instance_params(info->spare_params, &extra_info);
+
+    char runner_name[PURC_LEN_RUNNER_NAME + 1];
+    make_spare_name(info, runner_name, sizeof(runner_name));
+
+    void *th = NULL;
+    purc_atom_t atom = pcrun_create_inst_thread(info->spare_app, runner_name,
+            cond_handler, &extra_info, &th);
+    if (atom == 0) {
+        purc_log_warn("Failed to pre-warm an instance for %s\n",
+                info->spare_app);
+        /* do not try again and again */
+        info->nr_spares_wanted = pcutils_sorted_array_count(info->sa_spares);
+        return false;
+    }
+
+    pcutils_sorted_array_add(info->sa_spares, (void *)(uintptr_t)atom, th,
+            NULL);
+    return true;
+}
+
+void
+pcrun_instmgr_drop_spares(struct instmgr_info *info)
+{
+    if (info->sa_spares) {
+        size_t nr = pcutils_sorted_array_count(info->sa_spares);
+        for (size_t i = 0; i < nr; i++) {
+            void *th;
+            purc_atom_t atom = (purc_atom_t)(uintptr_t)
+                pcutils_sorted_array_get(info->sa_spares, i, &th);
+
+            pcrdr_msg *request_msg = pcrdr_make_request_message(
+                    PCRDR_MSG_TARGET_INSTANCE, atom,
+                    PCRUN_OPERATION_shutdownInstance,
+                    PCRDR_REQUESTID_NORETURN,
+                    purc_get_endpoint(NULL),
+                    PCRDR_MSG_ELEMENT_TYPE_VOID, NULL,
+                    NULL,
+                    PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+            purc_inst_move_message(atom, request_msg);
+            pcrdr_release_message(request_msg);
+            free(th);
+        }
+
+        pcutils_sorted_array_destroy(info->sa_spares);
+        info->sa_spares = NULL;
+    }
+
+    PURC_VARIANT_SAFE_CLEAR(info->spare_params);
+    if (info->spare_app) {
+        free(info->spare_app);
+        info->spare_app = NULL;
+    }
+    info->nr_spares_wanted = 0;
+}
+
 static void create_instance(struct instmgr_info *mgr_info,
         const pcrdr_msg *request, pcrdr_msg *response)
 {
@@ -395,61 +541,30 @@ static void create_instance(struct instmgr_info *mgr_info,
         return;
     }
 
+    purc_atom_t atom;
+    char spare_name[PURC_LEN_RUNNER_NAME + 1];
+    if (strcmp(runner_name, PURC_RUNNER_NAME_SPARE) == 0) {
+        atom = take_spare_instance(mgr_info, app_name);
+        if (atom) {
+            goto done;
+        }
+
+        /* no pre-warmed instance left; create one with a fresh name */
+        make_spare_name(mgr_info, spare_name, sizeof(spare_name));
+        runner_name = spare_name;
+    }
+
     purc_assemble_endpoint_name_ex(PCRDR_LOCALHOST,
             app_name, runner_name,
             endpoint_name, sizeof(endpoint_name) - 1);
-    purc_atom_t atom = purc_atom_try_string_ex(PURC_ATOM_BUCKET_DEF,
+    atom = purc_atom_try_string_ex(PURC_ATOM_BUCKET_DEF,
             endpoint_name);
     if (atom) {
         goto done;
     }
 
-    purc_cond_handler cond_handler = NULL;
-    tmp = purc_variant_object_get_by_ckey(request->data, "condHandler");
-    if (tmp) {
-        uint64_t u64;
-        purc_variant_cast_to_ulongint(tmp, &u64, false);
-        cond_handler = (purc_cond_handler)(uintptr_t)u64;
-    }
-
     struct purc_instance_extra_info info = {};
-
-    tmp = purc_variant_object_get_by_ckey(request->data, "rendererProt");
-    if (tmp && purc_variant_is_ulongint(tmp)) {
-        uint64_t u64;
-        purc_variant_cast_to_ulongint(tmp, &u64, false);
-        info.renderer_comm = (purc_rdrcomm_t)u64;
-    }
-
-    tmp = purc_variant_object_get_by_ckey(request->data, "rendererURI");
-    if (tmp) {
-        info.renderer_uri = purc_variant_get_string_const(tmp);
-    }
-
-    tmp = purc_variant_object_get_by_ckey(request->data, "sslCert");
-    if (tmp) {
-        info.ssl_cert = purc_variant_get_string_const(tmp);
-    }
-
-    tmp = purc_variant_object_get_by_ckey(request->data, "sslKey");
-    if (tmp) {
-        info.ssl_key = purc_variant_get_string_const(tmp);
-    }
-
-    tmp = purc_variant_object_get_by_ckey(request->data, "workspaceName");
-    if (tmp) {
-        info.workspace_name = purc_variant_get_string_const(tmp);
-    }
-
-    tmp = purc_variant_object_get_by_ckey(request->data, "workspaceTitle");
-    if (tmp) {
-        info.workspace_title = purc_variant_get_string_const(tmp);
-    }
-
-    tmp = purc_variant_object_get_by_ckey(request->data, "workspaceLayout");
-    if (tmp) {
-        info.workspace_layout = purc_variant_get_string_const(tmp);
-    }
+    purc_cond_handler cond_handler = get_instance_params(request->data, &info);
 
     void *th = NULL;
     atom = pcrun_create_inst_thread(app_name, runner_name, cond_handler,
@@ -618,6 +733,63 @@ static void kill_instance(struct instmgr_info *info,
     }
 }
 
+static void prewarm_instances(struct instmgr_info *info,
+        const pcrdr_msg *request, pcrdr_msg *response)
+{
+    if (!purc_variant_is_object(request->data)) {
+        return;
+    }
+
+    purc_variant_t tmp;
+
+    const char *app_name = NULL;
+    tmp = purc_variant_object_get_by_ckey(request->data, "appName");
+    if (tmp) {
+        app_name = purc_variant_get_string_const(tmp);
+    }
+
+    uint64_t nr_spares = 0;
+    tmp = purc_variant_object_get_by_ckey(request->data, "nrSpares");
+    if (tmp == PURC_VARIANT_INVALID ||
+            !purc_variant_cast_to_ulongint(tmp, &nr_spares, false)) {
+        return;
+    }
+
+    if (app_name == NULL || !purc_is_valid_app_name(app_name)) {
+        return;
+    }
+
+    response->type = PCRDR_MSG_TYPE_RESPONSE;
+    response->requestId = purc_variant_ref(request->requestId);
+    response->sourceURI = purc_variant_make_string(purc_get_endpoint(NULL),
+            false);
+    response->dataType = PCRDR_MSG_DATA_TYPE_VOID;
+    response->data = PURC_VARIANT_INVALID;
+
+    if (info->spare_app && strcmp(info->spare_app, app_name)) {
+        /* only one app can have the pre-warmed instances */
+        response->retCode = PCRDR_SC_CONFLICT;
+        response->resultValue = 0;
+        return;
+    }
+
+    if (info->spare_app == NULL) {
+        info->spare_app = strdup(app_name);
+        info->sa_spares = pcutils_sorted_array_create(SAFLAG_DEFAULT, 0,
+                NULL, NULL);
+    }
+
+    /* the new instances will use the latest parameters */
+    PURC_VARIANT_SAFE_CLEAR(info->spare_params);
+    info->spare_params = purc_variant_ref(request->data);
+    if (nr_spares > PCRUN_MAX_SPARES)
+        nr_spares = PCRUN_MAX_SPARES;
+    info->nr_spares_wanted = nr_spares;
+
+    response->retCode = PCRDR_SC_OK;
+    response->resultValue = nr_spares;
+}
+
 void pcrun_instmgr_handle_message(void *ctxt)
 {
     struct instmgr_info *info = ctxt;
@@ -629,6 +801,9 @@ void pcrun_instmgr_handle_message(void *ctxt)
         return;
     }
     else if (n == 0) {
+        if (refill_spare_instances(info))
+            return;
+
         // sleep 1ms to take a breath
         pcutils_usleep(1000);
         return;
@@ -666,6 +841,9 @@ void pcrun_instmgr_handle_message(void *ctxt)
         else if (strcmp(op, PCRUN_OPERATION_killInstance) == 0) {
             kill_instance(info, msg, response);
         }
+        else if (strcmp(op, PCRUN_OPERATION_prewarmInstances) == 0) {
+            prewarm_instances(info, msg, response);
+        }
         else {
             purc_log_warn("InstMgr got an unknown `%s` request from %s\n",
                     op, source_uri);
@@ -703,7 +881,19 @@ void pcrun_instmgr_handle_message(void *ctxt)
             uint64_t sid;
             purc_variant_cast_to_ulongint(msg->elementValue, &sid, false);
 
-            if (pcutils_sorted_array_find(info->sa_insts,
+            void *th;
+            ssize_t idx;
+            if (info->sa_spares && pcutils_sorted_array_find(info->sa_spares,
+                        (void *)(uintptr_t)sid, &th, &idx)) {
+                /* a pre-warmed instance exited before being handed out;
+                   forget it, or it would be handed out as a dead one */
+                pcutils_sorted_array_delete(info->sa_spares, idx);
+                free(th);
+
+                PC_DEBUG("InstMgr removes record of spare instance %u\n",
+                        (unsigned)sid);
+            }
+            else if (pcutils_sorted_array_find(info->sa_insts,
                         (void *)(uintptr_t)sid, NULL, NULL)) {
                 pcutils_sorted_array_remove(info->sa_insts,
                         (void *)(uintptr_t)sid);
@@ -713,6 +903,8 @@ void pcrun_instmgr_handle_message(void *ctxt)
                         (unsigned)sid, (unsigned)info->nr_insts);
 
                 if (info->nr_insts == 0) {
+                    pcrun_instmgr_drop_spares(info);
+
                     PC_DEBUG("InstMgr askes the main runner (%u) to shutdown...\n",
                             info->rid_main);
 
@@ -750,53 +942,33 @@ void pcrun_instmgr_handle_message(void *ctxt)
 }
 
 
-purc_atom_t
-purc_inst_create_or_get(const char *app_name, const char *runner_name,
-        purc_cond_handler cond_handler,
-        const purc_instance_extra_info* extra_info)
+/* The strings are copied if the instance manager keeps the data after
+   responding; otherwise static string variants are enough because the
+   request is synchronous. */
+static inline purc_variant_t
+make_string(const char *str, bool keep)
 {
-    char endpoint_name[PURC_LEN_ENDPOINT_NAME + 1];
-
-    if (!purc_is_valid_app_name(app_name) ||
-            !purc_is_valid_runner_name(runner_name)) {
-        purc_set_error(PURC_ERROR_INVALID_VALUE);
-        return 0;
-    }
-
-    purc_assemble_endpoint_name_ex(PCRDR_LOCALHOST,
-            app_name, runner_name,
-            endpoint_name, sizeof(endpoint_name) - 1);
-    purc_atom_t atom = purc_atom_try_string_ex(PURC_ATOM_BUCKET_DEF,
-            endpoint_name);
-    if (atom != 0) {
-        /* TODO: change the condition handler for an exisiting runner? */
-        return atom;
-    }
-
-    atom = purc_get_instmgr_rid();
-    if (atom == 0) {
-        purc_set_error(PURC_ERROR_NO_INSTANCE);
-        return 0;
-    }
-
-    pcrdr_msg *request;
-    request = pcrdr_make_request_message(
-            PCRDR_MSG_TARGET_INSTANCE, atom,
-            PCRUN_OPERATION_createInstance, NULL, purc_get_endpoint(NULL),
-            PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
-            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+    return keep ? purc_variant_make_string(str, false) :
+        purc_variant_make_string_static(str, false);
+}
 
+static purc_variant_t
+make_instance_data(const char *app_name, const char *runner_name,
+        purc_cond_handler cond_handler,
+        const purc_instance_extra_info* extra_info, bool keep)
+{
     purc_variant_t data, tmp;
     data = purc_variant_make_object_0();
 
-    /* here we make static string variant because this is a sync request */
-    tmp = purc_variant_make_string_static(app_name, false);
+    tmp = make_string(app_name, keep);
     purc_variant_object_set_by_static_ckey(data, "appName", tmp);
     purc_variant_unref(tmp);
 
-    tmp = purc_variant_make_string_static(runner_name, false);
-    purc_variant_object_set_by_static_ckey(data, "runnerName", tmp);
-    purc_variant_unref(tmp);
+    if (runner_name) {
+        tmp = make_string(runner_name, keep);
+        purc_variant_object_set_by_static_ckey(data, "runnerName", tmp);
+        purc_variant_unref(tmp);
+    }
 
     if (cond_handler) {
         tmp = purc_variant_make_ulongint((uint64_t)(uintptr_t)cond_handler);
@@ -810,48 +982,84 @@ purc_inst_create_or_get(const char *app_name, const char *runner_name,
         purc_variant_unref(tmp);
 
         if (extra_info->renderer_uri) {
-            tmp = purc_variant_make_string_static(extra_info->renderer_uri,
-                    false);
+            tmp = make_string(extra_info->renderer_uri, keep);
             purc_variant_object_set_by_static_ckey(data, "rendererURI", tmp);
             purc_variant_unref(tmp);
         }
 
         if (extra_info->ssl_cert) {
-            tmp = purc_variant_make_string_static(extra_info->ssl_cert,
-                    false);
+            tmp = make_string(extra_info->ssl_cert, keep);
             purc_variant_object_set_by_static_ckey(data, "sslCert", tmp);
             purc_variant_unref(tmp);
         }
 
         if (extra_info->ssl_key) {
-            tmp = purc_variant_make_string_static(extra_info->ssl_key,
-                    false);
+            tmp = make_string(extra_info->ssl_key, keep);
             purc_variant_object_set_by_static_ckey(data, "sslKey", tmp);
             purc_variant_unref(tmp);
         }
 
         if (extra_info->workspace_name) {
-            tmp = purc_variant_make_string_static(extra_info->workspace_name,
-                    false);
+            tmp = make_string(extra_info->workspace_name, keep);
             purc_variant_object_set_by_static_ckey(data, "workspaceName", tmp);
             purc_variant_unref(tmp);
         }
 
         if (extra_info->workspace_title) {
-            tmp = purc_variant_make_string_static(extra_info->workspace_title,
-                    false);
+            tmp = make_string(extra_info->workspace_title, keep);
             purc_variant_object_set_by_static_ckey(data, "workspaceTitle", tmp);
             purc_variant_unref(tmp);
         }
 
         if (extra_info->workspace_layout) {
-            tmp = purc_variant_make_string_static(extra_info->workspace_layout,
-                    false);
+            tmp = make_string(extra_info->workspace_layout, keep);
             purc_variant_object_set_by_static_ckey(data, "workspaceLayout", tmp);
             purc_variant_unref(tmp);
         }
     }
 
+    return data;
+}
+
+purc_atom_t
+purc_inst_create_or_get(const char *app_name, const char *runner_name,
+        purc_cond_handler cond_handler,
+        const purc_instance_extra_info* extra_info)
+{
+    char endpoint_name[PURC_LEN_ENDPOINT_NAME + 1];
+
+    if (!purc_is_valid_app_name(app_name) ||
+            !purc_is_valid_runner_name(runner_name)) {
+        purc_set_error(PURC_ERROR_INVALID_VALUE);
+        return 0;
+    }
+
+    purc_assemble_endpoint_name_ex(PCRDR_LOCALHOST,
+            app_name, runner_name,
+            endpoint_name, sizeof(endpoint_name) - 1);
+    purc_atom_t atom = purc_atom_try_string_ex(PURC_ATOM_BUCKET_DEF,
+            endpoint_name);
+    if (atom != 0) {
+        /* TODO: change the condition handler for an exisiting runner? */
+        return atom;
+    }
+
+    atom = purc_get_instmgr_rid();
+    if (atom == 0) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return 0;
+    }
+
+    pcrdr_msg *request;
+    request = pcrdr_make_request_message(
+            PCRDR_MSG_TARGET_INSTANCE, atom,
+            PCRUN_OPERATION_createInstance, NULL, purc_get_endpoint(NULL),
+            PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
+            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+
+    purc_variant_t data = make_instance_data(app_name, runner_name,
+            cond_handler, extra_info, false);
+
     purc_variant_t request_id = purc_variant_ref(request->requestId);
 
     request->dataType = PCRDR_MSG_DATA_TYPE_JSON;
@@ -889,6 +1097,77 @@ purc_inst_create_or_get(const char *app_name, const char *runner_name,
     return atom;
 }
 
+ssize_t
+purc_inst_prewarm(const char *app_name, size_t nr_spares,
+        purc_cond_handler cond_handler,
+        const purc_instance_extra_info* extra_info)
+{
+    if (!purc_is_valid_app_name(app_name)) {
+        purc_set_error(PURC_ERROR_INVALID_VALUE);
+        return -1;
+    }
+
+    purc_atom_t atom = purc_get_instmgr_rid();
+    if (atom == 0) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return -1;
+    }
+
+    pcrdr_msg *request;
+    request = pcrdr_make_request_message(
+            PCRDR_MSG_TARGET_INSTANCE, atom,
+            PCRUN_OPERATION_prewarmInstances, NULL, purc_get_endpoint(NULL),
+            PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
+            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+
+    /* the instance manager keeps the data to create the instances later */
+    purc_variant_t data = make_instance_data(app_name, NULL,
+            cond_handler, extra_info, true);
+    purc_variant_t tmp = purc_variant_make_ulongint((uint64_t)nr_spares);
+    purc_variant_object_set_by_static_ckey(data, "nrSpares", tmp);
+    purc_variant_unref(tmp);
+
+    purc_variant_t request_id = purc_variant_ref(request->requestId);
+
+    request->dataType = PCRDR_MSG_DATA_TYPE_JSON;
+    request->data = data;
+    size_t n = purc_inst_move_message(atom, request);
+    pcrdr_release_message(request);
+    if (n == 0) {
+        purc_variant_unref(request_id);
+        purc_log_warn("Failed to send request message\n");
+        return -1;
+    }
+
+    struct pcrdr_conn *conn = purc_get_conn_to_renderer();
+    assert(conn);
+
+    ssize_t retv = -1;
+    pcrdr_msg *response = NULL;
+    int ret = pcrdr_wait_response_for_specific_request(conn,
+            request_id, PCRUN_TIMEOUT_DEF, &response);
+    purc_variant_unref(request_id);
+
+    if (ret) {
+        purc_log_error("Failed to wait response: %s\n",
+               purc_get_error_message(purc_get_last_error()));
+    }
+    else if (response->retCode == PCRDR_SC_CONFLICT) {
+        purc_set_error(PURC_ERROR_CONFLICT);
+    }
+    else if (response->retCode != PCRDR_SC_OK) {
+        purc_log_error("Failed to pre-warm instances: %d\n",
+                response->retCode);
+    }
+    else {
+        retv = (ssize_t)response->resultValue;
+    }
+
+    if (response)
+        pcrdr_release_message(response);
+    return retv;
+}
+
 purc_atom_t
 purc_inst_schedule_vdom(purc_atom_t inst, purc_vdom_t vdom,
         purc_atom_t curator, purc_variant_t request,
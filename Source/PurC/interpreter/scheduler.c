@@ -35,6 +35,8 @@
 #include "private/variant.h"
 #include "private/ports.h"
 #include "private/msg-queue.h"
+#include "private/stats.h"
+#include "private/runners.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -531,35 +533,57 @@ execute_one_step(struct pcinst *inst)
     pcutils_array_destroy(cos, true);
 
 
+    size_t nr_ready = 0;
     crtns = &heap->crtns;
     list_for_each_entry_safe(p, q, crtns, ln) {
         pcintr_coroutine_t co = p;
         if (co->state != CO_STATE_READY) {
             continue;
         }
+        nr_ready++;
 
 #if 1
         struct timespec begin;
         clock_gettime(CLOCK_MONOTONIC, &begin);
+        uint64_t cpu_begin = pcinst_stats_cpu_ns();
+        uint64_t nr_steps = 0;
         struct pcintr_stack_frame *frame;
         while (co->state == CO_STATE_READY) {
             frame = pcintr_stack_get_bottom_frame(&co->stack);
             bool must_yield = frame ? frame->must_yield : false;
+            pcvdom_element_t pos = frame ? frame->pos : NULL;
             execute_one_step_for_ready_co(inst, co);
+            nr_steps++;
+            if (heap->profiler) {
+                pcintr_profiler_take_samples(heap->profiler, co, pos);
+            }
             if (must_yield) {
                 break;
             }
             double diff = purc_get_elapsed_seconds(&begin, NULL);
             if (diff > TIME_SLIECE) {
+                pcinst_stats_add(inst, PCINST_STATS_SCHED_PREEMPTIONS, 1);
                 break;
             }
         }
+
+        co->cpu_time += pcinst_stats_cpu_ns() - cpu_begin;
+        co->nr_steps += nr_steps;
+        co->nr_slices++;
+        pcinst_stats_add(inst, PCINST_STATS_SCHED_STEPS, nr_steps);
+        pcinst_stats_add(inst, PCINST_STATS_SCHED_SLICES, 1);
 #else
             execute_one_step_for_ready_co(inst, co);
 #endif
         busy = true;
     }
 
+    if (heap->worker) {
+        pcrun_worker_set_load(heap->worker, nr_ready,
+                heap->nr_arrived_crtns);
+        heap->nr_arrived_crtns = 0;
+    }
+
     return busy;
 }
 
@@ -629,6 +653,9 @@ handle_coroutine_event(pcintr_coroutine_t co)
     }
 
     pcrdr_msg *msg = pcinst_msg_queue_get_msg(co->mq);
+    if (msg && co->owner) {
+        pcinst_stats_add(co->owner->owner, PCINST_STATS_MSGS_DISPATCHED, 1);
+    }
 
     if (msg && msg->eventName) {
         const char *event = purc_variant_get_string_const(msg->eventName);
@@ -769,6 +796,7 @@ pcintr_schedule(void *ctxt)
     }
 
 again:
+    pcinst_stats_add(inst, PCINST_STATS_SCHED_ROUNDS, 1);
 
     // 1. exec one step for all ready coroutines and
     // return whether step is busy
@@ -776,6 +804,9 @@ again:
 
     // 2. dispatch event for observing / stopped coroutines
     event_is_busy = dispatch_event(inst);
+    if (heap->profiler) {
+        pcintr_profiler_take_samples(heap->profiler, NULL, NULL);
+    }
 
     // 3. its busy, goto next scheduler without sleep
     if (step_is_busy || event_is_busy) {
@@ -791,6 +822,7 @@ again:
     }
 
 out_sleep:
+    pcinst_stats_add(inst, PCINST_STATS_SCHED_IDLE_SLEEPS, 1);
     pcutils_usleep(SCHEDULE_SLEEP);
 
     return;
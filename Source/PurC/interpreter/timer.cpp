@@ -31,6 +31,7 @@
 #include "private/errors.h"
 #include "private/timer.h"
 #include "private/interpreter.h"
+#include "private/hashtable.h"
 #include "purc-runloop.h"
 
 #include <wtf/RunLoop.h>
@@ -38,22 +39,28 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
-class Timer : public PurCWTF::RunLoop::TimerBase {
+#define WHEEL_TICK_MS               1
+#define WHEEL_BITS                  6
+#define WHEEL_SIZE                  (1 << WHEEL_BITS)
+#define WHEEL_MASK                  (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS                5
+#define WHEEL_MAX_TICKS             ((1ULL << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+
+class PcTimer {
     public:
-        Timer(const char *id, pcintr_timer_fire_func func, RunLoop& runLoop,
-                void *data)
-            : TimerBase(runLoop)
-            , m_id(NULL)
+        PcTimer(const char *id, pcintr_timer_fire_func func, void *data)
+            : m_id(NULL)
             , m_func(func)
             , m_data(data)
+            , m_interval(0)
         {
             m_id = id ? strdup(id) : NULL;
         }
 
-        ~Timer()
+        virtual ~PcTimer()
         {
-            stop();
             if (m_id) {
                 free(m_id);
             }
@@ -64,13 +71,15 @@ class Timer : public PurCWTF::RunLoop::TimerBase {
         const char *getId() { return m_id; }
         void *getData() { return m_data; }
 
-        virtual void fired()
+        virtual void start(bool repeat) = 0;
+        virtual void stop() = 0;
+        virtual bool isActive() = 0;
+
+        void fire()
         {
             m_func(this, m_id, m_data);
         }
 
-        virtual void processed(void) {}
-
     private:
         char *m_id;
         pcintr_timer_fire_func m_func;
@@ -78,12 +87,438 @@ class Timer : public PurCWTF::RunLoop::TimerBase {
         uint32_t m_interval;
 };
 
+/* The timer driven by its own runloop timer source. */
+class Timer : public PcTimer, public PurCWTF::RunLoop::TimerBase {
+    public:
+        Timer(const char *id, pcintr_timer_fire_func func, RunLoop& runLoop,
+                void *data)
+            : PcTimer(id, func, data)
+            , TimerBase(runLoop)
+        {
+        }
+
+        ~Timer()
+        {
+            stop();
+        }
+
+        void start(bool repeat) override
+        {
+            Seconds interval = Seconds::fromMilliseconds(getInterval());
+            if (repeat) {
+                startRepeating(interval);
+            }
+            else {
+                startOneShot(interval);
+            }
+        }
+
+        void stop() override { TimerBase::stop(); }
+        bool isActive() override { return TimerBase::isActive(); }
+
+        virtual void fired() override
+        {
+            fire();
+        }
+};
+
+class TimerWheel;
+class WheelTimer;
+
+struct wheel_entry {
+    struct list_head    node;
+    uint64_t            expires;    // in ticks
+    WheelTimer         *timer;
+    int                 level;      // the slot the entry was placed in
+    unsigned            index;
+};
+
+/* The timer living in a slot of a timer wheel. */
+class WheelTimer : public PcTimer {
+    public:
+        WheelTimer(const char *id, pcintr_timer_fire_func func,
+                TimerWheel *wheel, void *data)
+            : PcTimer(id, func, data)
+            , m_wheel(wheel)
+            , m_repeat(false)
+        {
+            list_head_init(&m_entry.node);
+            m_entry.expires = 0;
+            m_entry.timer = this;
+            m_entry.level = 0;
+            m_entry.index = 0;
+        }
+
+        ~WheelTimer()
+        {
+            stop();
+        }
+
+        void start(bool repeat) override;
+        void stop() override;
+        bool isActive() override { return !list_empty(&m_entry.node); }
+
+    private:
+        friend class TimerWheel;
+
+        TimerWheel *m_wheel;
+        struct wheel_entry m_entry;
+        bool m_repeat;
+};
+
+/*
+ * A hierarchical timing wheel: WHEEL_LEVELS levels of WHEEL_SIZE slots,
+ * each level WHEEL_SIZE times coarser than the one below it. Adding and
+ * removing a timer are O(1) list operations; timers of the higher levels
+ * are cascaded down when the lower level wraps around.
+ *
+ * A bitmap per level tells the slots which are not empty, so the wheel
+ * jumps from one tick having something to do to the next one instead of
+ * stepping over the empty ticks, however long it slept.
+ *
+ * The whole wheel is driven by a single one-shot runloop timer armed for
+ * the next tick which has something to do, and all the timers expiring
+ * in the ticks processed by one wakeup are fired in one batch, so their
+ * events are handled by a single scheduler pass.
+ */
+class TimerWheel : public PurCWTF::RunLoop::TimerBase {
+    public:
+        TimerWheel(RunLoop& runLoop)
+            : TimerBase(runLoop)
+            , m_current(nowTick())
+            , m_armed(UINT64_MAX)
+            , m_count(0)
+        {
+            for (int l = 0; l < WHEEL_LEVELS; l++) {
+                for (int i = 0; i < WHEEL_SIZE; i++) {
+                    list_head_init(&m_slots[l][i]);
+                }
+                m_occupied[l] = 0;
+            }
+            list_head_init(&m_expired);
+        }
+
+        ~TimerWheel()
+        {
+            TimerBase::stop();
+
+            // detach the timers still in the wheel
+            for (int l = 0; l < WHEEL_LEVELS; l++) {
+                for (int i = 0; i < WHEEL_SIZE; i++) {
+                    struct wheel_entry *p, *n;
+                    list_for_each_entry_safe(p, n, &m_slots[l][i], node) {
+                        list_del_init(&p->node);
+                        p->timer->m_wheel = NULL;
+                    }
+                }
+            }
+
+            struct wheel_entry *p, *n;
+            list_for_each_entry_safe(p, n, &m_expired, node) {
+                list_del_init(&p->node);
+                p->timer->m_wheel = NULL;
+            }
+        }
+
+        size_t count() { return m_count; }
+
+        void add(WheelTimer *timer)
+        {
+            if (timer->isActive()) {
+                remove(timer);
+            }
+
+            // catch up with the clock before placing the timer; the timers
+            // expired meanwhile are fired by the next wakeup.
+            uint64_t now = nowTick();
+            advance(now, &m_expired);
+            if (!list_empty(&m_expired) && now < m_armed) {
+                arm(now);
+            }
+
+            struct wheel_entry *entry = &timer->m_entry;
+            uint64_t ticks = timer->getInterval() / WHEEL_TICK_MS;
+            entry->expires = now + (ticks ? ticks : 1);
+            place(entry);
+            m_count++;
+
+            if (entry->expires < m_armed) {
+                arm(entry->expires);
+            }
+        }
+
+        void remove(WheelTimer *timer)
+        {
+            if (!timer->isActive()) {
+                return;
+            }
+
+            struct wheel_entry *entry = &timer->m_entry;
+            list_del_init(&entry->node);
+            if (list_empty(&m_slots[entry->level][entry->index])) {
+                m_occupied[entry->level] &= ~(1ULL << entry->index);
+            }
+
+            m_count--;
+            if (m_count == 0) {
+                TimerBase::stop();
+                m_armed = UINT64_MAX;
+            }
+        }
+
+        virtual void fired() override
+        {
+            struct list_head expired;
+            list_head_init(&expired);
+
+            m_armed = UINT64_MAX;
+            list_splice_tail_init(&m_expired, &expired);
+            advance(nowTick(), &expired);
+
+            while (!list_empty(&expired)) {
+                struct wheel_entry *entry = list_first_entry(&expired,
+                        struct wheel_entry, node);
+                WheelTimer *timer = entry->timer;
+                list_del_init(&entry->node);
+                m_count--;
+
+                if (timer->m_repeat) {
+                    add(timer);
+                }
+
+                // the callback may stop or destroy any expired timer;
+                // they are all unlinked safely by remove().
+                timer->fire();
+            }
+
+            reschedule();
+        }
+
+    private:
+        static uint64_t nowTick()
+        {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return (ts.tv_sec * 1000 + ts.tv_nsec / 1000000) / WHEEL_TICK_MS;
+        }
+
+        void place(struct wheel_entry *entry)
+        {
+            uint64_t expires = entry->expires;
+            int level = 0;
+            unsigned index;
+
+            if (expires < m_current) {
+                index = m_current & WHEEL_MASK;
+            }
+            else {
+                uint64_t delta = expires - m_current;
+                if (delta > WHEEL_MAX_TICKS) {
+                    // beyond the range; it will be re-placed when cascaded.
+                    delta = WHEEL_MAX_TICKS;
+                    expires = m_current + delta;
+                }
+
+                while (level < WHEEL_LEVELS - 1 &&
+                        delta >= (1ULL << (WHEEL_BITS * (level + 1)))) {
+                    level++;
+                }
+
+                index = (expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+            }
+
+            entry->level = level;
+            entry->index = index;
+            list_add_tail(&entry->node, &m_slots[level][index]);
+            m_occupied[level] |= 1ULL << index;
+        }
+
+        void take(int level, unsigned index, struct list_head *list)
+        {
+            list_splice_tail_init(&m_slots[level][index], list);
+            m_occupied[level] &= ~(1ULL << index);
+        }
+
+        void cascade(int level, unsigned index)
+        {
+            struct list_head tmp;
+            list_head_init(&tmp);
+            take(level, index, &tmp);
+
+            struct wheel_entry *p, *n;
+            list_for_each_entry_safe(p, n, &tmp, node) {
+                list_del_init(&p->node);
+                place(p);
+            }
+        }
+
+        /* Processes the ticks till now, skipping the ones without anything
+           to expire or to cascade. */
+        void advance(uint64_t now, struct list_head *expired)
+        {
+            while (m_current <= now) {
+                uint64_t next = nextEventTick();
+                if (next > now) {
+                    m_current = now + 1;
+                    break;
+                }
+                m_current = next;
+
+                unsigned index = m_current & WHEEL_MASK;
+                if (index == 0) {
+                    for (int l = 1; l < WHEEL_LEVELS; l++) {
+                        unsigned i = (m_current >> (WHEEL_BITS * l)) &
+                            WHEEL_MASK;
+                        cascade(l, i);
+                        if (i) {
+                            break;
+                        }
+                    }
+                }
+
+                take(0, index, expired);
+                m_current++;
+            }
+        }
+
+        /* Returns the distance from the slot at index to the first slot
+           not empty in the bitmap, looking forward circularly. */
+        static unsigned firstOccupied(uint64_t bitmap, unsigned index)
+        {
+            uint64_t rotated = (bitmap >> index) |
+                (index ? (bitmap << (WHEEL_SIZE - index)) : 0);
+            return __builtin_ctzll(rotated);
+        }
+
+        /* Returns the next tick at which a slot expires or is cascaded. */
+        uint64_t nextEventTick()
+        {
+            uint64_t next = UINT64_MAX;
+
+            if (m_occupied[0]) {
+                next = m_current +
+                    firstOccupied(m_occupied[0], m_current & WHEEL_MASK);
+            }
+
+            for (int l = 1; l < WHEEL_LEVELS; l++) {
+                if (m_occupied[l] == 0) {
+                    continue;
+                }
+
+                // the slot of the current tick has been cascaded already
+                // unless the tick is the first one of the slot.
+                unsigned shift = WHEEL_BITS * l;
+                uint64_t base = m_current >> shift;
+                if ((base << shift) < m_current) {
+                    base++;
+                }
+
+                uint64_t tick = (base + firstOccupied(m_occupied[l],
+                            base & WHEEL_MASK)) << shift;
+                if (tick < next) {
+                    next = tick;
+                }
+            }
+
+            return next;
+        }
+
+        void arm(uint64_t tick)
+        {
+            uint64_t now = nowTick();
+            uint64_t delay = (tick > now) ? (tick - now) * WHEEL_TICK_MS : 0;
+
+            m_armed = tick;
+            startOneShot(Seconds::fromMilliseconds(delay));
+        }
+
+        void reschedule()
+        {
+            if (m_count == 0) {
+                TimerBase::stop();
+                m_armed = UINT64_MAX;
+                return;
+            }
+
+            uint64_t next = list_empty(&m_expired) ? nextEventTick() : 0;
+            if (next != m_armed || !TimerBase::isActive()) {
+                arm(next);
+            }
+        }
+
+        struct list_head m_slots[WHEEL_LEVELS][WHEEL_SIZE];
+        uint64_t m_occupied[WHEEL_LEVELS];  // the slots not empty
+        struct list_head m_expired; // expired, to be fired by the next wakeup
+        uint64_t m_current;         // the next tick to process
+        uint64_t m_armed;           // the tick the driver is armed for
+        size_t m_count;
+};
+
+void WheelTimer::start(bool repeat)
+{
+    if (m_wheel) {
+        m_repeat = repeat;
+        m_wheel->add(this);
+    }
+}
+
+void WheelTimer::stop()
+{
+    if (m_wheel) {
+        m_wheel->remove(this);
+    }
+}
+
+pcintr_timer_wheel_t
+pcintr_timer_wheel_create(purc_runloop_t runloop)
+{
+    RunLoop* loop = runloop ? (RunLoop*)runloop : &RunLoop::current();
+    TimerWheel* wheel = new TimerWheel(*loop);
+    if (!wheel) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    return wheel;
+}
+
+size_t
+pcintr_timer_wheel_count(pcintr_timer_wheel_t wheel)
+{
+    return wheel ? ((TimerWheel*)wheel)->count() : 0;
+}
+
+void
+pcintr_timer_wheel_destroy(pcintr_timer_wheel_t wheel)
+{
+    if (wheel) {
+        TimerWheel* tw = (TimerWheel*)wheel;
+        delete tw;
+    }
+}
+
 pcintr_timer_t
 pcintr_timer_create(purc_runloop_t runloop, const char* id,
         pcintr_timer_fire_func func, void *data)
 {
     RunLoop* loop = runloop ? (RunLoop*)runloop : &RunLoop::current();
-    Timer* timer = new Timer(id, func, *loop, data);
+    PcTimer* timer = new Timer(id, func, *loop, data);
+    if (!timer) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    return timer;
+}
+
+pcintr_timer_t
+pcintr_timer_create_in_wheel(pcintr_timer_wheel_t wheel, const char* id,
+        pcintr_timer_fire_func func, void *data)
+{
+    if (!wheel) {
+        purc_set_error(PURC_ERROR_INVALID_VALUE);
+        return NULL;
+    }
+
+    PcTimer* timer = new WheelTimer(id, func, (TimerWheel*)wheel, data);
     if (!timer) {
         purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
         return NULL;
@@ -95,7 +530,7 @@ void
 pcintr_timer_set_interval(pcintr_timer_t timer, uint32_t interval)
 {
     if (timer) {
-        ((Timer*)timer)->setInterval(interval);
+        ((PcTimer*)timer)->setInterval(interval);
     }
 }
 
@@ -103,7 +538,7 @@ uint32_t
 pcintr_timer_get_interval(pcintr_timer_t timer)
 {
     if (timer) {
-        return ((Timer*)timer)->getInterval();
+        return ((PcTimer*)timer)->getInterval();
     }
     return 0;
 }
@@ -112,9 +547,7 @@ void
 pcintr_timer_start(pcintr_timer_t timer)
 {
     if (timer) {
-        Timer* tm = (Timer*)timer;
-        tm->startRepeating(
-                PurCWTF::Seconds::fromMilliseconds(tm->getInterval()));
+        ((PcTimer*)timer)->start(true);
     }
 }
 
@@ -122,9 +555,7 @@ void
 pcintr_timer_start_oneshot(pcintr_timer_t timer)
 {
     if (timer) {
-        Timer* tm = (Timer*)timer;
-        tm->startOneShot(
-                PurCWTF::Seconds::fromMilliseconds(tm->getInterval()));
+        ((PcTimer*)timer)->start(false);
     }
 }
 
@@ -132,21 +563,21 @@ void
 pcintr_timer_stop(pcintr_timer_t timer)
 {
     if (timer) {
-        ((Timer*)timer)->stop();
+        ((PcTimer*)timer)->stop();
     }
 }
 
 bool
 pcintr_timer_is_active(pcintr_timer_t timer)
 {
-    return timer ? ((Timer*)timer)->isActive() : false;
+    return timer ? ((PcTimer*)timer)->isActive() : false;
 }
 
 void
 pcintr_timer_destroy(pcintr_timer_t timer)
 {
     if (timer) {
-        Timer* tm = (Timer*)timer;
+        PcTimer* tm = (PcTimer*)timer;
         delete tm;
     }
 }
@@ -160,60 +591,39 @@ pcintr_timer_destroy(pcintr_timer_t timer)
 #define TIMERS_STR_TIMERS           "TIMERS"
 #define TIMERS_STR_EXPIRED          "expired"
 
+/* The inner timer of a member of $TIMERS, and the listener watching the
+   changes of the member object. */
+struct inner_timer {
+    pcintr_timer_t          timer;
+    purc_variant_t          obj;
+    struct pcvar_listener  *listener;
+};
+
 struct pcintr_timers {
     purc_variant_t timers_var;
     struct pcvar_listener* timer_listener;
-    pcutils_map* timers_map; // id : pcintr_timer_t
-    pcutils_map* listener_map; // variant : struct pcvar_listener
+    /* id : struct inner_timer; the key is the id kept by the timer */
+    struct pchash_table* timers_map;
 };
 
-int
-listener_map_comp_by_key(const void *key1, const void *key2)
-{
-    uintptr_t k1 = (uintptr_t)key1;
-    uintptr_t k2 = (uintptr_t)key2;
-    return k1 - k2;
-}
-
-int
-listener_map_set_listener(pcutils_map *map, purc_variant_t obj,
-        struct pcvar_listener *listener)
-{
-    pcutils_map_entry *entry = pcutils_map_find(map, obj);
-    if (entry) {
-        return -1;
-    }
-
-    return pcutils_map_insert(map, obj, listener);
-}
-
-void
-listener_map_remove_listener(pcutils_map *map, purc_variant_t obj)
+static void
+unwatch_timer_object(struct inner_timer *inner)
 {
-    pcutils_map_entry *entry = pcutils_map_find(map, obj);
-    if (entry == NULL) {
-        return;
+    if (inner->listener) {
+        purc_variant_revoke_listener(inner->obj, inner->listener);
+        inner->listener = NULL;
+        inner->obj = PURC_VARIANT_INVALID;
     }
-
-    struct pcvar_listener *listener = (struct pcvar_listener*)(entry->val);
-
-    pcutils_map_erase(map, obj);
-
-    purc_variant_revoke_listener(obj, listener);
 }
 
-
-
-static void* map_copy_val(const void* val)
+static void
+free_inner_timer(struct pchash_entry *e)
 {
-    return (void*)val;
-}
+    struct inner_timer *inner = (struct inner_timer *)pchash_entry_v(e);
 
-static void map_free_val(void* val)
-{
-    if (val) {
-        pcintr_timer_destroy((pcintr_timer_t)val);
-    }
+    unwatch_timer_object(inner);
+    pcintr_timer_destroy(inner->timer);
+    free(inner);
 }
 
 static void timer_fire_func(pcintr_timer_t timer, const char *id, void *data)
@@ -241,74 +651,81 @@ is_euqal(purc_variant_t var, const char* comp)
     return false;
 }
 
-pcintr_timer_t
-find_timer(struct pcintr_timers* timers, const char* id)
+static const char *
+get_timer_id(purc_variant_t timer_var)
 {
-    pcutils_map_entry* entry = pcutils_map_find(timers->timers_map, id);
-    return entry ? (pcintr_timer_t) entry->val : NULL;
-}
-
-bool
-add_timer(struct pcintr_timers* timers, const char* id, pcintr_timer_t timer)
-{
-    int r;
-    r = pcutils_map_find_replace_or_insert(timers->timers_map, id, timer, NULL);
-    if (0 == r) {
-        return true;
+    purc_variant_t id = purc_variant_object_get_by_ckey(timer_var,
+            TIMERS_STR_ID);
+    if (!id) {
+        purc_set_error(PURC_ERROR_INVALID_VALUE);
+        return NULL;
     }
-    return false;
+
+    return purc_variant_get_string_const(id);
 }
 
-void
-remove_timer(struct pcintr_timers* timers, const char* id)
+static struct inner_timer *
+find_inner_timer(struct pcintr_timers* timers, const char* id)
 {
-    pcutils_map_erase(timers->timers_map, (void*)id);
+    void *val;
+    if (pchash_table_lookup_ex(timers->timers_map, id, &val)) {
+        return (struct inner_timer *)val;
+    }
+    return NULL;
 }
 
-static pcintr_timer_t
+static struct inner_timer *
 get_inner_timer(purc_coroutine_t cor , purc_variant_t timer_var)
 {
-    purc_variant_t id = purc_variant_object_get_by_ckey(timer_var,
-            TIMERS_STR_ID);
-    if (!id) {
-        purc_set_error(PURC_ERROR_INVALID_VALUE);
+    const char* idstr = get_timer_id(timer_var);
+    if (!idstr) {
         return NULL;
     }
 
-    const char* idstr = purc_variant_get_string_const(id);
-    pcintr_timer_t timer = find_timer(cor->timers, idstr);
-    if (timer) {
-        return timer;
+    struct inner_timer *inner = find_inner_timer(cor->timers, idstr);
+    if (inner) {
+        return inner;
+    }
+
+    inner = (struct inner_timer *)calloc(1, sizeof(*inner));
+    if (inner == NULL) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
     }
 
-    timer = pcintr_timer_create(NULL, idstr, timer_fire_func, cor);
-    if (timer == NULL) {
+    inner->timer = pcintr_timer_create_in_wheel(
+            pcintr_get_heap()->timer_wheel, idstr, timer_fire_func, cor);
+    if (inner->timer == NULL) {
+        free(inner);
         return NULL;
     }
 
-    if (!add_timer(cor->timers, idstr, timer)) {
-        pcintr_timer_destroy(timer);
+    const char *key = ((PcTimer*)inner->timer)->getId();
+    if (pchash_table_insert(cor->timers->timers_map, key, inner)) {
+        pcintr_timer_destroy(inner->timer);
+        free(inner);
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
         return NULL;
     }
-    return timer;
+    return inner;
 }
 
 static void
 destroy_inner_timer(purc_coroutine_t cor, purc_variant_t timer_var)
 {
-    purc_variant_t id;
-    id = purc_variant_object_get_by_ckey(timer_var, TIMERS_STR_ID);
-    if (!id) {
+    const char* idstr = get_timer_id(timer_var);
+    if (!idstr) {
         return;
     }
 
-    const char* idstr = purc_variant_get_string_const(id);
-    pcintr_timer_t timer = find_timer(cor->timers, idstr);
-    if (timer) {
-        remove_timer(cor->timers, idstr);
-    }
+    // the listener is revoked and the timer destroyed by free_inner_timer
+    pchash_table_delete(cor->timers->timers_map, idstr);
 }
 
+/* Watches the changes of the member object instead of the old one. */
+static bool
+watch_timer_object(struct inner_timer *inner, purc_variant_t obj);
+
 bool
 timer_listener_handler(purc_variant_t source, pcvar_op_t msg_type,
         void* ctxt, size_t nr_args, purc_variant_t* argv)
@@ -355,6 +772,24 @@ timer_listener_handler(purc_variant_t source, pcvar_op_t msg_type,
     return true;
 }
 
+static bool
+watch_timer_object(struct inner_timer *inner, purc_variant_t obj)
+{
+    if (inner->listener && inner->obj == obj) {
+        return true;
+    }
+
+    unwatch_timer_object(inner);
+    inner->listener = purc_variant_register_post_listener(obj,
+            PCVAR_OPERATION_CHANGE, timer_listener_handler, inner->timer);
+    if (!inner->listener) {
+        return false;
+    }
+
+    inner->obj = obj;
+    return true;
+}
+
 bool
 timers_set_grow(purc_variant_t source, pcvar_op_t msg_type,
         void *ctxt, size_t nr_args, purc_variant_t *argv)
@@ -365,29 +800,25 @@ timers_set_grow(purc_variant_t source, pcvar_op_t msg_type,
     UNUSED_PARAM(ctxt);
 
     purc_coroutine_t cor = (purc_coroutine_t)ctxt;
-    struct pcvar_listener *listener = NULL;
 
     purc_variant_t interval = purc_variant_object_get_by_ckey(argv[0],
             TIMERS_STR_INTERVAL);
     purc_variant_t active = purc_variant_object_get_by_ckey(argv[0],
             TIMERS_STR_ACTIVE);
-    pcintr_timer_t timer = get_inner_timer(cor, argv[0]);
-    if (!timer) {
+    struct inner_timer *inner = get_inner_timer(cor, argv[0]);
+    if (!inner) {
         return false;
     }
 
-    listener = purc_variant_register_post_listener(argv[0],
-            PCVAR_OPERATION_CHANGE, timer_listener_handler, timer);
-    if (!listener) {
+    if (!watch_timer_object(inner, argv[0])) {
         return false;
     }
-    listener_map_set_listener(cor->timers->listener_map, argv[0], listener);
 
     uint64_t ret = 0;
     purc_variant_cast_to_ulongint(interval, &ret, false);
-    pcintr_timer_set_interval(timer, ret);
+    pcintr_timer_set_interval(inner->timer, ret);
     if (is_euqal(active, TIMERS_STR_YES)) {
-        pcintr_timer_start(timer);
+        pcintr_timer_start(inner->timer);
     }
     return true;
 }
@@ -402,7 +833,6 @@ timers_set_shrink(purc_variant_t source, pcvar_op_t msg_type,
     UNUSED_PARAM(ctxt);
 
     purc_coroutine_t cor = (purc_coroutine_t)ctxt;
-    listener_map_remove_listener(cor->timers->listener_map, argv[0]);
     destroy_inner_timer(cor, argv[0]);
     return true;
 }
@@ -417,22 +847,18 @@ timers_set_change(purc_variant_t source, pcvar_op_t msg_type,
     UNUSED_PARAM(nr_args);
 
     purc_coroutine_t cor = (purc_coroutine_t)ctxt;
-    struct pcvar_listener *listener = NULL;
 
     purc_variant_t nv = argv[1];
-    pcintr_timer_t timer = get_inner_timer(cor, nv);
-    if (!timer) {
+    struct inner_timer *inner = get_inner_timer(cor, nv);
+    if (!inner) {
         return false;
     }
 
-    listener_map_remove_listener(cor->timers->listener_map, argv[0]);
-    listener = purc_variant_register_post_listener(nv,
-            PCVAR_OPERATION_CHANGE, timer_listener_handler, timer);
-    if (!listener) {
+    if (!watch_timer_object(inner, nv)) {
         return false;
     }
-    listener_map_set_listener(cor->timers->listener_map, nv, listener);
 
+    pcintr_timer_t timer = inner->timer;
     purc_variant_t interval = purc_variant_object_get_by_ckey(nv,
             TIMERS_STR_INTERVAL);
     purc_variant_t active = purc_variant_object_get_by_ckey(nv,
@@ -513,20 +939,13 @@ pcintr_timers_init(purc_coroutine_t cor)
     timers->timers_var = ret;
     purc_variant_ref(ret);
 
-    timers->timers_map = pcutils_map_create (copy_key_string, free_key_string,
-                          map_copy_val, map_free_val, comp_key_string, false);
+    timers->timers_map = pchash_kstr_table_new(HASHTABLE_DEFAULT_SIZE,
+            free_inner_timer);
     if (!timers->timers_map) {
         purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
         goto failure;
     }
 
-    timers->listener_map = pcutils_map_create (NULL, NULL, NULL, NULL,
-            listener_map_comp_by_key, false);
-    if (!timers->listener_map) {
-        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        goto failure;
-    }
-
     timers->timer_listener = purc_variant_register_post_listener(ret,
             (pcvar_op_t)op, timers_set_listener_handler, cor);
     if (!timers->timer_listener) {
@@ -568,15 +987,10 @@ pcintr_timers_destroy(struct pcintr_timers* timers)
 
         // remove inner timer
         if (timers->timers_map) {
-            pcutils_map_destroy(timers->timers_map);
+            pchash_table_free(timers->timers_map);
             timers->timers_map = NULL;
         }
 
-        if (timers->listener_map) {
-            pcutils_map_destroy(timers->listener_map);
-            timers->listener_map = NULL;
-        }
-
         PURC_VARIANT_SAFE_CLEAR(timers->timers_var);
         free(timers);
     }
@@ -0,0 +1,273 @@
+/*
+ * @file workers.c
+ * @date 2026/10/19
+ * @brief The pool of the worker runners which run the independent
+ *      coroutines of an app across the processors.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "purc.h"
+#include "private/runners.h"
+#include "private/instance.h"
+#include "private/debug.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* A worker is an ordinary instance with its own thread, run loop, and
+   variant heap; a coroutine is pinned to the worker on which it was
+   created, and the data go from one worker to another only through the
+   move buffers, like any other pair of runners. */
+struct pcrun_worker {
+    purc_atom_t         rid;
+
+    /* The load of a worker is the sum of the following counts. Written by
+       the worker and the runners placing coroutines, read by all; relaxed
+       atomics are enough because this is only a hint for the placement. */
+
+    /* the ready coroutines the worker counted in its last scheduling round */
+    atomic_size_t       ready;
+
+    /* the coroutines placed onto the worker which have not arrived yet */
+    atomic_size_t       placed;
+};
+
+/* The name of the app and the runner atoms of the workers are guarded by
+   the lock; the loads are atomics. The lock is not held while the workers
+   are being created, because every worker attaches itself to the pool
+   in its own thread meanwhile. */
+static struct {
+    pthread_mutex_t     lock;
+
+    /* signaled once the creation of the workers is done */
+    pthread_cond_t      created;
+    bool                creating;
+
+    /* set before the workers are created and cleared by the reset */
+    char                app_name[PURC_LEN_APP_NAME + 1];
+
+    /* the instance which created the pool; the pool is reset when
+       this instance is cleaned up */
+    purc_atom_t         owner;
+
+    /* published with release semantics once all workers are created */
+    atomic_size_t       nr_workers;
+
+    /* where the next placement starts to scan, to break the ties */
+    atomic_size_t       next;
+
+    struct pcrun_worker workers[PCRUN_MAX_WORKERS];
+} _pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .created = PTHREAD_COND_INITIALIZER,
+};
+
+static void
+make_worker_name(char *buf, size_t sz, size_t idx)
+{
+    snprintf(buf, sz, "%s%u", PCRUN_WORKER_NAME_PREFIX, (unsigned)idx);
+}
+
+size_t
+purc_inst_create_workers(size_t nr_workers)
+{
+    struct pcinst *inst = pcinst_current();
+    if (inst == NULL || inst->app_name == NULL) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return 0;
+    }
+
+    if (nr_workers == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        nr_workers = n > 0 ? (size_t)n : 1;
+    }
+    if (nr_workers > PCRUN_MAX_WORKERS)
+        nr_workers = PCRUN_MAX_WORKERS;
+
+    size_t nr_created;
+    pthread_mutex_lock(&_pool.lock);
+    while (_pool.creating)
+        pthread_cond_wait(&_pool.created, &_pool.lock);
+
+    nr_created = atomic_load_explicit(&_pool.nr_workers, memory_order_acquire);
+    if (nr_created > 0) {
+        if (strcmp(_pool.app_name, inst->app_name)) {
+            /* the pool belongs to another app of this process */
+            purc_set_error(PURC_ERROR_CONFLICT);
+            nr_created = 0;
+        }
+        goto done;
+    }
+
+    strcpy(_pool.app_name, inst->app_name);
+    for (size_t i = 0; i < nr_workers; i++) {
+        atomic_store_explicit(&_pool.workers[i].ready, 0,
+                memory_order_relaxed);
+        atomic_store_explicit(&_pool.workers[i].placed, 0,
+                memory_order_relaxed);
+    }
+    _pool.creating = true;
+    pthread_mutex_unlock(&_pool.lock);
+
+    purc_atom_t rids[PCRUN_MAX_WORKERS];
+    for (size_t i = 0; i < nr_workers; i++) {
+        char runner_name[PURC_LEN_RUNNER_NAME + 1];
+        make_worker_name(runner_name, sizeof(runner_name), i);
+
+        purc_atom_t rid = purc_inst_create_or_get(inst->app_name,
+                runner_name, NULL, NULL);
+        if (rid == 0) {
+            PC_WARN("Failed to create the worker runner: %s\n", runner_name);
+            break;
+        }
+
+        rids[nr_created++] = rid;
+    }
+
+    pthread_mutex_lock(&_pool.lock);
+    for (size_t i = 0; i < nr_created; i++)
+        _pool.workers[i].rid = rids[i];
+
+    if (nr_created == 0)
+        _pool.app_name[0] = 0;
+    else
+        _pool.owner = inst->endpoint_atom;
+    atomic_store_explicit(&_pool.nr_workers, nr_created, memory_order_release);
+    _pool.creating = false;
+    pthread_cond_broadcast(&_pool.created);
+
+done:
+    pthread_mutex_unlock(&_pool.lock);
+    return nr_created;
+}
+
+size_t
+purc_inst_get_nr_workers(void)
+{
+    return atomic_load_explicit(&_pool.nr_workers, memory_order_acquire);
+}
+
+struct pcrun_worker *
+pcrun_worker_attach(const char *app_name, const char *runner_name)
+{
+    size_t len = sizeof(PCRUN_WORKER_NAME_PREFIX) - 1;
+    if (app_name == NULL || runner_name == NULL ||
+            strncmp(runner_name, PCRUN_WORKER_NAME_PREFIX, len))
+        return NULL;
+
+    char *end;
+    unsigned long idx = strtoul(runner_name + len, &end, 10);
+    if (end == runner_name + len || *end || idx >= PCRUN_MAX_WORKERS)
+        return NULL;
+
+    /* called while the workers are being created, without the lock held */
+    pthread_mutex_lock(&_pool.lock);
+    bool mine = (strcmp(_pool.app_name, app_name) == 0);
+    pthread_mutex_unlock(&_pool.lock);
+
+    return mine ? _pool.workers + idx : NULL;
+}
+
+void
+pcrun_workers_reset(purc_atom_t owner)
+{
+    pthread_mutex_lock(&_pool.lock);
+
+    if (owner && _pool.owner == owner) {
+        atomic_store_explicit(&_pool.nr_workers, 0, memory_order_release);
+        atomic_store_explicit(&_pool.next, 0, memory_order_relaxed);
+        for (size_t i = 0; i < PCRUN_MAX_WORKERS; i++) {
+            _pool.workers[i].rid = 0;
+            atomic_store_explicit(&_pool.workers[i].ready, 0,
+                    memory_order_relaxed);
+            atomic_store_explicit(&_pool.workers[i].placed, 0,
+                    memory_order_relaxed);
+        }
+        _pool.app_name[0] = 0;
+        _pool.owner = 0;
+    }
+
+    pthread_mutex_unlock(&_pool.lock);
+}
+
+void
+pcrun_worker_set_load(struct pcrun_worker *worker, size_t nr_ready,
+        size_t nr_arrived)
+{
+    atomic_store_explicit(&worker->ready, nr_ready, memory_order_relaxed);
+
+    /* the arrived coroutines are counted in nr_ready from now on */
+    if (nr_arrived > 0) {
+        size_t placed = atomic_load_explicit(&worker->placed,
+                memory_order_relaxed);
+        size_t left;
+        do {
+            left = (placed > nr_arrived) ? placed - nr_arrived : 0;
+        } while (!atomic_compare_exchange_weak_explicit(&worker->placed,
+                    &placed, left,
+                    memory_order_relaxed, memory_order_relaxed));
+    }
+}
+
+purc_atom_t
+pcrun_workers_pick(const char *app_name, char *runner_name, size_t sz)
+{
+    purc_atom_t rid = 0;
+    pthread_mutex_lock(&_pool.lock);
+
+    size_t nr = atomic_load_explicit(&_pool.nr_workers, memory_order_acquire);
+    if (nr == 0 || strcmp(_pool.app_name, app_name))
+        goto done;
+
+    size_t start = atomic_fetch_add_explicit(&_pool.next, 1,
+            memory_order_relaxed);
+    size_t best = start % nr;
+    size_t min_load = SIZE_MAX;
+    for (size_t i = 0; i < nr; i++) {
+        size_t idx = (start + i) % nr;
+        size_t load = atomic_load_explicit(&_pool.workers[idx].ready,
+                memory_order_relaxed) +
+            atomic_load_explicit(&_pool.workers[idx].placed,
+                memory_order_relaxed);
+        if (load < min_load) {
+            min_load = load;
+            best = idx;
+            if (load == 0)
+                break;
+        }
+    }
+
+    /* count the new coroutine until the worker reports it as arrived,
+       so that a burst of placements does not go to a single worker */
+    atomic_fetch_add_explicit(&_pool.workers[best].placed, 1,
+            memory_order_relaxed);
+
+    make_worker_name(runner_name, sz, best);
+    rid = _pool.workers[best].rid;
+
+done:
+    pthread_mutex_unlock(&_pool.lock);
+    return rid;
+}
@@ -1082,10 +1082,10 @@ static void on_load(struct pcrdr_prot_data *prot_data,
 static void on_write_begin(struct pcrdr_prot_data *prot_data,
         const pcrdr_msg *msg, unsigned int op_id, struct result_info *result)
 {
-    void **domdocs = NULL;
+    void **domdocs;
 
     UNUSED_PARAM(op_id);
-    if (find_domdoc_ptr(prot_data, msg, result) == NULL) {
+    if ((domdocs = find_domdoc_ptr(prot_data, msg, result)) == NULL) {
         return;
     }
 
@@ -1098,10 +1098,10 @@ static void on_write_begin(struct pcrdr_prot_data *prot_data,
 static void on_write_more(struct pcrdr_prot_data *prot_data,
         const pcrdr_msg *msg, unsigned int op_id, struct result_info *result)
 {
-    void **domdocs = NULL;
+    void **domdocs;
 
     UNUSED_PARAM(op_id);
-    if (find_domdoc_ptr(prot_data, msg, result) == NULL) {
+    if ((domdocs = find_domdoc_ptr(prot_data, msg, result)) == NULL) {
         return;
     }
 
@@ -1120,10 +1120,10 @@ static void on_write_more(struct pcrdr_prot_data *prot_data,
 static void on_write_end(struct pcrdr_prot_data *prot_data,
         const pcrdr_msg *msg, unsigned int op_id, struct result_info *result)
 {
-    void **domdocs = NULL;
+    void **domdocs;
 
     UNUSED_PARAM(op_id);
-    if (find_domdoc_ptr(prot_data, msg, result) == NULL) {
+    if ((domdocs = find_domdoc_ptr(prot_data, msg, result)) == NULL) {
         return;
     }
 
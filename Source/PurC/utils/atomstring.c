@@ -33,18 +33,45 @@
 #include "purc-errors.h"
 #include "private/instance.h"
 #include "private/map.h"
+#include "private/tls.h"
 #include "private/utils.h"
 
+#if HAVE(STDATOMIC_H)
+#include <stdatomic.h>
+#endif
+
 #if PURC_ATOM_BUCKET_BITS > 16
 #error "Too many bits reserved for bucket"
 #endif
 
+/*
+ * purc_atom_to_string() reads the quarks without any lock: the writers store
+ * a new string before increasing `atom_seq_id`, and replace `quarks` by a
+ * larger array before storing a string beyond the old one. A reader loads
+ * `atom_seq_id` first, so the array it loads then covers the sequence.
+ * The replaced arrays may still be read, so they are freed on cleanup only.
+ */
+#if HAVE(STDATOMIC_H)
+typedef _Atomic purc_atom_t     atom_seq_t;
+typedef char ** _Atomic         atom_quarks_t;
+#else
+typedef purc_atom_t             atom_seq_t;
+typedef char **                 atom_quarks_t;
+#endif
+
+struct atom_old_quarks {
+    struct atom_old_quarks     *next;
+    char                      **quarks;
+};
+
 static struct atom_bucket {
     purc_atom_t     bucket_bits;
-    purc_atom_t     atom_seq_id;
+    atom_seq_t      atom_seq_id;
+    purc_atom_t     nr_quarks;
 
     pcutils_map    *atom_map;
-    char**          quarks;
+    atom_quarks_t   quarks;
+    struct atom_old_quarks *old_quarks;
 } atom_buckets[PURC_ATOM_BUCKETS_NR];
 
 #define ATOM_BITS_NR        (sizeof(purc_atom_t) << 3)
@@ -67,10 +94,176 @@ static struct atom_bucket {
 static inline purc_atom_t
 atom_new(struct atom_bucket *bucket, char *string, bool need_free);
 
-static purc_rwlock atom_rwlock;
+/*
+ * The readers lock only the shard assigned to the calling thread, and
+ * the writers lock all shards. So the lookups in different threads
+ * do not contend on a single lock; the writers are rare, because most
+ * atoms are created when the modules are initialized.
+ */
+#define NR_ATOM_LOCK_SHARDS     16
+
+static purc_rwlock atom_rwlocks[NR_ATOM_LOCK_SHARDS];
 static char *atom_block = NULL;
 static int  atom_block_offset = 0;
 
+/*
+ * The per-thread cache of the recent lookups. An entry keeps a copy of
+ * the string, so a hit needs neither a lock nor an access to the shared
+ * table. All entries are invalidated by bumping the generation when
+ * an atom is removed.
+ */
+#define NR_CACHED_ATOMS         64
+#define MAX_LEN_CACHED_ATOM     31
+
+struct atom_cache_entry {
+    unsigned        generation;
+    int             bucket;
+    purc_atom_t     atom;
+    char            string[MAX_LEN_CACHED_ATOM + 1];
+};
+
+struct atom_thread_data {
+    /* the shard of locks used by this thread; 0 for not assigned yet */
+    unsigned        shard;
+    struct atom_cache_entry cache[NR_CACHED_ATOMS];
+};
+
+PURC_DEFINE_THREAD_LOCAL(struct atom_thread_data, atom_thread_data);
+
+#if HAVE(STDATOMIC_H)
+static atomic_uint atom_generation = 1;
+static atomic_uint atom_nr_shards_assigned;
+#else
+static unsigned atom_nr_shards_assigned;
+#endif
+
+static inline struct atom_thread_data *atom_get_thread_data(void)
+{
+    struct atom_thread_data *data = PURC_GET_THREAD_LOCAL(atom_thread_data);
+
+    if (data && data->shard == 0) {
+#if HAVE(STDATOMIC_H)
+        unsigned n = atomic_fetch_add(&atom_nr_shards_assigned, 1);
+#else
+        unsigned n = atom_nr_shards_assigned++;
+#endif
+        data->shard = n % NR_ATOM_LOCK_SHARDS + 1;
+    }
+
+    return data;
+}
+
+static inline purc_rwlock *atom_reader_lock(struct atom_thread_data *data)
+{
+    purc_rwlock *lock = atom_rwlocks;
+    if (data)
+        lock += data->shard - 1;
+
+    purc_rwlock_reader_lock(lock);
+    return lock;
+}
+
+static inline void atom_reader_unlock(purc_rwlock *lock)
+{
+    purc_rwlock_reader_unlock(lock);
+}
+
+static void atom_writer_lock(void)
+{
+    for (int i = 0; i < NR_ATOM_LOCK_SHARDS; i++)
+        purc_rwlock_writer_lock(atom_rwlocks + i);
+}
+
+static void atom_writer_unlock(void)
+{
+    for (int i = NR_ATOM_LOCK_SHARDS - 1; i >= 0; i--)
+        purc_rwlock_writer_unlock(atom_rwlocks + i);
+}
+
+#if HAVE(STDATOMIC_H)
+
+/* Returns NULL if the string is too long to be cached. */
+static struct atom_cache_entry *
+atom_cache_slot(struct atom_thread_data *data, int bucket, const char *string)
+{
+    /* FNV-1a */
+    unsigned hash = 2166136261u ^ (unsigned)bucket;
+    for (size_t i = 0; string[i]; i++) {
+        if (i == MAX_LEN_CACHED_ATOM)
+            return NULL;
+        hash = (hash ^ (unsigned char)string[i]) * 16777619u;
+    }
+
+    return data->cache + (hash % NR_CACHED_ATOMS);
+}
+
+static inline purc_atom_t
+atom_cache_lookup(struct atom_cache_entry *entry, int bucket,
+        const char *string)
+{
+    if (entry->generation == atomic_load_explicit(&atom_generation,
+                memory_order_acquire) &&
+            entry->bucket == bucket && strcmp(entry->string, string) == 0)
+        return entry->atom;
+
+    return 0;
+}
+
+/* HOLDS: one of atom_rwlocks */
+static inline void
+atom_cache_update(struct atom_cache_entry *entry, int bucket,
+        const char *string, purc_atom_t atom)
+{
+    entry->generation = atomic_load_explicit(&atom_generation,
+            memory_order_relaxed);
+    entry->bucket = bucket;
+    entry->atom = atom;
+    strcpy(entry->string, string);
+}
+
+/* HOLDS: all atom_rwlocks */
+static inline void atom_cache_invalidate(void)
+{
+    atomic_fetch_add_explicit(&atom_generation, 1, memory_order_release);
+}
+
+#else /* HAVE(STDATOMIC_H) */
+
+static inline struct atom_cache_entry *
+atom_cache_slot(struct atom_thread_data *data, int bucket, const char *string)
+{
+    UNUSED_PARAM(data);
+    UNUSED_PARAM(bucket);
+    UNUSED_PARAM(string);
+    return NULL;
+}
+
+static inline purc_atom_t
+atom_cache_lookup(struct atom_cache_entry *entry, int bucket,
+        const char *string)
+{
+    UNUSED_PARAM(entry);
+    UNUSED_PARAM(bucket);
+    UNUSED_PARAM(string);
+    return 0;
+}
+
+static inline void
+atom_cache_update(struct atom_cache_entry *entry, int bucket,
+        const char *string, purc_atom_t atom)
+{
+    UNUSED_PARAM(entry);
+    UNUSED_PARAM(bucket);
+    UNUSED_PARAM(string);
+    UNUSED_PARAM(atom);
+}
+
+static inline void atom_cache_invalidate(void)
+{
+}
+
+#endif /* !HAVE(STDATOMIC_H) */
+
 static void atom_init_bucket(struct atom_bucket *bucket)
 {
     assert (bucket->atom_seq_id == 0);
@@ -79,6 +272,7 @@ static void atom_init_bucket(struct atom_bucket *bucket)
             comp_key_string, false);
     bucket->quarks = (char **)malloc(sizeof(char *) * ATOM_BLOCK_SIZE);
     bucket->quarks[0] = NULL;
+    bucket->nr_quarks = ATOM_BLOCK_SIZE;
     bucket->atom_seq_id = 1;
 
     assert(bucket->quarks != NULL);
@@ -105,29 +299,59 @@ static inline void atom_put_bucket(int bucket)
     if (LIKELY(atom_bucket->atom_map)) {
         pcutils_map_destroy(atom_bucket->atom_map);
         free(atom_bucket->quarks);
+
+        struct atom_old_quarks *old = atom_bucket->old_quarks;
+        while (old) {
+            struct atom_old_quarks *next = old->next;
+            free(old->quarks);
+            free(old);
+            old = next;
+        }
+
         memset(atom_bucket, 0, sizeof(*atom_bucket));
     }
 }
 
-purc_atom_t
-purc_atom_try_string_ex(int bucket, const char *string)
+/* Looks up the string without creating a new atom; uses the thread cache. */
+static purc_atom_t
+atom_try_string(int bucket, const char *string)
 {
     struct atom_bucket *atom_bucket = atom_get_bucket(bucket);
-    const pcutils_map_entry* entry = NULL;
+    struct atom_thread_data *data;
+    struct atom_cache_entry *entry = NULL;
+    const pcutils_map_entry* map_entry = NULL;
     purc_atom_t atom = 0;
 
-    if (string == NULL || atom_bucket == NULL)
+    if (atom_bucket == NULL)
         return 0;
 
-    purc_rwlock_reader_lock(&atom_rwlock);
-    if ((entry = pcutils_map_find(atom_bucket->atom_map, string))) {
-        atom = (purc_atom_t)(uintptr_t)entry->val;
+    data = atom_get_thread_data();
+    if (data) {
+        entry = atom_cache_slot(data, bucket, string);
+        if (entry && (atom = atom_cache_lookup(entry, bucket, string)))
+            return atom;
     }
-    purc_rwlock_reader_unlock(&atom_rwlock);
+
+    purc_rwlock *lock = atom_reader_lock(data);
+    if ((map_entry = pcutils_map_find(atom_bucket->atom_map, string))) {
+        atom = (purc_atom_t)(uintptr_t)map_entry->val;
+        if (entry)
+            atom_cache_update(entry, bucket, string, atom);
+    }
+    atom_reader_unlock(lock);
 
     return atom;
 }
 
+purc_atom_t
+purc_atom_try_string_ex(int bucket, const char *string)
+{
+    if (string == NULL)
+        return 0;
+
+    return atom_try_string(bucket, string);
+}
+
 bool
 purc_atom_remove_string_ex(int bucket, const char *string)
 {
@@ -140,23 +364,24 @@ purc_atom_remove_string_ex(int bucket, const char *string)
     bool ret;
     purc_atom_t atom;
 
-    purc_rwlock_writer_lock(&atom_rwlock);
+    atom_writer_lock();
     if ((entry = pcutils_map_find(atom_bucket->atom_map, string))) {
         atom = (purc_atom_t)(uintptr_t)entry->val;
         pcutils_map_erase(atom_bucket->atom_map, (void *)string);
         atom = ATOM_TO_SEQUENCE(atom);
         atom_bucket->quarks[atom] = NULL;
+        atom_cache_invalidate();
         ret = true;
     }
     else {
         ret = false;
     }
-    purc_rwlock_writer_unlock(&atom_rwlock);
+    atom_writer_unlock();
 
     return ret;
 }
 
-/* HOLDS: atom_rwlock_lock */
+/* HOLDS: all atom_rwlocks */
 static char *
 atom_strdup(const char *string, bool *need_free)
 {
@@ -185,7 +410,7 @@ atom_strdup(const char *string, bool *need_free)
     return copy;
 }
 
-/* HOLDS: purc_atom_rwlock_writer_lock */
+/* HOLDS: all atom_rwlocks */
 static inline purc_atom_t
 atom_from_string(struct atom_bucket *bucket, const char *string,
         bool duplicate, bool *newly_created)
@@ -210,20 +435,28 @@ atom_from_string(struct atom_bucket *bucket, const char *string,
         atom = atom_new(bucket, (char *)string, need_free);
 
         if (newly_created)
-            *newly_created = true;
+            *newly_created = (atom != 0);
     }
 
     return atom;
 }
 
 static inline purc_atom_t
-atom_from_string_locked(struct atom_bucket *bucket, const char *string,
+atom_from_string_locked(int bucket, const char *string,
         bool duplicate, bool *newly_created)
 {
-    purc_atom_t atom = 0;
-    purc_rwlock_writer_lock(&atom_rwlock);
-    atom = atom_from_string(bucket, string, duplicate, newly_created);
-    purc_rwlock_writer_unlock(&atom_rwlock);
+    /* most atoms exist already; do not lock all shards for them */
+    purc_atom_t atom = atom_try_string(bucket, string);
+    if (atom) {
+        if (newly_created)
+            *newly_created = false;
+        return atom;
+    }
+
+    atom_writer_lock();
+    atom = atom_from_string(atom_get_bucket(bucket), string, duplicate,
+            newly_created);
+    atom_writer_unlock();
 
     return atom;
 }
@@ -234,8 +467,7 @@ purc_atom_from_string_ex2(int bucket, const char *string, bool *newly_created)
     if (!string)
         return 0;
 
-    return atom_from_string_locked(atom_get_bucket(bucket), string,
-            true, newly_created);
+    return atom_from_string_locked(bucket, string, true, newly_created);
 }
 
 purc_atom_t
@@ -245,8 +477,7 @@ purc_atom_from_static_string_ex2(int bucket, const char *string,
     if (!string)
         return 0;
 
-    return atom_from_string_locked(atom_get_bucket(bucket), string,
-            false, newly_created);
+    return atom_from_string_locked(bucket, string, false, newly_created);
 }
 
 const char *
@@ -261,10 +492,19 @@ purc_atom_to_string(purc_atom_t atom)
     bucket = ATOM_TO_BUCKET(atom);
     struct atom_bucket *atom_bucket = atom_get_bucket(bucket);
     atom = ATOM_TO_SEQUENCE(atom);
-    purc_rwlock_reader_lock(&atom_rwlock);
+#if HAVE(STDATOMIC_H)
+    purc_atom_t nr = atomic_load_explicit(&atom_bucket->atom_seq_id,
+            memory_order_acquire);
+    char **quarks = atomic_load_explicit(&atom_bucket->quarks,
+            memory_order_acquire);
+    if (atom < nr)
+        result = quarks[atom];
+#else
+    purc_rwlock *lock = atom_reader_lock(atom_get_thread_data());
     if (atom < atom_bucket->atom_seq_id)
         result = atom_bucket->quarks[atom];
-    purc_rwlock_reader_unlock(&atom_rwlock);
+    atom_reader_unlock(lock);
+#endif
 
     return result;
 }
@@ -276,37 +516,44 @@ static void free_dup_key(void *key, void *data)
         free(key);
 }
 
-/* HOLDS: purc_atom_rwlock_writer_lock */
+/* HOLDS: all atom_rwlocks */
 static inline purc_atom_t
 atom_new(struct atom_bucket *bucket, char *string, bool need_free)
 {
-    purc_atom_t atom;
-    char **atoms_new;
-
-    if (bucket->atom_seq_id % ATOM_BLOCK_SIZE == 0) {
-        atoms_new = (char **)malloc(sizeof (char *) *
-                (bucket->atom_seq_id + ATOM_BLOCK_SIZE));
-        if (bucket->atom_seq_id != 0)
-            memcpy(atoms_new, bucket->quarks,
-                    sizeof (char *) * bucket->atom_seq_id);
-        memset(atoms_new + bucket->atom_seq_id, 0,
-                sizeof (char *) * ATOM_BLOCK_SIZE);
+    purc_atom_t atom = bucket->atom_seq_id;
+    char **quarks = bucket->quarks;
+
+    if (atom == bucket->nr_quarks) {
+        struct atom_old_quarks *old = malloc(sizeof(*old));
+        purc_atom_t nr_quarks = bucket->nr_quarks * 2;
+        char **quarks_new = (char **)malloc(sizeof (char *) * nr_quarks);
+        if (old == NULL || quarks_new == NULL) {
+            free(old);
+            free(quarks_new);
+            if (need_free)
+                free(string);
+            return 0;
+        }
+
+        memcpy(quarks_new, quarks, sizeof (char *) * atom);
+        memset(quarks_new + atom, 0, sizeof (char *) * (nr_quarks - atom));
 
         /*
-         * The implementation in glib did not free the old quarks array.
-         * The author said: `This leaks the old quarks array. Its unfortunate,
-         * but it allows us to do lockless lookup of the arrays, and there
-         * shouldn't be that many quarks in an app`.
-         *
-         * In our implementation, we do free the old quarks.
-         * Indeed, we can use realloc() instead of malloc() and memcpy()
+         * Like glib, we do not free the old quarks array at once, because
+         * purc_atom_to_string() may be reading it without any lock. The
+         * arrays grow by doubling, so the old ones take no more memory
+         * than the current one.
          */
-        free(bucket->quarks);
-        bucket->quarks = atoms_new;
+        old->quarks = quarks;
+        old->next = bucket->old_quarks;
+        bucket->old_quarks = old;
+
+        quarks = quarks_new;
+        bucket->nr_quarks = nr_quarks;
+        bucket->quarks = quarks;
     }
 
-    atom = bucket->atom_seq_id;
-    bucket->quarks[atom] = string;
+    quarks[atom] = string;
     atom |= bucket->bucket_bits;
     pcutils_map_insert_ex(bucket->atom_map,
                 string, (void *)(uintptr_t)atom,
@@ -327,8 +574,10 @@ atom_cleanup_once(void)
         atom_put_bucket(bucket);
     }
 
-    if (atom_rwlock.native_impl)
-        purc_rwlock_clear(&atom_rwlock);
+    for (int i = 0; i < NR_ATOM_LOCK_SHARDS; i++) {
+        if (atom_rwlocks[i].native_impl)
+            purc_rwlock_clear(atom_rwlocks + i);
+    }
     if (atom_block)
         free(atom_block);
 }
@@ -337,10 +586,13 @@ static int
 atom_init_once(void)
 {
     int r = 0;
+    int i;
 
-    purc_rwlock_init(&atom_rwlock);
-    if (atom_rwlock.native_impl == NULL)
-        goto fail_lock;
+    for (i = 0; i < NR_ATOM_LOCK_SHARDS; i++) {
+        purc_rwlock_init(atom_rwlocks + i);
+        if (atom_rwlocks[i].native_impl == NULL)
+            goto fail_lock;
+    }
 
     /* init the default bucket only */
     if (!atom_get_bucket(0))
@@ -360,9 +612,12 @@ fail_atexit:
     }
 
 fail_atom:
-    purc_rwlock_clear(&atom_rwlock);
-
 fail_lock:
+    while (i > 0) {
+        i--;
+        if (atom_rwlocks[i].native_impl)
+            purc_rwlock_clear(atom_rwlocks + i);
+    }
     return -1;
 }
 
@@ -60,12 +60,38 @@
 #include <sys/types.h>
 #include <assert.h>
 
+#include "config.h"
 #include "private/utils.h"
+#include "private/cpu.h"
+
+#if PCUTILS_X86_SIMD
+#include <immintrin.h>
+#endif
 
 static const char Base64[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 static const char Pad64 = '=';
 
+/* The values of the characters in Base64[]; -1 for the others. */
+static const signed char Base64Values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
 /* (From RFC1521 and draft-ietf-dnssec-secext-03.txt)
    The following encoding technique is taken from RFC 1521 by Borenstein
    and Freed.  It is reproduced here in a slightly edited form for
@@ -129,6 +155,123 @@ static const char Pad64 = '=';
        characters followed by one "=" padding character.
    */
 
+#if PCUTILS_X86_SIMD
+/* The kernels of Wojciech Mula and Daniel Lemire, "Faster Base64 Encoding
+   and Decoding Using AVX2 Instructions"; the two lanes of a register
+   work on the two halves of a block independently. */
+
+/* Encodes 24 bytes to 32 characters a time; returns the number of the bytes
+   encoded. Reads 28 bytes for a block, so stops 4 bytes earlier. */
+PCUTILS_TARGET("avx2")
+static size_t
+b64_encode_avx2(const unsigned char *src, size_t srclength,
+        char *target, size_t targsize)
+{
+    const __m256i shuf = _mm256_setr_epi8(
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i shift_lut = _mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+            '/' - 63, 'A', 0, 0,
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+            '/' - 63, 'A', 0, 0);
+    size_t done = 0;
+
+    while (srclength - done >= 28 && (done / 3 * 4) + 32 <= targsize) {
+        __m128i lo = _mm_loadu_si128((const __m128i *)(src + done));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(src + done + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo),
+                hi, 1);
+
+        /* split the 24-bit groups into the 6-bit indices */
+        in = _mm256_shuffle_epi8(in, shuf);
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i indices = _mm256_or_si256(t1, t3);
+
+        /* map the indices to the characters */
+        __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(result,
+                _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result = _mm256_shuffle_epi8(shift_lut, result);
+        result = _mm256_add_epi8(result, indices);
+
+        _mm256_storeu_si256((__m256i *)(target + done / 3 * 4), result);
+        done += 24;
+    }
+
+    return done;
+}
+
+/* Decodes 32 characters to 24 bytes a time, as long as all characters
+   are in the alphabet; returns the number of the characters decoded.
+   Writes 28 bytes for a block, so stops 4 bytes earlier. */
+PCUTILS_TARGET("avx2")
+static size_t
+b64_decode_avx2(const char *src, size_t srclength,
+        unsigned char *target, size_t targsize)
+{
+    const __m256i shift_lut = _mm256_setr_epi8(
+            0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    /* the bit `h` is set if the character `h * 16 + l` is in the alphabet */
+    const __m256i mask_lut = _mm256_setr_epi8(
+            0xa8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8,
+            0xf8, 0xf8, 0xf0, 0x54, 0x50, 0x50, 0x50, 0x54,
+            0xa8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8,
+            0xf8, 0xf8, 0xf0, 0x54, 0x50, 0x50, 0x50, 0x54);
+    const __m256i bitpos_lut = _mm256_setr_epi8(
+            0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, (char)0x80,
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, (char)0x80,
+            0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i pack = _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    size_t done = 0;
+
+    while (srclength - done >= 32 && (done / 4 * 3) + 28 <= targsize) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(src + done));
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi32(in, 4), nibble);
+        __m256i lo = _mm256_and_si256(in, nibble);
+
+        __m256i m = _mm256_shuffle_epi8(mask_lut, lo);
+        __m256i bit = _mm256_shuffle_epi8(bitpos_lut, hi);
+        __m256i invalid = _mm256_cmpeq_epi8(_mm256_and_si256(m, bit),
+                _mm256_setzero_si256());
+        if (_mm256_movemask_epi8(invalid))
+            break;
+
+        /* '/' shares the high nibble with '+' but has another offset */
+        __m256i shift = _mm256_shuffle_epi8(shift_lut, hi);
+        __m256i eq_slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+        shift = _mm256_add_epi8(shift,
+                _mm256_and_si256(eq_slash, _mm256_set1_epi8(-3)));
+        __m256i values = _mm256_add_epi8(in, shift);
+
+        /* merge the 6-bit values into the 24-bit groups */
+        __m256i merged = _mm256_maddubs_epi16(values,
+                _mm256_set1_epi32(0x01400140));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        merged = _mm256_shuffle_epi8(merged, pack);
+
+        unsigned char *dst = target + done / 4 * 3;
+        _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(merged));
+        _mm_storeu_si128((__m128i *)(dst + 12),
+                _mm256_extracti128_si256(merged, 1));
+        done += 32;
+    }
+
+    return done;
+}
+#endif
+
 ssize_t pcutils_b64_encode(const void *_src, size_t srclength,
            void *dest, size_t targsize)
 {
@@ -141,6 +284,15 @@ ssize_t pcutils_b64_encode(const void *_src, size_t srclength,
 
     assert(dest && targsize > 0);
 
+#if PCUTILS_X86_SIMD
+    if (pcutils_cpu_has(PCUTILS_CPU_AVX2)) {
+        size_t done = b64_encode_avx2(src, srclength, target, targsize);
+        src += done;
+        srclength -= done;
+        datalength = done / 3 * 4;
+    }
+#endif
+
     while (2 < srclength) {
         input[0] = *src++;
         input[1] = *src++;
@@ -193,29 +345,47 @@ ssize_t pcutils_b64_encode(const void *_src, size_t srclength,
    it returns the number of data bytes stored at the target, or -1 on error.
  */
 
-ssize_t pcutils_b64_decode(const void *_src, void *dest, size_t targsize)
+ssize_t pcutils_b64_decode(const void *src, void *dest, size_t targsize)
+{
+    return pcutils_b64_decode_ex(src, strlen(src), dest, targsize);
+}
+
+/* the next character, or '\0' at the end */
+#define NEXT_CHAR()     ((src < end) ? (unsigned char)*src++ : '\0')
+
+ssize_t pcutils_b64_decode_ex(const void *_src, size_t srclength,
+        void *dest, size_t targsize)
 {
     const char *src = _src;
+    const char *end = src + srclength;
     unsigned char *target = dest;
     int state, ch;
     size_t tarindex;
     u_char nextbyte;
-    char *pos;
+    int value;
 
     state = 0;
     tarindex = 0;
 
     assert(dest && targsize > 0);
 
-    while ((ch = (unsigned char)*src++) != '\0') {
+#if PCUTILS_X86_SIMD
+    if (pcutils_cpu_has(PCUTILS_CPU_AVX2)) {
+        size_t done = b64_decode_avx2(src, srclength, target, targsize);
+        src += done;
+        tarindex = done / 4 * 3;
+    }
+#endif
+
+    while ((ch = NEXT_CHAR()) != '\0') {
         if (purc_isspace(ch))    /* Skip whitespace anywhere. */
             continue;
 
         if (ch == Pad64)
             break;
 
-        pos = strchr(Base64, ch);
-        if (pos == 0)        /* A non-base64 character. */
+        value = Base64Values[ch];
+        if (value < 0)        /* A non-base64 character. */
             return (-1);
 
         switch (state) {
@@ -223,7 +393,7 @@ ssize_t pcutils_b64_decode(const void *_src, void *dest, size_t targsize)
             if (target) {
                 if (tarindex >= targsize)
                     return (-1);
-                target[tarindex] = (pos - Base64) << 2;
+                target[tarindex] = value << 2;
             }
             state = 1;
             break;
@@ -231,8 +401,8 @@ ssize_t pcutils_b64_decode(const void *_src, void *dest, size_t targsize)
             if (target) {
                 if (tarindex >= targsize)
                     return (-1);
-                target[tarindex]   |=  (pos - Base64) >> 4;
-                nextbyte = ((pos - Base64) & 0x0f) << 4;
+                target[tarindex]   |=  value >> 4;
+                nextbyte = (value & 0x0f) << 4;
                 if (tarindex + 1 < targsize)
                     target[tarindex+1] = nextbyte;
                 else if (nextbyte)
@@ -245,8 +415,8 @@ ssize_t pcutils_b64_decode(const void *_src, void *dest, size_t targsize)
             if (target) {
                 if (tarindex >= targsize)
                     return (-1);
-                target[tarindex]   |=  (pos - Base64) >> 2;
-                nextbyte = ((pos - Base64) & 0x03) << 6;
+                target[tarindex]   |=  value >> 2;
+                nextbyte = (value & 0x03) << 6;
                 if (tarindex + 1 < targsize)
                     target[tarindex+1] = nextbyte;
                 else if (nextbyte)
@@ -259,7 +429,7 @@ ssize_t pcutils_b64_decode(const void *_src, void *dest, size_t targsize)
             if (target) {
                 if (tarindex >= targsize)
                     return (-1);
-                target[tarindex] |= (pos - Base64);
+                target[tarindex] |= value;
             }
             tarindex++;
             state = 0;
@@ -273,7 +443,7 @@ ssize_t pcutils_b64_decode(const void *_src, void *dest, size_t targsize)
      */
 
     if (ch == Pad64) {            /* We got a pad char. */
-        ch = (unsigned char)*src++;    /* Skip it, get next. */
+        ch = NEXT_CHAR();    /* Skip it, get next. */
         switch (state) {
         case 0:        /* Invalid = in first position */
         case 1:        /* Invalid = in second position */
@@ -281,13 +451,13 @@ ssize_t pcutils_b64_decode(const void *_src, void *dest, size_t targsize)
 
         case 2:        /* Valid, means one byte of info */
             /* Skip any number of spaces. */
-            for (; ch != '\0'; ch = (unsigned char)*src++)
+            for (; ch != '\0'; ch = NEXT_CHAR())
                 if (!purc_isspace(ch))
                     break;
             /* Make sure there is another trailing = sign. */
             if (ch != Pad64)
                 return (-1);
-            ch = (unsigned char)*src++;        /* Skip the = */
+            ch = NEXT_CHAR();        /* Skip the = */
             /* Fall through to "single trailing =" case. */
             /* FALLTHROUGH */
 
@@ -296,7 +466,7 @@ ssize_t pcutils_b64_decode(const void *_src, void *dest, size_t targsize)
              * We know this char is an =.  Is there anything but
              * whitespace after it?
              */
-            for (; ch != '\0'; ch = (unsigned char)*src++)
+            for (; ch != '\0'; ch = NEXT_CHAR())
                 if (!purc_isspace(ch))
                     return (-1);
 
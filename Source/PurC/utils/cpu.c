@@ -0,0 +1,104 @@
+/*
+ * @file cpu.c
+ * @date 2026/10/19
+ * @brief The detection of the optional instruction sets of the processor.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "private/cpu.h"
+
+#include <stdatomic.h>
+
+#if PCUTILS_X86_SIMD
+#include <cpuid.h>
+#endif
+
+/* the features detected, or FEATURES_UNKNOWN before the first call */
+#define FEATURES_UNKNOWN    (~0U)
+
+static atomic_uint _features = FEATURES_UNKNOWN;
+static atomic_uint _disabled;
+
+#if PCUTILS_X86_SIMD
+static unsigned
+detect_features(void)
+{
+    unsigned eax, ebx, ecx, edx;
+    unsigned features = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+
+    if (ecx & bit_SSSE3)
+        features |= PCUTILS_CPU_SSSE3;
+    if (ecx & bit_SSE4_1)
+        features |= PCUTILS_CPU_SSE41;
+    if (ecx & bit_SSE4_2)
+        features |= PCUTILS_CPU_SSE42;
+    if (ecx & bit_PCLMUL)
+        features |= PCUTILS_CPU_PCLMUL;
+
+    /* AVX2 also needs the support of the system to save the YMM registers */
+    bool ymm_enabled = false;
+    if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+        unsigned xcr0_lo, xcr0_hi;
+        __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+        ymm_enabled = (xcr0_lo & 0x06) == 0x06;
+    }
+
+    if (__get_cpuid_max(0, NULL) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if ((ebx & bit_AVX2) && ymm_enabled)
+            features |= PCUTILS_CPU_AVX2;
+        if (ebx & bit_SHA)
+            features |= PCUTILS_CPU_SHA;
+    }
+
+    return features;
+}
+#else
+static unsigned
+detect_features(void)
+{
+    return 0;
+}
+#endif
+
+unsigned
+pcutils_cpu_features(void)
+{
+    unsigned features = atomic_load_explicit(&_features, memory_order_relaxed);
+    if (features == FEATURES_UNKNOWN) {
+        /* harmless if several threads detect the features at the same time */
+        features = detect_features();
+        atomic_store_explicit(&_features, features, memory_order_relaxed);
+    }
+
+    return features & ~atomic_load_explicit(&_disabled, memory_order_relaxed);
+}
+
+unsigned
+pcutils_cpu_disable_features(unsigned features)
+{
+    unsigned old = pcutils_cpu_features();
+    atomic_store_explicit(&_disabled, features, memory_order_relaxed);
+    return old;
+}
+
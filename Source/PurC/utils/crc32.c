@@ -27,6 +27,16 @@
 #include "config.h"
 #include "private/utils.h"
 #include "private/debug.h"
+#include "private/cpu.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#if PCUTILS_X86_SIMD
+#include <immintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
 
 /*
 
@@ -471,6 +481,281 @@ static const uint32_t crc32_table_000000af[] =
   0x00006494, 0x0000643b, 0x000065ca, 0x00006565
 };
 
+/* The polynomials (reflected) which can be computed by the instructions
+   of the processors: CRC32 of SSE 4.2 and CRC32C of ARMv8 compute the
+   Castagnoli one, CRC32 of ARMv8 and the folding by carry-less
+   multiplication compute the one of IEEE 802.3. */
+#define ACCEL_POLY_CASTAGNOLI   0x82F63B78
+#define ACCEL_POLY_IEEE         0xEDB88320
+
+/* The byte-at-a-time tables above, and the tables derived from them to
+   process eight bytes a time: slices[k][i] is the CRC of the byte `i`
+   followed by `k` zero bytes. */
+static const struct crc32_table_info {
+    const uint32_t *table;
+    bool            reflected;
+} crc32_tables[] = {
+    { crc32_table_04c11db7_reflected, true },
+    { crc32_table_04c11db7, false },
+    { crc32_table_1edc6f41_reflected, true },
+    { crc32_table_a833982b_reflected, true },
+    { crc32_table_814141ab, false },
+    { crc32_table_000000af, false },
+};
+
+#define NR_CRC32_TABLES     PCA_TABLESIZE(crc32_tables)
+
+static uint32_t crc32_slices[NR_CRC32_TABLES][8][256];
+static pthread_once_t crc32_slices_once = PTHREAD_ONCE_INIT;
+
+static void build_crc32_slices(void)
+{
+    for (size_t t = 0; t < NR_CRC32_TABLES; t++) {
+        const uint32_t *table = crc32_tables[t].table;
+        bool reflected = crc32_tables[t].reflected;
+        uint32_t (*slices)[256] = crc32_slices[t];
+
+        memcpy(slices[0], table, sizeof(slices[0]));
+        for (int k = 1; k < 8; k++) {
+            for (int i = 0; i < 256; i++) {
+                uint32_t c = slices[k - 1][i];
+                if (reflected)
+                    slices[k][i] = (c >> 8) ^ table[c & 0xFF];
+                else
+                    slices[k][i] = (c << 8) ^ table[c >> 24];
+            }
+        }
+    }
+}
+
+static const uint32_t (*get_crc32_slices(const uint32_t *table))[256]
+{
+    for (size_t t = 0; t < NR_CRC32_TABLES; t++) {
+        if (crc32_tables[t].table == table) {
+            pthread_once(&crc32_slices_once, build_crc32_slices);
+            return (const uint32_t (*)[256])crc32_slices[t];
+        }
+    }
+
+    return NULL;
+}
+
+static inline uint32_t load_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+        ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+        ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static uint32_t
+crc32_slicing_reflected(const uint32_t (*s)[256], uint32_t crc,
+        const uint8_t *buf, size_t n)
+{
+    while (n >= 8) {
+        uint32_t lo = crc ^ load_le32(buf);
+        uint32_t hi = load_le32(buf + 4);
+        crc = s[7][lo & 0xFF] ^ s[6][(lo >> 8) & 0xFF] ^
+            s[5][(lo >> 16) & 0xFF] ^ s[4][lo >> 24] ^
+            s[3][hi & 0xFF] ^ s[2][(hi >> 8) & 0xFF] ^
+            s[1][(hi >> 16) & 0xFF] ^ s[0][hi >> 24];
+        buf += 8;
+        n -= 8;
+    }
+
+    while (n--) {
+        crc = (crc >> 8) ^ s[0][(crc ^ *buf++) & 0xFF];
+    }
+
+    return crc;
+}
+
+static uint32_t
+crc32_slicing_normal(const uint32_t (*s)[256], uint32_t crc,
+        const uint8_t *buf, size_t n)
+{
+    while (n >= 8) {
+        uint32_t hi = crc ^ load_be32(buf);
+        uint32_t lo = load_be32(buf + 4);
+        crc = s[7][hi >> 24] ^ s[6][(hi >> 16) & 0xFF] ^
+            s[5][(hi >> 8) & 0xFF] ^ s[4][hi & 0xFF] ^
+            s[3][lo >> 24] ^ s[2][(lo >> 16) & 0xFF] ^
+            s[1][(lo >> 8) & 0xFF] ^ s[0][lo & 0xFF];
+        buf += 8;
+        n -= 8;
+    }
+
+    while (n--) {
+        crc = (crc << 8) ^ s[0][((crc >> 24) ^ *buf++) & 0xFF];
+    }
+
+    return crc;
+}
+
+#if PCUTILS_X86_SIMD
+PCUTILS_TARGET("sse4.2")
+static uint32_t
+crc32c_sse42(uint32_t crc, const uint8_t *buf, size_t n)
+{
+    uint64_t crc64 = crc;
+    while (n >= 8) {
+        uint64_t v;
+        memcpy(&v, buf, sizeof(v));
+        crc64 = _mm_crc32_u64(crc64, v);
+        buf += 8;
+        n -= 8;
+    }
+
+    crc = (uint32_t)crc64;
+    while (n--) {
+        crc = _mm_crc32_u8(crc, *buf++);
+    }
+
+    return crc;
+}
+
+/* Folds 64 bytes a time by carry-less multiplication, then reduces the
+   remainder to 32 bits with the Barrett reduction; see "Fast CRC
+   Computation for Generic Polynomials Using PCLMULQDQ Instruction" of
+   Intel. The length must be a multiple of 16 and not less than 64. */
+PCUTILS_TARGET("sse4.1,pclmul")
+static uint32_t
+crc32_ieee_pclmul(uint32_t crc, const uint8_t *buf, size_t n)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    buf += 64;
+    n -= 64;
+
+    while (n >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                _mm_loadu_si128((const __m128i *)(buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                _mm_loadu_si128((const __m128i *)(buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                _mm_loadu_si128((const __m128i *)(buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                _mm_loadu_si128((const __m128i *)(buf + 0x30)));
+        buf += 64;
+        n -= 64;
+    }
+
+    /* fold the four lanes into one */
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    while (n >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                _mm_loadu_si128((const __m128i *)buf));
+        buf += 16;
+        n -= 16;
+    }
+
+    /* fold 128 bits to 64 bits */
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduction to 32 bits */
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static uint32_t
+crc32_accel(uint32_t poly, uint32_t crc, const uint8_t **buf, size_t *n)
+{
+    if (poly == ACCEL_POLY_CASTAGNOLI && pcutils_cpu_has(PCUTILS_CPU_SSE42)) {
+        crc = crc32c_sse42(crc, *buf, *n);
+        *buf += *n;
+        *n = 0;
+    }
+    else if (poly == ACCEL_POLY_IEEE && *n >= 64 &&
+            pcutils_cpu_has(PCUTILS_CPU_PCLMUL | PCUTILS_CPU_SSE41)) {
+        size_t folded = *n & ~(size_t)15;
+        crc = crc32_ieee_pclmul(crc, *buf, folded);
+        *buf += folded;
+        *n -= folded;
+    }
+
+    return crc;
+}
+
+#elif defined(__ARM_FEATURE_CRC32)
+static uint32_t
+crc32_accel(uint32_t poly, uint32_t crc, const uint8_t **buf, size_t *n)
+{
+    const uint8_t *p = *buf;
+    size_t left = *n;
+
+    if (poly == ACCEL_POLY_CASTAGNOLI) {
+        for (; left >= 8; p += 8, left -= 8) {
+            uint64_t v;
+            memcpy(&v, p, sizeof(v));
+            crc = __crc32cd(crc, v);
+        }
+        for (; left > 0; p++, left--)
+            crc = __crc32cb(crc, *p);
+    }
+    else {
+        for (; left >= 8; p += 8, left -= 8) {
+            uint64_t v;
+            memcpy(&v, p, sizeof(v));
+            crc = __crc32d(crc, v);
+        }
+        for (; left > 0; p++, left--)
+            crc = __crc32b(crc, *p);
+    }
+
+    *buf = p;
+    *n = left;
+    return crc;
+}
+#endif
+
 /* For the parameters of different CRC32 algorithms, see
    <https://crccalc.com/> */
 void pcutils_crc32_begin(pcutils_crc32_ctxt *ctxt, purc_crc32_algo_t algo)
@@ -566,6 +851,12 @@ void pcutils_crc32_begin(pcutils_crc32_ctxt *ctxt, purc_crc32_algo_t algo)
     }
 
     ctxt->crc32 = ctxt->init;
+    ctxt->slices = get_crc32_slices(ctxt->table_static);
+    ctxt->accel_poly = 0;
+    if (ctxt->table_static == crc32_table_1edc6f41_reflected)
+        ctxt->accel_poly = ACCEL_POLY_CASTAGNOLI;
+    else if (ctxt->table_static == crc32_table_04c11db7_reflected)
+        ctxt->accel_poly = ACCEL_POLY_IEEE;
 }
 
 void pcutils_crc32_update(pcutils_crc32_ctxt *ctxt,
@@ -573,6 +864,22 @@ void pcutils_crc32_update(pcutils_crc32_ctxt *ctxt,
 {
     const uint8_t *buf = data;
 
+#if PCUTILS_X86_SIMD || defined(__ARM_FEATURE_CRC32)
+    if (ctxt->accel_poly) {
+        ctxt->crc32 = crc32_accel(ctxt->accel_poly, ctxt->crc32, &buf, &n);
+    }
+#endif
+
+    if (ctxt->slices) {
+        if (ctxt->refout)
+            ctxt->crc32 = crc32_slicing_reflected(ctxt->slices,
+                    ctxt->crc32, buf, n);
+        else
+            ctxt->crc32 = crc32_slicing_normal(ctxt->slices,
+                    ctxt->crc32, buf, n);
+        return;
+    }
+
     while (n--) {
         uint8_t ch;
         ch = *buf;
@@ -678,6 +985,8 @@ pcutils_crc32_begin_custom(uint32_t poly, uint32_t init, uint32_t xorout,
         ctxt->xorout = xorout;
         ctxt->refin = true;
         ctxt->refout = refout;
+        ctxt->slices = NULL;
+        ctxt->accel_poly = 0;
         if (refin) {
             calc_crc32_table(ctxt->table_alloc, poly, refin);
         }
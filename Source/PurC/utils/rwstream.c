@@ -28,6 +28,7 @@
 #include "purc-utils.h"
 #include "private/errors.h"
 #include "private/instance.h"
+#include "private/rwstream.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -104,6 +105,8 @@ struct mem_rwstream
     uint8_t* base;
     uint8_t* here;
     uint8_t* stop;
+    void *ctxt;
+    pcrws_cb_release cb_release;
 };
 
 struct buffer_rwstream
@@ -163,6 +166,17 @@ static rwstream_funcs mem_funcs = {
     mem_get_mem_buffer
 };
 
+/* the read-only memory rwstream which does not own the memory */
+static rwstream_funcs mem_ro_funcs = {
+    mem_seek,
+    mem_tell,
+    mem_read,
+    NULL,
+    mem_flush,
+    mem_destroy,
+    mem_get_mem_buffer
+};
+
 static off_t buffer_seek (purc_rwstream_t rws, off_t offset, int whence);
 static off_t buffer_tell (purc_rwstream_t rws);
 static ssize_t buffer_read (purc_rwstream_t rws, void* buf, size_t count);
@@ -255,6 +269,27 @@ purc_rwstream_t purc_rwstream_new_from_mem (void* mem, size_t sz)
     return (purc_rwstream_t)rws;
 }
 
+purc_rwstream_t
+pcrwstream_new_from_mem_ex (const void* mem, size_t sz, void *ctxt,
+        pcrws_cb_release release)
+{
+    struct mem_rwstream* rws = (struct mem_rwstream*) calloc(
+            1, sizeof(struct mem_rwstream));
+    if (rws == NULL) {
+        pcinst_set_error (PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    rws->rwstream.funcs = &mem_ro_funcs;
+    rws->base = (uint8_t *)mem;
+    rws->here = rws->base;
+    rws->stop = rws->base + sz;
+    rws->ctxt = ctxt;
+    rws->cb_release = release;
+
+    return (purc_rwstream_t)rws;
+}
+
 purc_rwstream_t purc_rwstream_new_from_file (const char* file, const char* mode)
 {
     FILE* fp = fopen(file, mode);
@@ -362,6 +397,7 @@ struct ro_rwstream
     purc_rwstream rwstream;
     void *ctxt;
     pcrws_cb_read cb_read;
+    pcrws_cb_release cb_release;
     off_t read_bytes;
 };
 
@@ -382,18 +418,29 @@ static ssize_t ro_read (purc_rwstream_t rws, void* buf, size_t count)
     return bytes;
 }
 
+static int ro_destroy (purc_rwstream_t rws)
+{
+    struct ro_rwstream *ro_rws = (struct ro_rwstream *)rws;
+
+    if (ro_rws->cb_release)
+        ro_rws->cb_release (ro_rws->ctxt);
+    free(ro_rws);
+    return 0;
+}
+
 static rwstream_funcs ro_funcs = {
     NULL,
     ro_tell,
     ro_read,
     NULL,
     NULL,
-    NULL,
+    ro_destroy,
     NULL
 };
 
 purc_rwstream_t
-purc_rwstream_new_for_read (void *ctxt, pcrws_cb_read fn)
+pcrwstream_new_for_read_ex (void *ctxt, pcrws_cb_read fn,
+        pcrws_cb_release release)
 {
     if (fn == NULL) {
         pcinst_set_error (PURC_ERROR_INVALID_VALUE);
@@ -402,14 +449,25 @@ purc_rwstream_new_for_read (void *ctxt, pcrws_cb_read fn)
 
     struct ro_rwstream* rws = (struct ro_rwstream*) calloc(1,
             sizeof (struct ro_rwstream));
+    if (rws == NULL) {
+        pcinst_set_error (PURC_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
 
     rws->rwstream.funcs = &ro_funcs;
     rws->ctxt = ctxt;
     rws->cb_read = fn;
+    rws->cb_release = release;
     rws->read_bytes = 0;
     return (purc_rwstream_t)rws;
 }
 
+purc_rwstream_t
+purc_rwstream_new_for_read (void *ctxt, pcrws_cb_read fn)
+{
+    return pcrwstream_new_for_read_ex (ctxt, fn, NULL);
+}
+
 int purc_rwstream_destroy (purc_rwstream_t rws)
 {
     if (rws == NULL) {
@@ -777,6 +835,8 @@ static ssize_t mem_flush (purc_rwstream_t rws)
 static int mem_destroy (purc_rwstream_t rws)
 {
     struct mem_rwstream* mem = (struct mem_rwstream *)rws;
+    if (mem->cb_release)
+        mem->cb_release (mem->ctxt);
     mem->base = NULL;
     mem->here = NULL;
     mem->stop = NULL;
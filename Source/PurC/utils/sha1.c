@@ -38,8 +38,14 @@ A million repetitions of "a"
 #include <string.h>
 
 #include "private/utils.h"
+#include "private/cpu.h"
 
-/* #define SHA1HANDSOFF * Copies data before messing with it. */
+#if PCUTILS_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* The input is copied before messing with it: it may be a constant. */
+#define SHA1HANDSOFF
 
 static void sha1_transform (uint32_t state[5], const uint8_t *buffer);
 
@@ -75,8 +81,8 @@ sha1_transform(uint32_t state[5], const uint8_t *buffer)
     } CHAR64LONG16;
     CHAR64LONG16 *block;
 #ifdef SHA1HANDSOFF
-    static uint8_t workspace[64];
-    block = (CHAR64LONG16 *) workspace;
+    CHAR64LONG16 workspace;
+    block = &workspace;
     memcpy (block, buffer, 64);
 #else
     block = (CHAR64LONG16 *) (void *) buffer;
@@ -178,6 +184,112 @@ sha1_transform(uint32_t state[5], const uint8_t *buffer)
     a = b = c = d = e = 0;
 }
 
+#if PCUTILS_X86_SIMD
+/* Four rounds with the SHA extensions of x86; the message schedule of the
+   later rounds is computed along the way, four words a time. */
+#define SHANI_ROUNDS(e_in, e_out, m0, m1, m2, m3, func)                 \
+    e_in = _mm_sha1nexte_epu32(e_in, m0);                               \
+    e_out = abcd;                                                       \
+    m1 = _mm_sha1msg2_epu32(m1, m0);                                    \
+    abcd = _mm_sha1rnds4_epu32(abcd, e_in, func);                       \
+    m3 = _mm_sha1msg1_epu32(m3, m0);                                    \
+    m2 = _mm_xor_si128(m2, m0);
+
+/* Hashes the 512-bit blocks with the SHA extensions of x86. */
+PCUTILS_TARGET("sha,ssse3,sse4.1")
+static void
+sha1_transform_shani(uint32_t state[5], const uint8_t *data, size_t nr_blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL,
+            0x08090a0b0c0d0e0fULL);
+    __m128i abcd, abcd_save, e0, e0_save, e1;
+    __m128i msg0, msg1, msg2, msg3;
+
+    abcd = _mm_loadu_si128((const __m128i *)state);
+    abcd = _mm_shuffle_epi32(abcd, 0x1B);
+    e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    for (; nr_blocks > 0; nr_blocks--, data += 64) {
+        abcd_save = abcd;
+        e0_save = e0;
+
+        /* rounds 0-3 */
+        msg0 = _mm_loadu_si128((const __m128i *)(data + 0));
+        msg0 = _mm_shuffle_epi8(msg0, mask);
+        e0 = _mm_add_epi32(e0, msg0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        /* rounds 4-7 */
+        msg1 = _mm_loadu_si128((const __m128i *)(data + 16));
+        msg1 = _mm_shuffle_epi8(msg1, mask);
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+        /* rounds 8-11 */
+        msg2 = _mm_loadu_si128((const __m128i *)(data + 32));
+        msg2 = _mm_shuffle_epi8(msg2, mask);
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        /* rounds 12-15 */
+        msg3 = _mm_loadu_si128((const __m128i *)(data + 48));
+        msg3 = _mm_shuffle_epi8(msg3, mask);
+        SHANI_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 0);
+
+        /* rounds 16-79 */
+        SHANI_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 0);
+        SHANI_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 1);
+        SHANI_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 1);
+        SHANI_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 1);
+        SHANI_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 1);
+        SHANI_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 1);
+        SHANI_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 2);
+        SHANI_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 2);
+        SHANI_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 2);
+        SHANI_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 2);
+        SHANI_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 2);
+        SHANI_ROUNDS(e1, e0, msg3, msg0, msg1, msg2, 3);
+        SHANI_ROUNDS(e0, e1, msg0, msg1, msg2, msg3, 3);
+        SHANI_ROUNDS(e1, e0, msg1, msg2, msg3, msg0, 3);
+        SHANI_ROUNDS(e0, e1, msg2, msg3, msg0, msg1, 3);
+
+        /* rounds 76-79 */
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    abcd = _mm_shuffle_epi32(abcd, 0x1B);
+    _mm_storeu_si128((__m128i *)state, abcd);
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+#endif
+
+/* Hashes the 512-bit blocks. */
+static void
+sha1_transform_blocks(uint32_t state[5], const uint8_t *data,
+        size_t nr_blocks)
+{
+#if PCUTILS_X86_SIMD
+    if (pcutils_cpu_has(PCUTILS_CPU_SHA | PCUTILS_CPU_SSE41)) {
+        sha1_transform_shani(state, data, nr_blocks);
+        return;
+    }
+#endif
+
+    for (; nr_blocks > 0; nr_blocks--, data += 64)
+        sha1_transform(state, data);
+}
+
 /* Initialize new context */
 void
 pcutils_sha1_begin(pcutils_sha1_ctxt *context)
@@ -204,10 +316,9 @@ pcutils_sha1_hash(pcutils_sha1_ctxt *context, const void *data, size_t len)
     context->count[1] += (len >> 29);
     if ((j + len) > 63) {
         memcpy (&context->buffer[j], bytes, (i = 64 - j));
-        sha1_transform (context->state, context->buffer);
-        for (; i + 63 < len; i += 64) {
-            sha1_transform (context->state, &bytes[i]);
-        }
+        sha1_transform_blocks (context->state, context->buffer, 1);
+        sha1_transform_blocks (context->state, &bytes[i], (len - i) / 64);
+        i += (len - i) / 64 * 64;
         j = 0;
     } else
         i = 0;
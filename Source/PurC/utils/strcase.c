@@ -41,22 +41,6 @@
 #if USE(GLIB)
 #include <glib.h>
 
-char *pcutils_strtoupper(const char *str, ssize_t len, size_t *len_new)
-{
-    char *new_str = g_utf8_strup(str, len);
-    if (len_new)
-        *len_new = strlen(new_str);
-    return new_str;
-}
-
-char *pcutils_strtolower(const char *str, ssize_t len, size_t *len_new)
-{
-    char *new_str = g_utf8_strdown(str, len);
-    if (len_new)
-        *len_new = strlen(new_str);
-    return new_str;
-}
-
 typedef enum {
   LOCALE_NORMAL,
   LOCALE_TURKIC,
@@ -87,6 +71,54 @@ static locale_type get_locale_type(void)
     return LOCALE_NORMAL;
 }
 
+/* Maps the case of a string of ASCII characters without GLib; the ASCII
+   letters map the same way in all locales but the Turkic ones. */
+static char *
+ascii_strcase(const char *str, size_t length, size_t *len_new, bool upper)
+{
+    char *new_str = malloc(length + 1);
+    if (new_str == NULL)
+        return NULL;
+
+    unsigned char first = upper ? 'a' : 'A';
+    for (size_t n = 0; n < length; n++) {
+        unsigned char c = str[n];
+        /* flip the case bit of the letters only */
+        new_str[n] = c ^ (((unsigned char)(c - first) < 26) << 5);
+    }
+    new_str[length] = '\0';
+
+    if (len_new)
+        *len_new = length;
+    return new_str;
+}
+
+char *pcutils_strtoupper(const char *str, ssize_t len, size_t *len_new)
+{
+    size_t length = (len < 0) ? strlen(str) : strnlen(str, len);
+    if (pcutils_string_ascii_prefix(str, length) == length &&
+            get_locale_type() != LOCALE_TURKIC)
+        return ascii_strcase(str, length, len_new, true);
+
+    char *new_str = g_utf8_strup(str, len);
+    if (len_new)
+        *len_new = strlen(new_str);
+    return new_str;
+}
+
+char *pcutils_strtolower(const char *str, ssize_t len, size_t *len_new)
+{
+    size_t length = (len < 0) ? strlen(str) : strnlen(str, len);
+    if (pcutils_string_ascii_prefix(str, length) == length &&
+            get_locale_type() != LOCALE_TURKIC)
+        return ascii_strcase(str, length, len_new, false);
+
+    char *new_str = g_utf8_strdown(str, len);
+    if (len_new)
+        *len_new = strlen(new_str);
+    return new_str;
+}
+
 #define G_UNICHAR_FULLWIDTH_A 0xff21
 #define G_UNICHAR_FULLWIDTH_I 0xff29
 #define G_UNICHAR_FULLWIDTH_J 0xff2a
@@ -211,6 +243,22 @@ int pcutils_strncasecmp(const char *s1, const char *s2, size_t n)
     locale_type lt = get_locale_type();
 
     while (n > 0) {
+        unsigned char c1 = *s1, c2 = *s2;
+
+        /* the ASCII letters other than I and J are lowercased the same way
+           in all locales; the differences have the same signs as below */
+        if ((c1 | c2) < 0x80 && c1 != 'I' && c2 != 'I' &&
+                c1 != 'J' && c2 != 'J') {
+            int diff = purc_tolower(c1) - purc_tolower(c2);
+            if (diff)
+                return diff;
+
+            s1++;
+            s2++;
+            n--;
+            continue;
+        }
+
         size_t len1 = utf8_char_to_lower(lt, s1, ucs1);
         size_t len2 = utf8_char_to_lower(lt, s2, ucs2);
 
@@ -34,10 +34,15 @@
 
 #include "private/utf8.h"
 #include "private/utils.h"
+#include "private/cpu.h"
 
 #include <string.h>
 #include <assert.h>
 
+#if PCUTILS_X86_SIMD
+#include <immintrin.h>
+#endif
+
 #define VALIDATE_BYTE(mask, expect)                         \
 do {                                                        \
     if (UNLIKELY((*(uint8_t *)p & (mask)) != (expect)))     \
@@ -46,13 +51,230 @@ do {                                                        \
 
 /* see IETF RFC 3629 Section 4 */
 
+#if PCUTILS_X86_SIMD
+/* The error bits of the lookup tables below; see "Validating UTF-8 In Less
+   Than One Instruction Per Byte" by John Keiser and Daniel Lemire. */
+#define TOO_SHORT       (1 << 0)    /* 11______ 0_______, 11______ 11______ */
+#define TOO_LONG        (1 << 1)    /* 0_______ 10______ */
+#define OVERLONG_3      (1 << 2)    /* 11100000 100_____ */
+#define TOO_LARGE       (1 << 3)    /* 11110100 1001____ and greater */
+#define SURROGATE       (1 << 4)    /* 11101101 101_____ */
+#define OVERLONG_2      (1 << 5)    /* 1100000_ 10______ */
+#define TOO_LARGE_1000  (1 << 6)    /* 11110101 1000____ and greater */
+#define OVERLONG_4      (1 << 6)    /* 11110000 1000____ */
+#define TWO_CONTS       (1 << 7)    /* 10______ 10______ */
+#define CARRY           (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+#define LOOKUP16(v0, v1, v2, v3, v4, v5, v6, v7,                        \
+        v8, v9, v10, v11, v12, v13, v14, v15)                           \
+    _mm256_setr_epi8((char)(v0), (char)(v1), (char)(v2), (char)(v3),    \
+        (char)(v4), (char)(v5), (char)(v6), (char)(v7),                 \
+        (char)(v8), (char)(v9), (char)(v10), (char)(v11),               \
+        (char)(v12), (char)(v13), (char)(v14), (char)(v15),             \
+        (char)(v0), (char)(v1), (char)(v2), (char)(v3),                 \
+        (char)(v4), (char)(v5), (char)(v6), (char)(v7),                 \
+        (char)(v8), (char)(v9), (char)(v10), (char)(v11),               \
+        (char)(v12), (char)(v13), (char)(v14), (char)(v15))
+
+/* the bytes of the input shifted right by n bytes, with the last bytes of
+   the previous block shifted in */
+#define PREV_BYTES(input, prev_input, n)                                \
+    _mm256_alignr_epi8(input,                                           \
+        _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - (n))
+
+/* Validates and counts the characters 32 bytes a time, until a block
+   contains a null byte or an invalid sequence, or less than 32 bytes are
+   left. Returns the end of the characters validated, which is always on
+   a character boundary, and adds the number of them to *nr_chars. */
+PCUTILS_TARGET("avx2")
+static const char *
+validate_avx2(const char *str, size_t max_len, size_t *nr_chars)
+{
+    const __m256i byte_1_high = LOOKUP16(
+            /* 0_______ ________ <ASCII in byte 1> */
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            /* 10______ ________ <continuation in byte 1> */
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            /* 1100____ ________ <two byte lead in byte 1> */
+            TOO_SHORT | OVERLONG_2,
+            /* 1101____ ________ <two byte lead in byte 1> */
+            TOO_SHORT,
+            /* 1110____ ________ <three byte lead in byte 1> */
+            TOO_SHORT | OVERLONG_3 | SURROGATE,
+            /* 1111____ ________ <four+ byte lead in byte 1> */
+            TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+    const __m256i byte_1_low = LOOKUP16(
+            /* ____0000 ________ */
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            /* ____0001 ________ */
+            CARRY | OVERLONG_2,
+            /* ____001_ ________ */
+            CARRY, CARRY,
+            /* ____0100 ________ */
+            CARRY | TOO_LARGE,
+            /* ____0101 ________ */
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            /* ____011_ ________ */
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            /* ____1___ ________ */
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            /* ____1101 ________ */
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000);
+    const __m256i byte_2_high = LOOKUP16(
+            /* ________ 0_______ <ASCII in byte 2> */
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            /* ________ 1000____ */
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 |
+                TOO_LARGE_1000 | OVERLONG_4,
+            /* ________ 1001____ */
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+            /* ________ 101_____ */
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            /* ________ 11______ */
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+    /* the last three bytes may start a character ending in the next block */
+    const __m256i max_value = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            (char)(0xf0 - 1), (char)(0xe0 - 1), (char)(0xc0 - 1));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+
+    __m256i prev_input = zero;
+    __m256i prev_incomplete = zero;
+    size_t n = 0;
+    size_t i;
+
+    for (i = 0; i + 32 <= max_len; i += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i *)(str + i));
+        __m256i error;
+
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(input, zero)))
+            break;
+
+        if (_mm256_movemask_epi8(input) == 0) {
+            /* all ASCII: only a character left by the last block can fail */
+            error = prev_incomplete;
+        }
+        else {
+            __m256i prev1 = PREV_BYTES(input, prev_input, 1);
+            __m256i special = _mm256_and_si256(
+                    _mm256_and_si256(
+                        _mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(
+                                _mm256_srli_epi16(prev1, 4), nibble)),
+                        _mm256_shuffle_epi8(byte_1_low,
+                            _mm256_and_si256(prev1, nibble))),
+                    _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(
+                            _mm256_srli_epi16(input, 4), nibble)));
+
+            /* the third and fourth bytes must be continuation bytes */
+            __m256i prev2 = PREV_BYTES(input, prev_input, 2);
+            __m256i prev3 = PREV_BYTES(input, prev_input, 3);
+            __m256i must23 = _mm256_or_si256(
+                    _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0 - 0x80)),
+                    _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0 - 0x80)));
+            must23 = _mm256_and_si256(must23, _mm256_set1_epi8((char)0x80));
+            error = _mm256_xor_si256(must23, special);
+        }
+
+        if (!_mm256_testz_si256(error, error))
+            break;
+
+        prev_incomplete = _mm256_subs_epu8(input, max_value);
+        prev_input = input;
+
+        /* count the bytes other than the continuation bytes */
+        n += __builtin_popcount(_mm256_movemask_epi8(
+                    _mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65))));
+    }
+
+    if (i > 0) {
+        /* leave the last character, which may be incomplete, to the caller */
+        const uint8_t *p = (const uint8_t *)str + i - 1;
+        while ((*p & 0xc0) == 0x80)
+            p--;
+        if (*p >= 0x80) {
+            i = (const char *)p - str;
+            n--;
+        }
+    }
+
+    *nr_chars += n;
+    return str + i;
+}
+
+#undef TOO_SHORT
+#undef TOO_LONG
+#undef OVERLONG_3
+#undef TOO_LARGE
+#undef SURROGATE
+#undef OVERLONG_2
+#undef TOO_LARGE_1000
+#undef OVERLONG_4
+#undef TWO_CONTS
+#undef CARRY
+#undef LOOKUP16
+#undef PREV_BYTES
+
+/* Returns the number of the leading ASCII characters other than the null
+   byte, 32 bytes a time. */
+PCUTILS_TARGET("avx2")
+static size_t
+ascii_prefix_avx2(const char *str, size_t len)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i;
+
+    for (i = 0; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(str + i));
+        if (_mm256_movemask_epi8(_mm256_or_si256(v,
+                        _mm256_cmpeq_epi8(v, zero))))
+            break;
+    }
+
+    return i;
+}
+#endif  /* PCUTILS_X86_SIMD */
+
+size_t
+pcutils_string_ascii_prefix(const char *str, size_t len)
+{
+    size_t i = 0;
+
+#if PCUTILS_X86_SIMD
+    if (len >= 32 && pcutils_cpu_has(PCUTILS_CPU_AVX2))
+        i = ascii_prefix_avx2(str, len);
+#endif
+
+    while (i < len && (uint8_t)(str[i] - 1) < 0x7f)
+        i++;
+
+    return i;
+}
+
 static const char *
 fast_validate(const char *str, size_t *nr_chars)
 {
     size_t n = 0;
-    const char *p;
+    const char *p = str;
+
+#if PCUTILS_X86_SIMD
+    if (pcutils_cpu_has(PCUTILS_CPU_AVX2))
+        p = validate_avx2(str, strlen(str), &n);
+#endif
 
-    for (p = str; *p; p++) {
+    for (; *p; p++) {
         if (*(uint8_t *)p < 128) {
             n++;
         }
@@ -121,11 +343,16 @@ static const char *
 fast_validate_len(const char *str, ssize_t max_len, size_t *nr_chars)
 {
     size_t n = 0;
-    const char *p;
+    const char *p = str;
 
     assert(max_len >= 0);
 
-    for (p = str; ((p - str) < max_len) && *p; p++) {
+#if PCUTILS_X86_SIMD
+    if (max_len >= 32 && pcutils_cpu_has(PCUTILS_CPU_AVX2))
+        p = validate_avx2(str, max_len, &n);
+#endif
+
+    for (; ((p - str) < max_len) && *p; p++) {
         if (*(uint8_t *)p < 128) {
             n++;
         }
@@ -252,11 +479,28 @@ size_t
 pcutils_string_utf8_chars(const char *p, ssize_t max)
 {
     size_t nr_chars = 0;
-    const char *start = p;
+    const char *start;
 
     if (p == NULL || max == 0)
         return 0;
 
+#if PCUTILS_X86_SIMD
+    if (pcutils_cpu_has(PCUTILS_CPU_AVX2)) {
+        /* the valid characters are counted the same way as below */
+        const char *end = validate_avx2(p, (max < 0) ? strlen(p) : (size_t)max,
+                &nr_chars);
+        if (end > p) {
+            if (max > 0) {
+                max -= end - p;
+                if (max == 0 || *end == '\0')
+                    return nr_chars;
+            }
+            p = end;
+        }
+    }
+#endif
+
+    start = p;
     if (max < 0) {
         while (*p) {
             p = pcutils_utf8_next_char(p);
@@ -24,6 +24,7 @@
 #include "private/errors.h"
 #include "private/printbuf.h"
 #include "private/debug.h"
+#include "private/cpu.h"
 
 #include <stdarg.h>
 #include <stdlib.h>
@@ -35,6 +36,10 @@
 #include <glib.h>
 #endif // HAVE(GLIB)
 
+#if PCUTILS_X86_SIMD
+#include <immintrin.h>
+#endif
+
 #define foreach_arg(_arg, _addr, _len, _first_addr, _first_len) \
     for (_addr = (_first_addr), _len = (_first_len); \
         _addr; \
@@ -78,6 +83,86 @@ void *pcutils_calloc_a(size_t len, ...)
 static const char *hex_digits_lower = "0123456789abcdef";
 static const char *hex_digits_upper = "0123456789ABCDEF";
 
+#if PCUTILS_X86_SIMD
+/* Converts 32 bytes to 64 heximal characters a time; returns the number of
+   the bytes converted. */
+PCUTILS_TARGET("avx2")
+static size_t
+bin2hex_avx2(const unsigned char *bin, size_t len, char *hex,
+        const char *hex_digits)
+{
+    const __m256i digits = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *)hex_digits));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    size_t i;
+
+    for (i = 0; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(bin + i));
+        __m256i hi = _mm256_shuffle_epi8(digits,
+                _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        __m256i lo = _mm256_shuffle_epi8(digits,
+                _mm256_and_si256(v, nibble));
+
+        /* the unpacking works in the lanes: reorder the halves */
+        __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i *)(hex + i * 2),
+                _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i *)(hex + i * 2 + 32),
+                _mm256_permute2x128_si256(first, second, 0x31));
+    }
+
+    return i;
+}
+
+/* Converts 64 heximal characters to 32 bytes a time, as long as all
+   characters are heximal digits; returns the number of the characters
+   converted. */
+PCUTILS_TARGET("avx2")
+static size_t
+hex2bin_avx2(const char *hex, size_t len, unsigned char *bin)
+{
+    size_t i;
+
+    for (i = 0; i + 64 <= len; i += 64) {
+        __m256i values[2];
+        int invalid = 0;
+
+        for (int j = 0; j < 2; j++) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(hex + i + j * 32));
+            __m256i digit = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+            __m256i alpha = _mm256_sub_epi8(
+                    _mm256_or_si256(v, _mm256_set1_epi8(0x20)),
+                    _mm256_set1_epi8('a'));
+
+            /* x <= n (unsigned) iff min(x, n) == x */
+            __m256i is_digit = _mm256_cmpeq_epi8(digit,
+                    _mm256_min_epu8(digit, _mm256_set1_epi8(9)));
+            __m256i is_alpha = _mm256_cmpeq_epi8(alpha,
+                    _mm256_min_epu8(alpha, _mm256_set1_epi8(5)));
+            invalid |= ~_mm256_movemask_epi8(
+                    _mm256_or_si256(is_digit, is_alpha));
+
+            values[j] = _mm256_blendv_epi8(
+                    _mm256_add_epi8(alpha, _mm256_set1_epi8(10)),
+                    digit, is_digit);
+        }
+
+        if (invalid)
+            break;
+
+        /* merge the pairs of nibbles, then pack the bytes */
+        __m256i a = _mm256_maddubs_epi16(values[0], _mm256_set1_epi16(0x0110));
+        __m256i b = _mm256_maddubs_epi16(values[1], _mm256_set1_epi16(0x0110));
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b),
+                0xD8);
+        _mm256_storeu_si256((__m256i *)(bin + i / 2), packed);
+    }
+
+    return i;
+}
+#endif
+
 void pcutils_bin2hex (const unsigned char *bin, size_t len, char *hex,
         bool uppercase)
 {
@@ -88,6 +173,15 @@ void pcutils_bin2hex (const unsigned char *bin, size_t len, char *hex,
     else
         hex_digits = hex_digits_lower;
 
+#if PCUTILS_X86_SIMD
+    if (len >= 32 && pcutils_cpu_has(PCUTILS_CPU_AVX2)) {
+        size_t done = bin2hex_avx2(bin, len, hex, hex_digits);
+        bin += done;
+        hex += done * 2;
+        len -= done;
+    }
+#endif
+
     for (size_t i = 0; i < len; i++) {
         unsigned char byte = bin [i];
         hex [i*2] = hex_digits [(byte >> 4) & 0x0f];
@@ -98,10 +192,26 @@ void pcutils_bin2hex (const unsigned char *bin, size_t len, char *hex,
 
 int pcutils_hex2bin (const char *hex, unsigned char *bin, size_t *converted)
 {
+    return pcutils_hex2bin_ex (hex, strlen (hex), bin, converted);
+}
+
+int pcutils_hex2bin_ex (const char *hex, size_t len, unsigned char *bin,
+        size_t *converted)
+{
+    const char *end = hex + len;
     size_t pos = 0;
     size_t sz = 0;
 
-    while (*hex) {
+#if PCUTILS_X86_SIMD
+    if (len >= 64 && pcutils_cpu_has(PCUTILS_CPU_AVX2)) {
+        pos = hex2bin_avx2(hex, len, bin);
+        hex += pos;
+        bin += pos / 2;
+        sz = pos / 2;
+    }
+#endif
+
+    while (hex < end && *hex) {
         unsigned char half;
 
         if (*hex >= '0' && *hex <= '9') {
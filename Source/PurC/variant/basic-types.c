@@ -44,6 +44,9 @@
 
 #define IS_TYPE(v, t)   (v->type == t)
 
+/* the number of characters of a string slice is counted when asked */
+#define NR_CHARS_UNKNOWN    ((size_t)-1)
+
 // API for variant
 purc_variant_t purc_variant_make_undefined (void)
 {
@@ -339,6 +342,19 @@ purc_variant_t purc_variant_make_string_static(const char* str_utf8,
     return value;
 }
 
+/* The byte following a string slice is in the buffer of its parent;
+   copies the slice if the byte is not a null byte. */
+static bool
+string_slice_terminate(purc_variant_t string)
+{
+    const char *str = (const char *)string->sz_ptr[1];
+
+    if (str[string->sz_ptr[0] - 1] == '\0')
+        return true;
+
+    return pcvariant_slice_detach(string);
+}
+
 const char* purc_variant_get_string_const_ex(purc_variant_t string,
         size_t *str_len)
 {
@@ -349,8 +365,14 @@ const char* purc_variant_get_string_const_ex(purc_variant_t string,
     const char *str_str = NULL;
 
     if (IS_TYPE(string, PURC_VARIANT_TYPE_STRING)) {
+        if ((string->flags & PCVRNT_FLAG_STRING_SLICE) &&
+                !string_slice_terminate(string)) {
+            return NULL;
+        }
+
         if ((string->flags & PCVRNT_FLAG_EXTRA_SIZE) ||
-                (string->flags & PCVRNT_FLAG_STRING_STATIC)) {
+                (string->flags & PCVRNT_FLAG_STRING_STATIC) ||
+                (string->flags & PCVRNT_FLAG_STRING_SLICE)) {
             str_str = (const char *)string->sz_ptr[1];
             len = (size_t)string->sz_ptr[0] - 1;
         }
@@ -381,7 +403,8 @@ bool purc_variant_string_bytes(purc_variant_t string, size_t *length)
 
     if (IS_TYPE(string, PURC_VARIANT_TYPE_STRING)) {
         if ((string->flags & PCVRNT_FLAG_EXTRA_SIZE) ||
-                (string->flags & PCVRNT_FLAG_STRING_STATIC))
+                (string->flags & PCVRNT_FLAG_STRING_STATIC) ||
+                (string->flags & PCVRNT_FLAG_STRING_SLICE))
             *length = (size_t)string->sz_ptr[0];
         else
             *length = string->size;
@@ -402,6 +425,12 @@ bool purc_variant_string_chars(purc_variant_t string, size_t *nr_chars)
         IS_TYPE(string, PURC_VARIANT_TYPE_ATOMSTRING) ||
         IS_TYPE(string, PURC_VARIANT_TYPE_EXCEPTION)) {
 
+        if (string->extra_size == NR_CHARS_UNKNOWN) {
+            size_t len;
+            const char *str = pcvariant_get_bytes_const(string, &len);
+            string->extra_size = pcutils_string_utf8_chars(str, len);
+        }
+
         *nr_chars = string->extra_size;
         return true;
     }
@@ -420,6 +449,9 @@ void pcvariant_string_release (purc_variant_t string)
             pcvariant_stat_set_extra_size (string, 0);
             free ((void *)string->sz_ptr[1]);
         }
+        else if (string->flags & PCVRNT_FLAG_STRING_SLICE) {
+            purc_variant_unref(string->parent);
+        }
     }
     else
         pcinst_set_error (PCVRNT_ERROR_INVALID_TYPE);
@@ -667,7 +699,8 @@ const unsigned char *purc_variant_get_bytes_const(purc_variant_t sequence,
 
     if (IS_TYPE(sequence, PURC_VARIANT_TYPE_BSEQUENCE)) {
         if ((sequence->flags & PCVRNT_FLAG_EXTRA_SIZE) ||
-                    (sequence->flags & PCVRNT_FLAG_STRING_STATIC)) {
+                    (sequence->flags & PCVRNT_FLAG_STRING_STATIC) ||
+                    (sequence->flags & PCVRNT_FLAG_STRING_SLICE)) {
             bytes = (const unsigned char *)sequence->sz_ptr[1];
             *nr_bytes = (size_t)sequence->sz_ptr[0];
         }
@@ -677,8 +710,15 @@ const unsigned char *purc_variant_get_bytes_const(purc_variant_t sequence,
         }
     }
     else if (IS_TYPE(sequence, PURC_VARIANT_TYPE_STRING)) {
+        /* the terminating null byte is counted in */
+        if ((sequence->flags & PCVRNT_FLAG_STRING_SLICE) &&
+                !string_slice_terminate(sequence)) {
+            return NULL;
+        }
+
         if ((sequence->flags & PCVRNT_FLAG_EXTRA_SIZE) ||
-                (sequence->flags & PCVRNT_FLAG_STRING_STATIC)) {
+                (sequence->flags & PCVRNT_FLAG_STRING_STATIC) ||
+                (sequence->flags & PCVRNT_FLAG_STRING_SLICE)) {
             bytes = (const unsigned char *)sequence->sz_ptr[1];
             *nr_bytes = (size_t)sequence->sz_ptr[0];
         }
@@ -699,7 +739,8 @@ bool purc_variant_bsequence_bytes(purc_variant_t sequence, size_t *length)
 
     if (IS_TYPE (sequence, PURC_VARIANT_TYPE_BSEQUENCE)) {
         if ((sequence->flags & PCVRNT_FLAG_EXTRA_SIZE) ||
-                    (sequence->flags & PCVRNT_FLAG_STRING_STATIC))
+                    (sequence->flags & PCVRNT_FLAG_STRING_STATIC) ||
+                    (sequence->flags & PCVRNT_FLAG_STRING_SLICE))
             *length = (size_t)sequence->sz_ptr[0];
         else
             *length = sequence->size;
@@ -721,11 +762,178 @@ void pcvariant_sequence_release(purc_variant_t sequence)
             pcvariant_stat_set_extra_size (sequence, 0);
             free((void *)sequence->sz_ptr[1]);
         }
+        else if (sequence->flags & PCVRNT_FLAG_STRING_SLICE) {
+            purc_variant_unref(sequence->parent);
+        }
     }
     else
         pcinst_set_error (PCVRNT_ERROR_INVALID_TYPE);
 }
 
+/* Returns the length of the longest prefix of the len bytes at str, which
+   are taken from a valid UTF-8 string, without a broken character. */
+static size_t
+utf8_whole_chars_len(const char *str, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)str;
+    size_t lead = len;
+
+    if (len == 0 || (p[0] & 0xC0) == 0x80)
+        return 0;
+
+    while (lead > 0 && (p[lead - 1] & 0xC0) == 0x80)
+        lead--;
+    lead--;
+
+    return (lead + _pcutils_utf8_skip[p[lead]] <= len) ? len : lead;
+}
+
+/* Checks the range of a slice and returns the variant owning the buffer;
+   the byte following a string slice must be in the buffer too. */
+static purc_variant_t
+slice_get_owner(purc_variant_t parent, const char *start, size_t len,
+        bool for_string)
+{
+    if (!IS_TYPE(parent, PURC_VARIANT_TYPE_STRING) &&
+            !IS_TYPE(parent, PURC_VARIANT_TYPE_BSEQUENCE)) {
+        pcinst_set_error(PCVRNT_ERROR_INVALID_TYPE);
+        return PURC_VARIANT_INVALID;
+    }
+
+    size_t sz_buf;
+    const char *buf = pcvariant_get_bytes_const(parent, &sz_buf);
+    if (IS_TYPE(parent, PURC_VARIANT_TYPE_STRING))
+        sz_buf++;   // the terminating null byte
+    if (for_string)
+        len++;
+
+    if (start < buf || len > sz_buf || start - buf > (ptrdiff_t)(sz_buf - len)) {
+        pcinst_set_error(PURC_ERROR_INVALID_VALUE);
+        return PURC_VARIANT_INVALID;
+    }
+
+    if (parent->flags & PCVRNT_FLAG_STRING_SLICE)
+        return parent->parent;
+    return parent;
+}
+
+purc_variant_t
+pcvariant_make_string_slice(purc_variant_t parent, const char *str,
+        size_t len, bool check_encoding)
+{
+    PCVRNT_CHECK_FAIL_RET(parent && str, PURC_VARIANT_INVALID);
+
+    static const size_t sz_bytes = MAX(sizeof(long double), sizeof(void*) * 2);
+    purc_variant_t owner = slice_get_owner(parent, str, len, true);
+    if (owner == PURC_VARIANT_INVALID)
+        return PURC_VARIANT_INVALID;
+
+    if (len < sz_bytes)
+        return purc_variant_make_string_ex(str, len, check_encoding);
+
+    size_t nr_chars = NR_CHARS_UNKNOWN;
+    size_t valid_len;
+    if (IS_TYPE(parent, PURC_VARIANT_TYPE_STRING)) {
+        /* only the ends of a slice of a string may break a character */
+        valid_len = utf8_whole_chars_len(str, len);
+    }
+    else {
+        const char *end;
+        pcutils_string_check_utf8_len(str, len, &nr_chars, &end);
+        valid_len = end - str;
+    }
+
+    if (valid_len < len) {
+        if (check_encoding) {
+            pcinst_set_error(PURC_ERROR_BAD_ENCODING);
+            return PURC_VARIANT_INVALID;
+        }
+
+        len = valid_len;
+        if (len < sz_bytes)
+            return purc_variant_make_string_ex(str, len, false);
+    }
+
+    purc_variant_t value = pcvariant_get(PURC_VARIANT_TYPE_STRING);
+    if (value == NULL) {
+        pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return PURC_VARIANT_INVALID;
+    }
+
+    value->type = PURC_VARIANT_TYPE_STRING;
+    value->size = 0;
+    value->flags = PCVRNT_FLAG_STRING_SLICE;
+    value->refc = 1;
+    value->extra_size = nr_chars;
+    // VWNOTE: the size includes the byte following the slice.
+    value->sz_ptr[0] = len + 1;
+    value->sz_ptr[1] = (uintptr_t)str;
+    value->parent = purc_variant_ref(owner);
+
+    return value;
+}
+
+purc_variant_t
+pcvariant_make_byte_sequence_slice(purc_variant_t parent, const void *bytes,
+        size_t nr_bytes)
+{
+    PCVRNT_CHECK_FAIL_RET(parent && bytes, PURC_VARIANT_INVALID);
+
+    static const size_t sz_bytes = MAX(sizeof(long double), sizeof(void*) * 2);
+    purc_variant_t owner = slice_get_owner(parent, bytes, nr_bytes, false);
+    if (owner == PURC_VARIANT_INVALID)
+        return PURC_VARIANT_INVALID;
+
+    if (nr_bytes == 0)
+        return purc_variant_make_byte_sequence_empty();
+    if (nr_bytes <= sz_bytes)
+        return purc_variant_make_byte_sequence(bytes, nr_bytes);
+
+    purc_variant_t value = pcvariant_get(PURC_VARIANT_TYPE_BSEQUENCE);
+    if (value == NULL) {
+        pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return PURC_VARIANT_INVALID;
+    }
+
+    value->type = PURC_VARIANT_TYPE_BSEQUENCE;
+    value->size = 0;
+    value->flags = PCVRNT_FLAG_STRING_SLICE;
+    value->refc = 1;
+    value->sz_ptr[0] = nr_bytes;
+    value->sz_ptr[1] = (uintptr_t)bytes;
+    value->parent = purc_variant_ref(owner);
+
+    return value;
+}
+
+bool pcvariant_slice_detach(purc_variant_t v)
+{
+    if (!(v->flags & PCVRNT_FLAG_STRING_SLICE))
+        return true;
+
+    size_t sz = (size_t)v->sz_ptr[0];
+    char *buf = malloc(sz);
+    if (buf == NULL) {
+        pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+
+    memcpy(buf, (const char *)v->sz_ptr[1], sz);
+    if (IS_TYPE(v, PURC_VARIANT_TYPE_STRING))
+        buf[sz - 1] = '\0';
+
+    purc_variant_unref(v->parent);
+    INIT_LIST_HEAD(&v->listeners);
+
+    v->flags &= ~PCVRNT_FLAG_STRING_SLICE;
+    v->flags |= PCVRNT_FLAG_EXTRA_SIZE;
+    v->sz_ptr[0] = 0;
+    v->sz_ptr[1] = (uintptr_t)buf;
+    // VWNOTE: sz_ptr[0] will be set in pcvariant_stat_set_extra_size
+    pcvariant_stat_set_extra_size(v, sz);
+    return true;
+}
+
 purc_variant_t purc_variant_make_dynamic(purc_dvariant_method getter,
         purc_dvariant_method setter)
 {
@@ -25,16 +25,26 @@
 #include "config.h"
 #include "private/variant.h"
 #include "private/errors.h"
+#include "private/hashtable.h"
 #include "variant-internals.h"
 #include "purc-errors.h"
 #include "purc-utils.h"
 
 
 #include <limits.h>
+#include <math.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 
+/* The members are matched through a transient hash index instead of the
+   nested loops if the product of the sizes of the operands exceeds this. */
+#define HASH_INDEX_THRESHOLD    1024
+
+/* Two integral numbers in this range are equal under pcutils_equal_doubles()
+   if and only if they are identical. */
+#define MAX_EXACT_INTEGER       1125899906842624.0  /* 2^50 */
+
 #define SET_SILENT_ERROR(error)                                     \
     do {                                                            \
         if (!silently)                                              \
@@ -283,6 +293,176 @@ end:
     return ret;
 }
 
+/*
+ * purc_variant_compare_ex() with PCVRNT_COMPARE_METHOD_AUTO compares
+ * numbers as numbers and others as their stringified forms. Both are
+ * equivalence relations as long as the operands fall into the same class
+ * and the numbers are exact integers; we only build the hash index in this
+ * case, and fall back to the nested loops otherwise.
+ */
+enum member_class {
+    MEMBER_CLASS_UNKNOWN = 0,
+    MEMBER_CLASS_NUMBER,
+    MEMBER_CLASS_STRING,
+};
+
+struct member_key {
+    purc_variant_t      val;
+    unsigned long       hash;
+    /* the occurrences in the index not matched yet */
+    size_t              count;
+};
+
+static enum member_class
+member_key_init(struct member_key *key, purc_variant_t val)
+{
+    const char *str = NULL;
+    char *buf = NULL;
+
+    key->val = val;
+    key->count = 1;
+
+    switch (purc_variant_get_type(val)) {
+    case PURC_VARIANT_TYPE_NUMBER:
+    case PURC_VARIANT_TYPE_LONGINT:
+    case PURC_VARIANT_TYPE_ULONGINT:
+    case PURC_VARIANT_TYPE_LONGDOUBLE:
+        {
+            double d = purc_variant_numerify(val);
+            if (!(d > -MAX_EXACT_INTEGER && d < MAX_EXACT_INTEGER) ||
+                    d != trunc(d))
+                return MEMBER_CLASS_UNKNOWN;
+
+            uint64_t u = (uint64_t)(int64_t)d;
+            u = (u ^ (u >> 31)) * 0x9E3779B97F4A7C15ULL;
+            key->hash = (unsigned long)(u ^ (u >> 29));
+            return MEMBER_CLASS_NUMBER;
+        }
+
+    case PURC_VARIANT_TYPE_STRING:
+    case PURC_VARIANT_TYPE_ATOMSTRING:
+    case PURC_VARIANT_TYPE_EXCEPTION:
+        str = purc_variant_get_string_const_ex(val, NULL);
+        break;
+
+    default:
+        if (purc_variant_stringify_alloc(&buf, val) < 0)
+            return MEMBER_CLASS_UNKNOWN;
+        str = buf;
+        break;
+    }
+
+    if (str == NULL)
+        return MEMBER_CLASS_UNKNOWN;
+
+    key->hash = pchash_perllike_str_hash(str);
+    free(buf);
+    return MEMBER_CLASS_STRING;
+}
+
+static unsigned long
+member_key_hash(const void *k)
+{
+    return ((const struct member_key *)k)->hash;
+}
+
+static int
+member_key_equal(const void *k1, const void *k2)
+{
+    const struct member_key *key1 = k1;
+    const struct member_key *key2 = k2;
+
+    return key1->hash == key2->hash &&
+        purc_variant_compare_ex(key1->val, key2->val,
+                PCVRNT_COMPARE_METHOD_AUTO) == 0;
+}
+
+/*
+ * Removes the members of src from the array dst, one matched member of dst
+ * for every member of src, like remove_array_member() does one by one, but
+ * in O(n + m) time. Returns 1 if done, 0 if the operands are too small or
+ * not suitable for the hash index, and -1 on failure.
+ */
+static int
+array_remove_hashed(purc_variant_t dst, purc_variant_t src)
+{
+    size_t n = purc_variant_array_get_size(dst);
+    ssize_t m = purc_variant_linear_container_get_size(src);
+    if (n == 0 || m <= 0 || n * (size_t)m < HASH_INDEX_THRESHOLD)
+        return 0;
+
+    int ret = -1;
+    struct member_key *keys = calloc(m, sizeof(*keys));
+    size_t *victims = malloc(sizeof(*victims) * (n < (size_t)m ? n : (size_t)m));
+    struct pchash_table *index = pchash_table_new(HASHTABLE_DEFAULT_SIZE,
+            NULL, member_key_hash, member_key_equal);
+    if (keys == NULL || victims == NULL || index == NULL) {
+        pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+        goto out;
+    }
+
+    enum member_class klass = MEMBER_CLASS_UNKNOWN;
+    size_t nr_keys = 0, nr_wanted = 0;
+    for (ssize_t i = 0; i < m; i++) {
+        purc_variant_t v = purc_variant_linear_container_get(src, i);
+        if (v == PURC_VARIANT_INVALID)
+            continue;
+
+        struct member_key *key = keys + nr_keys;
+        enum member_class c = member_key_init(key, v);
+        if (c == MEMBER_CLASS_UNKNOWN || (klass && c != klass)) {
+            ret = 0;
+            goto out;
+        }
+        klass = c;
+        nr_wanted++;
+
+        struct pchash_entry *e;
+        e = pchash_table_lookup_entry_w_hash(index, key, key->hash);
+        if (e) {
+            ((struct member_key *)e->v)->count++;
+        }
+        else if (pchash_table_insert_w_hash(index, key, key, key->hash, 0)) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            goto out;
+        }
+        else {
+            nr_keys++;
+        }
+    }
+
+    /* match the members of dst in order; nothing is changed until all
+       the candidates are known to be comparable through the index */
+    size_t nr_victims = 0;
+    for (size_t i = 0; i < n && nr_victims < nr_wanted; i++) {
+        struct member_key probe;
+        if (member_key_init(&probe, purc_variant_array_get(dst, i)) != klass) {
+            ret = 0;
+            goto out;
+        }
+
+        struct pchash_entry *e;
+        e = pchash_table_lookup_entry_w_hash(index, &probe, probe.hash);
+        if (e && ((struct member_key *)e->v)->count > 0) {
+            ((struct member_key *)e->v)->count--;
+            victims[nr_victims++] = i;
+        }
+    }
+
+    for (size_t i = nr_victims; i > 0; i--) {
+        if (!purc_variant_array_remove(dst, victims[i - 1]))
+            goto out;
+    }
+    ret = 1;
+
+out:
+    if (index)
+        pchash_table_free(index);
+    free(victims);
+    free(keys);
+    return ret;
+}
+
 static purc_variant_t
 clone_if_necessary(purc_variant_t val)
 {
@@ -497,6 +677,12 @@ array_remove(purc_variant_t dst, purc_variant_t src, bool silently)
         goto end;
     }
 
+    int r = array_remove_hashed(dst, src);
+    if (r) {
+        ret = (r > 0);
+        goto end;
+    }
+
     if (type == PURC_VARIANT_TYPE_ARRAY) {
         ret = array_foreach(src, remove_array_member, dst, silently);
     }
@@ -504,7 +690,7 @@ array_remove(purc_variant_t dst, purc_variant_t src, bool silently)
         ret = set_foreach(src, remove_array_member, dst, silently);
     }
     else {
-        ret = tuple_foreach(src, append_array_member, dst, silently);
+        ret = tuple_foreach(src, remove_array_member, dst, silently);
     }
 
 end:
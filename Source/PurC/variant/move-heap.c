@@ -133,9 +133,29 @@ struct pcmodule _module_mvheap = {
     .init_instance   = NULL,
 };
 
+/* A slice must not refer to a buffer of a variant in the heap of the
+   instance; copy the bytes with the heap of the instance in use. */
+static bool
+detach_slice(struct pcinst *inst, purc_variant_t v)
+{
+    if (!(v->flags & PCVRNT_FLAG_STRING_SLICE))
+        return true;
+
+    struct pcvariant_heap *heap = inst->variant_heap;
+    inst->variant_heap = inst->org_vrt_heap;
+    bool ok = pcvariant_slice_detach(v);
+    inst->variant_heap = heap;
+    return ok;
+}
+
 static void
 move_variant_in(struct pcinst *inst, purc_variant_t v)
 {
+    if (!detach_slice(inst, v)) {
+        /* keep the slice in the heap of the instance */
+        return;
+    }
+
     /* move directly and change the stat info */
 
     if (IS_CONTAINER(v->type) ||
@@ -168,6 +188,9 @@ move_or_clone_immutable(struct pcinst *inst, purc_variant_t v)
     if (IS_CONTAINER(v->type))
         return retv;
 
+    if (!detach_slice(inst, v))
+        return retv;
+
     if (v == &inst->org_vrt_heap->v_undefined) {
         retv = &move_heap.v_undefined;
         v->refc--;
@@ -207,6 +230,7 @@ move_or_clone_immutable(struct pcinst *inst, purc_variant_t v)
         retv = pcvariant_alloc();
         memcpy(retv, v, sizeof(*retv));
         retv->refc = 1;
+        retv->flags &= ~PCVRNT_FLAG_INTERNED;
 
         /* copy the extra space */
         if ((v->type == PURC_VARIANT_TYPE_STRING ||
@@ -248,6 +272,11 @@ move_keys_in_cloned_array(struct travel_context *ctxt, purc_variant_t arr)
 {
     size_t idx;
     purc_variant_t v;
+
+    /* the members of a packed array are plain numbers in the column */
+    if (variant_array_get_data(arr)->packed_type)
+        return true;
+
     foreach_value_in_variant_array(arr, v, idx) {
         UNUSED_PARAM(idx);
 
@@ -278,6 +307,24 @@ move_keys_in_cloned_array(struct travel_context *ctxt, purc_variant_t arr)
     return true;
 }
 
+/* An interned key is shared by the objects in the instance, clone it. */
+static void
+move_key_in(struct travel_context *ctxt, struct obj_node *node)
+{
+    purc_variant_t k = node->key;
+
+    if (k->flags & PCVRNT_FLAG_INTERNED) {
+        purc_variant_t retk = move_or_clone_immutable(ctxt->inst, k);
+        if (retk != k) {
+            node->key = retk;
+            pcutils_arrlist_append(ctxt->vrts_to_unref, k);
+        }
+    }
+    else {
+        move_variant_in(ctxt->inst, k);
+    }
+}
+
 static bool
 move_keys_in_cloned_object(struct travel_context *ctxt, purc_variant_t obj)
 {
@@ -293,22 +340,22 @@ move_keys_in_cloned_object(struct travel_context *ctxt, purc_variant_t obj)
 
         switch (v->type) {
         case PURC_VARIANT_TYPE_ARRAY:
-            move_variant_in(ctxt->inst, k);
+            move_key_in(ctxt, _node);
             move_keys_in_cloned_array(ctxt, v);
             break;
 
         case PURC_VARIANT_TYPE_OBJECT:
-            move_variant_in(ctxt->inst, k);
+            move_key_in(ctxt, _node);
             move_keys_in_cloned_object(ctxt, v);
             break;
 
         case PURC_VARIANT_TYPE_SET:
-            move_variant_in(ctxt->inst, k);
+            move_key_in(ctxt, _node);
             move_keys_in_cloned_set(ctxt, v);
             break;
 
         case PURC_VARIANT_TYPE_TUPLE:
-            move_variant_in(ctxt->inst, k);
+            move_key_in(ctxt, _node);
             move_keys_in_cloned_tuple(ctxt, v);
             break;
 
@@ -440,6 +487,11 @@ move_or_clone_mutable_descendants_in_array(struct travel_context *ctxt,
 {
     size_t idx;
     purc_variant_t v;
+
+    /* the members of a packed array are plain numbers in the column */
+    if (variant_array_get_data(arr)->packed_type)
+        return true;
+
     foreach_value_in_variant_array(arr, v, idx) {
         purc_variant_t retv;
 
@@ -480,7 +532,7 @@ move_or_clone_mutable_descendants_in_array(struct travel_context *ctxt,
 
             move_keys_in_cloned_container(ctxt, retv);
 
-            _p->val = retv;
+            *_p = retv;
             pcutils_arrlist_append(ctxt->vrts_to_unref, v);
         }
 
@@ -494,6 +546,7 @@ move_or_clone_mutable_descendants_in_object(struct travel_context *ctxt,
         purc_variant_t obj)
 {
     purc_variant_t k,v;
+    pcvar_obj_touch(obj);
     foreach_key_value_in_variant_object(obj, k, v) {
         purc_variant_t retk, retv;
 
@@ -710,6 +763,11 @@ move_or_clone_immutable_descendants_in_array(struct travel_context *ctxt,
 {
     size_t idx;
     purc_variant_t v;
+
+    /* the members of a packed array are plain numbers in the column */
+    if (variant_array_get_data(arr)->packed_type)
+        return true;
+
     foreach_value_in_variant_array(arr, v, idx) {
         purc_variant_t retv;
 
@@ -745,7 +803,7 @@ move_or_clone_immutable_descendants_in_array(struct travel_context *ctxt,
         }
 
         if (retv != v) {
-            _p->val = retv;
+            *_p = retv;
             if (!(v->flags & PCVRNT_FLAG_NOFREE))
                 pcutils_arrlist_append(ctxt->vrts_to_unref, v);
         }
@@ -760,6 +818,7 @@ move_or_clone_immutable_descendants_in_object(struct travel_context *ctxt,
         purc_variant_t obj)
 {
     purc_variant_t k,v;
+    pcvar_obj_touch(obj);
     foreach_key_value_in_variant_object(obj, k, v) {
         purc_variant_t retk, retv;
 
@@ -1016,6 +1075,10 @@ static purc_variant_t move_array_descendants_out(purc_variant_t arr)
     size_t idx;
     purc_variant_t v;
 
+    /* the members of a packed array are plain numbers in the column */
+    if (variant_array_get_data(arr)->packed_type)
+        return arr;
+
     foreach_value_in_variant_array(arr, v, idx) {
         purc_variant_t retv;
 
@@ -1046,7 +1109,7 @@ static purc_variant_t move_array_descendants_out(purc_variant_t arr)
             break;
         }
 
-        _p->val = retv;
+        *_p = retv;
 
     } end_foreach;
 
@@ -1056,6 +1119,7 @@ static purc_variant_t move_array_descendants_out(purc_variant_t arr)
 static purc_variant_t move_object_descendants_out(purc_variant_t obj)
 {
     purc_variant_t k,v;
+    pcvar_obj_touch(obj);
     foreach_key_value_in_variant_object(obj, k, v) {
         purc_variant_t retk, retv;
 
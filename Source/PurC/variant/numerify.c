@@ -146,6 +146,37 @@ pcvar_obj_numerify(purc_variant_t val)
     return d;
 }
 
+/* Sums the column of a packed array in order, like the elements of an
+   unpacked array are summed, so that both give the same result. */
+#define SUM_PACKED(_col, _nr, _d)                                       \
+    do {                                                                \
+        for (size_t _i = 0; _i < (_nr); _i++)                           \
+            _d += (double)(_col)[_i];                                   \
+    } while (0)
+
+static double
+packed_numerify(purc_variant_type type, const void *packed, size_t nr)
+{
+    double d = 0.0;
+
+    switch (type) {
+    case PURC_VARIANT_TYPE_NUMBER:
+        SUM_PACKED((const double *)packed, nr, d);
+        break;
+    case PURC_VARIANT_TYPE_LONGINT:
+        SUM_PACKED((const int64_t *)packed, nr, d);
+        break;
+    case PURC_VARIANT_TYPE_ULONGINT:
+        SUM_PACKED((const uint64_t *)packed, nr, d);
+        break;
+    default:
+        PC_ASSERT(0);
+        break;
+    }
+
+    return d;
+}
+
 double
 pcvar_arr_numerify(purc_variant_t val)
 {
@@ -154,6 +185,12 @@ pcvar_arr_numerify(purc_variant_t val)
 
     double d = 0.0;
 
+    purc_variant_type type;
+    size_t nr;
+    const void *packed = pcvariant_array_get_packed(val, &type, &nr);
+    if (packed)
+        return packed_numerify(type, packed, nr);
+
     purc_variant_t v;
     size_t idx;
     foreach_value_in_variant_array(val, v, idx) {
@@ -46,6 +46,7 @@
 #include "private/instance.h"
 #include "private/errors.h"
 #include "private/debug.h"
+#include "private/cpu.h"
 
 #include "variant/variant-internals.h"
 
@@ -56,33 +57,85 @@
 #include <float.h>
 #include <assert.h>
 
+#if PCUTILS_X86_SIMD
+#include <immintrin.h>
+#endif
+
 static const char *hex_chars = "0123456789abcdefABCDEF";
 
-#define MY_WRITE(rws, buff, count)                                      \
+/* The serialized data are gathered in a buffer and written to the stream
+   in chunks, instead of calling purc_rwstream_write() for every token. */
+#define SZ_OUTPUT_BUFF      4096
+
+struct serializer {
+    purc_rwstream_t     rws;
+    unsigned int        flags;
+
+    /* the formats of the local data, fetched once */
+    const char         *format_double;
+    const char         *format_long_double;
+
+    /* the number of bytes the stream accepted */
+    ssize_t             nr_written;
+
+    size_t              len;
+    char                buff[SZ_OUTPUT_BUFF];
+};
+
+static int
+write_through(struct serializer *ser, const char *buf, size_t count)
+{
+    while (count > 0) {
+        ssize_t n = purc_rwstream_write(ser->rws, buf, count);
+        if (n <= 0) {
+            if (ser->flags & PCVRNT_SERIALIZE_OPT_IGNORE_ERRORS)
+                break;
+            return -1;
+        }
+
+        ser->nr_written += n;
+        buf += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+static int
+flush_output(struct serializer *ser)
+{
+    size_t len = ser->len;
+
+    ser->len = 0;
+    if (len)
+        return write_through(ser, ser->buff, len);
+    return 0;
+}
+
+static inline int
+write_output(struct serializer *ser, const char *buf, size_t count)
+{
+    if (count > SZ_OUTPUT_BUFF - ser->len) {
+        if (flush_output(ser))
+            return -1;
+
+        if (count >= SZ_OUTPUT_BUFF)
+            return write_through(ser, buf, count);
+    }
+
+    memcpy(ser->buff + ser->len, buf, count);
+    ser->len += count;
+    return 0;
+}
+
+#define MY_WRITE(ser, buff, count)                                      \
     do {                                                                \
-        const char* _buff = buff;                                       \
-        ssize_t n;                                                      \
-        size_t nr_left = (count);                                       \
+        size_t _count = (count);                                        \
         if (len_expected)                                               \
-            *len_expected += (count);                                   \
-        while (1) {                                                     \
-            n = purc_rwstream_write((rws), _buff, nr_left);             \
-            if (n <= 0) {                                               \
-                if (flags & PCVRNT_SERIALIZE_OPT_IGNORE_ERRORS)      \
-                    break;                                              \
-                else                                                    \
-                    goto failed;                                        \
-            }                                                           \
-            else if ((size_t)n < nr_left) {                             \
-                nr_written += n;                                        \
-                _buff += n;                                             \
-                continue;                                               \
-            }                                                           \
-            else {                                                      \
-                nr_written += n;                                        \
-                break;                                                  \
-            }                                                           \
-        }                                                               \
+            *len_expected += _count;                                    \
+        if (write_output((ser), (buff), _count))                        \
+            goto failed;                                                \
+        nr_written += _count;                                           \
     } while (0)
 
 #define MY_CHECK(n)                                                     \
@@ -96,93 +149,80 @@ static const char *hex_chars = "0123456789abcdefABCDEF";
         }                                                               \
     } while (0)
 
-static ssize_t
-serialize_string(purc_rwstream_t rws, const char* str,
-        size_t len, unsigned int flags, size_t *len_expected)
+/* the second characters of the escape sequences; 'u' for \u00XX */
+static const char escape_chars[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    ['"'] = '"', ['/'] = '/', ['\\'] = '\\',
+};
+
+/* Returns the number of the leading bytes which need no escape. */
+static size_t
+scan_unescaped(const char *str, size_t len, bool escape_slash)
 {
-    int nr_written = 0;
-    size_t pos = 0, start_offset = 0;
-    unsigned char c;
-    char buff[3];
-
-    while (len--) {
-        c = str[pos];
-        switch (c) {
-        case '\b':
-        case '\n':
-        case '\r':
-        case '\t':
-        case '\f':
-        case '"':
-        case '\\':
-        case '/':
-            if ((flags & PCVRNT_SERIALIZE_OPT_NOSLASHESCAPE) && c == '/') {
-                pos++;
-                break;
-            }
-
-            if (pos - start_offset > 0)
-                MY_WRITE(rws, str + start_offset, pos - start_offset);
-
-            buff[0] = 0;
-            if (c == '\b') {
-                buff[0] = '\\';
-                buff[1] = 'b';
-            }
-            else if (c == '\n') {
-                buff[0] = '\\';
-                buff[1] = 'n';
-            }
-            else if (c == '\r') {
-                buff[0] = '\\';
-                buff[1] = 'r';
-            }
-            else if (c == '\t') {
-                buff[0] = '\\';
-                buff[1] = 't';
-            }
-            else if (c == '\f') {
-                buff[0] = '\\';
-                buff[1] = 'f';
-            }
-            else if (c == '"') {
-                buff[0] = '\\';
-                buff[1] = '\"';
-            }
-            else if (c == '\\') {
-                buff[0] = '\\';
-                buff[1] = '\\';
-            }
-            else if (c == '/') {
-                buff[0] = '\\';
-                buff[1] = '/';
-            }
-
-            if (buff[0])
-                MY_WRITE(rws, buff, 2);
+    size_t i = 0;
+
+#if PCUTILS_X86_SIMD
+    /* SSE2 is a part of x86-64: no need to check the CPU */
+    const __m128i ctrl = _mm_set1_epi8(0x1f);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i slash = _mm_set1_epi8(escape_slash ? '/' : '"');
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(str + i));
+        __m128i special = _mm_or_si128(
+                _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl),
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                    _mm_or_si128(_mm_cmpeq_epi8(v, backslash),
+                        _mm_cmpeq_epi8(v, slash))));
+        int mask = _mm_movemask_epi8(special);
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+#endif
 
-            start_offset = ++pos;
+    for (; i < len; i++) {
+        unsigned char c = str[i];
+        if (escape_chars[c] && (c != '/' || escape_slash))
             break;
+    }
 
-        default:
-            if (c < ' ') {
-                char sbuf[7];
-                if (pos - start_offset > 0)
-                    MY_WRITE(rws, str + start_offset, pos - start_offset);
+    return i;
+}
 
-                if (snprintf(sbuf, sizeof(sbuf), "\\u00%c%c",
-                            hex_chars[c >> 4], hex_chars[c & 0xf]) < 0)
-                    goto failed;
+static ssize_t
+serialize_string(struct serializer *ser, const char* str,
+        size_t len, unsigned int flags, size_t *len_expected)
+{
+    ssize_t nr_written = 0;
+    bool escape_slash = !(flags & PCVRNT_SERIALIZE_OPT_NOSLASHESCAPE);
+    size_t pos = 0;
+
+    while (pos < len) {
+        size_t n = scan_unescaped(str + pos, len - pos, escape_slash);
+        if (n > 0) {
+            MY_WRITE(ser, str + pos, n);
+            pos += n;
+            if (pos == len)
+                break;
+        }
 
-                MY_WRITE(rws, sbuf, sizeof(sbuf) - 1);
-                start_offset = ++pos;
-            }
-            else
-                pos++;
+        unsigned char c = str[pos++];
+        char buff[6] = { '\\', escape_chars[c] };
+        if (buff[1] == 'u') {
+            buff[2] = '0';
+            buff[3] = '0';
+            buff[4] = hex_chars[c >> 4];
+            buff[5] = hex_chars[c & 0xf];
+            MY_WRITE(ser, buff, 6);
+        }
+        else {
+            MY_WRITE(ser, buff, 2);
         }
     }
-    if (pos - start_offset > 0)
-        MY_WRITE(rws, str + start_offset, pos - start_offset);
 
     return nr_written;
 
@@ -257,9 +297,8 @@ static const char base64_pad = '=';
        characters followed by one "=" padding character.
    */
 
-static ssize_t serialize_bsequence_base64(purc_rwstream_t rws,
-        const void *_src, size_t srclength,
-        unsigned int flags, size_t *len_expected)
+static ssize_t serialize_bsequence_base64(struct serializer *ser,
+        const void *_src, size_t srclength, size_t *len_expected)
 {
     const unsigned char *src = _src;
     ssize_t nr_written = 0;
@@ -284,7 +323,7 @@ static ssize_t serialize_bsequence_base64(purc_rwstream_t rws,
         buff[2] = base64_chars[output[2]];
         buff[3] = base64_chars[output[3]];
 
-        MY_WRITE(rws, buff, 4);
+        MY_WRITE(ser, buff, 4);
     }
 
     /* Now we worry about padding. */
@@ -306,7 +345,7 @@ static ssize_t serialize_bsequence_base64(purc_rwstream_t rws,
             buff[2] = base64_chars[output[2]];
         buff[3] = base64_pad;
 
-        MY_WRITE(rws, buff, 4);
+        MY_WRITE(ser, buff, 4);
     }
 
     return nr_written;
@@ -316,7 +355,7 @@ failed:
 }
 
 static ssize_t
-serialize_bsequence(purc_rwstream_t rws, const char* content,
+serialize_bsequence(struct serializer *ser, const char* content,
         size_t sz_content, unsigned int flags, size_t *len_expected)
 {
     ssize_t nr_written = 0, n;
@@ -324,31 +363,31 @@ serialize_bsequence(purc_rwstream_t rws, const char* content,
 
     switch (flags & PCVRNT_SERIALIZE_OPT_BSEQUENCE_MASK) {
         case PCVRNT_SERIALIZE_OPT_BSEQUENCE_HEX_STRING:
-            MY_WRITE(rws, "\"", 1);
+            MY_WRITE(ser, "\"", 1);
             for (i = 0; i < sz_content; i++) {
                 unsigned char byte = (unsigned char)content[i];
                 char buff[2];
                 buff [0] = hex_chars[(byte >> 4) & 0x0f];
                 buff [1] = hex_chars[byte & 0x0f];
-                MY_WRITE(rws, buff, 2);
+                MY_WRITE(ser, buff, 2);
             }
-            MY_WRITE(rws, "\"", 1);
+            MY_WRITE(ser, "\"", 1);
             break;
 
         case PCVRNT_SERIALIZE_OPT_BSEQUENCE_HEX:
-            MY_WRITE(rws, "bx", 2);
+            MY_WRITE(ser, "bx", 2);
             for (i = 0; i < sz_content; i++) {
                 unsigned char byte = (unsigned char)content[i];
                 char buff[2];
                 buff [0] = hex_chars[(byte >> 4) & 0x0f];
                 buff [1] = hex_chars[byte & 0x0f];
-                MY_WRITE(rws, buff, 2);
+                MY_WRITE(ser, buff, 2);
             }
             break;
 
         case PCVRNT_SERIALIZE_OPT_BSEQUENCE_BIN:
         case PCVRNT_SERIALIZE_OPT_BSEQUENCE_BIN_DOT:
-            MY_WRITE(rws, "bb", 2);
+            MY_WRITE(ser, "bb", 2);
             for (i = 0; i < sz_content; i++) {
                 unsigned char byte = (unsigned char)content[i];
                 char buff[10];
@@ -368,15 +407,15 @@ serialize_bsequence(purc_rwstream_t rws, const char* content,
                     }
                 }
 
-                MY_WRITE(rws, buff, k);
+                MY_WRITE(ser, buff, k);
             }
             break;
 
         case PCVRNT_SERIALIZE_OPT_BSEQUENCE_BASE64:
         default:
-            MY_WRITE(rws, "b64", 3);
-            n = serialize_bsequence_base64(rws, content, sz_content,
-                    flags, len_expected);
+            MY_WRITE(ser, "b64", 3);
+            n = serialize_bsequence_base64(ser, content, sz_content,
+                    len_expected);
             MY_CHECK(n);
             break;
     }
@@ -405,8 +444,178 @@ static inline UNUSED_FUNCTION bool equal_long_doubles(long double a,
 /* strlen of character literals resolved at compile time */
 #define static_strlen(string_literal) (sizeof(string_literal) - sizeof(""))
 
+static const char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233"
+    "34353637383940414243444546474849505152535455565758596061626364656667"
+    "6869707172737475767778798081828384858687888990919293949596979899";
+
+/* Formats an unsigned integer as "%llu" does; returns the number of the
+   digits, which are not null-terminated. */
+static size_t
+u64_to_str(uint64_t u, char *buf)
+{
+    char tmp[20];
+    char *p = tmp + sizeof(tmp);
+
+    while (u >= 100) {
+        const char *pair = digit_pairs + (u % 100) * 2;
+        u /= 100;
+        *--p = pair[1];
+        *--p = pair[0];
+    }
+
+    if (u >= 10) {
+        *--p = digit_pairs[u * 2 + 1];
+        *--p = digit_pairs[u * 2];
+    }
+    else {
+        *--p = '0' + u;
+    }
+
+    size_t n = tmp + sizeof(tmp) - p;
+    memcpy(buf, p, n);
+    return n;
+}
+
+#ifdef __SIZEOF_INT128__
+typedef unsigned __int128 uint128_type;
+
+/* Formats a double as snprintf() does with "%.17g" in the C locale, with
+   exact integer arithmetic; returns -1 for the values out of the range
+   handled, roughly from 1e-6 to 1e38. */
+static int
+format_double_17g(char *buf, double d)
+{
+    static const uint64_t pow10[] = {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+        10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+        100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+        100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+        100000000000000000ULL, 1000000000000000000ULL,
+    };
+    const uint64_t lower = pow10[16], upper = pow10[17];
+
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    int biased = (int)((bits >> 52) & 0x7ff);
+    if (biased == 0 || biased == 0x7ff)
+        return -1;      /* zero, subnormal, infinity, or NaN */
+
+    /* d = m * 2^e */
+    uint64_t m = (bits & ((1ULL << 52) - 1)) | (1ULL << 52);
+    int e = biased - 1075;
+
+    /* q = m * 2^e * 10^k, truncated, in [10^16, 10^17) */
+    int exp10 = (int)floor(log10(fabs(d)));
+    uint128_type q, r, half;
+    for (int tries = 0; ; tries++) {
+        int k = 16 - exp10;
+        uint128_type num = m, den = 1;
+
+        if (tries > 2 || k > 36 || k < -36 || e < -126 || e > 60)
+            return -1;
+
+        if (k > 0) {
+            uint128_type p10 = (k > 18) ?
+                (uint128_type)pow10[k - 18] * pow10[18] : pow10[k];
+            if (__builtin_mul_overflow(num, p10, &num))
+                return -1;
+        }
+        else if (k < 0) {
+            den = (-k > 18) ?
+                (uint128_type)pow10[-k - 18] * pow10[18] : pow10[-k];
+        }
+
+        if (e > 0) {
+            if ((num >> (127 - e)) != 0)
+                return -1;
+            num <<= e;
+        }
+
+        if (e < 0 && den == 1) {
+            q = num >> -e;
+            r = num & (((uint128_type)1 << -e) - 1);
+            half = (uint128_type)1 << (-e - 1);
+        }
+        else if (e >= 0) {
+            /* den is 1 or a power of ten: no halves of 1 */
+            q = num / den;
+            r = num % den;
+            half = den / 2;
+        }
+        else {
+            return -1;
+        }
+
+        if (q < lower)
+            exp10--;
+        else if (q >= upper)
+            exp10++;
+        else
+            break;
+    }
+
+    /* round half to even, as glibc does in the default rounding mode */
+    if (r > half || (r == half && r && (q & 1)))
+        q++;
+    if (q == upper) {
+        q = lower;
+        exp10++;
+    }
+
+    char digits[17];
+    u64_to_str((uint64_t)q, digits);
+    int nr_digits = 17;
+    while (nr_digits > 1 && digits[nr_digits - 1] == '0')
+        nr_digits--;
+
+    char *p = buf;
+    if (d < 0)
+        *p++ = '-';
+
+    if (exp10 < -4 || exp10 >= 17) {
+        *p++ = digits[0];
+        if (nr_digits > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, nr_digits - 1);
+            p += nr_digits - 1;
+        }
+
+        *p++ = 'e';
+        *p++ = (exp10 < 0) ? '-' : '+';
+        int x = (exp10 < 0) ? -exp10 : exp10;
+        if (x >= 100) {
+            *p++ = '0' + x / 100;
+            x %= 100;
+        }
+        *p++ = digit_pairs[x * 2];
+        *p++ = digit_pairs[x * 2 + 1];
+    }
+    else if (exp10 >= 0) {
+        memcpy(p, digits, exp10 + 1);
+        p += exp10 + 1;
+        if (nr_digits > exp10 + 1) {
+            *p++ = '.';
+            memcpy(p, digits + exp10 + 1, nr_digits - exp10 - 1);
+            p += nr_digits - exp10 - 1;
+        }
+    }
+    else {
+        *p++ = '0';
+        *p++ = '.';
+        for (int i = -1; i > exp10; i--)
+            *p++ = '0';
+        memcpy(p, digits, nr_digits);
+        p += nr_digits;
+    }
+
+    *p = '\0';
+    return p - buf;
+}
+#endif  /* defined __SIZEOF_INT128__ */
+
 static ssize_t
-serialize_number(purc_rwstream_t rws, double d, size_t *len_expected)
+serialize_number(struct serializer *ser, double d, size_t *len_expected)
 {
     char buf[128];
     int size;
@@ -430,6 +639,18 @@ serialize_number(purc_rwstream_t rws, double d, size_t *len_expected)
             size = static_strlen("-Infinity");
         }
     }
+    else if (fabs(d) < 18446744073709551616.0) {  /* 2^64 */
+        /* the same as below without formatting and scanning: "%.0f"
+           rounds as nearbyint() does, and scans back exactly */
+        double r = nearbyint(d);
+        if (!equal_doubles(r, d))
+            return 0;
+
+        size = 0;
+        if (signbit(r))
+            buf[size++] = '-';
+        size += u64_to_str((uint64_t)fabs(r), buf + size);
+    }
     else {
         double test;
 
@@ -449,11 +670,11 @@ serialize_number(purc_rwstream_t rws, double d, size_t *len_expected)
 
     if (len_expected)
         *len_expected += size;
-    return purc_rwstream_write(rws, buf, size);
+    return write_output(ser, buf, size) ? -1 : size;
 }
 
 static ssize_t
-serialize_double(purc_rwstream_t rws, double d, int flags,
+serialize_double(struct serializer *ser, double d, int flags,
         const char *format, size_t *len_expected)
 {
     char buf[128], *p, *q;
@@ -467,7 +688,13 @@ serialize_double(purc_rwstream_t rws, double d, int flags,
         format = std_format;
     }
 
-    size = snprintf(buf, sizeof(buf), format, d);
+    size = -1;
+#ifdef __SIZEOF_INT128__
+    if (format == std_format)
+        size = format_double_17g(buf, d);
+#endif
+    if (size < 0)
+        size = snprintf(buf, sizeof(buf), format, d);
     // although unlikely, snprintf might fail
     if (UNLIKELY(size < 0)) {
         pcinst_set_error(PURC_ERROR_OUTPUT);
@@ -517,11 +744,11 @@ serialize_double(purc_rwstream_t rws, double d, int flags,
 
     if (len_expected)
         *len_expected += size;
-    return purc_rwstream_write(rws, buf, size);
+    return write_output(ser, buf, size) ? -1 : size;
 }
 
 static ssize_t
-serialize_long_double(purc_rwstream_t rws, long double ld, int flags,
+serialize_long_double(struct serializer *ser, long double ld, int flags,
         const char *format, size_t *len_expected)
 {
     char buf[256], *p, *q;
@@ -588,25 +815,25 @@ serialize_long_double(purc_rwstream_t rws, long double ld, int flags,
 
     if (len_expected)
         *len_expected += size;
-    return purc_rwstream_write(rws, buf, size);
+    return write_output(ser, buf, size) ? -1 : size;
 }
 
 static ssize_t
-print_newline(purc_rwstream_t rws, unsigned int flags, size_t *len_expected)
+print_newline(struct serializer *ser, unsigned int flags, size_t *len_expected)
 {
     ssize_t nr_written = 0;
 
     if (flags & PCVRNT_SERIALIZE_OPT_PRETTY) {
         if (len_expected)
             *len_expected += 1;
-        nr_written = purc_rwstream_write(rws, "\n", 1);
+        nr_written = write_output(ser, "\n", 1) ? -1 : 1;
     }
 
     return nr_written;
 }
 
 static ssize_t
-print_indent(purc_rwstream_t rws, int level, unsigned int flags,
+print_indent(struct serializer *ser, int level, unsigned int flags,
         size_t *len_expected)
 {
     size_t n;
@@ -627,27 +854,27 @@ print_indent(purc_rwstream_t rws, int level, unsigned int flags,
 
         if (len_expected)
             *len_expected += n;
-        return purc_rwstream_write(rws, buff, n);
+        return write_output(ser, buff, n) ? -1 : (ssize_t)n;
     }
 
     return 0;
 }
 
 static inline ssize_t
-print_space(purc_rwstream_t rws, unsigned int flags, size_t* len_expected)
+print_space(struct serializer *ser, unsigned int flags, size_t* len_expected)
 {
     ssize_t nr_written = 0;
 
     if (flags & PCVRNT_SERIALIZE_OPT_SPACED) {
         if (len_expected)
             *len_expected += 1;
-        nr_written = purc_rwstream_write(rws, " ", 1);
+        nr_written = write_output(ser, " ", 1) ? -1 : 1;
     }
 
     return nr_written;
 }
 
-static inline ssize_t print_space_no_pretty(purc_rwstream_t rws,
+static inline ssize_t print_space_no_pretty(struct serializer *ser,
         unsigned int flags, size_t *len_expected)
 {
     ssize_t nr_written = 0;
@@ -656,30 +883,100 @@ static inline ssize_t print_space_no_pretty(purc_rwstream_t rws,
             !(flags & PCVRNT_SERIALIZE_OPT_PRETTY)) {
         if (len_expected)
             *len_expected += 1;
-        nr_written = purc_rwstream_write(rws, " ", 1);
+        nr_written = write_output(ser, " ", 1) ? -1 : 1;
     }
 
     return nr_written;
 }
 
-ssize_t purc_variant_serialize(purc_variant_t value, purc_rwstream_t rws,
+/* Serializes a real of a number, longint, or ulongint variant, or of
+   a member of a packed array. */
+static ssize_t
+serialize_real(struct serializer *ser, purc_variant_type type,
+        const purc_real_t *real, unsigned int flags,
+        const char *format_double, size_t *len_expected)
+{
+    ssize_t nr_written = 0, n;
+    char buff[64];
+    size_t len;
+
+    switch (type) {
+        case PURC_VARIANT_TYPE_NUMBER:
+            /* try to serialize the number as an integer first */
+            n = serialize_number(ser, real->d, len_expected);
+            if (n < 0)
+                goto failed;
+            if (n == 0) {
+                n = serialize_double(ser, real->d, flags,
+                        ser->format_double, len_expected);
+                if (n < 0)
+                    goto failed;
+            }
+            nr_written += n;
+            break;
+
+        case PURC_VARIANT_TYPE_LONGINT:
+            len = 0;
+            if (real->i64 < 0) {
+                buff[len++] = '-';
+                len += u64_to_str(-(uint64_t)real->i64, buff + len);
+            }
+            else {
+                len += u64_to_str(real->i64, buff + len);
+            }
+
+            if (flags & PCVRNT_SERIALIZE_OPT_REAL_EJSON)
+                buff[len++] = 'L';
+            MY_WRITE(ser, buff, len);
+            break;
+
+        case PURC_VARIANT_TYPE_ULONGINT:
+            len = u64_to_str(real->u64, buff);
+            if (flags & PCVRNT_SERIALIZE_OPT_REAL_EJSON) {
+                buff[len++] = 'U';
+                buff[len++] = 'L';
+            }
+            MY_WRITE(ser, buff, len);
+            break;
+
+        default:
+            PC_ASSERT(0);
+            break;
+    }
+
+    return nr_written;
+
+failed:
+    return -1;
+}
+
+static inline void
+packed_real(purc_variant_type type, const void *packed, size_t idx,
+        purc_real_t *real)
+{
+    if (type == PURC_VARIANT_TYPE_NUMBER)
+        real->d = ((const double *)packed)[idx];
+    else if (type == PURC_VARIANT_TYPE_LONGINT)
+        real->i64 = ((const int64_t *)packed)[idx];
+    else
+        real->u64 = ((const uint64_t *)packed)[idx];
+}
+
+static ssize_t
+serialize_variant(struct serializer *ser, purc_variant_t value,
         int level, unsigned int flags, size_t *len_expected)
 {
     ssize_t nr_written = 0, n;
     const char* content = NULL;
     size_t sz_content = 0;
     size_t i, idx;
-    char buff [256];
     purc_variant_t member = NULL;
     purc_variant_t key;
-    char* format_double = NULL;
-    char* format_long_double = NULL;
     variant_set_t data;
-
-    purc_get_local_data(PURC_LDNAME_FORMAT_DOUBLE,
-            (uintptr_t *)&format_double, NULL);
-    purc_get_local_data(PURC_LDNAME_FORMAT_LDOUBLE,
-            (uintptr_t *)&format_long_double, NULL);
+    purc_real_t real;
+    purc_variant_type packed_type;
+    const void *packed;
+    size_t nr_packed;
 
     PC_ASSERT(value);
 
@@ -707,66 +1004,37 @@ ssize_t purc_variant_serialize(purc_variant_t value, purc_rwstream_t rws,
         case PURC_VARIANT_TYPE_EXCEPTION:
             content = purc_atom_to_string(value->atom);
             sz_content = strlen(content);
-            MY_WRITE(rws, "\"", 1);
-            n = serialize_string(rws, content, sz_content,
+            MY_WRITE(ser, "\"", 1);
+            n = serialize_string(ser, content, sz_content,
                         flags, len_expected);
             MY_CHECK(n);
-            MY_WRITE(rws, "\"", 1);
+            MY_WRITE(ser, "\"", 1);
 
             content = NULL;
             break;
 
         case PURC_VARIANT_TYPE_NUMBER:
-            /* try to serialize the number as an integer first */
-            n = serialize_number(rws, value->d, len_expected);
-            if (n < 0)
-                goto failed;
-            if (n == 0) {
-                n = serialize_double(rws, value->d, flags,
-                        format_double, len_expected);
-                if (n < 0)
-                    goto failed;
-            }
-            nr_written += n;
-
-            content = NULL;
-            break;
-
         case PURC_VARIANT_TYPE_LONGINT:
-        {
-            const char *format;
-            if (flags & PCVRNT_SERIALIZE_OPT_REAL_EJSON)
-                format = "%lldL";
-            else
-                format = "%lld";
-
-            if (snprintf(buff, sizeof(buff), format,
-                        (long long int)value->i64) < 0)
-                goto failed;
-            content = buff;
-            // sz_content = strlen(buff);
-            break;
-        }
-
         case PURC_VARIANT_TYPE_ULONGINT:
-        {
-            const char *format;
-            if (flags & PCVRNT_SERIALIZE_OPT_REAL_EJSON)
-                format = "%lluUL";
+            if (value->type == PURC_VARIANT_TYPE_NUMBER)
+                real.d = value->d;
+            else if (value->type == PURC_VARIANT_TYPE_LONGINT)
+                real.i64 = value->i64;
             else
-                format = "%llu";
+                real.u64 = value->u64;
 
-            if (snprintf(buff, sizeof(buff), format,
-                        (long long unsigned)value->u64) < 0)
+            n = serialize_real(ser, value->type, &real, flags,
+                    ser->format_double, len_expected);
+            if (n < 0)
                 goto failed;
-            content = buff;
-            // sz_content = strlen(buff);
+            nr_written += n;
+
+            content = NULL;
             break;
-        }
 
         case PURC_VARIANT_TYPE_LONGDOUBLE:
-            n = serialize_long_double(rws, value->ld, flags,
-                    format_long_double, len_expected);
+            n = serialize_long_double(ser, value->ld, flags,
+                    ser->format_long_double, len_expected);
             MY_CHECK(n);
 
             content = NULL;
@@ -775,37 +1043,26 @@ ssize_t purc_variant_serialize(purc_variant_t value, purc_rwstream_t rws,
         case PURC_VARIANT_TYPE_ATOMSTRING:
             content = purc_atom_to_string(value->atom);
             sz_content = strlen(content);
-            MY_WRITE(rws, "\"", 1);
-            n = serialize_string(rws, content, sz_content,
+            MY_WRITE(ser, "\"", 1);
+            n = serialize_string(ser, content, sz_content,
                         flags, len_expected);
             MY_CHECK(n);
-            MY_WRITE(rws, "\"", 1);
+            MY_WRITE(ser, "\"", 1);
 
             content = NULL;
             break;
 
         case PURC_VARIANT_TYPE_STRING:
         case PURC_VARIANT_TYPE_BSEQUENCE:
-            if (value->flags & PCVRNT_FLAG_STRING_STATIC) {
-                content = (const char*)value->sz_ptr[1];
-                sz_content = (size_t)value->sz_ptr[0];
-            }
-            else if (value->flags & PCVRNT_FLAG_EXTRA_SIZE) {
-                content = (const char*)value->sz_ptr[1];
-                sz_content = (size_t)value->sz_ptr[0];
-            }
-            else {
-                content = (const char*)value->bytes;
-                sz_content = value->size;
-            }
+            content = pcvariant_get_bytes_const(value, &sz_content);
             if (value->type == PURC_VARIANT_TYPE_STRING) {
-                MY_WRITE(rws, "\"", 1);
-                n = serialize_string(rws, content, sz_content - 1,
+                MY_WRITE(ser, "\"", 1);
+                n = serialize_string(ser, content, sz_content,
                             flags, len_expected);
-                MY_WRITE(rws, "\"", 1);
+                MY_WRITE(ser, "\"", 1);
             }
             else
-                n = serialize_bsequence(rws, content, sz_content,
+                n = serialize_bsequence(ser, content, sz_content,
                             flags, len_expected);
             MY_CHECK(n);
 
@@ -829,121 +1086,146 @@ ssize_t purc_variant_serialize(purc_variant_t value, purc_rwstream_t rws,
         case PURC_VARIANT_TYPE_OBJECT:
             content = NULL;
 
-            n = print_indent(rws, level, flags, len_expected);
+            n = print_indent(ser, level, flags, len_expected);
             MY_CHECK(n);
 
-            MY_WRITE(rws, "{", 1);
-            n = print_newline(rws, flags, len_expected);
+            MY_WRITE(ser, "{", 1);
+            n = print_newline(ser, flags, len_expected);
             MY_CHECK(n);
 
             i = 0;
             foreach_key_value_in_variant_object(value, key, member)
                 if (i > 0) {
-                    MY_WRITE(rws, ",", 1);
-                    n = print_newline(rws, flags, len_expected);
+                    MY_WRITE(ser, ",", 1);
+                    n = print_newline(ser, flags, len_expected);
                     MY_CHECK(n);
                 }
 
-                n = print_space_no_pretty(rws, flags, len_expected);
+                n = print_space_no_pretty(ser, flags, len_expected);
                 MY_CHECK(n);
 
-                n = print_indent(rws, level + 1, flags, len_expected);
+                n = print_indent(ser, level + 1, flags, len_expected);
                 MY_CHECK(n);
 
                 // key
-                MY_WRITE(rws, "\"", 1);
+                MY_WRITE(ser, "\"", 1);
                 size_t len;
                 const char *ks = purc_variant_get_string_const_ex(key, &len);
                 assert(ks != NULL);
-                n = serialize_string(rws, ks, len, flags, len_expected);
+                n = serialize_string(ser, ks, len, flags, len_expected);
                 MY_CHECK(n);
-                MY_WRITE(rws, "\"", 1);
+                MY_WRITE(ser, "\"", 1);
 
-                MY_WRITE(rws, ":", 1);
-                n = print_space(rws, flags, len_expected);
+                MY_WRITE(ser, ":", 1);
+                n = print_space(ser, flags, len_expected);
                 MY_CHECK(n);
 
                 // value
-                n = purc_variant_serialize(member,
-                        rws, level + 1, flags, len_expected);
+                n = serialize_variant(ser, member,
+                        level + 1, flags, len_expected);
                 MY_CHECK(n);
 
                 i++;
             end_foreach;
 
             if (i > 0) {
-                n = print_newline(rws, flags, len_expected);
+                n = print_newline(ser, flags, len_expected);
                 MY_CHECK(n);
             }
 
-            n = print_indent(rws, level, flags, len_expected);
+            n = print_indent(ser, level, flags, len_expected);
             MY_CHECK(n);
 
-            n = print_space_no_pretty(rws, flags, len_expected);
+            n = print_space_no_pretty(ser, flags, len_expected);
             MY_CHECK(n);
 
-            MY_WRITE(rws, "}", 1);
+            MY_WRITE(ser, "}", 1);
             break;
 
         case PURC_VARIANT_TYPE_ARRAY:
             content = NULL;
 
-            n = print_indent(rws, level, flags, len_expected);
+            n = print_indent(ser, level, flags, len_expected);
             MY_CHECK(n);
 
-            MY_WRITE(rws, "[", 1);
-            n = print_newline(rws, flags, len_expected);
+            MY_WRITE(ser, "[", 1);
+            n = print_newline(ser, flags, len_expected);
             MY_CHECK(n);
 
             i = 0;
-            foreach_value_in_variant_array(value, member, idx)
-                (void)idx;
-                if (i > 0) {
-                    MY_WRITE(rws, ",", 1);
-                    n = print_newline(rws, flags, len_expected);
+            packed = pcvariant_array_get_packed(value,
+                    &packed_type, &nr_packed);
+            if (packed) {
+                for (i = 0; i < nr_packed; i++) {
+                    if (i > 0) {
+                        MY_WRITE(ser, ",", 1);
+                        n = print_newline(ser, flags, len_expected);
+                        MY_CHECK(n);
+                    }
+
+                    n = print_space_no_pretty(ser, flags, len_expected);
+                    MY_CHECK(n);
+
+                    n = print_indent(ser, level + 1, flags, len_expected);
+                    MY_CHECK(n);
+
+                    // member of the packed array
+                    packed_real(packed_type, packed, i, &real);
+                    n = serialize_real(ser, packed_type, &real, flags,
+                            ser->format_double, len_expected);
                     MY_CHECK(n);
                 }
+            }
+            else {
+                foreach_value_in_variant_array(value, member, idx)
+                    (void)idx;
+                    if (i > 0) {
+                        MY_WRITE(ser, ",", 1);
+                        n = print_newline(ser, flags, len_expected);
+                        MY_CHECK(n);
+                    }
 
-                n = print_space_no_pretty(rws, flags, len_expected);
-                MY_CHECK(n);
+                    n = print_space_no_pretty(ser, flags, len_expected);
+                    MY_CHECK(n);
 
-                n = print_indent(rws, level + 1, flags, len_expected);
-                MY_CHECK(n);
+                    n = print_indent(ser, level + 1, flags, len_expected);
+                    MY_CHECK(n);
 
-                // member
-                n = purc_variant_serialize(member,
-                        rws, level + 1, flags, len_expected);
-                MY_CHECK(n);
+                    // member
+                    n = serialize_variant(ser, member,
+                            level + 1, flags, len_expected);
+                    MY_CHECK(n);
 
-                i++;
-            end_foreach;
+                    i++;
+                end_foreach;
+            }
 
             if (i > 0) {
-                n = print_newline(rws, flags, len_expected);
+                n = print_newline(ser, flags, len_expected);
                 MY_CHECK(n);
             }
 
-            n = print_indent(rws, level, flags, len_expected);
+            n = print_indent(ser, level, flags, len_expected);
             MY_CHECK(n);
 
-            n = print_space_no_pretty(rws, flags, len_expected);
+            n = print_space_no_pretty(ser, flags, len_expected);
             MY_CHECK(n);
 
-            MY_WRITE(rws, "]", 1);
+            MY_WRITE(ser, "]", 1);
             break;
 
         case PURC_VARIANT_TYPE_SET:
             content = NULL;
 
-            n = print_indent(rws, level, flags, len_expected);
+            n = print_indent(ser, level, flags, len_expected);
             MY_CHECK(n);
 
             if (flags & PCVRNT_SERIALIZE_OPT_UNIQKEYS)
-                MY_WRITE(rws, "[!", 2);
+                MY_WRITE(ser, "[!", 2);
             else
-                MY_WRITE(rws, "[", 1);
+                MY_WRITE(ser, "[", 1);
 
-            n = print_newline(rws, flags, len_expected);
+            n = print_newline(ser, flags, len_expected);
             MY_CHECK(n);
 
             if (flags & PCVRNT_SERIALIZE_OPT_UNIQKEYS) {
@@ -952,8 +1234,8 @@ ssize_t purc_variant_serialize(purc_variant_t value, purc_rwstream_t rws,
                     for (size_t i=0; i<data->nr_keynames; ++i) {
                         const char *sk = data->keynames[i];
                         if (i>0)
-                            MY_WRITE(rws, " ", 1);
-                        MY_WRITE(rws, sk, strlen(sk));
+                            MY_WRITE(ser, " ", 1);
+                        MY_WRITE(ser, sk, strlen(sk));
                     }
                 }
             }
@@ -961,53 +1243,53 @@ ssize_t purc_variant_serialize(purc_variant_t value, purc_rwstream_t rws,
             i = 0;
             foreach_value_in_variant_set_order(value, member)
                 if (i > 0 || flags & PCVRNT_SERIALIZE_OPT_UNIQKEYS) {
-                    MY_WRITE(rws, ",", 1);
-                    n = print_newline(rws, flags, len_expected);
+                    MY_WRITE(ser, ",", 1);
+                    n = print_newline(ser, flags, len_expected);
                     MY_CHECK(n);
                 }
 
-                n = print_space_no_pretty(rws, flags, len_expected);
+                n = print_space_no_pretty(ser, flags, len_expected);
                 MY_CHECK(n);
 
-                n = print_indent(rws, level + 1, flags, len_expected);
+                n = print_indent(ser, level + 1, flags, len_expected);
                 MY_CHECK(n);
 
                 // member
-                n = purc_variant_serialize(member,
-                        rws, level + 1, flags, len_expected);
+                n = serialize_variant(ser, member,
+                        level + 1, flags, len_expected);
                 MY_CHECK(n);
 
                 i++;
             end_foreach;
 
             if (i > 0) {
-                n = print_newline(rws, flags, len_expected);
+                n = print_newline(ser, flags, len_expected);
                 MY_CHECK(n);
             }
 
-            n = print_indent(rws, level, flags, len_expected);
+            n = print_indent(ser, level, flags, len_expected);
             MY_CHECK(n);
 
-            n = print_space_no_pretty(rws, flags, len_expected);
+            n = print_space_no_pretty(ser, flags, len_expected);
             MY_CHECK(n);
 
-            MY_WRITE(rws, "]", 1);
+            MY_WRITE(ser, "]", 1);
             break;
 
         case PURC_VARIANT_TYPE_TUPLE:
         {
             content = NULL;
 
-            n = print_indent(rws, level, flags, len_expected);
+            n = print_indent(ser, level, flags, len_expected);
             MY_CHECK(n);
 
             /* TODO: might use '(' in the future. */
             if (flags & PCVRNT_SERIALIZE_OPT_TUPLE_EJSON)
-                MY_WRITE(rws, "[!", 2);
+                MY_WRITE(ser, "[!", 2);
             else
-                MY_WRITE(rws, "[", 1);
+                MY_WRITE(ser, "[", 1);
 
-            n = print_newline(rws, flags, len_expected);
+            n = print_newline(ser, flags, len_expected);
             MY_CHECK(n);
 
             i = 0;
@@ -1020,38 +1302,38 @@ ssize_t purc_variant_serialize(purc_variant_t value, purc_rwstream_t rws,
             for (idx = 0; idx < sz; idx++) {
 
                 if (i > 0) {
-                    MY_WRITE(rws, ",", 1);
-                    n = print_newline(rws, flags, len_expected);
+                    MY_WRITE(ser, ",", 1);
+                    n = print_newline(ser, flags, len_expected);
                     MY_CHECK(n);
                 }
 
-                n = print_space_no_pretty(rws, flags, len_expected);
+                n = print_space_no_pretty(ser, flags, len_expected);
                 MY_CHECK(n);
 
-                n = print_indent(rws, level + 1, flags, len_expected);
+                n = print_indent(ser, level + 1, flags, len_expected);
                 MY_CHECK(n);
 
                 // member
-                n = purc_variant_serialize(members[idx],
-                        rws, level + 1, flags, len_expected);
+                n = serialize_variant(ser, members[idx],
+                        level + 1, flags, len_expected);
                 MY_CHECK(n);
 
                 i++;
             }
 
             if (i > 0) {
-                n = print_newline(rws, flags, len_expected);
+                n = print_newline(ser, flags, len_expected);
                 MY_CHECK(n);
             }
 
-            n = print_indent(rws, level, flags, len_expected);
+            n = print_indent(ser, level, flags, len_expected);
             MY_CHECK(n);
 
-            n = print_space_no_pretty(rws, flags, len_expected);
+            n = print_space_no_pretty(ser, flags, len_expected);
             MY_CHECK(n);
 
             /* TODO: might use ']' in the future. */
-            MY_WRITE(rws, "]", 1);
+            MY_WRITE(ser, "]", 1);
             break;
         }
 
@@ -1061,7 +1343,7 @@ ssize_t purc_variant_serialize(purc_variant_t value, purc_rwstream_t rws,
 
     if (content) {
         // for simple types
-        MY_WRITE(rws, content, strlen (content));
+        MY_WRITE(ser, content, strlen (content));
     }
 
     return nr_written;
@@ -1070,3 +1352,29 @@ failed:
     return -1;
 }
 
+ssize_t purc_variant_serialize(purc_variant_t value, purc_rwstream_t rws,
+        int level, unsigned int flags, size_t *len_expected)
+{
+    struct serializer ser;
+    uintptr_t format;
+
+    ser.rws = rws;
+    ser.flags = flags;
+    ser.format_double = NULL;
+    ser.format_long_double = NULL;
+    ser.nr_written = 0;
+    ser.len = 0;
+
+    if (purc_get_local_data(PURC_LDNAME_FORMAT_DOUBLE, &format, NULL) > 0)
+        ser.format_double = (const char *)format;
+    if (purc_get_local_data(PURC_LDNAME_FORMAT_LDOUBLE, &format, NULL) > 0)
+        ser.format_long_double = (const char *)format;
+
+    ssize_t n = serialize_variant(&ser, value, level, flags, len_expected);
+
+    /* write the data before any error out as well */
+    if (flush_output(&ser) || n < 0)
+        return -1;
+
+    return ser.nr_written;
+}
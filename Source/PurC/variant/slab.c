@@ -0,0 +1,459 @@
+/*
+ * @file slab.c
+ * @date 2026/10/19
+ * @brief The slab allocator for variants and the nodes of containers.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "private/instance.h"
+#include "private/variant.h"
+#include "private/list.h"
+
+#include "variant-internals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if HAVE(STDATOMIC_H)
+
+#include <stdatomic.h>
+
+/*
+ * A slab is an aligned block of SLAB_SIZE bytes owned by the variant heap
+ * of an instance, and holds the chunks of a size class. The owner
+ * allocates and frees the chunks without any lock. A chunk freed in
+ * another instance (a variant moved between instances, for example) is
+ * pushed to the lock-free `thread_free` list, and collected by the owner
+ * later. When an instance exits, the slabs still having used chunks are
+ * orphaned, and adopted by the next instance needing a slab of the class.
+ */
+#define SLAB_SIZE               (16 * 1024)
+#define SLAB_OF(p)              \
+    ((struct pcvariant_slab *)((uintptr_t)(p) & ~(uintptr_t)(SLAB_SIZE - 1)))
+#define SLAB_HEADER_SIZE        \
+    ((sizeof(struct pcvariant_slab) + PCVARIANT_SLAB_GRANULARITY - 1) & \
+        ~(size_t)(PCVARIANT_SLAB_GRANULARITY - 1))
+
+enum {
+    SLAB_CURR = 0,
+    SLAB_PARTIAL,
+    SLAB_FULL,
+};
+
+struct pcvariant_slab {
+    struct list_head        list;
+
+    // the owner heap; NULL if the slab is orphaned.
+    _Atomic(struct pcvariant_heap *) owner;
+    // the chunks freed in other instances.
+    _Atomic(void *)         thread_free;
+
+    // the free chunks, only accessed by the owner.
+    void                   *free;
+    // the chunks never allocated.
+    char                   *unused;
+    char                   *end;
+
+    size_t                  chunk_size;
+    size_t                  nr_used;
+    int                     cls;
+    int                     state;
+};
+
+static purc_mutex           orphans_lock;
+static struct list_head     orphans[PCVARIANT_SLAB_NR_CLASSES];
+
+static inline int
+size_to_class(size_t size)
+{
+    if (size == 0)
+        size = 1;
+    return (int)((size - 1) / PCVARIANT_SLAB_GRANULARITY);
+}
+
+static inline struct pcvariant_heap *
+current_heap(void)
+{
+    struct pcinst *inst = pcinst_current();
+    return inst ? inst->org_vrt_heap : NULL;
+}
+
+/* Moves the chunks freed in other instances to the free list. */
+static size_t
+slab_collect(struct pcvariant_heap *heap, struct pcvariant_slab *slab)
+{
+    void *p = atomic_exchange_explicit(&slab->thread_free, NULL,
+            memory_order_acquire);
+    size_t n = 0;
+
+    while (p) {
+        void *next = *(void **)p;
+        *(void **)p = slab->free;
+        slab->free = p;
+        p = next;
+        n++;
+    }
+
+    slab->nr_used -= n;
+    heap->stat.nr_slab_chunks -= n;
+    return n;
+}
+
+static void *
+slab_pop(struct pcvariant_heap *heap, struct pcvariant_slab *slab)
+{
+    void *p = slab->free;
+
+    if (p == NULL && slab->unused + slab->chunk_size <= slab->end) {
+        p = slab->unused;
+        slab->unused += slab->chunk_size;
+        slab->nr_used++;
+        return p;
+    }
+
+    if (p == NULL) {
+        if (slab_collect(heap, slab) == 0)
+            return NULL;
+        p = slab->free;
+    }
+
+    slab->free = *(void **)p;
+    slab->nr_used++;
+    return p;
+}
+
+static void
+slab_set_state(struct pcvariant_slab_class *sc, struct pcvariant_slab *slab,
+        int state)
+{
+    if (slab->state != SLAB_CURR)
+        list_del(&slab->list);
+
+    slab->state = state;
+    if (state == SLAB_PARTIAL)
+        list_add(&slab->list, &sc->partial);
+    else if (state == SLAB_FULL)
+        list_add_tail(&slab->list, &sc->full);
+}
+
+static void
+slab_destroy(struct pcvariant_heap *heap, struct pcvariant_slab *slab)
+{
+    heap->stat.nr_slabs--;
+    heap->stat.sz_slabs -= SLAB_SIZE;
+    free(slab);
+}
+
+static struct pcvariant_slab *
+slab_new(struct pcvariant_heap *heap, int cls)
+{
+    struct pcvariant_slab *slab = NULL;
+
+    purc_mutex_lock(&orphans_lock);
+    if (!list_empty(orphans + cls)) {
+        slab = list_first_entry(orphans + cls, struct pcvariant_slab, list);
+        list_del(&slab->list);
+    }
+    purc_mutex_unlock(&orphans_lock);
+
+    if (slab) {
+        atomic_store_explicit(&slab->owner, heap, memory_order_relaxed);
+        heap->stat.nr_slab_chunks += slab->nr_used;
+        slab_collect(heap, slab);
+    }
+    else {
+        void *block;
+        if (posix_memalign(&block, SLAB_SIZE, SLAB_SIZE))
+            return NULL;
+
+        slab = block;
+        atomic_init(&slab->owner, heap);
+        atomic_init(&slab->thread_free, NULL);
+        slab->free = NULL;
+        slab->chunk_size = (cls + 1) * PCVARIANT_SLAB_GRANULARITY;
+        slab->unused = (char *)slab + SLAB_HEADER_SIZE;
+        slab->end = (char *)slab + SLAB_SIZE;
+        slab->nr_used = 0;
+        slab->cls = cls;
+    }
+
+    heap->stat.nr_slabs++;
+    heap->stat.sz_slabs += SLAB_SIZE;
+    slab->state = SLAB_CURR;
+    return slab;
+}
+
+void *
+pcvariant_slab_alloc(size_t size)
+{
+    if (size > PCVARIANT_SLAB_MAX_CHUNK_SIZE)
+        return malloc(size);
+
+    struct pcvariant_heap *heap = current_heap();
+    if (heap == NULL) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return NULL;
+    }
+
+    int cls = size_to_class(size);
+    struct pcvariant_slab_class *sc = heap->slab_classes + cls;
+    struct pcvariant_slab *slab = sc->curr;
+    void *p;
+
+    if (slab && (p = slab_pop(heap, slab)))
+        goto done;
+
+    if (slab)
+        slab_set_state(sc, slab, SLAB_FULL);
+
+    if (!list_empty(&sc->partial)) {
+        slab = list_first_entry(&sc->partial, struct pcvariant_slab, list);
+        slab_set_state(sc, slab, SLAB_CURR);
+    }
+    else if ((slab = slab_new(heap, cls)) == NULL) {
+        sc->curr = NULL;
+        return NULL;
+    }
+
+    sc->curr = slab;
+    p = slab_pop(heap, slab);
+    if (p == NULL) {
+        /* an adopted slab without any free chunk */
+        slab_set_state(sc, slab, SLAB_FULL);
+        if ((slab = slab_new(heap, cls)) == NULL) {
+            sc->curr = NULL;
+            return NULL;
+        }
+        sc->curr = slab;
+        p = slab_pop(heap, slab);
+    }
+
+done:
+    heap->stat.nr_slab_chunks++;
+    return p;
+}
+
+void *
+pcvariant_slab_alloc_0(size_t size)
+{
+    void *p = pcvariant_slab_alloc(size);
+    if (p)
+        memset(p, 0, size);
+    return p;
+}
+
+void
+pcvariant_slab_free(void *p, size_t size)
+{
+    if (size > PCVARIANT_SLAB_MAX_CHUNK_SIZE) {
+        free(p);
+        return;
+    }
+
+    if (p == NULL)
+        return;
+
+    struct pcvariant_slab *slab = SLAB_OF(p);
+    struct pcvariant_heap *heap = current_heap();
+
+    if (heap && heap == atomic_load_explicit(&slab->owner,
+                memory_order_relaxed)) {
+        *(void **)p = slab->free;
+        slab->free = p;
+        slab->nr_used--;
+        heap->stat.nr_slab_chunks--;
+
+        if (slab->state == SLAB_FULL)
+            slab_set_state(heap->slab_classes + slab->cls, slab,
+                    SLAB_PARTIAL);
+    }
+    else {
+        void *head = atomic_load_explicit(&slab->thread_free,
+                memory_order_relaxed);
+        do {
+            *(void **)p = head;
+        } while (!atomic_compare_exchange_weak_explicit(&slab->thread_free,
+                    &head, p, memory_order_release, memory_order_relaxed));
+    }
+}
+
+static void
+trim_slabs(struct pcvariant_heap *heap, struct pcvariant_slab_class *sc,
+        struct list_head *slabs)
+{
+    struct pcvariant_slab *slab, *tmp;
+
+    list_for_each_entry_safe(slab, tmp, slabs, list) {
+        slab_collect(heap, slab);
+        if (slab->nr_used == 0) {
+            list_del(&slab->list);
+            slab_destroy(heap, slab);
+        }
+        else if (slab->state == SLAB_FULL && slab->free) {
+            slab_set_state(sc, slab, SLAB_PARTIAL);
+        }
+    }
+}
+
+void
+pcvariant_slab_trim(void)
+{
+    struct pcvariant_heap *heap = current_heap();
+    if (heap == NULL)
+        return;
+
+    for (int i = 0; i < PCVARIANT_SLAB_NR_CLASSES; i++) {
+        struct pcvariant_slab_class *sc = heap->slab_classes + i;
+
+        trim_slabs(heap, sc, &sc->full);
+        trim_slabs(heap, sc, &sc->partial);
+    }
+}
+
+void
+pcvariant_slab_init_heap(struct pcvariant_heap *heap)
+{
+    for (int i = 0; i < PCVARIANT_SLAB_NR_CLASSES; i++) {
+        struct pcvariant_slab_class *sc = heap->slab_classes + i;
+
+        sc->curr = NULL;
+        list_head_init(&sc->partial);
+        list_head_init(&sc->full);
+    }
+}
+
+static void
+orphan_slab(struct pcvariant_heap *heap, struct pcvariant_slab *slab)
+{
+    slab_collect(heap, slab);
+    if (slab->nr_used == 0) {
+        slab_destroy(heap, slab);
+        return;
+    }
+
+    atomic_store_explicit(&slab->owner, NULL, memory_order_relaxed);
+    purc_mutex_lock(&orphans_lock);
+    list_add_tail(&slab->list, orphans + slab->cls);
+    purc_mutex_unlock(&orphans_lock);
+}
+
+void
+pcvariant_slab_cleanup_heap(struct pcvariant_heap *heap)
+{
+    for (int i = 0; i < PCVARIANT_SLAB_NR_CLASSES; i++) {
+        struct pcvariant_slab_class *sc = heap->slab_classes + i;
+        struct pcvariant_slab *slab, *tmp;
+
+        if (sc->curr) {
+            orphan_slab(heap, sc->curr);
+            sc->curr = NULL;
+        }
+
+        list_for_each_entry_safe(slab, tmp, &sc->partial, list) {
+            list_del(&slab->list);
+            orphan_slab(heap, slab);
+        }
+
+        list_for_each_entry_safe(slab, tmp, &sc->full, list) {
+            list_del(&slab->list);
+            orphan_slab(heap, slab);
+        }
+    }
+}
+
+static void
+slab_cleanup_once(void)
+{
+    for (int i = 0; i < PCVARIANT_SLAB_NR_CLASSES; i++) {
+        struct pcvariant_slab *slab, *tmp;
+        list_for_each_entry_safe(slab, tmp, orphans + i, list) {
+            list_del(&slab->list);
+            free(slab);
+        }
+    }
+
+    purc_mutex_clear(&orphans_lock);
+}
+
+int
+pcvariant_slab_init_once(void)
+{
+    purc_mutex_init(&orphans_lock);
+    if (orphans_lock.native_impl == NULL)
+        return -1;
+
+    for (int i = 0; i < PCVARIANT_SLAB_NR_CLASSES; i++)
+        list_head_init(orphans + i);
+
+    if (atexit(slab_cleanup_once)) {
+        purc_mutex_clear(&orphans_lock);
+        return -1;
+    }
+
+    return 0;
+}
+
+#else /* HAVE(STDATOMIC_H) */
+
+void *
+pcvariant_slab_alloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *
+pcvariant_slab_alloc_0(size_t size)
+{
+    return calloc(1, size);
+}
+
+void
+pcvariant_slab_free(void *p, size_t size)
+{
+    UNUSED_PARAM(size);
+    free(p);
+}
+
+void
+pcvariant_slab_trim(void)
+{
+}
+
+void
+pcvariant_slab_init_heap(struct pcvariant_heap *heap)
+{
+    UNUSED_PARAM(heap);
+}
+
+void
+pcvariant_slab_cleanup_heap(struct pcvariant_heap *heap)
+{
+    UNUSED_PARAM(heap);
+}
+
+int
+pcvariant_slab_init_once(void)
+{
+    return 0;
+}
+
+#endif /* !HAVE(STDATOMIC_H) */
+
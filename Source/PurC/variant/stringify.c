@@ -40,10 +40,10 @@ pcvar_str_stringify(purc_variant_t val, void *ctxt, stringify_f cb)
     PC_ASSERT(val);
     PC_ASSERT(purc_variant_is_string(val));
 
-    int r;
-    const char *s = purc_variant_get_string_const(val);
-    r = _stringify_str(s, ctxt, cb);
-    return r;
+    /* a string slice needs not to be null-terminated here */
+    size_t len;
+    const unsigned char *bs = pcvariant_get_bytes_const(val, &len);
+    return cb(bs, len, ctxt);
 }
 
 int
@@ -159,6 +159,28 @@ pcvar_arr_stringify(purc_variant_t val, void *ctxt, stringify_f cb)
 
     purc_variant_t v;
     size_t idx;
+    variant_arr_t data = pcvar_arr_get_data(val);
+    if (data->packed_type) {
+        /* stringify the members one by one without materializing all
+           of them in the array */
+        for (idx = 0; idx < data->nr; idx++) {
+            v = pcvariant_array_get_member(val, idx);
+            if (v == PURC_VARIANT_INVALID)
+                return -1;
+
+            r = pcvar_stringify(v, ctxt, cb);
+            purc_variant_unref(v);
+            if (r)
+                return r;
+
+            r = _stringify_str(";", ctxt, cb);
+            if (r)
+                return r;
+        }
+
+        return r;
+    }
+
     foreach_value_in_variant_array(val, v, idx) {
         UNUSED_PARAM(idx);
         PC_ASSERT(v != PURC_VARIANT_INVALID);
@@ -36,11 +36,16 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* the initial capacity of the members */
+#define ARRAY_MIN_SIZE          4
+
+/* the minimal number of the members to pack an array */
+#define ARRAY_PACK_MIN_SIZE     16
+
 static size_t
 variant_arr_length(variant_arr_t data)
 {
-    struct pcutils_array_list *al = &data->al;
-    return pcutils_array_list_length(al);
+    return data->nr;
 }
 
 static inline bool
@@ -129,51 +134,252 @@ pcvar_arr_get_data(purc_variant_t arr)
     return (variant_arr_t)arr->sz_ptr[1];
 }
 
+static int
+expand(variant_arr_t data, size_t capacity)
+{
+    if (data->sz >= capacity)
+        return 0;
+
+    size_t sz = data->sz ? data->sz : ARRAY_MIN_SIZE;
+    while (sz < capacity)
+        sz *= 2;
+
+    if (data->packed_type) {
+        void *packed = realloc(data->packed, sz * sizeof(*data->packed_u64));
+        if (!packed)
+            return -1;
+
+        data->packed = packed;
+        data->sz = sz;
+        return 0;
+    }
+
+    purc_variant_t *members;
+    members = (purc_variant_t*)realloc(data->members, sz * sizeof(*members));
+    if (!members)
+        return -1;
+
+    data->members = members;
+    data->sz = sz;
+    return 0;
+}
+
+/* Removes the member at idx from the storage and returns it; the caller
+   owns the reference. Nothing is returned for a packed array. */
+static purc_variant_t
+take_member(variant_arr_t data, size_t idx)
+{
+    purc_variant_t val = PURC_VARIANT_INVALID;
+
+    data->nr--;
+    if (data->packed_type) {
+        memmove(data->packed_u64 + idx, data->packed_u64 + idx + 1,
+                (data->nr - idx) * sizeof(*data->packed_u64));
+    }
+    else {
+        val = data->members[idx];
+        memmove(data->members + idx, data->members + idx + 1,
+                (data->nr - idx) * sizeof(*data->members));
+    }
+
+    return val;
+}
+
 static void
-break_rev_update_chain(purc_variant_t arr, struct arr_node *node)
+refresh_extra(purc_variant_t arr)
 {
-    struct pcvar_rev_update_edge edge = {
-        .parent        = arr,
-        .arr_me        = node,
-    };
+    size_t extra = 0;
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    if (data) {
+        extra += sizeof(*data);
+        if (data->members)
+            extra += data->sz * sizeof(*data->members);
+        if (data->packed)
+            extra += data->sz * sizeof(*data->packed_u64);
+    }
+    pcvariant_stat_set_extra_size(arr, extra);
+}
 
-    pcvar_break_edge_to_parent(node->val, &edge);
-    pcvar_break_rue_downward(node->val);
+static bool
+is_packable_type(purc_variant_type type)
+{
+    return type == PURC_VARIANT_TYPE_NUMBER ||
+        type == PURC_VARIANT_TYPE_LONGINT ||
+        type == PURC_VARIANT_TYPE_ULONGINT;
 }
 
 static void
-arr_node_release(purc_variant_t arr, struct arr_node *node)
+packed_set(variant_arr_t data, size_t idx, purc_variant_t val)
 {
-    if (!node)
-        return;
+    PC_ASSERT(val->type == data->packed_type);
+
+    switch (data->packed_type) {
+    case PURC_VARIANT_TYPE_NUMBER:
+        data->packed_f64[idx] = val->d;
+        break;
+    case PURC_VARIANT_TYPE_LONGINT:
+        data->packed_i64[idx] = val->i64;
+        break;
+    case PURC_VARIANT_TYPE_ULONGINT:
+        data->packed_u64[idx] = val->u64;
+        break;
+    default:
+        PC_ASSERT(0);
+        break;
+    }
+}
+
+static purc_variant_t
+packed_make_member(variant_arr_t data, size_t idx)
+{
+    switch (data->packed_type) {
+    case PURC_VARIANT_TYPE_NUMBER:
+        return purc_variant_make_number(data->packed_f64[idx]);
+    case PURC_VARIANT_TYPE_LONGINT:
+        return purc_variant_make_longint(data->packed_i64[idx]);
+    case PURC_VARIANT_TYPE_ULONGINT:
+        return purc_variant_make_ulongint(data->packed_u64[idx]);
+    default:
+        PC_ASSERT(0);
+        break;
+    }
+
+    return PURC_VARIANT_INVALID;
+}
 
-    break_rev_update_chain(arr, node);
+purc_variant_t
+pcvariant_array_get_member(purc_variant_t arr, size_t idx)
+{
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    if (idx >= data->nr)
+        return PURC_VARIANT_INVALID;
 
-    if (node->node.idx != (size_t)-1) {
-        variant_arr_t data = pcvar_arr_get_data(arr);
-        PC_ASSERT(data);
+    if (data->packed_type)
+        return packed_make_member(data, idx);
 
-        struct pcutils_array_list *al = &data->al;
-        PC_ASSERT(al);
+    return purc_variant_ref(data->members[idx]);
+}
 
-        struct pcutils_array_list_node *p;
-        int r = pcutils_array_list_remove(al, node->node.idx, &p);
-        PC_ASSERT(r == 0);
-        PC_ASSERT(&node->node == p);
-        PC_ASSERT(node->node.idx == (size_t)-1);
+int
+pcvariant_array_unpack(purc_variant_t arr)
+{
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    if (!data->packed_type)
+        return 0;
+
+    purc_variant_t *members = NULL;
+    if (data->sz > 0) {
+        members = (purc_variant_t*)calloc(data->sz, sizeof(*members));
+        if (members == NULL) {
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return -1;
+        }
     }
 
-    PURC_VARIANT_SAFE_CLEAR(node->val);
+    for (size_t i = 0; i < data->nr; i++) {
+        members[i] = packed_make_member(data, i);
+        if (members[i] == PURC_VARIANT_INVALID) {
+            while (i > 0)
+                purc_variant_unref(members[--i]);
+            free(members);
+            return -1;
+        }
+    }
+
+    free(data->packed);
+    data->packed = NULL;
+    data->packed_type = PURC_VARIANT_TYPE_UNDEFINED;
+    data->members = members;
+
+    refresh_extra(arr);
+    return 0;
+}
+
+bool
+pcvariant_array_pack(purc_variant_t arr)
+{
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    if (data->packed_type)
+        return true;
+
+    if (data->nr < ARRAY_PACK_MIN_SIZE)
+        return false;
+
+    purc_variant_type type = data->members[0]->type;
+    if (!is_packable_type(type))
+        return false;
+
+    for (size_t i = 1; i < data->nr; i++) {
+        if (data->members[i]->type != type)
+            return false;
+    }
+
+    void *packed = malloc(data->sz * sizeof(*data->packed_u64));
+    if (packed == NULL)
+        return false;
+
+    data->packed = packed;
+    data->packed_type = type;
+    for (size_t i = 0; i < data->nr; i++) {
+        packed_set(data, i, data->members[i]);
+        purc_variant_unref(data->members[i]);
+    }
+
+    /* the members will be materialized as temporaries on demand */
+    free(data->members);
+    data->members = NULL;
+
+    refresh_extra(arr);
+    return true;
+}
+
+const void *
+pcvariant_array_get_packed(purc_variant_t arr,
+        purc_variant_type *type, size_t *nr)
+{
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    if (!data->packed_type || data->packed == NULL)
+        return NULL;
+
+    if (type)
+        *type = data->packed_type;
+    if (nr)
+        *nr = data->nr;
+    return data->packed;
+}
+
+/* The edges from the members are keyed by the array itself, so a member
+   occurring more than once has a single edge to the array. */
+static void
+break_rev_update_chain(purc_variant_t arr, purc_variant_t val)
+{
+    if (!pcvariant_is_mutable(val))
+        return;
+
+    struct pcvar_rev_update_edge edge = {
+        .parent        = arr,
+        .arr_me        = (struct arr_node*)arr,
+    };
+
+    pcvar_break_edge_to_parent(val, &edge);
+    pcvar_break_rue_downward(val);
 }
 
+/* Breaks the edge from val to the array unless it still occurs at
+   a position other than skip. */
 static void
-arr_node_destroy(purc_variant_t arr, struct arr_node *node)
+release_rev_update_chain(purc_variant_t arr, size_t skip, purc_variant_t val)
 {
-    if (!node)
+    if (!pcvariant_is_mutable(val) || !pcvar_container_belongs_to_set(arr))
         return;
 
-    arr_node_release(arr, node);
-    free(node);
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    for (size_t i = 0; i < data->nr; i++) {
+        if (i != skip && data->members[i] == val)
+            return;
+    }
+
+    break_rev_update_chain(arr, val);
 }
 
 static purc_variant_t
@@ -186,40 +392,22 @@ variant_arr_make_pos(variant_arr_t data, size_t idx)
     return purc_variant_make_longint(idx);
 }
 
-static struct arr_node*
-arr_node_create(purc_variant_t val)
-{
-    struct arr_node *node;
-    node = (struct arr_node*)calloc(1, sizeof(*node));
-    if (!node) {
-        pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
-        return NULL;
-    }
-
-    node->node.idx = (size_t)-1;
-
-    node->val = val;
-    purc_variant_ref(val);
-
-    return node;
-}
-
 static int
-build_rev_update_chain(purc_variant_t arr, struct arr_node *node)
+build_rev_update_chain(purc_variant_t arr, purc_variant_t val)
 {
-    if (!pcvar_container_belongs_to_set(arr))
+    if (!pcvariant_is_mutable(val) || !pcvar_container_belongs_to_set(arr))
         return 0;
 
     int r;
 
     struct pcvar_rev_update_edge edge = {
         .parent        = arr,
-        .arr_me        = node,
+        .arr_me        = (struct arr_node*)arr,
     };
 
-    r = pcvar_build_edge_to_parent(node->val, &edge);
+    r = pcvar_build_edge_to_parent(val, &edge);
     if (r == 0) {
-        r = pcvar_build_rue_downward(node->val);
+        r = pcvar_build_rue_downward(val);
     }
 
     return r ? -1 : 0;
@@ -280,18 +468,16 @@ variant_arr_insert_before(purc_variant_t arr, size_t idx, purc_variant_t val,
     variant_arr_t data = pcvar_arr_get_data(arr);
     PC_ASSERT(data);
 
-    struct pcutils_array_list *al = &data->al;
-    PC_ASSERT(al);
-
-    size_t nr = pcutils_array_list_length(al);
+    size_t nr = data->nr;
     if (idx > nr)
         idx = nr;
 
-    purc_variant_t pos = variant_arr_make_pos(data, idx);
-    if (pos == PURC_VARIANT_INVALID)
-        return -1;
-
-    struct arr_node *node = NULL;
+    purc_variant_t pos = PURC_VARIANT_INVALID;
+    if (check) {
+        pos = variant_arr_make_pos(data, idx);
+        if (pos == PURC_VARIANT_INVALID)
+            return -1;
+    }
 
     do {
         if (check) {
@@ -302,61 +488,56 @@ variant_arr_insert_before(purc_variant_t arr, size_t idx, purc_variant_t val,
                 break;
         }
 
-        node = arr_node_create(val);
-        if (!node)
+        /* only a number of the same type can be appended to a packed
+           array without unpacking it */
+        if (data->packed_type && (idx < nr || val->type != data->packed_type)
+                && pcvariant_array_unpack(arr))
             break;
 
-        int r;
-        PC_ASSERT(node->node.idx == (size_t)-1);
-        r = pcutils_array_list_insert_before(al, idx, &node->node);
-        if (r) {
-            PC_ASSERT(node->node.idx == (size_t)-1);
+        if (expand(data, nr + 1)) {
             purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             break;
         }
-        PC_ASSERT(node->node.idx != (size_t)-1);
+
+        if (data->packed_type) {
+            packed_set(data, nr, val);
+        }
+        else {
+            memmove(data->members + idx + 1, data->members + idx,
+                    (nr - idx) * sizeof(*data->members));
+            data->members[idx] = purc_variant_ref(val);
+        }
+        data->nr++;
 
         if (check) {
-            if (build_rev_update_chain(arr, node))
+            if (build_rev_update_chain(arr, val)) {
+                release_rev_update_chain(arr, idx, val);
+                purc_variant_t v = take_member(data, idx);
+                if (v)
+                    purc_variant_unref(v);
                 break;
+            }
 
-            pcvar_adjust_set_by_descendant(arr);
+            if (pcvar_container_belongs_to_set(arr))
+                pcvar_adjust_set_by_descendant(arr);
             grown(arr, pos, val, check);
+            purc_variant_unref(pos);
         }
 
-        purc_variant_unref(pos);
-
         return 0;
     } while (0);
 
-    arr_node_destroy(arr, node);
-    purc_variant_unref(pos);
+    PURC_VARIANT_SAFE_CLEAR(pos);
 
     return -1;
 }
 
-static void
-refresh_extra(purc_variant_t arr)
-{
-    size_t extra = 0;
-    variant_arr_t data = pcvar_arr_get_data(arr);
-    if (data) {
-        extra += sizeof(*data);
-        struct pcutils_array_list *al = &data->al;
-        extra += al->sz * sizeof(*al->nodes);
-        extra += al->nr * sizeof(struct arr_node);
-    }
-    pcvariant_stat_set_extra_size(arr, extra);
-}
-
 static int
 variant_arr_append(purc_variant_t arr, purc_variant_t val,
         bool check)
 {
     variant_arr_t data = pcvar_arr_get_data(arr);
-    struct pcutils_array_list *al = &data->al;
-    size_t nr = pcutils_array_list_length(al);
-    int r = variant_arr_insert_before(arr, nr, val, check);
+    int r = variant_arr_insert_before(arr, data->nr, val, check);
     refresh_extra(arr);
     return r ? -1 : 0;
 }
@@ -368,22 +549,23 @@ variant_arr_prepend(purc_variant_t arr, purc_variant_t val,
     return variant_arr_insert_before(arr, 0, val, check);
 }
 
+/* The member returned lives as long as the array holds it, so a packed
+   array is unpacked; use pcvariant_array_get_member() to keep it packed. */
 static purc_variant_t
-variant_arr_get(variant_arr_t data, size_t idx)
+variant_arr_get(purc_variant_t arr, size_t idx)
 {
-    struct pcutils_array_list *al = &data->al;
-    struct pcutils_array_list_node *p;
-    p = pcutils_array_list_get(al, idx);
-    if (p == NULL)
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    if (idx >= data->nr)
         return PURC_VARIANT_INVALID;
 
-    struct arr_node *node;
-    node = (struct arr_node*)container_of(p, struct arr_node, node);
-    return node->val;
+    if (data->packed_type && pcvariant_array_unpack(arr))
+        return PURC_VARIANT_INVALID;
+
+    return data->members[idx];
 }
 
 static int
-check_change(purc_variant_t arr, struct arr_node *node, purc_variant_t val)
+check_change(purc_variant_t arr, size_t idx, purc_variant_t val)
 {
     if (!pcvar_container_belongs_to_set(arr))
         return 0;
@@ -398,10 +580,10 @@ check_change(purc_variant_t arr, struct arr_node *node, purc_variant_t val)
         size_t i;
         purc_variant_t v;
         foreach_value_in_variant_array(arr, v, i) {
-            if (i == node->node.idx) {
+            if (i == idx) {
                 found = true;
             }
-            r = pcvar_arr_append(_new, i == node->node.idx ? val : v);
+            r = pcvar_arr_append(_new, i == idx ? val : v);
             if (r)
                 break;
         } end_foreach;
@@ -431,74 +613,84 @@ variant_arr_set(purc_variant_t arr, size_t idx, purc_variant_t val,
     variant_arr_t data = pcvar_arr_get_data(arr);
     PC_ASSERT(data);
 
-    struct pcutils_array_list *al = &data->al;
-    PC_ASSERT(al);
-
-    size_t nr = pcutils_array_list_length(al);
-    if (idx >= nr) {
+    if (idx >= data->nr) {
         purc_set_error(PURC_ERROR_OVERFLOW);
         return -1;
     }
 
-    struct pcutils_array_list_node *p;
-    p = pcutils_array_list_get(al, idx);
-    PC_ASSERT(p);
+    if (data->packed_type && val->type != data->packed_type &&
+            pcvariant_array_unpack(arr))
+        return -1;
 
-    struct arr_node *old_node;
-    old_node = (struct arr_node*)container_of(p, struct arr_node, node);
-    PC_ASSERT(old_node->val != PURC_VARIANT_INVALID);
-    if (old_node->val == val) {
+    /* the old member of a packed array is a temporary, which is released
+       like the one taken from an ordinary array */
+    purc_variant_t old;
+    if (data->packed_type)
+        old = pcvariant_array_get_member(arr, idx);
+    else
+        old = data->members[idx];
+    if (old == PURC_VARIANT_INVALID)
+        return -1;
+    if (old == val) {
         // NOTE: keep refc intact
         return 0;
     }
 
-    purc_variant_t pos = variant_arr_make_pos(data, idx);
-    if (pos == PURC_VARIANT_INVALID)
-        return -1;
+    purc_variant_t pos = PURC_VARIANT_INVALID;
+    if (check) {
+        pos = variant_arr_make_pos(data, idx);
+        if (pos == PURC_VARIANT_INVALID) {
+            if (data->packed_type)
+                purc_variant_unref(old);
+            return -1;
+        }
+    }
 
     do {
-        purc_variant_t old = old_node->val;
-
         if (check) {
             if (!change(arr, pos, old, val, check))
                 break;
 
-            if (check_change(arr, old_node, val))
+            if (check_change(arr, idx, val))
                 break;
 
-            old_node->val = val;
-
-            if (build_rev_update_chain(arr, old_node)) {
-                break_rev_update_chain(arr, old_node);
-                old_node->val = old;
+            if (build_rev_update_chain(arr, val)) {
+                release_rev_update_chain(arr, idx, val);
                 break;
             }
 
-            old_node->val = old;
-            break_rev_update_chain(arr, old_node);
+            release_rev_update_chain(arr, idx, old);
         }
 
-        old_node->val = purc_variant_ref(val);
+        if (data->packed_type) {
+            packed_set(data, idx, val);
+        }
+        else {
+            data->members[idx] = purc_variant_ref(val);
+        }
 
         if (check) {
-            pcvar_adjust_set_by_descendant(arr);
+            if (pcvar_container_belongs_to_set(arr))
+                pcvar_adjust_set_by_descendant(arr);
 
             changed(arr, pos, old, val, check);
         }
 
         purc_variant_unref(old);
-        purc_variant_unref(pos);
+        PURC_VARIANT_SAFE_CLEAR(pos);
 
         return 0;
     } while (0);
 
-    purc_variant_unref(pos);
+    if (data->packed_type)
+        purc_variant_unref(old);
+    PURC_VARIANT_SAFE_CLEAR(pos);
 
     return -1;
 }
 
 static int
-check_shrink(purc_variant_t arr, struct arr_node *node)
+check_shrink(purc_variant_t arr, size_t idx)
 {
     if (!pcvar_container_belongs_to_set(arr))
         return 0;
@@ -513,7 +705,7 @@ check_shrink(purc_variant_t arr, struct arr_node *node)
         size_t i;
         purc_variant_t v;
         foreach_value_in_variant_array(arr, v, i) {
-            if (i == node->node.idx) {
+            if (i == idx) {
                 PC_ASSERT(!found);
                 found = true;
                 continue;
@@ -548,57 +740,58 @@ variant_arr_remove(purc_variant_t arr, size_t idx,
     variant_arr_t data = pcvar_arr_get_data(arr);
     PC_ASSERT(data);
 
-    struct pcutils_array_list *al = &data->al;
-    PC_ASSERT(al);
-
-    size_t nr = pcutils_array_list_length(al);
-    if (idx >= nr) {
+    if (idx >= data->nr) {
         // FIXME: failure or success???
         return 0;
     }
 
-    purc_variant_t pos = variant_arr_make_pos(data, idx);
-    if (pos == PURC_VARIANT_INVALID)
-        return -1;
-
-    struct pcutils_array_list_node *p, *n;
-    p = pcutils_array_list_get(al, idx);
-    PC_ASSERT(p);
+    purc_variant_t pos = PURC_VARIANT_INVALID;
+    if (check) {
+        pos = variant_arr_make_pos(data, idx);
+        if (pos == PURC_VARIANT_INVALID)
+            return -1;
+    }
 
-    struct arr_node *node;
-    node = (struct arr_node*)container_of(p, struct arr_node, node);
-    PC_ASSERT(node->val);
+    /* the member of a packed array is a temporary, which is released
+       like the one taken from an ordinary array */
+    purc_variant_t val;
+    if (data->packed_type)
+        val = pcvariant_array_get_member(arr, idx);
+    else
+        val = data->members[idx];
+    if (val == PURC_VARIANT_INVALID) {
+        PURC_VARIANT_SAFE_CLEAR(pos);
+        return -1;
+    }
 
     do {
         if (check) {
-            if (!shrink(arr, pos, node->val, check))
+            if (!shrink(arr, pos, val, check))
                 break;
 
-            if (check_shrink(arr, node))
+            if (check_shrink(arr, idx))
                 break;
-
-            break_rev_update_chain(arr, node);
         }
 
-        PC_ASSERT(node->node.idx != (size_t)-1);
-        int r = pcutils_array_list_remove(al, idx, &n);
-        PC_ASSERT(r == 0);
-        PC_ASSERT(&node->node == n);
-        PC_ASSERT(node->node.idx == (size_t)-1);
+        release_rev_update_chain(arr, idx, val);
+        take_member(data, idx);
 
         if (check) {
-            pcvar_adjust_set_by_descendant(arr);
+            if (pcvar_container_belongs_to_set(arr))
+                pcvar_adjust_set_by_descendant(arr);
 
-            shrunk(arr, pos, node->val, check);
+            shrunk(arr, pos, val, check);
         }
 
-        arr_node_destroy(arr, node);
-        purc_variant_unref(pos);
+        purc_variant_unref(val);
+        PURC_VARIANT_SAFE_CLEAR(pos);
 
         return 0;
     } while (0);
 
-    purc_variant_unref(pos);
+    if (data->packed_type)
+        purc_variant_unref(val);
+    PURC_VARIANT_SAFE_CLEAR(pos);
 
     return -1;
 }
@@ -610,13 +803,19 @@ array_release (purc_variant_t arr)
     if (!data)
         return;
 
-    struct pcutils_array_list *al = &data->al;
-    struct arr_node *p, *n;
-    array_list_for_each_entry_reverse_safe(al, p, n, node) {
-        arr_node_destroy(arr, p);
-    };
+    for (size_t i = data->nr; data->members && i > 0; i--) {
+        purc_variant_t val = data->members[i - 1];
+        break_rev_update_chain(arr, val);
+        purc_variant_unref(val);
+    }
 
-    pcutils_array_list_reset(al);
+    free(data->members);
+    data->members = NULL;
+    free(data->packed);
+    data->packed = NULL;
+    data->packed_type = PURC_VARIANT_TYPE_UNDEFINED;
+    data->nr = 0;
+    data->sz = 0;
 
     if (data->rev_update_chain) {
         pcvar_destroy_rev_update_chain(data->rev_update_chain);
@@ -642,21 +841,15 @@ make_array(size_t sz)
         var->flags         = PCVRNT_FLAG_EXTRA_SIZE;
         var->refc          = 1;
 
-        size_t initial_size = ARRAY_LIST_DEFAULT_SIZE;
-        if (sz>initial_size)
-            initial_size = sz;
-
         variant_arr_t data = (variant_arr_t)calloc(1, sizeof(*data));
         if (!data) {
             pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
             break;
         }
 
-        struct pcutils_array_list *al;
-        al = &data->al;
-        pcutils_array_list_init(al);
-        if (pcutils_array_list_expand(al, initial_size)) {
-            pcutils_array_list_reset(al);
+        /* the storage of an empty array is allocated on the first
+           insertion */
+        if (sz > 0 && expand(data, sz)) {
             free(data);
             pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
             break;
@@ -682,6 +875,33 @@ pcvar_make_arr(void)
     return make_array(0);
 }
 
+purc_variant_t
+pcvariant_array_make_packed(purc_variant_type type,
+        const void *reals, size_t nr)
+{
+    PC_ASSERT(is_packable_type(type));
+
+    purc_variant_t var = make_array(0);
+    if (var == PURC_VARIANT_INVALID)
+        return PURC_VARIANT_INVALID;
+
+    variant_arr_t data = pcvar_arr_get_data(var);
+    data->packed_type = type;
+    if (nr > 0) {
+        if (expand(data, nr)) {
+            purc_variant_unref(var);
+            pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
+            return PURC_VARIANT_INVALID;
+        }
+
+        memcpy(data->packed, reals, nr * sizeof(*data->packed_u64));
+        data->nr = nr;
+    }
+
+    refresh_extra(var);
+    return var;
+}
+
 int
 pcvar_arr_append(purc_variant_t arr, purc_variant_t val)
 {
@@ -808,9 +1028,7 @@ purc_variant_t purc_variant_array_get (purc_variant_t arr, size_t idx)
     PCVRNT_CHECK_FAIL_RET(arr && arr->type==PVT(_ARRAY),
         PURC_VARIANT_INVALID);
 
-    variant_arr_t data = pcvar_arr_get_data(arr);
-
-    return variant_arr_get(data, idx);
+    return variant_arr_get(arr, idx);
 }
 
 bool purc_variant_array_size(purc_variant_t arr, size_t *sz)
@@ -870,17 +1088,23 @@ struct arr_user_data {
     void *ud;
 };
 
+#if OS(HURD) || OS(LINUX)
 static int
-sort_cmp(struct pcutils_array_list_node *l, struct pcutils_array_list_node *r,
-        void *ud)
+sort_cmp(const void *l, const void *r, void *ud)
+{
+    struct arr_user_data *d = (struct arr_user_data*)ud;
+    return d->cmp(*(purc_variant_t*)l, *(purc_variant_t*)r, d->ud);
+}
+#elif OS(DARWIN) || OS(FREEBSD) || OS(NETBSD) || OS(OPENBSD) || OS(WINDOWS)
+static int
+sort_cmp(void *ud, const void *l, const void *r)
 {
-    struct arr_node *l_n, *r_n;
-    l_n = container_of(l, struct arr_node, node);
-    r_n = container_of(r, struct arr_node, node);
-
     struct arr_user_data *d = (struct arr_user_data*)ud;
-    return d->cmp(l_n->val, r_n->val, d->ud);
+    return d->cmp(*(purc_variant_t*)l, *(purc_variant_t*)r, d->ud);
 }
+#else
+#error Unsupported operating system.
+#endif
 
 static int vrtcmp(purc_variant_t l, purc_variant_t r, void *ud)
 {
@@ -913,7 +1137,19 @@ int pcvariant_array_sort(purc_variant_t arr, void *ud,
         d.cmp = vrtcmp;
     }
 
-    pcutils_array_list_sort(&data->al, &d, sort_cmp);
+    if (data->nr < 2)
+        return 0;
+
+    if (data->packed_type && pcvariant_array_unpack(arr))
+        return -1;
+
+#if OS(HURD) || OS(LINUX)
+    qsort_r(data->members, data->nr, sizeof(*data->members), sort_cmp, &d);
+#elif OS(DARWIN) || OS(FREEBSD) || OS(NETBSD) || OS(OPENBSD)
+    qsort_r(data->members, data->nr, sizeof(*data->members), &d, sort_cmp);
+#elif OS(WINDOWS)
+    qsort_s(data->members, data->nr, sizeof(*data->members), sort_cmp, &d);
+#endif
 
     return 0;
 }
@@ -921,8 +1157,15 @@ int pcvariant_array_sort(purc_variant_t arr, void *ud,
 purc_variant_t
 pcvariant_array_clone(purc_variant_t arr, bool recursively)
 {
+    variant_arr_t data = pcvar_arr_get_data(arr);
+    if (data->packed_type) {
+        /* the members are numbers */
+        return pcvariant_array_make_packed(data->packed_type, data->packed,
+                data->nr);
+    }
+
     purc_variant_t var;
-    var = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+    var = make_array(variant_arr_length(data));
     if (var == PURC_VARIANT_INVALID)
         return PURC_VARIANT_INVALID;
 
@@ -960,17 +1203,12 @@ pcvar_array_break_rue_downward(purc_variant_t arr)
     PC_ASSERT(purc_variant_is_array(arr));
 
     variant_arr_t data = pcvar_arr_get_data(arr);
-    if (!data)
+    if (!data || data->packed_type)     // the members are all numbers
         return;
 
-    struct arr_node *p;
-    foreach_in_variant_array(arr, p) {
-        struct pcvar_rev_update_edge edge = {
-            .parent         = arr,
-            .arr_me         = p,
-        };
-        pcvar_break_edge_to_parent(p->val, &edge);
-        pcvar_break_rue_downward(p->val);
+    size_t i;
+    foreach_in_variant_array(arr, i) {
+        break_rev_update_chain(arr, data->members[i]);
     }
 }
 
@@ -995,19 +1233,23 @@ pcvar_array_build_rue_downward(purc_variant_t arr)
     PC_ASSERT(purc_variant_is_array(arr));
 
     variant_arr_t data = pcvar_arr_get_data(arr);
-    if (!data)
+    if (!data || data->packed_type)     // the members are all numbers
         return 0;
 
-    struct arr_node *p;
-    foreach_in_variant_array(arr, p) {
+    size_t i;
+    foreach_in_variant_array(arr, i) {
+        purc_variant_t v = data->members[i];
+        if (!pcvariant_is_mutable(v))
+            continue;
+
         struct pcvar_rev_update_edge edge = {
             .parent         = arr,
-            .arr_me         = p,
+            .arr_me         = (struct arr_node*)arr,
         };
-        int r = pcvar_build_edge_to_parent(p->val, &edge);
+        int r = pcvar_build_edge_to_parent(v, &edge);
         if (r)
             return -1;
-        r = pcvar_build_rue_downward(p->val);
+        r = pcvar_build_rue_downward(v);
         if (r)
             return -1;
     }
@@ -1042,67 +1284,25 @@ pcvar_array_build_edge_to_parent(purc_variant_t arr,
     return r ? -1 : 0;
 }
 
-static struct pcutils_array_list_node*
-next_node(struct pcutils_array_list *al, struct pcutils_array_list_node *node)
-{
-    if (!node)
-        return NULL;
-    size_t count = pcutils_array_list_length(al);
-    size_t idx = node->idx + 1;
-    if (idx >= count)
-        return NULL;
-
-    return pcutils_array_list_get(al, idx);
-}
-
-static struct pcutils_array_list_node*
-prev_node(struct pcutils_array_list *al, struct pcutils_array_list_node *node)
-{
-    if (!node)
-        return NULL;
-    if (node->idx == 0)
-        return NULL;
-
-    size_t count = pcutils_array_list_length(al);
-    size_t idx = node->idx - 1;
-    if (idx >= count)
-        return NULL;
-
-    return pcutils_array_list_get(al, idx);
-}
-
 static void
-it_refresh(struct arr_iterator *it,
-        struct pcutils_array_list *al,
-        struct pcutils_array_list_node *curr)
+it_refresh(struct arr_iterator *it, size_t idx)
 {
-    struct pcutils_array_list_node *next  = NULL;
-    struct pcutils_array_list_node *prev  = NULL;
-    if (curr) {
-        next  = next_node(al, curr);
-        prev  = prev_node(al, curr);
-    }
-
-    if (curr) {
-        it->curr = container_of(curr, struct arr_node, node);
-    }
-    else {
-        it->curr = NULL;
-    }
+    variant_arr_t data = pcvar_arr_get_data(it->arr);
 
-    if (next) {
-        it->next = container_of(next, struct arr_node, node);
-    }
-    else {
-        it->next = NULL;
+    if (idx >= data->nr) {
+        it->idx  = -1;
+        it->curr = PURC_VARIANT_INVALID;
+        it->next = PURC_VARIANT_INVALID;
+        it->prev = PURC_VARIANT_INVALID;
+        return;
     }
 
-    if (prev) {
-        it->prev = container_of(prev, struct arr_node, node);
-    }
-    else {
-        it->prev = NULL;
-    }
+    it->idx  = idx;
+    it->curr = variant_arr_get(it->arr, idx);
+    it->prev = idx > 0 ?
+        variant_arr_get(it->arr, idx - 1) : PURC_VARIANT_INVALID;
+    it->next = idx + 1 < data->nr ?
+        variant_arr_get(it->arr, idx + 1) : PURC_VARIANT_INVALID;
 }
 
 struct arr_iterator
@@ -1110,6 +1310,7 @@ pcvar_arr_it_first(purc_variant_t arr)
 {
     struct arr_iterator it = {
         .arr         = arr,
+        .idx         = -1,
     };
     if (arr == PURC_VARIANT_INVALID)
         return it;
@@ -1119,12 +1320,7 @@ pcvar_arr_it_first(purc_variant_t arr)
     if (count == 0)
         return it;
 
-    struct pcutils_array_list *al = &data->al;
-
-    struct pcutils_array_list_node *first;
-    first = pcutils_array_list_get_first(al);
-
-    it_refresh(&it, al, first);
+    it_refresh(&it, 0);
 
     return it;
 }
@@ -1134,6 +1330,7 @@ pcvar_arr_it_last(purc_variant_t arr)
 {
     struct arr_iterator it = {
         .arr         = arr,
+        .idx         = -1,
     };
     if (arr == PURC_VARIANT_INVALID)
         return it;
@@ -1143,12 +1340,7 @@ pcvar_arr_it_last(purc_variant_t arr)
     if (count == 0)
         return it;
 
-    struct pcutils_array_list *al = &data->al;
-
-    struct pcutils_array_list_node *last;
-    last = pcutils_array_list_get_last(al);
-
-    it_refresh(&it, al, last);
+    it_refresh(&it, count - 1);
 
     return it;
 }
@@ -1156,45 +1348,17 @@ pcvar_arr_it_last(purc_variant_t arr)
 void
 pcvar_arr_it_next(struct arr_iterator *it)
 {
-    if (it->curr == NULL)
+    if (it->curr == PURC_VARIANT_INVALID)
         return;
 
-    if (it->next) {
-        variant_arr_t data = pcvar_arr_get_data(it->arr);
-        struct pcutils_array_list *al = &data->al;
-
-        struct pcutils_array_list_node *next;
-        next = &it->next->node;
-
-        it_refresh(it, al, next);
-    }
-    else {
-        it->curr = NULL;
-        it->next = NULL;
-        it->prev = NULL;
-    }
+    it_refresh(it, it->idx + 1);
 }
 
 void
 pcvar_arr_it_prev(struct arr_iterator *it)
 {
-    if (it->curr == NULL)
+    if (it->curr == PURC_VARIANT_INVALID)
         return;
 
-    if (it->prev) {
-        variant_arr_t data = pcvar_arr_get_data(it->arr);
-        struct pcutils_array_list *al = &data->al;
-
-        struct pcutils_array_list_node *prev;
-        prev = &it->prev->node;
-
-        it_refresh(it, al, prev);
-    }
-    else {
-        it->curr = NULL;
-        it->next = NULL;
-        it->prev = NULL;
-    }
+    it_refresh(it, it->idx - 1);
 }
-
-
@@ -73,10 +73,19 @@ void pcvariant_set_release     (purc_variant_t value)    WTF_INTERNAL;
 void pcvariant_tuple_release   (purc_variant_t value)    WTF_INTERNAL;
 void pcvariant_sorted_array_release (purc_variant_t value)    WTF_INTERNAL;
 
+// release the interned object keys in a variant heap
+void pcvariant_object_release_interned_keys(struct pcvariant_heap *heap)
+    WTF_INTERNAL;
+
 variant_arr_t
 pcvar_arr_get_data(purc_variant_t arr) WTF_INTERNAL;
+
 variant_obj_t
 pcvar_obj_get_data(purc_variant_t obj) WTF_INTERNAL;
+
+// gives the object a new stamp after a change of its members
+void
+pcvar_obj_touch(purc_variant_t obj) WTF_INTERNAL;
 variant_set_t
 pcvar_set_get_data(purc_variant_t set) WTF_INTERNAL;
 variant_tuple_t
@@ -191,10 +200,11 @@ pcvar_obj_it_prev(struct obj_iterator *it);
 
 struct arr_iterator {
     purc_variant_t                arr;
+    size_t                        idx;
 
-    struct arr_node              *curr;
-    struct arr_node              *next;
-    struct arr_node              *prev;
+    purc_variant_t                curr;
+    purc_variant_t                next;
+    purc_variant_t                prev;
 };
 
 struct arr_iterator
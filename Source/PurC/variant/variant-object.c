@@ -26,18 +26,36 @@
 #include "config.h"
 #include "private/variant.h"
 #include "private/errors.h"
+#include "private/instance.h"
+#include "private/atom-buckets.h"
 #include "purc-errors.h"
 #include "variant-internals.h"
 
 
 #include <limits.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
 #define OBJ_EXTRA_SIZE(data) (sizeof(*data) + \
         (data->size) * sizeof(struct obj_node))
 
+#define ATOM_SEQ_BITS               \
+    ((sizeof(purc_atom_t) << 3) - PURC_ATOM_BUCKET_BITS)
+#define ATOM_TO_SEQ(atom)           \
+    ((atom) & (((purc_atom_t)1 << ATOM_SEQ_BITS) - 1))
+
+/* keys longer than this are not interned; they are unlikely to repeat */
+#define MAX_LEN_INTERNED_KEY        64
+#define MIN_NR_INTERNED_KEYS        256
+
+/* the atoms in ATOM_BUCKET_OBJKEY are never freed; no more keys are
+   registered after so many ones, that is, 4MB at most for the strings */
+#define MAX_NR_OBJKEY_ATOMS         65536
+
+static atomic_uint _nr_objkey_atoms;
+
 static inline bool
 grow(purc_variant_t obj, purc_variant_t key, purc_variant_t val,
         bool check)
@@ -127,6 +145,27 @@ pcvar_obj_get_data(purc_variant_t obj)
     return data;
 }
 
+/* Every thread takes a block of stamps at a time, so that stamping an
+   object does not contend on the global counter; stamp 0 is never used. */
+#define STAMP_BLOCK_SIZE    (1 << 16)
+
+static atomic_uint_fast64_t _next_stamp_block = STAMP_BLOCK_SIZE;
+static __thread uint64_t _stamp;
+static __thread uint64_t _stamp_end;
+
+void
+pcvar_obj_touch(purc_variant_t obj)
+{
+    if (UNLIKELY(_stamp == _stamp_end)) {
+        _stamp = atomic_fetch_add_explicit(&_next_stamp_block,
+                STAMP_BLOCK_SIZE, memory_order_relaxed);
+        _stamp_end = _stamp + STAMP_BLOCK_SIZE;
+    }
+
+    variant_obj_t data = pcvar_obj_get_data(obj);
+    data->stamp = _stamp++;
+}
+
 static purc_variant_t v_object_new_with_capacity(void)
 {
     purc_variant_t var = pcvariant_get(PVT(_OBJECT));
@@ -151,6 +190,7 @@ static purc_variant_t v_object_new_with_capacity(void)
 
     var->sz_ptr[1]     = (uintptr_t)data;
     var->refc          = 1;
+    pcvar_obj_touch(var);
 
     size_t extra = OBJ_EXTRA_SIZE(data);
     pcvariant_stat_set_extra_size(var, extra);
@@ -186,6 +226,7 @@ obj_node_release(purc_variant_t obj, struct obj_node *node)
         --data->size;
         pcutils_rbtree_erase(&node->node, root);
         node->node.rb_parent = NULL;
+        pcvar_obj_touch(obj);
     }
 
     PURC_VARIANT_SAFE_CLEAR(node->key);
@@ -200,7 +241,108 @@ obj_node_destroy(purc_variant_t obj, struct obj_node *node)
 
     obj_node_release(obj, node);
 
-    free(node);
+    pcvariant_slab_free(node, sizeof(*node));
+}
+
+/*
+ * Returns the interned key variant having the same string as @key, or @key
+ * itself if interning keys is disabled or failed. The interned key variants
+ * are shared by all objects in the current instance, so the keys repeating
+ * in many objects occupy the memory only once, and can be compared
+ * by pointer.
+ *
+ * A key is interned when it is seen the second time: the first time only
+ * registers the atom, so the keys used once do not pay for a copy. The
+ * atoms are shared by all instances and live as long as the process, so
+ * the new keys are no longer registered after MAX_NR_OBJKEY_ATOMS ones. The
+ * interned variant is a copy owned by the heap; @key itself is never
+ * changed nor kept, as it may be a static string, or a slice which would
+ * pin its parent buffer.
+ */
+static purc_variant_t
+intern_key(purc_variant_t key)
+{
+    struct pcinst *inst = pcinst_current();
+    struct pcvariant_heap *heap = inst->org_vrt_heap;
+
+    if (!heap->intern_keys || (key->flags & PCVRNT_FLAG_INTERNED))
+        return key;
+
+    size_t len;
+    const char *sk = purc_variant_get_string_const_ex(key, &len);
+    /* the atoms are null-terminated strings */
+    if (sk == NULL || len > MAX_LEN_INTERNED_KEY || memchr(sk, 0, len))
+        return key;
+
+    purc_atom_t atom = purc_atom_try_string_ex(ATOM_BUCKET_OBJKEY, sk);
+    if (atom == 0) {
+        /* the first time: remember the key, but do not intern it yet */
+        if (atomic_load_explicit(&_nr_objkey_atoms,
+                    memory_order_relaxed) < MAX_NR_OBJKEY_ATOMS) {
+            atomic_fetch_add_explicit(&_nr_objkey_atoms, 1,
+                    memory_order_relaxed);
+            purc_atom_from_string_ex(ATOM_BUCKET_OBJKEY, sk);
+        }
+        return key;
+    }
+
+    size_t seq = ATOM_TO_SEQ(atom);
+    if (seq >= heap->nr_interned_keys) {
+        size_t nr = heap->nr_interned_keys;
+        if (nr == 0)
+            nr = MIN_NR_INTERNED_KEYS;
+        while (nr <= seq)
+            nr <<= 1;
+
+        purc_variant_t *keys = realloc(heap->interned_keys,
+                sizeof(purc_variant_t) * nr);
+        if (keys == NULL)
+            return key;
+
+        memset(keys + heap->nr_interned_keys, 0,
+                sizeof(purc_variant_t) * (nr - heap->nr_interned_keys));
+        heap->interned_keys = keys;
+        heap->nr_interned_keys = nr;
+    }
+
+    if (heap->interned_keys[seq] == PURC_VARIANT_INVALID) {
+        purc_variant_t interned = purc_variant_make_string_ex(sk, len, false);
+        if (interned == PURC_VARIANT_INVALID)
+            return key;
+
+        interned->flags |= PCVRNT_FLAG_INTERNED;
+        heap->interned_keys[seq] = interned;
+    }
+
+    return heap->interned_keys[seq];
+}
+
+void
+pcvariant_object_release_interned_keys(struct pcvariant_heap *heap)
+{
+    for (size_t i = 0; i < heap->nr_interned_keys; i++) {
+        if (heap->interned_keys[i])
+            purc_variant_unref(heap->interned_keys[i]);
+    }
+
+    free(heap->interned_keys);
+    heap->interned_keys = NULL;
+    heap->nr_interned_keys = 0;
+}
+
+bool
+purc_variant_object_intern_keys(bool enable)
+{
+    struct pcinst *inst = pcinst_current();
+    if (inst == NULL || inst->org_vrt_heap == NULL) {
+        purc_set_error(PURC_ERROR_NO_INSTANCE);
+        return false;
+    }
+
+    struct pcvariant_heap *heap = inst->org_vrt_heap;
+    bool old = heap->intern_keys;
+    heap->intern_keys = enable;
+    return old;
 }
 
 static struct obj_node*
@@ -212,13 +354,13 @@ obj_node_create(purc_variant_t k, purc_variant_t v)
     }
 
     struct obj_node *node;
-    node = (struct obj_node*)calloc(1, sizeof(*node));
+    node = (struct obj_node*)pcvariant_slab_alloc_0(sizeof(*node));
     if (!node) {
         pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
         return NULL;
     }
 
-    node->key = purc_variant_ref(k);
+    node->key = purc_variant_ref(intern_key(k));
     node->val = purc_variant_ref(v);
 
     return node;
@@ -345,6 +487,7 @@ v_object_remove(purc_variant_t obj, const char *key, bool silently,
         PC_ASSERT(entry == root->rb_node || entry->rb_parent);
         pcutils_rbtree_erase(entry, root);
         entry->rb_parent = NULL;
+        pcvar_obj_touch(obj);
 
         if (check) {
             pcvar_adjust_set_by_descendant(obj);
@@ -480,8 +623,14 @@ v_object_set(purc_variant_t obj, purc_variant_t key, purc_variant_t val,
     while (*pnode) {
         struct obj_node *node;
         node = container_of(*pnode, struct obj_node, node);
-        const char *sko = purc_variant_get_string_const(node->key);
-        int ret = strcmp(sk, sko);
+        int ret;
+        if (node->key == key) {
+            ret = 0;
+        }
+        else {
+            const char *sko = purc_variant_get_string_const(node->key);
+            ret = strcmp(sk, sko);
+        }
 
         parent = *pnode;
 
@@ -515,6 +664,7 @@ v_object_set(purc_variant_t obj, purc_variant_t key, purc_variant_t val,
             pcutils_rbtree_insert_color(entry, root);
 
             ++data->size;
+            pcvar_obj_touch(obj);
 
             if (check) {
                 if (build_rev_update_chain(obj, node))
@@ -570,6 +720,7 @@ v_object_set(purc_variant_t obj, purc_variant_t key, purc_variant_t val,
 
         node->key = purc_variant_ref(key);
         node->val = purc_variant_ref(val);
+        pcvar_obj_touch(obj);
 
         if (check) {
             pcvar_adjust_set_by_descendant(obj);
@@ -443,8 +443,6 @@ find_element_rb_node(struct element_rb_node *node,
     struct rb_node **pnode = &root->rb_node;
     struct rb_node *parent = NULL;
     struct rb_node *entry = NULL;
-    char md5[33];
-    pcvariant_md5_by_set(md5, kvs, set);
 
     while (*pnode) {
         struct set_node *on;
@@ -454,6 +452,9 @@ find_element_rb_node(struct element_rb_node *node,
             diff = variant_set_compare_by_set_keys(set, kvs, on->val);
         }
         else if (0) {
+            /* not used; computing the digest on every lookup is costly */
+            char md5[33];
+            pcvariant_md5_by_set(md5, kvs, set);
             diff = pcvariant_diff_by_set(md5, kvs, on->md5, on->val, set);
         }
         else {
@@ -603,7 +604,7 @@ elem_node_destroy(purc_variant_t set, struct set_node *node)
         return;
 
     elem_node_release(set, node);
-    free(node);
+    pcvariant_slab_free(node, sizeof(*node));
 }
 
 static int
@@ -709,7 +710,8 @@ variant_set_create_elem_node(purc_variant_t set, purc_variant_t val)
     variant_set_t data = pcvar_set_get_data(set);
     PC_ASSERT(data);
 
-    struct set_node *_new = (struct set_node*)calloc(1, sizeof(*_new));
+    struct set_node *_new;
+    _new = (struct set_node*)pcvariant_slab_alloc_0(sizeof(*_new));
     if (!_new) {
         pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
         return NULL;
@@ -2166,33 +2168,11 @@ out:
     return ret;
 }
 
-static bool
-is_in_array(purc_variant_t array, purc_variant_t v, int* idx)
-{
-    bool ret = false;
-    purc_variant_t val;
-    size_t curr;
-    UNUSED_VARIABLE(val);
-    foreach_value_in_variant_array_safe(array, val, curr)
-        if (val == v) {
-            if (idx) {
-                *idx = curr;
-            }
-            ret = true;
-            goto end;
-        }
-    end_foreach;
-
-end:
-    return ret;
-}
-
-
 ssize_t
 purc_variant_set_intersect(purc_variant_t set, purc_variant_t value)
 {
     ssize_t ret = -1;
-    purc_variant_t tmp = PURC_VARIANT_INVALID;
+    struct pchash_table *found = NULL;
     if (set == PURC_VARIANT_INVALID || value == PURC_VARIANT_INVALID) {
         purc_set_error(PURC_ERROR_INVALID_VALUE);
         goto out;
@@ -2208,8 +2188,10 @@ purc_variant_set_intersect(purc_variant_t set, purc_variant_t value)
         goto out;
     }
 
-    tmp = purc_variant_make_array(0, PURC_VARIANT_INVALID);
-    if (tmp == PURC_VARIANT_INVALID) {
+    /* the members of the set found in value, indexed by their addresses */
+    found = pchash_kptr_table_new(HASHTABLE_DEFAULT_SIZE, NULL);
+    if (found == NULL) {
+        purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
         goto out;
     }
 
@@ -2221,19 +2203,20 @@ purc_variant_set_intersect(purc_variant_t set, purc_variant_t value)
         }
 
         purc_variant_t vf = pcvariant_set_find(set, v);
-        if (vf == PURC_VARIANT_INVALID) {
+        if (vf == PURC_VARIANT_INVALID ||
+                pchash_table_lookup_entry(found, vf)) {
             continue;
         }
 
-        if (!purc_variant_array_append(tmp, vf)) {
-            ret = -1;
+        if (pchash_table_insert(found, vf, vf)) {
+            purc_set_error(PURC_ERROR_OUT_OF_MEMORY);
             goto out;
         }
     }
 
     purc_variant_t v;
     foreach_value_in_variant_set_safe(set, v)
-        if (is_in_array(tmp, v, NULL)) {
+        if (pchash_table_lookup_entry(found, v)) {
             continue;
         }
 
@@ -2245,8 +2228,8 @@ purc_variant_set_intersect(purc_variant_t set, purc_variant_t value)
 
     ret = purc_variant_set_get_size(set);
 out:
-    if (tmp) {
-        purc_variant_unref(tmp);
+    if (found) {
+        pchash_table_free(found);
     }
     return ret;
 }
@@ -86,32 +86,18 @@ static struct err_msg_seg _variant_err_msgs_seg = {
     variant_err_msgs
 };
 
-#if HAVE(GLIB)
 purc_variant *pcvariant_alloc(void) {
-    return (purc_variant *)g_slice_alloc(sizeof(purc_variant));
+    return (purc_variant *)pcvariant_slab_alloc(sizeof(purc_variant));
 }
 
 purc_variant *pcvariant_alloc_0(void) {
-    return (purc_variant *)g_slice_alloc0(sizeof(purc_variant));
+    return (purc_variant *)pcvariant_slab_alloc_0(sizeof(purc_variant));
 }
 
 void pcvariant_free(purc_variant *v) {
-    return g_slice_free1(sizeof(purc_variant), (gpointer)v);
-}
-#else
-purc_variant *pcvariant_alloc(void) {
-    return (purc_variant *)malloc(sizeof(purc_variant));
+    pcvariant_slab_free(v, sizeof(purc_variant));
 }
 
-purc_variant *pcvariant_alloc_0(void) {
-    return (purc_variant *)calloc(1, sizeof(purc_variant));
-}
-
-void pcvariant_free(purc_variant *v) {
-    return free(v);
-}
-#endif
-
 purc_atom_t pcvariant_atom_grow;
 purc_atom_t pcvariant_atom_shrink;
 purc_atom_t pcvariant_atom_change;
@@ -131,7 +117,7 @@ static int _init_once(void)
     pcvariant_atom_change = purc_atom_from_static_string_ex(ATOM_BUCKET_MSG,
         "change");
 
-    return 0;
+    return pcvariant_slab_init_once();
 }
 
 static void _cleanup_instance(struct pcinst *inst)
@@ -146,6 +132,8 @@ static void _cleanup_instance(struct pcinst *inst)
     if (heap == NULL)
         return;
 
+    pcvariant_object_release_interned_keys(heap);
+
     /* VWNOTE: do not try to release the extra memory here. */
 #if USE(LOOP_BUFFER_FOR_RESERVED)
     for (int i = 0; i < MAX_RESERVED_VARIANTS; i++) {
@@ -171,6 +159,7 @@ static void _cleanup_instance(struct pcinst *inst)
     assert(heap->v_true.refc == 0);
     assert(heap->v_false.refc == 0);
 
+    pcvariant_slab_cleanup_heap(heap);
     free(heap);
     inst->variant_heap = NULL;
     inst->org_vrt_heap = NULL;
@@ -189,6 +178,7 @@ static int _init_instance(struct pcinst *curr_inst,
     }
 
     inst->org_vrt_heap = inst->variant_heap;
+    pcvariant_slab_init_heap(inst->variant_heap);
 
     // initialize const values in instance
     inst->variant_heap->v_undefined.type = PURC_VARIANT_TYPE_UNDEFINED;
@@ -573,8 +563,10 @@ static bool equal_arrays(purc_variant_t v1, purc_variant_t v2)
     size_t curr;
     foreach_value_in_variant_array(v1, m1, curr)
         (void)curr;
-        m2 = purc_variant_array_get(v2, idx);
-        if (!purc_variant_is_equal_to(m1, m2))
+        m2 = pcvariant_array_get_member(v2, idx);
+        bool equal = purc_variant_is_equal_to(m1, m2);
+        purc_variant_unref(m2);
+        if (!equal)
             return false;
         idx++;
     end_foreach;
@@ -674,31 +666,8 @@ bool purc_variant_is_equal_to(purc_variant_t v1, purc_variant_t v2)
 
         case PURC_VARIANT_TYPE_STRING:
         case PURC_VARIANT_TYPE_BSEQUENCE:
-            if (v1->flags & PCVRNT_FLAG_STRING_STATIC) {
-                str1 = (const char*)v1->sz_ptr[1];
-                len1 = v1->sz_ptr[0];
-            }
-            else if (v1->flags & PCVRNT_FLAG_EXTRA_SIZE) {
-                str1 = (const char*)v1->sz_ptr[1];
-                len1 = v1->sz_ptr[0];
-            }
-            else {
-                str1 = (const char*)v1->bytes;
-                len1 = v1->size;
-            }
-
-            if (v2->flags & PCVRNT_FLAG_STRING_STATIC) {
-                str2 = (const char*)v2->sz_ptr[1];
-                len2 = v2->sz_ptr[0];
-            }
-            else if (v2->flags & PCVRNT_FLAG_EXTRA_SIZE) {
-                str2 = (const char*)v2->sz_ptr[1];
-                len2 = v2->sz_ptr[0];
-            }
-            else {
-                str2 = (const char*)v2->bytes;
-                len2 = v2->size;
-            }
+            str1 = pcvariant_get_bytes_const(v1, &len1);
+            str2 = pcvariant_get_bytes_const(v2, &len2);
 
             return (len1 == len2 && memcmp(str1, str2, len1) == 0);
 
@@ -897,18 +866,7 @@ purc_variant_cast_to_int32(purc_variant_t v, int32_t *i32, bool force)
             if (!force)
                 break;
 
-            if (v->flags & PCVRNT_FLAG_STRING_STATIC) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = strlen((const char*)bytes);
-            }
-            else if (v->flags & PCVRNT_FLAG_EXTRA_SIZE) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = v->sz_ptr[0];
-            }
-            else {
-                bytes = (void*)v->bytes;
-                sz = v->size;
-            }
+            bytes = (void*)pcvariant_get_bytes_const(v, &sz);
             if (pcutils_parse_int32(bytes, sz, i32) != 0) {
                 *i32 = 0;
             }
@@ -1018,18 +976,7 @@ purc_variant_cast_to_uint32(purc_variant_t v, uint32_t *u32, bool force)
             if (!force)
                 break;
 
-            if (v->flags & PCVRNT_FLAG_STRING_STATIC) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = strlen((const char*)bytes);
-            }
-            else if (v->flags & PCVRNT_FLAG_EXTRA_SIZE) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = v->sz_ptr[0];
-            }
-            else {
-                bytes = (void*)v->bytes;
-                sz = v->size;
-            }
+            bytes = (void*)pcvariant_get_bytes_const(v, &sz);
             if (pcutils_parse_uint32(bytes, sz, u32) != 0) {
                 *u32 = 0;
             }
@@ -1139,18 +1086,7 @@ purc_variant_cast_to_longint(purc_variant_t v, int64_t *i64, bool force)
             if (!force)
                 break;
 
-            if (v->flags & PCVRNT_FLAG_STRING_STATIC) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = strlen((const char*)bytes);
-            }
-            else if (v->flags & PCVRNT_FLAG_EXTRA_SIZE) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = v->sz_ptr[0];
-            }
-            else {
-                bytes = (void*)v->bytes;
-                sz = v->size;
-            }
+            bytes = (void*)pcvariant_get_bytes_const(v, &sz);
             if (pcutils_parse_int64(bytes, sz, i64) != 0) {
                 *i64 = 0;
             }
@@ -1256,18 +1192,7 @@ purc_variant_cast_to_ulongint(purc_variant_t v, uint64_t *u64, bool force)
             if (!force)
                 break;
 
-            if (v->flags & PCVRNT_FLAG_STRING_STATIC) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = strlen((const char*)bytes);
-            }
-            else if (v->flags & PCVRNT_FLAG_EXTRA_SIZE) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = v->sz_ptr[0];
-            }
-            else {
-                bytes = (void*)v->bytes;
-                sz = v->size;
-            }
+            bytes = (void*)pcvariant_get_bytes_const(v, &sz);
             if (pcutils_parse_uint64(bytes, sz, u64) != 0) {
                 *u64 = 0;
             }
@@ -1334,18 +1259,7 @@ bool purc_variant_cast_to_number(purc_variant_t v, double *d, bool force)
             if (!force)
                 break;
 
-            if (v->flags & PCVRNT_FLAG_STRING_STATIC) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = strlen((const char*)bytes);
-            }
-            else if (v->flags & PCVRNT_FLAG_EXTRA_SIZE) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = v->sz_ptr[0];
-            }
-            else {
-                bytes = (void*)v->bytes;
-                sz = v->size;
-            }
+            bytes = (void*)pcvariant_get_bytes_const(v, &sz);
             if (pcutils_parse_double(bytes, sz, d) != 0) {
                 *d = 0;
             }
@@ -1414,18 +1328,7 @@ purc_variant_cast_to_longdouble(purc_variant_t v, long double *d,
             if (!force)
                 break;
 
-            if (v->flags & PCVRNT_FLAG_STRING_STATIC) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = strlen((const char*)bytes);
-            }
-            else if (v->flags & PCVRNT_FLAG_EXTRA_SIZE) {
-                bytes = (void*)v->sz_ptr[1];
-                sz = v->sz_ptr[0];
-            }
-            else {
-                bytes = (void*)v->bytes;
-                sz = v->size;
-            }
+            bytes = (void*)pcvariant_get_bytes_const(v, &sz);
             if (pcutils_parse_long_double(bytes, sz, d) != 0) {
                 *d = 0;
             }
@@ -1452,12 +1355,20 @@ bool purc_variant_cast_to_byte_sequence(purc_variant_t v,
 
         case PURC_VARIANT_TYPE_STRING:
         case PURC_VARIANT_TYPE_BSEQUENCE:
+            /* the size counts the terminating null byte of a string in */
+            if (v->type == PURC_VARIANT_TYPE_STRING &&
+                    (v->flags & PCVRNT_FLAG_STRING_SLICE) &&
+                    purc_variant_get_string_const(v) == NULL) {
+                return false;
+            }
+
             if (v->type == PURC_VARIANT_TYPE_STRING &&
                     v->flags & PCVRNT_FLAG_STRING_STATIC) {
                 *bytes = (void*)v->sz_ptr[1];
                 *sz = v->sz_ptr[0]; // strlen((const char*)*bytes) + 1;
             }
-            else if (v->flags & PCVRNT_FLAG_EXTRA_SIZE) {
+            else if (v->flags & (PCVRNT_FLAG_EXTRA_SIZE |
+                        PCVRNT_FLAG_STRING_SLICE)) {
                 *bytes = (void*)v->sz_ptr[1];
                 *sz = v->sz_ptr[0];
             }
@@ -1622,7 +1533,7 @@ purc_variant_t purc_variant_load_from_json_stream(purc_rwstream_t stream)
         goto ret;
     }
 
-    value = pcvcm_eval (root, NULL, false);
+    value = pcvcm_eval_once (root, false);
 
 ret:
     pcvcm_node_destroy (root);
@@ -2882,34 +2793,23 @@ cmp_by_arr(purc_variant_t l, purc_variant_t r,
     PC_ASSERT(ld);
     PC_ASSERT(rd);
 
-    struct pcutils_array_list *la = &ld->al;
-    struct pcutils_array_list *ra = &rd->al;
-
-    struct pcutils_array_list_node *lnode = pcutils_array_list_get_first(la);
-    struct pcutils_array_list_node *rnode = pcutils_array_list_get_first(ra);
-
-    for (;
-        lnode && rnode;
-        lnode = pcutils_array_list_get(la, lnode->idx + 1),
-        rnode = pcutils_array_list_get(ra, rnode->idx + 1))
-    {
-        struct arr_node *lo, *ro;
-        lo = container_of(lnode, struct arr_node, node);
-        ro = container_of(rnode, struct arr_node, node);
-
-        purc_variant_t lv = lo->val;
-        purc_variant_t rv = ro->val;
+    size_t i;
+    for (i = 0; i < ld->nr && i < rd->nr; i++) {
+        purc_variant_t lv = pcvariant_array_get_member(l, i);
+        purc_variant_t rv = pcvariant_array_get_member(r, i);
         PC_ASSERT(lv != PURC_VARIANT_INVALID);
         PC_ASSERT(rv != PURC_VARIANT_INVALID);
 
         diff = pcvar_compare_ex(lv, rv, caseless, unify_number);
+        purc_variant_unref(lv);
+        purc_variant_unref(rv);
         if (diff)
             return diff;
     }
 
-    if (lnode)
+    if (i < ld->nr)
         return 1;
-    else if (rnode)
+    else if (i < rd->nr)
         return -1;
     else
         return 0;
@@ -34,8 +34,11 @@
 
 #include "private/errors.h"
 #include "private/stack.h"
+#include "private/instance.h"
 #include "private/interpreter.h"
+#include "private/stats.h"
 #include "private/utils.h"
+#include "private/variant.h"
 
 #include "eval.h"
 #include "ops.h"
@@ -469,6 +472,76 @@ pcvcm_eval_native_wrapper_get_param(purc_variant_t val)
 }
 
 
+#define METHOD_CACHE_BITS       8
+#define METHOD_CACHE_SIZE       (1 << METHOD_CACHE_BITS)
+
+struct method_cache_entry {
+    const struct pcvcm_node    *node;
+    purc_variant_t              obj;
+    uint64_t                    stamp;
+    uint32_t                    generation;
+    purc_variant_t              val;    // held by obj
+};
+
+struct pcvcm_method_cache {
+    struct method_cache_entry   entries[METHOD_CACHE_SIZE];
+};
+
+static inline struct method_cache_entry *
+method_cache_slot(struct pcvcm_method_cache *cache,
+        const struct pcvcm_node *node, purc_variant_t obj)
+{
+    uintptr_t h = ((uintptr_t)node >> 4) ^ ((uintptr_t)obj >> 4) * 31;
+    return cache->entries + (h & (METHOD_CACHE_SIZE - 1));
+}
+
+purc_variant_t
+pcvcm_eval_method_cache_get(const struct pcvcm_node *node,
+        purc_variant_t obj)
+{
+    struct pcinst *inst = pcinst_current();
+    if (inst == NULL || inst->vcm_method_cache == NULL)
+        return PURC_VARIANT_INVALID;
+
+    struct method_cache_entry *entry =
+        method_cache_slot(inst->vcm_method_cache, node, obj);
+    if (entry->node == node && entry->obj == obj &&
+            entry->stamp == pcvariant_object_get_stamp(obj) &&
+            entry->generation == pcvcm_node_get_element_generation())
+        return entry->val;
+
+    return PURC_VARIANT_INVALID;
+}
+
+void
+pcvcm_eval_method_cache_put(const struct pcvcm_node *node,
+        purc_variant_t obj, purc_variant_t val)
+{
+    struct pcinst *inst = pcinst_current();
+    if (inst == NULL)
+        return;
+
+    if (inst->vcm_method_cache == NULL) {
+        inst->vcm_method_cache = calloc(1, sizeof(struct pcvcm_method_cache));
+        if (inst->vcm_method_cache == NULL)
+            return;
+    }
+
+    struct method_cache_entry *entry =
+        method_cache_slot(inst->vcm_method_cache, node, obj);
+    entry->node = node;
+    entry->obj = obj;
+    entry->stamp = pcvariant_object_get_stamp(obj);
+    entry->generation = pcvcm_node_get_element_generation();
+    entry->val = val;
+}
+
+void
+pcvcm_method_cache_delete(struct pcvcm_method_cache *cache)
+{
+    free(cache);
+}
+
 purc_variant_t
 pcvcm_eval_call_dvariant_method(purc_variant_t root,
         purc_variant_t var, size_t nr_args, purc_variant_t *argv,
@@ -646,6 +719,9 @@ eval_vcm(struct pcvcm_node *tree,
 {
     purc_variant_t result = PURC_VARIANT_INVALID;
     struct pcvcm_eval_stack_frame *frame;
+#if ENABLE(RUNTIME_STATS)
+    uint64_t begin = pcinst_stats_now_ns();
+#endif
 
     ctxt->find_var = find_var;
     ctxt->find_var_ctxt = find_var_ctxt;
@@ -694,6 +770,10 @@ out:
         }
         ctxt->result = purc_variant_ref(result);
     }
+#if ENABLE(RUNTIME_STATS)
+    pcinst_stats_record(pcinst_current(), PCINST_STATS_VCM_EVAL,
+            pcinst_stats_now_ns() - begin);
+#endif
 #if 0
     if (ctxt->enable_log) {
         pcvcm_print_stack(ctxt);
@@ -787,6 +867,28 @@ out:
     return result;
 }
 
+purc_variant_t
+pcvcm_eval_once(struct pcvcm_node *tree, bool silently)
+{
+    purc_variant_t result = PURC_VARIANT_INVALID;
+    struct pcvcm_eval_ctxt *ctxt;
+
+    purc_clr_error();
+
+    if (tree && (ctxt = pcvcm_eval_ctxt_create())) {
+        ctxt->node = tree;
+        ctxt->flags |= PCVCM_EVAL_FLAG_ONCE;
+        result = eval_vcm(tree, ctxt, PURC_VARIANT_INVALID, NULL, NULL,
+                silently, false, false);
+        pcvcm_eval_ctxt_destroy(ctxt);
+    }
+
+    if (!result && silently) {
+        result = purc_variant_make_undefined();
+    }
+    return result;
+}
+
 purc_variant_t pcvcm_eval_again_full(struct pcvcm_node *tree,
         struct pcvcm_eval_ctxt *ctxt,
         find_var_fn find_var, void *find_var_ctxt,
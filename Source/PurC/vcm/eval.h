@@ -41,6 +41,8 @@
 #define PCVCM_EVAL_FLAG_SILENTLY        0x0001
 #define PCVCM_EVAL_FLAG_AGAIN           0x0002
 #define PCVCM_EVAL_FLAG_TIMEOUT         0x0004
+/* the tree is destroyed right after the evaluation */
+#define PCVCM_EVAL_FLAG_ONCE            0x0008
 
 #define KEY_INNER_HANDLER               "__vcm_native_wrapper"
 #define KEY_CALLER_NODE                 "__vcm_caller_node"
@@ -161,6 +163,22 @@ pcvcm_eval_call_nvariant_method(purc_variant_t var,
 bool
 pcvcm_eval_is_handle_as_getter(struct pcvcm_node *node);
 
+/* The method cache of the current instance maps a `get_element` node
+   with a constant key and the object it is applied to, to the dynamic
+   value found in the object; an entry is valid until the object changes
+   or any `get_element` node is destroyed. */
+purc_variant_t
+pcvcm_eval_method_cache_get(const struct pcvcm_node *node,
+        purc_variant_t obj);
+
+void
+pcvcm_eval_method_cache_put(const struct pcvcm_node *node,
+        purc_variant_t obj, purc_variant_t val);
+
+/* Changed whenever a `get_element` node is destroyed. */
+uint32_t
+pcvcm_node_get_element_generation(void);
+
 static inline purc_variant_t
 pcvcm_eval_get_attach_variant(struct pcvcm_node *node)
 {
@@ -36,6 +36,7 @@
 #include "private/stack.h"
 #include "private/interpreter.h"
 #include "private/utils.h"
+#include "private/variant.h"
 #include "private/vcm.h"
 
 #include "../eval.h"
@@ -67,6 +68,9 @@ eval(struct pcvcm_eval_ctxt *ctxt,
         }
     }
 
+    /* a large array of numbers, e.g., a series of samples in eJSON */
+    pcvariant_array_pack(array);
+
 out:
     return array;
 }
@@ -72,8 +72,13 @@ eval(struct pcvcm_eval_ctxt *ctxt,
     unsigned call_flags = pcvcm_eval_ctxt_get_call_flags(ctxt);
 
     purc_variant_t *params = NULL;
+    purc_variant_t *args = NULL;
     size_t nr_params = frame->nr_params - 1;
-    if (nr_params > 0) {
+    if (nr_params > 0 && frame->params_result->length >= frame->nr_params) {
+        /* all results are on the stack frame already: pass them in place */
+        args = (purc_variant_t *)frame->params_result->list + 1;
+    }
+    else if (nr_params > 0) {
         params = (purc_variant_t*)calloc(nr_params, sizeof(purc_variant_t));
         if (!params) {
             pcinst_set_error(PURC_ERROR_OUT_OF_MEMORY);
@@ -83,13 +88,14 @@ eval(struct pcvcm_eval_ctxt *ctxt,
         for (size_t i = 1, j = 0; i < frame->nr_params; i++, j++) {
             params[j] = pcutils_array_get(frame->params_result, i);
         }
+        args = params;
     }
 
     if (purc_variant_is_dynamic(caller_var)) {
         ret_var = pcvcm_eval_call_dvariant_method(
                 pcvcm_eval_get_attach_variant(
                     pcvcm_node_first_child(caller_node)),
-                caller_var, nr_params, params, GETTER_METHOD, call_flags);
+                caller_var, nr_params, args, GETTER_METHOD, call_flags);
     }
     else if (pcvcm_eval_is_native_wrapper(caller_var)) {
         purc_variant_t nv = pcvcm_eval_native_wrapper_get_caller(caller_var);
@@ -98,7 +104,7 @@ eval(struct pcvcm_eval_ctxt *ctxt,
             if (name) {
                 ret_var = pcvcm_eval_call_nvariant_method(nv,
                         purc_variant_get_string_const(name), nr_params,
-                        params, GETTER_METHOD, call_flags);
+                        args, GETTER_METHOD, call_flags);
             }
         }
     }
@@ -36,6 +36,7 @@
 #include "private/stack.h"
 #include "private/interpreter.h"
 #include "private/utils.h"
+#include "private/variant.h"
 #include "private/vcm.h"
 
 #include "../eval.h"
@@ -91,9 +92,23 @@ eval(struct pcvcm_eval_ctxt *ctxt, struct pcvcm_eval_stack_frame *frame)
     }
 
     if (purc_variant_is_object(caller_var)) {
-        purc_variant_t val = purc_variant_object_get(caller_var, param_var);
+        /* the key is a constant: look up the dynamic value found last time
+           in the same object, e.g., `$SYS.time` in a loop */
+        bool cacheable = (param_node->type == PCVCM_NODE_TYPE_STRING);
+        purc_variant_t val = PURC_VARIANT_INVALID;
+        if (cacheable) {
+            val = pcvcm_eval_method_cache_get(frame->node, caller_var);
+        }
+
         if (val == PURC_VARIANT_INVALID) {
-            goto out;
+            val = purc_variant_object_get(caller_var, param_var);
+            if (val == PURC_VARIANT_INVALID) {
+                goto out;
+            }
+
+            if (cacheable && purc_variant_is_dynamic(val)) {
+                pcvcm_eval_method_cache_put(frame->node, caller_var, val);
+            }
         }
 
         if (!purc_variant_is_dynamic(val)) {
@@ -124,24 +139,24 @@ eval(struct pcvcm_eval_ctxt *ctxt, struct pcvcm_eval_stack_frame *frame)
             goto out;
         }
 
-        purc_variant_t val = purc_variant_array_get(caller_var, index);
+        /* a new reference, which keeps a packed array packed */
+        purc_variant_t val = pcvariant_array_get_member(caller_var, index);
         if (val == PURC_VARIANT_INVALID) {
             goto out;
         }
 
         if (!purc_variant_is_dynamic(val)) {
             ret_var = val;
-            purc_variant_ref(ret_var);
             goto out;
         }
 
         if (!pcvcm_eval_is_handle_as_getter(frame->node)) {
             ret_var = val;
-            purc_variant_ref(ret_var);
             goto out;
         }
         ret_var = pcvcm_eval_call_dvariant_method(caller_var, val, 0, NULL,
                 GETTER_METHOD, call_flags);
+        purc_variant_unref(val);
     }
     else if (purc_variant_is_tuple(caller_var)) {
         if (!has_index) {
@@ -50,13 +50,40 @@ after_pushed(struct pcvcm_eval_ctxt *ctxt,
     return 0;
 }
 
+/* Nothing reads a string in an object or an array after it is evaluated,
+   so the buffer can be handed over to the result if the tree is evaluated
+   only once. */
+static bool
+can_take_buffer(struct pcvcm_eval_ctxt *ctxt, struct pcvcm_node *node)
+{
+    if (!(ctxt->flags & PCVCM_EVAL_FLAG_ONCE) || ctxt->enable_log)
+        return false;
+
+    struct pcvcm_node *parent = (struct pcvcm_node *)
+        pctree_node_parent(&node->tree_node);
+    return parent == NULL || parent->type == PCVCM_NODE_TYPE_OBJECT ||
+        parent->type == PCVCM_NODE_TYPE_ARRAY;
+}
+
 static purc_variant_t
 eval(struct pcvcm_eval_ctxt *ctxt,
         struct pcvcm_eval_stack_frame *frame)
 {
-    UNUSED_PARAM(ctxt);
     struct pcvcm_node *node = frame->node;
-    return purc_variant_make_string((char*)node->sz_ptr[1], false);
+    char *buf = (char*)node->sz_ptr[1];
+    size_t nr_bytes = node->sz_ptr[0];
+
+    if (can_take_buffer(ctxt, node)) {
+        purc_variant_t v = purc_variant_make_string_reuse_buff(buf,
+                nr_bytes + 1, false);
+        if (v) {
+            node->sz_ptr[0] = 0;
+            node->sz_ptr[1] = 0;
+        }
+        return v;
+    }
+
+    return purc_variant_make_string_ex(buf, nr_bytes, false);
 }
 
 
@@ -26,6 +26,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
+#include <stdatomic.h>
 
 #include "config.h"
 #include "purc-utils.h"
@@ -488,11 +489,22 @@ pcvcm_node_new_cjsonee_op_semicolon()
     return pcvcm_node_new(PCVCM_NODE_TYPE_CJSONEE_OP_SEMICOLON, true);
 }
 
+static atomic_uint_fast32_t _get_element_generation;
+
+uint32_t
+pcvcm_node_get_element_generation(void)
+{
+    return (uint32_t)atomic_load_explicit(&_get_element_generation,
+            memory_order_relaxed);
+}
+
 static void
 pcvcm_node_destroy_callback(struct pctree_node *n,  void *data)
 {
-    UNUSED_PARAM(data);
     struct pcvcm_node *node = (struct pcvcm_node*)n;
+    if (node->type == PCVCM_NODE_TYPE_FUNC_GET_ELEMENT) {
+        *(bool *)data = true;
+    }
     if ((node->type == PCVCM_NODE_TYPE_STRING
                 || node->type == PCVCM_NODE_TYPE_BYTE_SEQUENCE
         ) && node->sz_ptr[1]) {
@@ -504,8 +516,14 @@ pcvcm_node_destroy_callback(struct pctree_node *n,  void *data)
 void pcvcm_node_destroy(struct pcvcm_node *root)
 {
     if (root) {
+        /* the method caches may refer to the get_element nodes */
+        bool has_get_element = false;
         pctree_node_post_order_traversal((struct pctree_node*)root,
-                pcvcm_node_destroy_callback, NULL);
+                pcvcm_node_destroy_callback, &has_get_element);
+        if (has_get_element) {
+            atomic_fetch_add_explicit(&_get_element_generation, 1,
+                    memory_order_relaxed);
+        }
     }
 }
 
@@ -110,6 +110,10 @@ struct pcvdom_element {
 
     pcutils_array_t        *attrs;
 
+    // the position of the start tag in the source; 0 if unknown
+    int                     line;
+    int                     column;
+
     unsigned int            self_closing:1;
 };
 
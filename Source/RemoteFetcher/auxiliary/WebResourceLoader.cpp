@@ -71,6 +71,10 @@ void WebResourceLoader::didReceiveSharedBuffer(IPC::SharedBufferDataReference&&,
 {
 }
 
+void WebResourceLoader::didReceiveSharedMemory(const PurCFetcher::SharedMemory::Handle&, uint64_t, int64_t)
+{
+}
+
 void WebResourceLoader::didFinishResourceLoad(const PurCFetcher::NetworkLoadMetrics&)
 {
 }
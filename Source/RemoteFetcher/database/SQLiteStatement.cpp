@@ -256,6 +256,16 @@ unsigned SQLiteStatement::bindParameterCount() const
     return sqlite3_bind_parameter_count(m_statement);
 }
 
+String SQLiteStatement::bindParameterName(int index) const
+{
+    ASSERT(m_isPrepared);
+    ASSERT(index > 0);
+    ASSERT(static_cast<unsigned>(index) <= bindParameterCount());
+    if (!m_statement)
+        return String();
+    return String::fromUTF8(sqlite3_bind_parameter_name(m_statement, index));
+}
+
 int SQLiteStatement::columnCount()
 {
     ASSERT(m_isPrepared);
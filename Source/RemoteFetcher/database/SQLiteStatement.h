@@ -49,6 +49,7 @@ public:
     PURCFETCHER_EXPORT int bindNull(int index);
     PURCFETCHER_EXPORT int bindValue(int index, const SQLValue&);
     PURCFETCHER_EXPORT unsigned bindParameterCount() const;
+    PURCFETCHER_EXPORT String bindParameterName(int index) const;
 
     PURCFETCHER_EXPORT int step();
     PURCFETCHER_EXPORT int finalize();
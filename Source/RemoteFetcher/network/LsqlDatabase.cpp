@@ -0,0 +1,136 @@
+/* 
+ * Copyright (C) 2022 Beijing FMSoft Technologies Co., Ltd.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Or,
+ * 
+ * As this component is a program released under LGPLv3, which claims
+ * explicitly that the program could be modified by any end user
+ * even if the program is conveyed in non-source form on the system it runs.
+ * Generally, if you distribute this program in embedded devices,
+ * you might not satisfy this condition. Under this situation or you can
+ * not accept any condition of LGPLv3, you need to get a commercial license
+ * from FMSoft, along with a patent license for the patents owned by FMSoft.
+ * 
+ * If you have got a commercial/patent license of this program, please use it
+ * under the terms and conditions of the commercial license.
+ * 
+ * For more information about the commercial license and patent license,
+ * please refer to
+ * <https://hybridos.fmsoft.cn/blog/hybridos-licensing-policy/>.
+ * 
+ * Also note that the LGPLv3 license does not apply to any entity in the
+ * Exception List published by Beijing FMSoft Technologies Co., Ltd.
+ * 
+ * If you are or the entity you represent is listed in the Exception List,
+ * the above open source or free software license does not apply to you
+ * or the entity you represent. Regardless of the purpose, you should not
+ * use the software in any way whatsoever, including but not limited to
+ * downloading, viewing, copying, distributing, compiling, and running.
+ * If you have already downloaded it, you MUST destroy all of its copies.
+ * 
+ * The Exception List is published by FMSoft and may be updated
+ * from time to time. For more information, please see
+ * <https://www.fmsoft.cn/exception-list>.
+ */ 
+
+#include "config.h"
+#include "LsqlDatabase.h"
+
+#if ENABLE(LSQL)
+
+#include <wtf/NeverDestroyed.h>
+
+namespace PurCFetcher {
+
+// the least recently used database comes first
+static Vector<std::pair<String, RefPtr<LsqlDatabase>>>& openedDatabases()
+{
+    static NeverDestroyed<Vector<std::pair<String, RefPtr<LsqlDatabase>>>> databases;
+    return databases;
+}
+
+RefPtr<LsqlDatabase> LsqlDatabase::open(const String& path)
+{
+    auto& databases = openedDatabases();
+    for (size_t i = 0; i < databases.size(); i++) {
+        if (databases[i].first == path) {
+            auto entry = WTFMove(databases[i]);
+            databases.remove(i);
+            RefPtr<LsqlDatabase> database = entry.second;
+            databases.append(WTFMove(entry));
+            return database;
+        }
+    }
+
+    auto database = adoptRef(*new LsqlDatabase);
+    if (!database->m_database.open(path))
+        return nullptr;
+    database->m_database.disableThreadingChecks();
+
+    // The tasks still using an evicted database keep it alive.
+    if (databases.size() >= maxOpenedDatabases)
+        databases.remove(0);
+    databases.append({ path, database.copyRef() });
+    return database;
+}
+
+LsqlDatabase::~LsqlDatabase()
+{
+    m_statements.clear();
+    if (m_database.isOpen())
+        m_database.close();
+}
+
+std::unique_ptr<SQLiteStatement> LsqlDatabase::takeStatement(const String& sql)
+{
+    for (size_t i = 0; i < m_statements.size(); i++) {
+        if (m_statements[i]->query() == sql) {
+            auto statement = WTFMove(m_statements[i]);
+            m_statements.remove(i);
+            return statement;
+        }
+    }
+
+    auto statement = makeUnique<SQLiteStatement>(m_database, sql);
+    if (statement->prepare() != SQLITE_OK)
+        return nullptr;
+    return statement;
+}
+
+void LsqlDatabase::giveBackStatement(std::unique_ptr<SQLiteStatement>&& statement)
+{
+    if (!statement)
+        return;
+
+    // Release the locks on the database and the bound values.
+    statement->reset();
+
+    for (size_t i = 0; i < m_statements.size(); i++) {
+        // the same query taken by two tasks at the same time
+        if (m_statements[i]->query() == statement->query()) {
+            m_statements.remove(i);
+            break;
+        }
+    }
+
+    if (m_statements.size() >= maxCachedStatements)
+        m_statements.remove(0);
+    m_statements.append(WTFMove(statement));
+}
+
+} // namespace PurCFetcher
+
+#endif // ENABLE(LSQL)
@@ -0,0 +1,95 @@
+/* 
+ * Copyright (C) 2022 Beijing FMSoft Technologies Co., Ltd.
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Or,
+ * 
+ * As this component is a program released under LGPLv3, which claims
+ * explicitly that the program could be modified by any end user
+ * even if the program is conveyed in non-source form on the system it runs.
+ * Generally, if you distribute this program in embedded devices,
+ * you might not satisfy this condition. Under this situation or you can
+ * not accept any condition of LGPLv3, you need to get a commercial license
+ * from FMSoft, along with a patent license for the patents owned by FMSoft.
+ * 
+ * If you have got a commercial/patent license of this program, please use it
+ * under the terms and conditions of the commercial license.
+ * 
+ * For more information about the commercial license and patent license,
+ * please refer to
+ * <https://hybridos.fmsoft.cn/blog/hybridos-licensing-policy/>.
+ * 
+ * Also note that the LGPLv3 license does not apply to any entity in the
+ * Exception List published by Beijing FMSoft Technologies Co., Ltd.
+ * 
+ * If you are or the entity you represent is listed in the Exception List,
+ * the above open source or free software license does not apply to you
+ * or the entity you represent. Regardless of the purpose, you should not
+ * use the software in any way whatsoever, including but not limited to
+ * downloading, viewing, copying, distributing, compiling, and running.
+ * If you have already downloaded it, you MUST destroy all of its copies.
+ * 
+ * The Exception List is published by FMSoft and may be updated
+ * from time to time. For more information, please see
+ * <https://www.fmsoft.cn/exception-list>.
+ */ 
+
+#pragma once
+
+#if ENABLE(LSQL)
+
+#include "SQLiteDatabase.h"
+#include "SQLiteStatement.h"
+#include <wtf/RefCounted.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace PurCFetcher {
+
+// An opened local database shared by the LSQL data tasks, with a cache of
+// the prepared statements. All the calls are made on the network thread.
+class LsqlDatabase : public RefCounted<LsqlDatabase> {
+    WTF_MAKE_NONCOPYABLE(LsqlDatabase); WTF_MAKE_FAST_ALLOCATED;
+public:
+    // Returns the database opened for the path, opening it if needed;
+    // nullptr if the database can not be opened.
+    static RefPtr<LsqlDatabase> open(const String& path);
+
+    ~LsqlDatabase();
+
+    SQLiteDatabase& database() { return m_database; }
+
+    // Takes the prepared statement for the SQL out of the cache, or
+    // prepares a new one; nullptr if the statement can not be prepared.
+    // The statement is not shared with others until it is given back.
+    std::unique_ptr<SQLiteStatement> takeStatement(const String& sql);
+
+    // Resets the statement and caches it for the next use.
+    void giveBackStatement(std::unique_ptr<SQLiteStatement>&&);
+
+    static const size_t maxCachedStatements = 32;
+    static const size_t maxOpenedDatabases = 8;
+
+private:
+    LsqlDatabase() = default;
+
+    SQLiteDatabase m_database;
+    // the least recently used statement comes first
+    Vector<std::unique_ptr<SQLiteStatement>> m_statements;
+};
+
+} // namespace PurCFetcher
+
+#endif // ENABLE(LSQL)
@@ -70,15 +70,26 @@
 #include "TextEncoding.h"
 #include <wtf/MainThread.h>
 #include <wtf/glib/RunLoopSourcePriority.h>
+#include <wtf/glib/GUniquePtr.h>
+#include <gio/gio.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
+extern char **environ;
+
 
 namespace PurCFetcher {
 using namespace PurCFetcher;
 
 #define  DEFAULT_READBUFFER_SIZE 8192
 
+// the default maximal bytes of the output of a command
+#define  DEFAULT_OUTPUT_LIMIT    (16 * 1024 * 1024)
+
 const char* KEY_STATUS_CODE = "statusCode";
 const char* KEY_ERROR_MSG = "errorMsg";
 const char* KEY_EXIT_CODE = "exitCode";
@@ -86,6 +97,8 @@ const char* KEY_LINES = "lines";
 
 const char* CMD_FILTER = "cmdfilter";
 const char* CMD_LINE = "cmdline";
+const char* CMD_OUTPUT_LIMIT = "cmdoutputlimit";
+const char* CMD_TIMEOUT = "cmdtimeout";
 
 String decodeEscapeSequencesFromParsedURL(StringView input)
 {
@@ -111,6 +124,8 @@ String decodeEscapeSequencesFromParsedURL(StringView input)
 NetworkDataTaskLcmd::NetworkDataTaskLcmd(NetworkSession& session, NetworkDataTaskClient& client, const ResourceRequest& requestWithCredentials, StoredCredentialsPolicy storedCredentialsPolicy, ContentSniffingPolicy shouldContentSniff, PurCFetcher::ContentEncodingSniffingPolicy, bool shouldClearReferrerOnHTTPSToHTTPRedirect, bool dataTaskIsForMainFrameNavigation)
     : NetworkDataTask(session, client, requestWithCredentials, storedCredentialsPolicy, shouldClearReferrerOnHTTPSToHTTPRedirect, dataTaskIsForMainFrameNavigation)
     , m_filterManager(adoptRef(*new CmdFilterManager()))
+    , m_timeoutTimer(RunLoop::main(), this, &NetworkDataTaskLcmd::timeoutFired)
+    , m_outputLimit(DEFAULT_OUTPUT_LIMIT)
 {
     UNUSED_PARAM(shouldContentSniff);
     m_session->registerNetworkDataTask(*this);
@@ -123,6 +138,12 @@ NetworkDataTaskLcmd::NetworkDataTaskLcmd(NetworkSession& session, NetworkDataTas
 
 NetworkDataTaskLcmd::~NetworkDataTaskLcmd()
 {
+    if (m_childWatch)
+        g_source_destroy(m_childWatch.get());
+    if (m_pid > 0 && !m_exited) {
+        kill(-m_pid, SIGKILL);
+        waitpid(m_pid, nullptr, 0);
+    }
     m_session->unregisterNetworkDataTask(*this);
 }
 
@@ -146,6 +167,8 @@ void NetworkDataTaskLcmd::cancel()
         return;
 
     m_state = State::Canceling;
+    if (m_pid > 0)
+        killCommand(503, "Canceling");
 }
 
 void NetworkDataTaskLcmd::resume()
@@ -188,7 +211,8 @@ void NetworkDataTaskLcmd::dispatchDidReceiveResponse()
     const char* contentType = "application/json";
     m_response.setMimeType(extractMIMETypeFromMediaType(contentType));
     m_response.setTextEncodingName(extractCharsetFromMediaType(contentType));
-    m_response.setExpectedContentLength(m_responseBuffer.size());
+    // The length is unknown if the lines are sent while the command runs.
+    m_response.setExpectedContentLength(m_finished ? static_cast<long long>(m_responseBuffer.size()) : -1);
     m_response.setHTTPHeaderField(HTTPHeaderName::AccessControlAllowOrigin, "*");
     m_response.setHTTPHeaderField(HTTPHeaderName::Expires, "-1");
     m_response.setHTTPHeaderField(HTTPHeaderName::CacheControl, "no-cache");
@@ -202,10 +226,8 @@ void NetworkDataTaskLcmd::dispatchDidReceiveResponse()
 
         switch (policyAction) {
         case PolicyAction::Use:
-            {
-                m_client->didReceiveData(SharedBuffer::create(WTFMove(m_responseBuffer)));
-                dispatchDidCompleteWithError({ });
-            }
+            m_responseReady = true;
+            flushResponseBuffer();
             break;
 
         case PolicyAction::Ignore:
@@ -225,14 +247,19 @@ void NetworkDataTaskLcmd::createRequest(PurCFetcher::ResourceRequest&& request)
 void NetworkDataTaskLcmd::sendRequest()
 {
     runCmdInner();
-    buildResponse();
-    dispatchDidReceiveResponse();
+    if (m_pid > 0)
+        return;
+
+    // failed to run the command
+    m_outputClosed = true;
+    m_exited = true;
+    m_protectedThis = this;
+    finishIfDone();
 }
 
 void NetworkDataTaskLcmd::runCmdInner()
 {
     m_readBuffer.clear();
-	char data[DEFAULT_READBUFFER_SIZE] = {'0'};
 
     String cmdLine;
     if (m_currentRequest.url().hasQuery())
@@ -257,10 +284,10 @@ void NetworkDataTaskLcmd::runCmdInner()
 
 
     String path = m_currentRequest.url().path().toString().stripWhiteSpace();
-    const char* command;
+    CString command;
     if (cmdLine.isEmpty())
     {
-        command = (const char*)path.characters8();
+        command = path.utf8();
     }
     else
     {
@@ -287,40 +314,253 @@ void NetworkDataTaskLcmd::runCmdInner()
                 sb.append(cmdLine);
             }
         }
-        const CString& tmp = sb.toString().utf8();
-        command = (const char*)tmp.data();
+        command = sb.toString().utf8();
     }
 
-	FILE* fp = popen(command, "r");
-	if (fp == NULL)
-	{
+    m_filterIncrementally = m_filterManager->canFilterIncrementally();
+    if (!spawnCommand(command))
+        return;
+
+    m_statusCode = 200;
+    m_protectedThis = this;
+
+    m_outputMonitor.start(m_outputSocket.get(), static_cast<GIOCondition>(G_IO_IN | G_IO_HUP | G_IO_ERR), RunLoop::main(), [this] (GIOCondition condition) -> gboolean {
+        return readOutput(condition);
+    });
+
+    m_childWatch = adoptGRef(g_child_watch_source_new(m_pid));
+    g_source_set_callback(m_childWatch.get(), reinterpret_cast<GSourceFunc>(reinterpret_cast<GCallback>(+[](GPid, gint status, gpointer userData) {
+        static_cast<NetworkDataTaskLcmd*>(userData)->childExited(status);
+    })), this, nullptr);
+    g_source_attach(m_childWatch.get(), RunLoop::main().mainContext());
+
+    if (m_timeout > 0_s)
+        m_timeoutTimer.startOneShot(m_timeout);
+}
+
+// Runs the command line with the shell as popen() does, but with the
+// output read through a non-blocking socket monitored by the run loop.
+bool NetworkDataTaskLcmd::spawnCommand(const CString& command)
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0) {
         m_statusCode = 500;
         m_errorMsg = String(strerror(errno));
-        return;
-	}
-	while (fgets(data, sizeof(data), fp) != NULL)
-	{
-        m_readBuffer.append(data, strlen(data));
-        if (m_state == State::Canceling)
-        {
-            m_statusCode = 503;
-            m_errorMsg = String(strerror(errno));
-            return;
+        return false;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+
+    // in a process group of its own, so that it can be killed with
+    // the processes it starts.
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    const char* argv[] = { "sh", "-c", command.data(), nullptr };
+    int ret = posix_spawn(&m_pid, "/bin/sh", &actions, &attr, const_cast<char* const*>(argv), environ);
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    if (ret) {
+        close(fds[0]);
+        m_pid = -1;
+        m_statusCode = 500;
+        m_errorMsg = String(strerror(ret));
+        return false;
+    }
+
+    GUniqueOutPtr<GError> error;
+    m_outputSocket = adoptGRef(g_socket_new_from_fd(fds[0], &error.outPtr()));
+    if (!m_outputSocket) {
+        close(fds[0]);
+        kill(-m_pid, SIGKILL);
+        waitpid(m_pid, nullptr, 0);
+        m_pid = -1;
+        m_statusCode = 500;
+        m_errorMsg = String::fromUTF8(error->message);
+        return false;
+    }
+    g_socket_set_blocking(m_outputSocket.get(), FALSE);
+    return true;
+}
+
+gboolean NetworkDataTaskLcmd::readOutput(GIOCondition)
+{
+    char data[DEFAULT_READBUFFER_SIZE];
+    bool atEnd = false;
+
+    while (true) {
+        GUniqueOutPtr<GError> error;
+        gssize bytes = g_socket_receive(m_outputSocket.get(), data, sizeof(data), nullptr, &error.outPtr());
+        if (bytes < 0 && g_error_matches(error.get(), G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+            break;
+        if (bytes <= 0) {
+            atEnd = true;
+            break;
         }
-	}
 
-    m_readLines = String(m_readBuffer.data(),m_readBuffer.size()).split("\n");
+        m_outputSize += bytes;
+        if (m_outputLimit && m_outputSize > m_outputLimit) {
+            killCommand(413, "The output exceeds the limit");
+            atEnd = true;
+            break;
+        }
+        m_readBuffer.append(data, bytes);
+    }
 
-	int status = pclose(fp);
-    m_exitCode = WEXITSTATUS(status);
-    if (m_exitCode == 127)
-    {
+    splitLines(atEnd);
+    if (m_linesStarted)
+        flushResponseBuffer();
+
+    if (!atEnd)
+        return G_SOURCE_CONTINUE;
+
+    m_outputClosed = true;
+    // the monitor can not be stopped in its own callback
+    RunLoop::main().dispatch([this, protectedThis = makeRef(*this)] {
+        finishIfDone();
+    });
+    return G_SOURCE_REMOVE;
+}
+
+void NetworkDataTaskLcmd::childExited(int status)
+{
+    m_exited = true;
+    m_childWatch = nullptr;
+
+    if (WIFEXITED(status))
+        m_exitCode = WEXITSTATUS(status);
+    else
+        m_exitCode = 128 + WTERMSIG(status);
+    finishIfDone();
+}
+
+void NetworkDataTaskLcmd::timeoutFired()
+{
+    killCommand(504, "Timeout");
+}
+
+void NetworkDataTaskLcmd::killCommand(int statusCode, const String& errorMsg)
+{
+    if (m_killed || m_exited)
+        return;
+
+    kill(-m_pid, SIGKILL);
+    m_killed = true;
+    m_statusCode = statusCode;
+    m_errorMsg = errorMsg;
+}
+
+void NetworkDataTaskLcmd::finishIfDone()
+{
+    if (!m_outputClosed || !m_exited || !m_protectedThis)
+        return;
+
+    m_timeoutTimer.stop();
+    m_outputMonitor.stop();
+    m_outputSocket = nullptr;
+    m_pid = -1;
+
+    // released when returning
+    auto protectedThis = WTFMove(m_protectedThis);
+    if (m_state == State::Canceling || m_state == State::Completed)
+        return;
+
+    if (!m_killed && m_statusCode == 200 && m_exitCode == 127) {
         m_statusCode = 404;
         m_errorMsg = "Not Found";
     }
+
+    if (!m_filterIncrementally)
+        appendLines(WTFMove(m_readLines));
+
+    buildResponse();
+    m_finished = true;
+    flushResponseBuffer();
+}
+
+// Splits the complete lines out of the read buffer, and filters them if
+// the filters allow, so that they can be sent before the command exits.
+void NetworkDataTaskLcmd::splitLines(bool atEnd)
+{
+    Vector<String> lines;
+    size_t start = 0;
+    size_t size = m_readBuffer.size();
+    for (size_t i = 0; i <= size; i++) {
+        if (i < size && m_readBuffer[i] != '\n')
+            continue;
+        if (i == size && !atEnd)
+            break;
+
+        // the empty lines are skipped as String::split() does
+        if (i > start) {
+            const char* line = m_readBuffer.data() + start;
+            String string = String::fromUTF8(line, i - start);
+            if (string.isNull())
+                string = String(line, i - start);
+            lines.append(WTFMove(string));
+        }
+        start = i + 1;
+    }
+
+    if (start >= size)
+        m_readBuffer.clear();
+    else if (start)
+        m_readBuffer.remove(0, start);
+
+    if (lines.isEmpty())
+        return;
+
+    if (m_filterIncrementally)
+        appendLines(WTFMove(lines));
     else
-    {
-        m_statusCode = 200;
+        m_readLines.appendVector(lines);
+}
+
+void NetworkDataTaskLcmd::appendLines(Vector<String>&& lines)
+{
+    if (lines.isEmpty())
+        return;
+
+    Vector<Ref<JSON::Value>> values = m_filterManager->doFilter(WTFMove(lines));
+    for (auto& value : values) {
+        appendString(m_linesStarted ? "," : "{\"lines\":[");
+        m_linesStarted = true;
+        appendString(value->toJSONString());
+    }
+}
+
+void NetworkDataTaskLcmd::appendString(const String& string)
+{
+    CString utf8 = string.utf8();
+    m_responseBuffer.append(utf8.data(), utf8.length());
+}
+
+void NetworkDataTaskLcmd::flushResponseBuffer()
+{
+    if (!m_responseSent) {
+        m_responseSent = true;
+        dispatchDidReceiveResponse();
+        return;
+    }
+
+    if (!m_responseReady)
+        return;
+
+    if (!m_responseBuffer.isEmpty()) {
+        m_client->didReceiveData(SharedBuffer::create(WTFMove(m_responseBuffer)));
+        m_responseBuffer.clear();
+    }
+
+    if (m_finished) {
+        m_responseReady = false;
+        dispatchDidCompleteWithError({ });
     }
 }
 
@@ -328,9 +568,10 @@ void NetworkDataTaskLcmd::runCmdOuter()
 {
 }
 
+// Ends the array of the lines sent and puts the other members after it:
+// {"lines":[...],"statusCode":200,"errorMsg":null,"exitCode":0}
 void NetworkDataTaskLcmd::buildResponse()
 {
-    m_responseBuffer.clear();
     auto result = JSON::Object::create();
     result->setInteger(KEY_STATUS_CODE, m_statusCode);
     if (m_errorMsg.isEmpty())
@@ -342,25 +583,12 @@ void NetworkDataTaskLcmd::buildResponse()
     else
         result->setValue(KEY_EXIT_CODE, JSON::Value::null());
 
-    if (m_readLines.size())
-    {
-        auto array = JSON::Array::create();
-        Vector<Ref<JSON::Value>>  lines = m_filterManager->doFilter(m_readLines);
-        int lineSize = lines.size();
-        for (int i = 0; i < lineSize; i++)
-        {
-            array->pushValue(WTFMove(lines[i]));
-        }
-        result->setArray(KEY_LINES, WTFMove(array));
-    }
-    else
-    {
-        auto array = JSON::Array::create();
-        result->setArray(KEY_LINES, WTFMove(array));
+    if (!m_linesStarted) {
+        appendString("{\"lines\":[");
+        m_linesStarted = true;
     }
-
-    String json = result->toJSONString();
-    m_responseBuffer.append(json.characters8(), json.length());
+    appendString("],");
+    appendString(result->toJSONString().substring(1));
 }
 
 void NetworkDataTaskLcmd::parseQueryString(String query)
@@ -388,6 +616,20 @@ void NetworkDataTaskLcmd::parseQueryString(String query)
         {
             m_cmdLine = value;
         }
+        else if (equalIgnoringASCIICase(name, CMD_OUTPUT_LIMIT))
+        {
+            bool ok = false;
+            uint64_t limit = value.toUInt64(&ok);
+            if (ok)
+                m_outputLimit = limit;
+        }
+        else if (equalIgnoringASCIICase(name, CMD_TIMEOUT))
+        {
+            bool ok = false;
+            double timeout = value.toDouble(&ok);
+            if (ok && timeout > 0)
+                m_timeout = Seconds(timeout);
+        }
         else
         {
             m_paramMap.set(name, value);
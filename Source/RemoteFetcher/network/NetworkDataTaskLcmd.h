@@ -56,6 +56,7 @@
 #include "ResourceResponse.h"
 #include <wtf/RunLoop.h>
 #include <wtf/glib/GRefPtr.h>
+#include <wtf/glib/GSocketMonitor.h>
 #include "CmdFilterManager.h"
 
 namespace PurCFetcher {
@@ -89,6 +90,17 @@ private:
     void runCmdOuter();
     void buildResponse();
 
+    bool spawnCommand(const CString& command);
+    gboolean readOutput(GIOCondition);
+    void childExited(int status);
+    void timeoutFired();
+    void killCommand(int statusCode, const String& errorMsg);
+    void finishIfDone();
+    void splitLines(bool atEnd);
+    void appendLines(Vector<String>&& lines);
+    void appendString(const String&);
+    void flushResponseBuffer();
+
     void parseQueryString(String query);
     void parseCmdFilter(String cmdFilter);
     String parseCmdLine(String cmdLine);
@@ -105,7 +117,7 @@ private:
 
     String m_errorMsg;
     int m_statusCode;
-    int m_exitCode;
+    int m_exitCode { 0 };
 
     RefPtr<CmdFilterManager> m_filterManager;
 
@@ -113,6 +125,27 @@ private:
 
     String m_cmdFilter;
     String m_cmdLine;
+
+    // the command running in its own process group
+    pid_t m_pid { -1 };
+    GRefPtr<GSocket> m_outputSocket;
+    GSocketMonitor m_outputMonitor;
+    GRefPtr<GSource> m_childWatch;
+    RunLoop::Timer<NetworkDataTaskLcmd> m_timeoutTimer;
+    RefPtr<NetworkDataTaskLcmd> m_protectedThis;
+
+    size_t m_outputSize { 0 };
+    size_t m_outputLimit;
+    Seconds m_timeout;
+
+    bool m_outputClosed { false };
+    bool m_exited { false };
+    bool m_killed { false };
+    bool m_filterIncrementally { true };
+    bool m_linesStarted { false };
+    bool m_finished { false };
+    bool m_responseSent { false };
+    bool m_responseReady { false };
 };
 
 } // namespace PurCFetcher
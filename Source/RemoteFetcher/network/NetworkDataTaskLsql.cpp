@@ -93,15 +93,14 @@ const char* CMD_SQL_ROWFORMAT = "sqlRowFormat";
 
 const char* FORMAT_DICT = "dict";
 const char* FORMAT_ARRAY = "array";
+const char* FORMAT_NDJSON = "ndjson";
 
 const char* SELECT = "select";
-const char* INSERT = "insert";
-const char* UPDATE = "update";
-const char* DELETE = "delete";
 
 NetworkDataTaskLsql::NetworkDataTaskLsql(NetworkSession& session, NetworkDataTaskClient& client, const ResourceRequest& requestWithCredentials, StoredCredentialsPolicy storedCredentialsPolicy, ContentSniffingPolicy shouldContentSniff, PurCFetcher::ContentEncodingSniffingPolicy, bool shouldClearReferrerOnHTTPSToHTTPRedirect, bool dataTaskIsForMainFrameNavigation)
     : NetworkDataTask(session, client, requestWithCredentials, storedCredentialsPolicy, shouldClearReferrerOnHTTPSToHTTPRedirect, dataTaskIsForMainFrameNavigation)
     , m_formatArray(false)
+    , m_formatNdjson(false)
 {
     UNUSED_PARAM(shouldContentSniff);
     m_session->registerNetworkDataTask(*this);
@@ -114,6 +113,8 @@ NetworkDataTaskLsql::NetworkDataTaskLsql(NetworkSession& session, NetworkDataTas
 
 NetworkDataTaskLsql::~NetworkDataTaskLsql()
 {
+    if (m_database)
+        m_database->giveBackStatement(WTFMove(m_statement));
     m_session->unregisterNetworkDataTask(*this);
 }
 
@@ -170,20 +171,17 @@ void NetworkDataTaskLsql::dispatchDidCompleteWithError(const ResourceError& erro
     m_networkLoadMetrics.markComplete();
 
     m_client->didCompleteWithError(error, m_networkLoadMetrics);
-    if (m_database.isOpen())
-        m_database.close();
 }
 
 void NetworkDataTaskLsql::dispatchDidReceiveResponse()
 {
-    if (m_database.isOpen())
-        m_database.close();
     m_networkLoadMetrics.responseStart = MonotonicTime::now() - m_startTime;
     m_response.setURL(m_currentRequest.url());
-    const char* contentType = "application/json";
+    const char* contentType = m_formatNdjson ? "application/x-ndjson" : "application/json";
     m_response.setMimeType(extractMIMETypeFromMediaType(contentType));
     m_response.setTextEncodingName(extractCharsetFromMediaType(contentType));
-    m_response.setExpectedContentLength(m_responseBuffer.size());
+    // The length is unknown: the rows are sent while being read.
+    m_response.setExpectedContentLength(-1);
     m_response.setHTTPHeaderField(HTTPHeaderName::AccessControlAllowOrigin, "*");
     m_response.setHTTPHeaderField(HTTPHeaderName::Expires, "-1");
     m_response.setHTTPHeaderField(HTTPHeaderName::CacheControl, "no-cache");
@@ -199,10 +197,7 @@ void NetworkDataTaskLsql::dispatchDidReceiveResponse()
 
         switch (policyAction) {
         case PolicyAction::Use:
-            {
-                m_client->didReceiveData(SharedBuffer::create(WTFMove(m_responseBuffer)));
-                dispatchDidCompleteWithError({ });
-            }
+            startStreaming();
             break;
 
         case PolicyAction::Ignore:
@@ -222,7 +217,6 @@ void NetworkDataTaskLsql::createRequest(PurCFetcher::ResourceRequest&& request)
 void NetworkDataTaskLsql::sendRequest()
 {
     runCmdInner();
-    buildResponse();
     dispatchDidReceiveResponse();
 }
 
@@ -255,7 +249,8 @@ void NetworkDataTaskLsql::runCmdInner()
         return;
     }
 
-    if (!m_database.open(path)) {
+    m_database = LsqlDatabase::open(path);
+    if (!m_database) {
 #if 0
         printf("Failed to open databasePath %s.", path.utf8().data());
 #endif
@@ -264,249 +259,248 @@ void NetworkDataTaskLsql::runCmdInner()
         m_errorMsg = "Failed to open database " + path + ".";
         return;
     }
-    m_database.disableThreadingChecks();
 
     m_statusCode = 200;
-#if 1
-    int size = m_sqlVec.size();
-    for (int i = 0; i < size; i++)
-    {
-        String& sql = m_sqlVec[i];
-        if (sql.startsWithIgnoringASCIICase(SELECT))
-        {
-            runSqlSelect(sql);
-        }
-        else if (sql.startsWithIgnoringASCIICase(INSERT))
-        {
-            runSqlInsert(sql);
-        }
-        else if (sql.startsWithIgnoringASCIICase(UPDATE))
-        {
-            runSqlUpdate(sql);
-        }
-        else if (sql.startsWithIgnoringASCIICase(DELETE))
-        {
-            runSqlDelete(sql);
-        }
+
+    // Drop the empty statements, so that the layout of the result is known
+    // before the first row is sent. The statements other than SELECT,
+    // e.g., CREATE TABLE, are run as commands.
+    Vector<String> sqlVec;
+    for (auto& sql : m_sqlVec) {
+        if (!sql.isEmpty())
+            sqlVec.append(sql);
     }
-#endif
+    m_sqlVec = WTFMove(sqlVec);
+}
 
+/*
+ * The result is streamed in chunks of rowsPerChunk rows, one chunk in a turn
+ * of the run loop. The JSON layout is the same as before, except that
+ * the rows come before the other members of a result:
+ *
+ *  - one statement: {"rows":[...],"statusCode":200,"errorMsg":null,"rowsAffected":1}
+ *  - more statements: {"statusCode":200,"result":[{"rows":[...],"errorMsg":null,...},...]}
+ *
+ * With `sqlRowFormat=ndjson`, a line is sent for every row, and a line of
+ * {"statusCode":200,"errorMsg":null,"rowsAffected":1} ends every statement.
+ */
+static const unsigned rowsPerChunk = 256;
+
+void NetworkDataTaskLsql::startStreaming()
+{
+    if (!m_database || m_sqlVec.isEmpty()) {
+        buildResponse();
+        flushResponseBuffer();
+        dispatchDidCompleteWithError({ });
+        return;
+    }
+
+    if (!m_formatNdjson && m_sqlVec.size() > 1)
+        appendString("{\"statusCode\":200,\"result\":[");
+    runNextChunk();
 }
 
-void NetworkDataTaskLsql::runSqlSelect(String sql)
+void NetworkDataTaskLsql::runNextChunk()
 {
-    if (sql.isEmpty())
+    if (m_state == State::Canceling || m_state == State::Completed) {
+        m_database->giveBackStatement(WTFMove(m_statement));
         return;
+    }
 
-    SqlResult sr;
-    SQLiteStatement statement(m_database, sql);
-    if (statement.prepare() != SQLITE_OK) {
-        sr.statusCode = 500;
-        sr.errorMsg = "Failed to prepare : " + sql;
-#if 0
-        printf("Failed to prepare statement.\n");
-#endif
-        m_sqlResults.append(sr);
+    if (!m_statement)
+        beginStatement();
+
+    if (m_statement) {
+        if (m_isSelect)
+            stepSelect();
+        else
+            stepCommand();
+    }
+
+    if (m_sqlIndex < m_sqlVec.size()) {
+        flushResponseBuffer();
+        RunLoop::current().dispatch([this, protectedThis = makeRef(*this)] {
+            runNextChunk();
+        });
         return;
     }
 
-    sr.statusCode = 200;
+    if (!m_formatNdjson && m_sqlVec.size() > 1)
+        appendString("]}");
+    flushResponseBuffer();
+    dispatchDidCompleteWithError({ });
+}
 
-    int result;
-    while ((result = statement.step()) == SQLITE_ROW) {
-        int columnCount = statement.columnCount();
-        Vector<SQLValueH> columns;
-        for (int i = 0; i < columnCount; i++)
-        {
-            if ((int)m_sqlResultColumnNames.size() <= i)
-            {
-                String key = statement.getColumnName(i);
-                m_sqlResultColumnNames.append(key);
-            }
+void NetworkDataTaskLsql::beginStatement()
+{
+    const String& sql = m_sqlVec[m_sqlIndex];
 
-            columns.append(statement.getColumnValueH(i));
-        }
-        sr.rowsVec.append(columns);
+    m_isSelect = sql.startsWithIgnoringASCIICase(SELECT);
+    m_rowsAffected = 0;
+    m_sqlResultColumnNames.clear();
 
-        if (m_state == State::Canceling)
-        {
-            sr.statusCode = 503;
-            sr.errorMsg = "Canceling";
-            m_sqlResults.append(sr);
-            return;
-        }
+    if (!m_formatNdjson) {
+        if (m_sqlIndex > 0)
+            appendString(",");
+        appendString("{\"rows\":[");
     }
-    sr.rowsAffected = sr.rowsVec.size();
 
-    if (result != SQLITE_DONE)
-    {
-        sr.statusCode = 503;
-        sr.errorMsg = "Failed to read in all origins from the database.";
-#if 0
-        printf("Failed to read in all origins from the database.\n");
-#endif
-    }
-    m_sqlResults.append(sr);
+    m_statement = m_database->takeStatement(sql);
+    if (!m_statement || !bindParameters(*m_statement))
+        finishStatement(500, "Failed to prepare : " + sql + ": " + lastError());
 }
 
-void NetworkDataTaskLsql::runSqlInsert(String sql)
+String NetworkDataTaskLsql::lastError()
 {
-    if (sql.isEmpty())
-        return;
+    return String::fromUTF8(m_database->database().lastErrorMsg());
+}
 
-    SqlResult sr;
-    SQLiteStatement statement(m_database, sql);
-    if (statement.prepare() != SQLITE_OK
-            || statement.step() != SQLITE_DONE) {
-        sr.statusCode = 500;
-        sr.errorMsg = "Failed to prepare : " + sql;
-#if 0
-        printf("Failed to prepare statement.\n");
-#endif
-        m_sqlResults.append(sr);
-        return;
-    }
+// The named parameters of SQLite (:name or @name) are bound to the values
+// of the query parameters; unlike the $name ones substituted by
+// parseSqlQuery(), they keep the SQL unchanged and the statement cached.
+bool NetworkDataTaskLsql::bindParameters(SQLiteStatement& statement)
+{
+    unsigned count = statement.bindParameterCount();
+    for (unsigned i = 1; i <= count; i++) {
+        String name = statement.bindParameterName(i);
+        if (name.length() < 2 || (name[0] != ':' && name[0] != '@'))
+            continue;
 
-    sr.statusCode = 200;
-    sr.rowsAffected = m_database.lastChanges();
-    m_sqlResults.append(sr);
+        auto findResult = m_paramMap.find(name.substring(1));
+        if (findResult == m_paramMap.end())
+            continue;
+
+        if (statement.bindText(i, findResult->value) != SQLITE_OK)
+            return false;
+    }
+    return true;
 }
 
-void NetworkDataTaskLsql::runSqlUpdate(String sql)
+void NetworkDataTaskLsql::stepSelect()
 {
-    if (sql.isEmpty())
-        return;
+    int result;
+    unsigned rows = 0;
+    while ((result = m_statement->step()) == SQLITE_ROW) {
+        appendRow();
+        if (++rows == rowsPerChunk)
+            return;
+    }
 
-    SqlResult sr;
-    SQLiteStatement statement(m_database, sql);
-    if (statement.prepare() != SQLITE_OK
-            || statement.step() != SQLITE_DONE) {
-        sr.statusCode = 500;
-        sr.errorMsg = "Failed to prepare : " + sql;
-#if 0
-        printf("Failed to prepare statement.\n");
-#endif
-        m_sqlResults.append(sr);
+    if (result != SQLITE_DONE) {
+        finishStatement(503, "Failed to execute : " + m_sqlVec[m_sqlIndex]
+                + ": " + lastError());
         return;
     }
-
-    sr.statusCode = 200;
-    sr.rowsAffected = m_database.lastChanges();
-    m_sqlResults.append(sr);
+    finishStatement(200, String());
 }
 
-void NetworkDataTaskLsql::runSqlDelete(String sql)
+// A command returning rows, e.g., a PRAGMA, runs to the end, and the rows
+// are ignored.
+void NetworkDataTaskLsql::stepCommand()
 {
-    if (sql.isEmpty())
-        return;
+    int result;
+    while ((result = m_statement->step()) == SQLITE_ROW) { }
 
-    SqlResult sr;
-    SQLiteStatement statement(m_database, sql);
-    if (statement.prepare() != SQLITE_OK
-            || statement.step() != SQLITE_DONE) {
-        sr.statusCode = 500;
-        sr.errorMsg = "Failed to prepare : " + sql;
-#if 0
-        printf("Failed to prepare statement.\n");
-#endif
-        m_sqlResults.append(sr);
+    if (result != SQLITE_DONE) {
+        finishStatement(500, "Failed to execute : " + m_sqlVec[m_sqlIndex]
+                + ": " + lastError());
         return;
     }
 
-    sr.statusCode = 200;
-    sr.rowsAffected = m_database.lastChanges();
-    m_sqlResults.append(sr);
+    m_rowsAffected = m_database->database().lastChanges();
+    finishStatement(200, String());
 }
 
-void NetworkDataTaskLsql::buildResponse()
+void NetworkDataTaskLsql::finishStatement(int statusCode, const String& errorMsg)
 {
-    auto result = JSON::Object::create();
+    m_database->giveBackStatement(WTFMove(m_statement));
 
-    int resultSize = m_sqlResults.size();
-    switch (resultSize)
-    {
-    case 0:
-        {
-            result->setInteger(KEY_STATUS_CODE, m_statusCode);
+    auto result = JSON::Object::create();
+    if (m_formatNdjson || m_sqlVec.size() == 1)
+        result->setInteger(KEY_STATUS_CODE, statusCode);
+    if (errorMsg.isEmpty())
+        result->setValue(KEY_ERROR_MSG, JSON::Value::null());
+    else
+        result->setString(KEY_ERROR_MSG, errorMsg);
+    result->setInteger(KEY_ROWSAFFECTED, m_rowsAffected);
 
-            if (m_errorMsg.isEmpty())
-                result->setValue(KEY_ERROR_MSG, JSON::Value::null());
-            else
-                result->setString(KEY_ERROR_MSG, m_errorMsg);
+    String json = result->toJSONString();
+    if (m_formatNdjson) {
+        appendString(json);
+        appendString("\n");
+    }
+    else {
+        // close the rows and put the other members after them
+        appendString("],");
+        appendString(json.substring(1));
+    }
 
-            result->setInteger(KEY_ROWSAFFECTED, m_readLines.size());
-            auto array = JSON::Array::create();
-            result->setArray(KEY_ROWS, WTFMove(array));
-        }
-        break;
+    m_sqlIndex++;
+}
 
-    case 1:
+void NetworkDataTaskLsql::appendRow()
+{
+    int columnCount = m_statement->columnCount();
+    Vector<SQLValueH> columns;
+    for (int i = 0; i < columnCount; i++)
+    {
+        if ((int)m_sqlResultColumnNames.size() <= i)
         {
-            SqlResult& sqlResult = m_sqlResults[0];
-            result->setInteger(KEY_STATUS_CODE, sqlResult.statusCode);
-            if (sqlResult.errorMsg.isEmpty())
-                result->setValue(KEY_ERROR_MSG, JSON::Value::null());
-            else
-                result->setString(KEY_ERROR_MSG, sqlResult.errorMsg);
-            result->setInteger(KEY_ROWSAFFECTED, sqlResult.rowsAffected);
-
-            int rowSize = sqlResult.rowsVec.size();
-            auto array = JSON::Array::create();
-            for (int i = 0; i < rowSize; i++)
-            {
-                if (m_formatArray)
-                {
-                    array->pushValue(formatAsArray(sqlResult.rowsVec[i]));
-                }
-                else
-                {
-                    array->pushValue(formatAsDict(sqlResult.rowsVec[i]));
-                }
-            }
-            result->setArray(KEY_ROWS, WTFMove(array));
+            String key = m_statement->getColumnName(i);
+            m_sqlResultColumnNames.append(key);
         }
-        break;
 
-    default:
-        {
-            result->setInteger(KEY_STATUS_CODE, 200);
-            auto resultArray = JSON::Array::create();
-            for (int j = 0; j < resultSize; j++)
-            {
-                SqlResult& sqlResult = m_sqlResults[j];
-                auto res = JSON::Object::create();
+        columns.append(m_statement->getColumnValueH(i));
+    }
 
-                if (sqlResult.errorMsg.isEmpty())
-                    res->setValue(KEY_ERROR_MSG, JSON::Value::null());
-                else
-                    res->setString(KEY_ERROR_MSG, sqlResult.errorMsg);
-                res->setInteger(KEY_ROWSAFFECTED, sqlResult.rowsAffected);
+    if (!m_formatNdjson && m_rowsAffected > 0)
+        appendString(",");
+    if (m_formatArray)
+        appendString(formatAsArray(columns)->toJSONString());
+    else
+        appendString(formatAsDict(columns)->toJSONString());
+    if (m_formatNdjson)
+        appendString("\n");
 
-                int rowSize = sqlResult.rowsVec.size();
-                auto array = JSON::Array::create();
-                for (int i = 0; i < rowSize; i++)
-                {
-                    if (m_formatArray)
-                    {
-                        array->pushValue(formatAsArray(sqlResult.rowsVec[i]));
-                    }
-                    else
-                    {
-                        array->pushValue(formatAsDict(sqlResult.rowsVec[i]));
-                    }
-                }
-                res->setArray(KEY_ROWS, WTFMove(array));
-                resultArray->pushObject(WTFMove(res));
-            }
-            result->setArray(KEY_RESULT, WTFMove(resultArray));
-        }
-        break;
-    }
+    m_rowsAffected++;
+}
 
-    String json = result->toJSONString();
+void NetworkDataTaskLsql::appendString(const String& string)
+{
+    CString utf8 = string.utf8();
+    m_responseBuffer.append(utf8.data(), utf8.length());
+}
 
+void NetworkDataTaskLsql::flushResponseBuffer()
+{
+    if (m_responseBuffer.isEmpty())
+        return;
+
+    m_client->didReceiveData(SharedBuffer::create(WTFMove(m_responseBuffer)));
     m_responseBuffer.clear();
-    m_responseBuffer.append(json.characters8(), json.length());
+}
+
+// the result when there is no statement to run
+void NetworkDataTaskLsql::buildResponse()
+{
+    auto result = JSON::Object::create();
+
+    result->setInteger(KEY_STATUS_CODE, m_statusCode);
+
+    if (m_errorMsg.isEmpty())
+        result->setValue(KEY_ERROR_MSG, JSON::Value::null());
+    else
+        result->setString(KEY_ERROR_MSG, m_errorMsg);
+
+    result->setInteger(KEY_ROWSAFFECTED, m_readLines.size());
+    if (!m_formatNdjson) {
+        auto array = JSON::Array::create();
+        result->setArray(KEY_ROWS, WTFMove(array));
+    }
+
+    appendString(result->toJSONString());
+    if (m_formatNdjson)
+        appendString("\n");
 }
 
 Ref<JSON::Value> NetworkDataTaskLsql::formatAsArray(Vector<SQLValueH>& lineColumns)
@@ -590,6 +584,7 @@ void NetworkDataTaskLsql::parseQueryString(String query)
         else if (equalIgnoringASCIICase(name, CMD_SQL_ROWFORMAT))
         {
             m_formatArray = equalIgnoringASCIICase(value, FORMAT_ARRAY);
+            m_formatNdjson = equalIgnoringASCIICase(value, FORMAT_NDJSON);
         }
         else
         {
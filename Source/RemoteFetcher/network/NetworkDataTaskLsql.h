@@ -54,6 +54,7 @@
 #include "NetworkLoadMetrics.h"
 #include "ProtectionSpace.h"
 #include "ResourceResponse.h"
+#include "LsqlDatabase.h"
 #include "SQLiteDatabase.h"
 #include "SQLiteFileSystem.h"
 #include "SQLValue.h"
@@ -99,10 +100,17 @@ private:
 
     void runCmdInner();
 
-    void runSqlSelect(String sql);
-    void runSqlInsert(String sql);
-    void runSqlUpdate(String sql);
-    void runSqlDelete(String sql);
+    void startStreaming();
+    void runNextChunk();
+    void beginStatement();
+    void stepSelect();
+    void stepCommand();
+    void finishStatement(int statusCode, const String& errorMsg);
+    String lastError();
+    bool bindParameters(SQLiteStatement&);
+    void appendRow();
+    void appendString(const String&);
+    void flushResponseBuffer();
 
     void buildResponse();
 
@@ -128,13 +136,19 @@ private:
 
     HashMap<String, String> m_paramMap;
 
-    PurCFetcher::SQLiteDatabase m_database;
+    RefPtr<LsqlDatabase> m_database;
     Vector<String> m_sqlVec;
     Vector<String> m_sqlResultColumnNames;
-    Vector<SqlResult> m_sqlResults;
 
     bool m_formatArray;
+    bool m_formatNdjson;
     String m_sqlQuery;
+
+    // the state of the statement being streamed
+    size_t m_sqlIndex { 0 };
+    bool m_isSelect { false };
+    std::unique_ptr<SQLiteStatement> m_statement;
+    int m_rowsAffected { 0 };
 };
 
 } // namespace PurCFetcher
@@ -59,6 +59,7 @@
 #include "SameSiteInfo.h"
 #include "SecurityOrigin.h"
 #include "SharedBuffer.h"
+#include "SharedMemory.h"
 #include <wtf/Expected.h>
 #include <wtf/RunLoop.h>
 
@@ -1129,12 +1130,31 @@ void NetworkResourceLoader::bufferingTimerFired()
     if (m_bufferedData->isEmpty())
         return;
 
-    send(Messages::WebResourceLoader::DidReceiveSharedBuffer({ *m_bufferedData }, m_bufferedDataEncodedDataLength));
+    sendSharedBuffer(*m_bufferedData, m_bufferedDataEncodedDataLength);
 
     m_bufferedData = SharedBuffer::create();
     m_bufferedDataEncodedDataLength = 0;
 }
 
+// Keep in sync with PCFETCHER_SHARED_MEMORY_THRESHOLD of PurC.
+static const size_t sharedMemoryTransferThreshold = 64 * 1024;
+
+void NetworkResourceLoader::sendSharedBuffer(SharedBuffer& buffer, size_t encodedDataLength)
+{
+    // A large body is copied once into a shared memory and only the handle
+    // goes through the socket; the client maps it read-only.
+    if (buffer.size() >= sharedMemoryTransferThreshold) {
+        auto sharedMemory = SharedMemory::copyBuffer(buffer);
+        SharedMemory::Handle handle;
+        if (sharedMemory && sharedMemory->createHandle(handle, SharedMemory::Protection::ReadOnly)) {
+            send(Messages::WebResourceLoader::DidReceiveSharedMemory(handle, buffer.size(), encodedDataLength));
+            return;
+        }
+    }
+
+    send(Messages::WebResourceLoader::DidReceiveSharedBuffer({ buffer }, encodedDataLength));
+}
+
 void NetworkResourceLoader::sendBuffer(SharedBuffer& buffer, size_t encodedDataLength)
 {
     ASSERT(!isSynchronous());
@@ -1144,7 +1164,7 @@ void NetworkResourceLoader::sendBuffer(SharedBuffer& buffer, size_t encodedDataL
 #endif
 
     if(!m_parameters.request.getJsonType())
-        send(Messages::WebResourceLoader::DidReceiveSharedBuffer({ buffer }, encodedDataLength));
+        sendSharedBuffer(buffer, encodedDataLength);
     else
     {
         if(m_httpresponsecode == 200)
@@ -183,6 +183,7 @@ private:
     void startBufferingTimerIfNeeded();
     void bufferingTimerFired();
     void sendBuffer(PurCFetcher::SharedBuffer&, size_t encodedDataLength);
+    void sendSharedBuffer(PurCFetcher::SharedBuffer&, size_t encodedDataLength);
 
     void consumeSandboxExtensions();
     void invalidateSandboxExtensions();
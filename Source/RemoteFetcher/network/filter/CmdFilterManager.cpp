@@ -100,8 +100,10 @@ bool CmdFilterManager::addFilter(String name, String param)
     RefPtr<FilterBase> filter = findResult->value;
     switch(filter->type())
     {
-        case FilterTypeLineSplit:
         case FilterTypeLineCut:
+            m_hasLineCutFilter = true;
+            FALLTHROUGH;
+        case FilterTypeLineSplit:
         case FilterTypeColumnSplit:
         case FilterTypeColumnCut:
             m_filterNameVec.append(nameLowerCase);
@@ -151,7 +153,9 @@ Vector<Ref<JSON::Value>> CmdFilterManager::doFilter(Vector<String> lines)
 
 Vector<Vector<String>> CmdFilterManager::doFilterInner(Vector<Vector<String>>& lineListVec, String filterName, String filterParam)
 {
+#if 0
     printf(".....................................doFilterInner|name=%s|param=%s|\n", filterName.characters8(), filterParam.characters8());
+#endif
     auto findResult  = m_nameFilterMap.find(filterName);
     if(findResult == m_nameFilterMap.end())
         return lineListVec;
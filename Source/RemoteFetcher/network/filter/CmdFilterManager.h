@@ -63,6 +63,10 @@ public:
     bool addFilter(String name, String param);
     Vector<Ref<JSON::Value>> doFilter(Vector<String> lines);
 
+    // Whether the lines can be filtered in batches as they come: false if
+    // a filter picks the lines by their positions in the whole output.
+    bool canFilterIncrementally() const { return !m_hasLineCutFilter; }
+
 private:
     void initFilterVec();
     void initNameFilterMap();
@@ -79,6 +83,8 @@ private:
 
     Vector<String> m_filterNameVec;
     Vector<String> m_filterParamVec;
+
+    bool m_hasLineCutFilter { false };
 };
 
 } // namespace PurCFetcher
@@ -0,0 +1,458 @@
+/*
+ * @file bench.c
+ * @date 2026/10/19
+ * @brief The implementation of the tiny harness used by the benchmarks.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include "purc/purc-version.h"
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/utsname.h>
+
+#ifndef PCBENCH_BUILD_TYPE
+#define PCBENCH_BUILD_TYPE      "unknown"
+#endif
+
+#define DEF_MIN_TIME            0.2
+#define DEF_REPETITIONS         5
+#define MAX_REPETITIONS         100
+#define MAX_COUNTERS            8
+#define MAX_ITERATIONS          ((size_t)1 << 40)
+
+struct bench_counter {
+    char   *key;
+    double  value;
+};
+
+struct bench_result {
+    char       *name;
+    const char *skipped;
+
+    size_t      iterations;
+    size_t      bytes_per_op;
+
+    /* nanoseconds per operation */
+    double      median;
+    double      mean;
+    double      min;
+    double      max;
+    double      stddev;
+
+    struct bench_counter counters[MAX_COUNTERS];
+    size_t      nr_counters;
+};
+
+static struct {
+    const char *suite;
+    const char *filter;
+    const char *output;
+    double      min_time;
+    unsigned    repetitions;
+    unsigned    seed;
+    bool        list;
+    bool        quiet;
+
+    struct bench_result *results;
+    size_t      nr_results;
+    size_t      sz_results;
+
+    /* the index of the last result plus 1; 0 if it was not selected */
+    size_t      last;
+} bench = {
+    .min_time = DEF_MIN_TIME,
+    .repetitions = DEF_REPETITIONS,
+    .seed = 1,
+};
+
+static void
+usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -f, --filter=<substr>   only run the benchmarks matching it\n"
+            "  -t, --min-time=<secs>   minimal time of one repetition (%.1f)\n"
+            "  -r, --repetitions=<n>   number of repetitions (%d)\n"
+            "  -s, --seed=<n>          seed of the pseudo random numbers (1)\n"
+            "  -o, --output=<file>     write the JSON report to the file\n"
+            "  -l, --list              list the benchmarks only\n"
+            "  -q, --quiet             do not print the summary\n"
+            "  -h, --help              show this help\n",
+            prog, DEF_MIN_TIME, DEF_REPETITIONS);
+}
+
+bool pcbench_init(int argc, char **argv, const char *suite)
+{
+    static const struct option long_opts[] = {
+        { "filter",      required_argument, NULL, 'f' },
+        { "min-time",    required_argument, NULL, 't' },
+        { "repetitions", required_argument, NULL, 'r' },
+        { "seed",        required_argument, NULL, 's' },
+        { "output",      required_argument, NULL, 'o' },
+        { "list",        no_argument,       NULL, 'l' },
+        { "quiet",       no_argument,       NULL, 'q' },
+        { "help",        no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    bench.suite = suite;
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "f:t:r:s:o:lqh",
+                    long_opts, NULL)) != -1) {
+        switch (opt) {
+        case 'f':
+            bench.filter = optarg;
+            break;
+        case 't':
+            bench.min_time = atof(optarg);
+            if (bench.min_time <= 0)
+                bench.min_time = DEF_MIN_TIME;
+            break;
+        case 'r':
+            bench.repetitions = (unsigned)atoi(optarg);
+            if (bench.repetitions == 0)
+                bench.repetitions = 1;
+            else if (bench.repetitions > MAX_REPETITIONS)
+                bench.repetitions = MAX_REPETITIONS;
+            break;
+        case 's':
+            bench.seed = (unsigned)strtoul(optarg, NULL, 0);
+            break;
+        case 'o':
+            bench.output = optarg;
+            break;
+        case 'l':
+            bench.list = true;
+            break;
+        case 'q':
+            bench.quiet = true;
+            break;
+        default:
+            usage(argv[0]);
+            return false;
+        }
+    }
+
+    srandom(bench.seed);
+    return true;
+}
+
+unsigned int pcbench_seed(void)
+{
+    return bench.seed;
+}
+
+bool pcbench_selected(const char *name)
+{
+    bench.last = 0;
+    if (bench.filter && strstr(name, bench.filter) == NULL)
+        return false;
+
+    if (bench.list) {
+        printf("%s/%s\n", bench.suite, name);
+        return false;
+    }
+
+    return true;
+}
+
+void pcbench_use(const void *ptr)
+{
+    __asm__ __volatile__("" : : "g"(ptr) : "memory");
+}
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static struct bench_result *
+new_result(const char *name)
+{
+    if (bench.nr_results == bench.sz_results) {
+        size_t sz = bench.sz_results ? bench.sz_results * 2 : 32;
+        struct bench_result *results = realloc(bench.results,
+                sizeof(*results) * sz);
+        if (results == NULL)
+            return NULL;
+        bench.results = results;
+        bench.sz_results = sz;
+    }
+
+    struct bench_result *result = bench.results + bench.nr_results++;
+    memset(result, 0, sizeof(*result));
+    bench.last = bench.nr_results;
+    result->name = strdup(name);
+    return result;
+}
+
+static int
+cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void
+measure(struct bench_result *result, pcbench_fn fn, void *ctxt,
+        size_t nr_iters)
+{
+    double samples[MAX_REPETITIONS];
+    double sum = 0;
+
+    for (unsigned i = 0; i < bench.repetitions; i++) {
+        double start = now_ns();
+        fn(ctxt, nr_iters);
+        samples[i] = (now_ns() - start) / nr_iters;
+        sum += samples[i];
+    }
+
+    qsort(samples, bench.repetitions, sizeof(double), cmp_double);
+
+    unsigned n = bench.repetitions;
+    result->iterations = nr_iters;
+    result->min = samples[0];
+    result->max = samples[n - 1];
+    result->mean = sum / n;
+    result->median = (n % 2) ? samples[n / 2] :
+        (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+    double var = 0;
+    for (unsigned i = 0; i < n; i++)
+        var += (samples[i] - result->mean) * (samples[i] - result->mean);
+    result->stddev = (n > 1) ? sqrt(var / (n - 1)) : 0;
+
+    if (!bench.quiet) {
+        fprintf(stderr, "%-40s %14.1f ns/op %12zu iters  (+-%.1f%%)\n",
+                result->name, result->median, nr_iters,
+                result->mean > 0 ? result->stddev * 100 / result->mean : 0);
+    }
+}
+
+void pcbench_run(const char *name, pcbench_fn fn, void *ctxt,
+        size_t bytes_per_op)
+{
+    if (!pcbench_selected(name))
+        return;
+
+    struct bench_result *result = new_result(name);
+    if (result == NULL)
+        return;
+    result->bytes_per_op = bytes_per_op;
+
+    /* warm up, and find the number of iterations which lasts
+       at least the minimal time */
+    double min_ns = bench.min_time * 1e9;
+    size_t nr_iters = 1;
+    while (nr_iters < MAX_ITERATIONS) {
+        double start = now_ns();
+        fn(ctxt, nr_iters);
+        double elapsed = now_ns() - start;
+        if (elapsed >= min_ns)
+            break;
+
+        double factor = (elapsed > 0) ? min_ns * 1.4 / elapsed : 10;
+        if (factor > 10)
+            factor = 10;
+        else if (factor < 2)
+            factor = 2;
+        nr_iters = (size_t)(nr_iters * factor);
+    }
+
+    measure(result, fn, ctxt, nr_iters);
+}
+
+void pcbench_run_fixed(const char *name, pcbench_fn fn, void *ctxt,
+        size_t nr_iters)
+{
+    if (!pcbench_selected(name))
+        return;
+
+    struct bench_result *result = new_result(name);
+    if (result == NULL)
+        return;
+
+    if (nr_iters == 0)
+        nr_iters = 1;
+
+    /* warm up */
+    fn(ctxt, 1);
+    measure(result, fn, ctxt, nr_iters);
+}
+
+void pcbench_add_counter(const char *key, double value)
+{
+    if (bench.last == 0)
+        return;
+
+    struct bench_result *result = bench.results + bench.last - 1;
+    if (result->nr_counters < MAX_COUNTERS) {
+        result->counters[result->nr_counters].key = strdup(key);
+        result->counters[result->nr_counters].value = value;
+        result->nr_counters++;
+    }
+}
+
+void pcbench_skip(const char *name, const char *reason)
+{
+    if (!pcbench_selected(name))
+        return;
+
+    struct bench_result *result = new_result(name);
+    if (result == NULL)
+        return;
+    result->skipped = reason;
+
+    if (!bench.quiet)
+        fprintf(stderr, "%-40s skipped: %s\n", name, reason);
+}
+
+static void
+write_json_string(FILE *fp, const char *str)
+{
+    fputc('"', fp);
+    for (const char *p = str; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\')
+            fprintf(fp, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(fp, "\\u%04x", c);
+        else
+            fputc(c, fp);
+    }
+    fputc('"', fp);
+}
+
+static void
+write_report(FILE *fp)
+{
+    struct utsname uts;
+    if (uname(&uts))
+        memset(&uts, 0, sizeof(uts));
+
+    fprintf(fp, "{\n  \"suite\": ");
+    write_json_string(fp, bench.suite);
+    fprintf(fp, ",\n  \"context\": {\n");
+    fprintf(fp, "    \"purc_version\": ");
+    write_json_string(fp, PURC_VERSION_STRING);
+    fprintf(fp, ",\n    \"build_type\": ");
+    write_json_string(fp, PCBENCH_BUILD_TYPE);
+    fprintf(fp, ",\n    \"compiler\": ");
+#ifdef __VERSION__
+    write_json_string(fp, __VERSION__);
+#else
+    write_json_string(fp, "unknown");
+#endif
+    fprintf(fp, ",\n    \"system\": ");
+    write_json_string(fp, uts.sysname);
+    fprintf(fp, ",\n    \"release\": ");
+    write_json_string(fp, uts.release);
+    fprintf(fp, ",\n    \"machine\": ");
+    write_json_string(fp, uts.machine);
+    fprintf(fp, ",\n    \"date\": %ld", (long)time(NULL));
+    fprintf(fp, ",\n    \"min_time\": %g", bench.min_time);
+    fprintf(fp, ",\n    \"repetitions\": %u", bench.repetitions);
+    fprintf(fp, ",\n    \"seed\": %u\n  },\n", bench.seed);
+
+    fprintf(fp, "  \"results\": [");
+    for (size_t i = 0; i < bench.nr_results; i++) {
+        struct bench_result *result = bench.results + i;
+
+        fprintf(fp, "%s\n    {\n      \"name\": ", i ? "," : "");
+        write_json_string(fp, result->name);
+        if (result->skipped) {
+            fprintf(fp, ",\n      \"skipped\": ");
+            write_json_string(fp, result->skipped);
+            fprintf(fp, "\n    }");
+            continue;
+        }
+
+        fprintf(fp, ",\n      \"iterations\": %zu", result->iterations);
+        fprintf(fp, ",\n      \"ns_per_op\": %.3f", result->median);
+        fprintf(fp, ",\n      \"mean_ns\": %.3f", result->mean);
+        fprintf(fp, ",\n      \"min_ns\": %.3f", result->min);
+        fprintf(fp, ",\n      \"max_ns\": %.3f", result->max);
+        fprintf(fp, ",\n      \"stddev_ns\": %.3f", result->stddev);
+        fprintf(fp, ",\n      \"ops_per_sec\": %.3f",
+                result->median > 0 ? 1e9 / result->median : 0);
+        if (result->bytes_per_op) {
+            fprintf(fp, ",\n      \"bytes_per_sec\": %.3f",
+                    result->median > 0 ?
+                    result->bytes_per_op * 1e9 / result->median : 0);
+        }
+
+        if (result->nr_counters) {
+            fprintf(fp, ",\n      \"counters\": {");
+            for (size_t j = 0; j < result->nr_counters; j++) {
+                fprintf(fp, "%s\n        ", j ? "," : "");
+                write_json_string(fp, result->counters[j].key);
+                fprintf(fp, ": %.3f", result->counters[j].value);
+            }
+            fprintf(fp, "\n      }");
+        }
+        fprintf(fp, "\n    }");
+    }
+    fprintf(fp, "\n  ]\n}\n");
+}
+
+int pcbench_finish(void)
+{
+    int ret = EXIT_SUCCESS;
+
+    if (!bench.list) {
+        FILE *fp = stdout;
+        if (bench.output) {
+            fp = fopen(bench.output, "w");
+            if (fp == NULL) {
+                perror(bench.output);
+                ret = EXIT_FAILURE;
+            }
+        }
+
+        if (fp) {
+            write_report(fp);
+            if (fp != stdout)
+                fclose(fp);
+        }
+    }
+
+    for (size_t i = 0; i < bench.nr_results; i++) {
+        struct bench_result *result = bench.results + i;
+        for (size_t j = 0; j < result->nr_counters; j++)
+            free(result->counters[j].key);
+        free(result->name);
+    }
+    free(bench.results);
+    bench.results = NULL;
+    bench.nr_results = bench.sz_results = 0;
+
+    return ret;
+}
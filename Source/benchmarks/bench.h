@@ -0,0 +1,89 @@
+/*
+ * @file bench.h
+ * @date 2026/10/19
+ * @brief The interface of the tiny harness used by the benchmarks.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PURC_BENCHMARKS_BENCH_H
+#define PURC_BENCHMARKS_BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * A benchmark function runs the measured operation `nr_iters` times.
+ * The harness calls it repeatedly with a growing `nr_iters` until one
+ * call lasts at least the minimal time, then measures it `repetitions`
+ * times with the same count.
+ */
+typedef void (*pcbench_fn)(void *ctxt, size_t nr_iters);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Parses the command line options. Returns false if the program should
+ * exit (e.g. for `--help` or a bad option). The options are:
+ *
+ *  -f, --filter=<substr>   only run the benchmarks whose names contain it
+ *  -t, --min-time=<secs>   the minimal time of one repetition (0.2)
+ *  -r, --repetitions=<n>   the number of repetitions (5)
+ *  -s, --seed=<n>          the seed of the pseudo random numbers (1)
+ *  -o, --output=<file>     write the JSON report to the file (stdout)
+ *  -l, --list              list the benchmarks only
+ *  -q, --quiet             do not print the summary to stderr
+ */
+bool pcbench_init(int argc, char **argv, const char *suite);
+
+/* Returns the seed given with `--seed`; the benchmarks must derive all
+   their pseudo random data from it to be reproducible. */
+unsigned int pcbench_seed(void);
+
+/* Returns true if the benchmark called `name` is selected to run. */
+bool pcbench_selected(const char *name);
+
+/* Measures a benchmark; `bytes_per_op` is the number of bytes processed
+   by one iteration for the throughput, or 0 if not applicable. */
+void pcbench_run(const char *name, pcbench_fn fn, void *ctxt,
+        size_t bytes_per_op);
+
+/* Like pcbench_run(), but runs exactly `nr_iters` iterations in every
+   repetition; for the macro benchmarks which last long. */
+void pcbench_run_fixed(const char *name, pcbench_fn fn, void *ctxt,
+        size_t nr_iters);
+
+/* Attaches a named counter to the result of the last benchmark run. */
+void pcbench_add_counter(const char *key, double value);
+
+/* Marks a benchmark as skipped with the reason. */
+void pcbench_skip(const char *name, const char *reason);
+
+/* Writes the JSON report; returns the exit code for main(). */
+int pcbench_finish(void);
+
+/* Keeps the compiler from optimizing away a computed value. */
+void pcbench_use(const void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* PURC_BENCHMARKS_BENCH_H */
@@ -0,0 +1,170 @@
+/*
+ * @file bench_ejson.c
+ * @date 2026/10/19
+ * @brief The benchmarks of parsing and serializing eJSON documents.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include "purc/purc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NR_LARGE_RECORDS        2000
+
+static const char small_doc[] =
+    "{"
+    "  \"id\": 1024,"
+    "  \"name\": \"HVML\","
+    "  \"lang\": \"en\","
+    "  \"active\": true,"
+    "  \"ratio\": 0.618,"
+    "  \"tags\": [\"interpreter\", \"markup\", \"coroutine\"],"
+    "  \"owner\": { \"name\": \"FMSoft\", \"site\": \"https://www.fmsoft.cn\" },"
+    "  \"note\": null"
+    "}";
+
+struct doc {
+    const char     *json;
+    size_t          len;
+    purc_variant_t  value;
+    purc_rwstream_t out;
+};
+
+/* Generates an array of records with pseudo random contents. */
+static char *
+make_large_doc(size_t nr_records, size_t *len)
+{
+    static const char *words[] = {
+        "alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta",
+        "theta", "iota", "kappa", "lambda", "mu", "nu", "xi", "omicron",
+        "\\u4e2d\\u6587", "line\\nbreak", "quote\\\"d",
+    };
+    size_t nr_words = sizeof(words) / sizeof(words[0]);
+    size_t sz = nr_records * 256 + 16;
+    char *buf = malloc(sz);
+    size_t n = 0;
+
+    n += snprintf(buf + n, sz - n, "[");
+    for (size_t i = 0; i < nr_records; i++) {
+        n += snprintf(buf + n, sz - n,
+                "%s{\"id\":%zu,\"name\":\"%s %s\",\"score\":%.4f,"
+                "\"count\":%ld,\"valid\":%s,\"tags\":[\"%s\",\"%s\"],"
+                "\"pos\":{\"x\":%d,\"y\":%d}}",
+                i ? "," : "", i,
+                words[random() % nr_words], words[random() % nr_words],
+                (random() % 100000) / 997.0,
+                random() % 1000000,
+                (random() % 2) ? "true" : "false",
+                words[random() % nr_words], words[random() % nr_words],
+                (int)(random() % 1920), (int)(random() % 1080));
+    }
+    n += snprintf(buf + n, sz - n, "]");
+
+    *len = n;
+    return buf;
+}
+
+static void
+bench_parse(void *ctxt, size_t nr_iters)
+{
+    struct doc *doc = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t v = purc_variant_make_from_json_string(doc->json,
+                doc->len);
+        pcbench_use(v);
+        purc_variant_unref(v);
+    }
+}
+
+static void
+bench_serialize(void *ctxt, size_t nr_iters)
+{
+    struct doc *doc = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_rwstream_seek(doc->out, 0, SEEK_SET);
+        size_t len_expected = 0;
+        purc_variant_serialize(doc->value, doc->out, 0,
+                PCVRNT_SERIALIZE_OPT_PLAIN, &len_expected);
+    }
+}
+
+static void
+bench_serialize_pretty(void *ctxt, size_t nr_iters)
+{
+    struct doc *doc = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_rwstream_seek(doc->out, 0, SEEK_SET);
+        size_t len_expected = 0;
+        purc_variant_serialize(doc->value, doc->out, 0,
+                PCVRNT_SERIALIZE_OPT_PRETTY, &len_expected);
+    }
+}
+
+static void
+run_doc(const char *name, struct doc *doc)
+{
+    char buf[64];
+
+    doc->value = purc_variant_make_from_json_string(doc->json, doc->len);
+    if (doc->value == PURC_VARIANT_INVALID) {
+        snprintf(buf, sizeof(buf), "parse/%s", name);
+        pcbench_skip(buf, "bad document");
+        return;
+    }
+    doc->out = purc_rwstream_new_buffer(doc->len * 2, 0);
+
+    snprintf(buf, sizeof(buf), "parse/%s", name);
+    pcbench_run(buf, bench_parse, doc, doc->len);
+    snprintf(buf, sizeof(buf), "serialize/%s", name);
+    pcbench_run(buf, bench_serialize, doc, doc->len);
+    snprintf(buf, sizeof(buf), "serialize_pretty/%s", name);
+    pcbench_run(buf, bench_serialize_pretty, doc, doc->len);
+
+    purc_rwstream_destroy(doc->out);
+    purc_variant_unref(doc->value);
+}
+
+int main(int argc, char **argv)
+{
+    if (!pcbench_init(argc, argv, "ejson"))
+        return EXIT_FAILURE;
+
+    int ret = purc_init_ex(PURC_MODULE_EJSON, "cn.fmsoft.hvml.benchmarks",
+            "ejson", NULL);
+    if (ret != PURC_ERROR_OK) {
+        fprintf(stderr, "Failed to initialize PurC: %d\n", ret);
+        return EXIT_FAILURE;
+    }
+
+    struct doc small = { small_doc, sizeof(small_doc) - 1, NULL, NULL };
+    run_doc("small", &small);
+
+    size_t len;
+    char *json = make_large_doc(NR_LARGE_RECORDS, &len);
+    struct doc large = { json, len, NULL, NULL };
+    run_doc("large", &large);
+    free(json);
+
+    purc_cleanup();
+    return pcbench_finish();
+}
@@ -0,0 +1,291 @@
+/*
+ * @file bench_fetcher.c
+ * @date 2026/10/19
+ * @brief The benchmarks of the requests to the remote fetcher with the
+ *      LCMD and LSQL schemas.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include "purc/purc.h"
+#include "private/fetcher.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define REQUEST_TIMEOUT         30
+#define NR_CONCURRENT_REQUESTS  32
+#define NR_TABLE_ROWS           1000
+#define NR_INSERTS_PER_REQUEST  100
+
+struct context {
+    char           *url;
+    size_t          nr_bytes;
+    size_t          nr_failures;
+
+    /* for the concurrent requests */
+    size_t          nr_pending;
+};
+
+static char *
+make_url(const char *prefix, const char *query)
+{
+    size_t len = strlen(prefix);
+    char *url = malloc(len + strlen(query) * 3 + 1);
+    char *p = url;
+
+    memcpy(p, prefix, len);
+    p += len;
+    for (const unsigned char *q = (const unsigned char *)query; *q; q++) {
+        if (isalnum(*q) || strchr("-_.~*,()", *q)) {
+            *p++ = *q;
+        }
+        else {
+            sprintf(p, "%%%02X", *q);
+            p += 3;
+        }
+    }
+    *p = 0;
+    return url;
+}
+
+/* The HTTP status only tells the request reached the fetcher; whether the
+   command or the statement succeeded is told by the last `statusCode`
+   in the JSON result, which follows the lines or the rows. */
+static int
+result_status(purc_rwstream_t resp)
+{
+    static const char key[] = "\"statusCode\":";
+    const size_t len = sizeof(key) - 1;
+
+    size_t sz = 0;
+    const char *buf = resp ? purc_rwstream_get_mem_buffer(resp, &sz) : NULL;
+    if (buf == NULL || sz <= len)
+        return 0;
+
+    for (const char *p = buf + sz - len; p >= buf; p--) {
+        if (memcmp(p, key, len) == 0) {
+            int status = 0;
+            for (p += len; p < buf + sz && isdigit((unsigned char)*p); p++)
+                status = status * 10 + (*p - '0');
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+static int
+request_sync(const char *url, size_t *nr_bytes)
+{
+    struct pcfetcher_resp_header header = { };
+    purc_rwstream_t resp = pcfetcher_request_sync(url,
+            PCFETCHER_REQUEST_METHOD_GET, PURC_VARIANT_INVALID,
+            REQUEST_TIMEOUT, &header);
+
+    int ret = header.ret_code;
+    if (resp) {
+        size_t sz = 0;
+        purc_rwstream_get_mem_buffer(resp, &sz);
+        if (nr_bytes)
+            *nr_bytes = sz ? sz : header.sz_resp;
+        if (ret == 200)
+            ret = result_status(resp);
+        purc_rwstream_destroy(resp);
+    }
+    else if (ret == 200) {
+        ret = 0;
+    }
+    if (header.mime_type)
+        free(header.mime_type);
+
+    return ret;
+}
+
+static void
+bench_sync(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        if (request_sync(ctx->url, &ctx->nr_bytes) != 200)
+            ctx->nr_failures++;
+    }
+}
+
+static void
+on_response(purc_variant_t request_id, void *ctxt,
+        const struct pcfetcher_resp_header *header, purc_rwstream_t resp)
+{
+    struct context *ctx = ctxt;
+    (void)request_id;
+
+    if (header->ret_code != 200 || result_status(resp) != 200)
+        ctx->nr_failures++;
+    if (resp)
+        purc_rwstream_destroy(resp);
+
+    if (--ctx->nr_pending == 0)
+        purc_runloop_stop(purc_runloop_get_current());
+}
+
+/* Keeps a number of requests in flight; they share the pooled
+   connections to the fetcher process. */
+static void
+bench_concurrent(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    purc_variant_t ids[NR_CONCURRENT_REQUESTS];
+
+    for (size_t i = 0; i < nr_iters; i++) {
+        ctx->nr_pending = 0;
+        for (int j = 0; j < NR_CONCURRENT_REQUESTS; j++) {
+            ids[j] = pcfetcher_request_async(ctx->url,
+                    PCFETCHER_REQUEST_METHOD_GET, PURC_VARIANT_INVALID,
+                    REQUEST_TIMEOUT, on_response, ctx, NULL, NULL);
+            if (ids[j])
+                ctx->nr_pending++;
+            else
+                ctx->nr_failures++;
+        }
+
+        if (ctx->nr_pending)
+            purc_runloop_run();
+
+        for (int j = 0; j < NR_CONCURRENT_REQUESTS; j++) {
+            if (ids[j])
+                purc_variant_unref(ids[j]);
+        }
+    }
+}
+
+static void
+run_sync(const char *name, char *url)
+{
+    struct context ctx = { url, 0, 0, 0 };
+    pcbench_run(name, bench_sync, &ctx, 0);
+    pcbench_add_counter("response_bytes", ctx.nr_bytes);
+    pcbench_add_counter("failures", ctx.nr_failures);
+    free(url);
+}
+
+static bool
+prepare_database(const char *db_path)
+{
+    /* the fetcher opens the existing databases only; SQLite takes
+       an empty file as an empty database */
+    FILE *fp = fopen(db_path, "w");
+    if (fp == NULL)
+        return false;
+    fclose(fp);
+
+    char prefix[PATH_MAX + 32];
+    snprintf(prefix, sizeof(prefix), "lsql://%s?sqlquery=", db_path);
+
+    const char *ddl =
+        "CREATE TABLE IF NOT EXISTS records "
+        "(id INTEGER PRIMARY KEY, name TEXT, score REAL)";
+    char *url = make_url(prefix, ddl);
+    int ret = request_sync(url, NULL);
+    free(url);
+    if (ret != 200)
+        return false;
+
+    char sql[NR_INSERTS_PER_REQUEST * 48 + 64];
+    for (int i = 0; i < NR_TABLE_ROWS; i += NR_INSERTS_PER_REQUEST) {
+        size_t n = snprintf(sql, sizeof(sql),
+                "INSERT INTO records (id, name, score) VALUES ");
+        for (int j = 0; j < NR_INSERTS_PER_REQUEST; j++) {
+            n += snprintf(sql + n, sizeof(sql) - n, "%s(%d, 'name%ld', %.3f)",
+                    j ? "," : "", i + j, random() % 10000,
+                    (random() % 100000) / 1000.0);
+        }
+
+        url = make_url(prefix, sql);
+        ret = request_sync(url, NULL);
+        free(url);
+        if (ret != 200)
+            return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (!pcbench_init(argc, argv, "fetcher"))
+        return EXIT_FAILURE;
+
+    int ret = purc_init_ex(PURC_MODULE_HVML | PURC_HAVE_FETCHER_R,
+            "cn.fmsoft.hvml.benchmarks", "fetcher", NULL);
+    if (ret != PURC_ERROR_OK) {
+        fprintf(stderr, "Failed to initialize PurC: %d\n", ret);
+        return EXIT_FAILURE;
+    }
+
+    static const char *names[] = {
+        "lcmd/echo", "lcmd/concurrent", "lcmd/large_output",
+        "lsql/select_one", "lsql/select_all",
+    };
+
+    char *probe = make_url("lcmd:///bin/echo?cmdline=", "echo hello");
+    bool available = pcfetcher_is_init() && request_sync(probe, NULL) == 200;
+    free(probe);
+    if (!available) {
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+            pcbench_skip(names[i], "the remote fetcher is not available");
+        purc_cleanup();
+        return pcbench_finish();
+    }
+
+    run_sync("lcmd/echo", make_url("lcmd:///bin/echo?cmdline=", "echo hello"));
+
+    struct context ctx = { };
+    ctx.url = make_url("lcmd:///bin/echo?cmdline=", "echo hello");
+    pcbench_run("lcmd/concurrent", bench_concurrent, &ctx, 0);
+    pcbench_add_counter("requests_per_op", NR_CONCURRENT_REQUESTS);
+    pcbench_add_counter("failures", ctx.nr_failures);
+    free(ctx.url);
+
+    run_sync("lcmd/large_output",
+            make_url("lcmd:///usr/bin/seq?cmdline=", "seq 1 100000"));
+
+    char db_path[PATH_MAX];
+    snprintf(db_path, sizeof(db_path), "/tmp/purc-bench-%d.db", (int)getpid());
+    if (prepare_database(db_path)) {
+        char prefix[PATH_MAX + 32];
+        snprintf(prefix, sizeof(prefix), "lsql://%s?sqlquery=", db_path);
+        run_sync("lsql/select_one",
+                make_url(prefix, "SELECT * FROM records WHERE id = 500"));
+        run_sync("lsql/select_all", make_url(prefix, "SELECT * FROM records"));
+        pcbench_add_counter("rows", NR_TABLE_ROWS);
+    }
+    else {
+        pcbench_skip("lsql/select_one", "failed to prepare the database");
+        pcbench_skip("lsql/select_all", "failed to prepare the database");
+    }
+    unlink(db_path);
+
+    purc_cleanup();
+    return pcbench_finish();
+}
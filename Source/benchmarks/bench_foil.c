@@ -0,0 +1,180 @@
+/*
+ * @file bench_foil.c
+ * @date 2026/10/19
+ * @brief The benchmarks of the screen buffer of the Foil renderer.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include "purc/purc.h"
+#include "screen-buffer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NR_ROWS                 50
+#define NR_COLS                 160
+#define NR_FRAMES               2
+
+struct context {
+    foil_scrbuf    *scrbuf;
+    size_t          nr_written;
+
+    /* the contents of the frames to show alternately */
+    struct foil_tty_cell frames[NR_FRAMES][NR_ROWS][NR_COLS];
+};
+
+/* The in-memory sink of the screen buffer. */
+static ssize_t
+write_to_sink(void *ctxt, const void *buf, size_t len)
+{
+    struct context *ctx = ctxt;
+    pcbench_use(buf);
+    ctx->nr_written += len;
+    return len;
+}
+
+static void
+fill_frame(struct foil_tty_cell (*frame)[NR_COLS], bool cjk)
+{
+    for (int y = 0; y < NR_ROWS; y++) {
+        for (int x = 0; x < NR_COLS; x++) {
+            struct foil_tty_cell *cell = &frame[y][x];
+            memset(cell, 0, sizeof(*cell));
+
+            if (cjk && (x % 2) == 1) {
+                /* the latter half of the wide character before */
+                cell->uc = frame[y][x - 1].uc;
+                cell->latter_half = 1;
+            }
+            else if (cjk) {
+                cell->uc = 0x4E00 + (random() % 0x5000);
+            }
+            else {
+                cell->uc = 0x20 + (random() % 0x5F);
+            }
+            cell->fgc = random() % 16;
+            cell->bgc = (x / 20) % 8;
+            cell->attrs = (random() % 8) == 0 ? 1 : 0;
+            if (cell->latter_half) {
+                cell->fgc = frame[y][x - 1].fgc;
+                cell->bgc = frame[y][x - 1].bgc;
+                cell->attrs = frame[y][x - 1].attrs;
+            }
+        }
+    }
+}
+
+static void
+put_frame(struct context *ctx, struct foil_tty_cell (*frame)[NR_COLS])
+{
+    for (int y = 0; y < NR_ROWS; y++)
+        foil_scrbuf_put_cells(ctx->scrbuf, 0, y, frame[y], NR_COLS);
+}
+
+/* Every cell changes in every frame. */
+static void
+bench_full_repaint(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        put_frame(ctx, ctx->frames[i % NR_FRAMES]);
+        foil_scrbuf_flush(ctx->scrbuf, true);
+    }
+}
+
+/* The whole screen is exposed, but nothing changes. */
+static void
+bench_unchanged(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        put_frame(ctx, ctx->frames[0]);
+        foil_scrbuf_flush(ctx->scrbuf, true);
+    }
+}
+
+/* A status line and a counter change in every frame, like a clock. */
+static void
+bench_small_update(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    struct foil_tty_cell line[NR_COLS];
+    memcpy(line, ctx->frames[0][NR_ROWS - 1], sizeof(line));
+
+    for (size_t i = 0; i < nr_iters; i++) {
+        char buf[16];
+        int n = snprintf(buf, sizeof(buf), "%08zu", i);
+        for (int x = 0; x < n; x++)
+            line[NR_COLS - n + x].uc = (unsigned char)buf[x];
+
+        put_frame(ctx, ctx->frames[0]);
+        foil_scrbuf_put_cells(ctx->scrbuf, 0, NR_ROWS - 1, line, NR_COLS);
+        foil_scrbuf_flush(ctx->scrbuf, true);
+    }
+}
+
+static void
+run(struct context *ctx, const char *name, pcbench_fn fn)
+{
+    ctx->scrbuf = foil_scrbuf_new(NR_ROWS, NR_COLS, 0, write_to_sink, ctx);
+    ctx->nr_written = 0;
+
+    pcbench_run(name, fn, ctx, NR_ROWS * NR_COLS);
+
+    const struct foil_scrbuf_stats *stats =
+        foil_scrbuf_get_stats(ctx->scrbuf);
+    if (stats->nr_frames) {
+        pcbench_add_counter("bytes_per_frame",
+                (double)stats->nr_bytes / stats->nr_frames);
+        pcbench_add_counter("cells_per_frame",
+                (double)stats->nr_cells / stats->nr_frames);
+    }
+    foil_scrbuf_delete(ctx->scrbuf);
+}
+
+int main(int argc, char **argv)
+{
+    if (!pcbench_init(argc, argv, "foil"))
+        return EXIT_FAILURE;
+
+    int ret = purc_init_ex(PURC_MODULE_UTILS, "cn.fmsoft.hvml.benchmarks",
+            "foil", NULL);
+    if (ret != PURC_ERROR_OK) {
+        fprintf(stderr, "Failed to initialize PurC: %d\n", ret);
+        return EXIT_FAILURE;
+    }
+
+    static struct context ctx;
+
+    fill_frame(ctx.frames[0], false);
+    fill_frame(ctx.frames[1], false);
+    run(&ctx, "scrbuf/full_repaint", bench_full_repaint);
+    run(&ctx, "scrbuf/unchanged", bench_unchanged);
+    run(&ctx, "scrbuf/small_update", bench_small_update);
+
+    fill_frame(ctx.frames[0], true);
+    fill_frame(ctx.frames[1], true);
+    run(&ctx, "scrbuf/full_repaint_cjk", bench_full_repaint);
+
+    purc_cleanup();
+    return pcbench_finish();
+}
@@ -0,0 +1,141 @@
+/*
+ * @file bench_hvml.c
+ * @date 2026/10/19
+ * @brief The macro benchmarks running HVML programs against the headless
+ *      renderer.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include "purc/purc.h"
+#include "private/vdom.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef PCBENCH_HVML_DIR
+#define PCBENCH_HVML_DIR        "hvml"
+#endif
+
+static const char *programs[] = {
+    "iterate",
+    "update",
+    "observe",
+};
+
+struct context {
+    char   *hvml;
+    size_t  len;
+    size_t  nr_failures;
+};
+
+static void
+bench_load(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        /* not purc_load_hvml_from_string() which caches the vDOM */
+        purc_rwstream_t in = purc_rwstream_new_from_mem(ctx->hvml, ctx->len);
+        purc_vdom_t vdom = purc_load_hvml_from_rwstream(in);
+        purc_rwstream_destroy(in);
+        if (vdom)
+            pcvdom_document_unref(vdom);
+        else
+            ctx->nr_failures++;
+    }
+}
+
+static void
+bench_run(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_vdom_t vdom = purc_load_hvml_from_string(ctx->hvml);
+        if (vdom == NULL) {
+            ctx->nr_failures++;
+            continue;
+        }
+
+        purc_renderer_extra_info extra_info = {};
+        extra_info.title = "benchmark";
+        purc_coroutine_t co = purc_schedule_vdom(vdom,
+                0, PURC_VARIANT_INVALID, PCRDR_PAGE_TYPE_PLAINWIN,
+                "main",         /* target_workspace */
+                NULL,           /* target_group */
+                "bench",        /* page_name */
+                &extra_info, NULL, NULL);
+        if (co == NULL) {
+            ctx->nr_failures++;
+            continue;
+        }
+
+        purc_run(NULL);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (!pcbench_init(argc, argv, "hvml"))
+        return EXIT_FAILURE;
+
+    purc_instance_extra_info info = {};
+    info.renderer_comm = PURC_RDRCOMM_HEADLESS;
+    info.renderer_uri = "file:///dev/null";
+    info.workspace_name = "main";
+
+    unsigned int modules = (PURC_MODULE_HVML | PURC_MODULE_PCRDR) &
+        ~PURC_HAVE_FETCHER;
+    int ret = purc_init_ex(modules, "cn.fmsoft.hvml.benchmarks",
+            "hvml", &info);
+    if (ret != PURC_ERROR_OK) {
+        fprintf(stderr, "Failed to initialize PurC: %d\n", ret);
+        return EXIT_FAILURE;
+    }
+
+    char path[PATH_MAX], name[64];
+    for (size_t i = 0; i < sizeof(programs) / sizeof(programs[0]); i++) {
+        struct context ctx = { };
+
+        snprintf(path, sizeof(path), "%s/%s.hvml",
+                PCBENCH_HVML_DIR, programs[i]);
+        ctx.hvml = purc_load_file_contents(path, &ctx.len);
+        if (ctx.hvml == NULL) {
+            snprintf(name, sizeof(name), "load/%s", programs[i]);
+            pcbench_skip(name, "no such program");
+            snprintf(name, sizeof(name), "run/%s", programs[i]);
+            pcbench_skip(name, "no such program");
+            continue;
+        }
+
+        snprintf(name, sizeof(name), "load/%s", programs[i]);
+        pcbench_run(name, bench_load, &ctx, ctx.len);
+
+        snprintf(name, sizeof(name), "run/%s", programs[i]);
+        pcbench_run(name, bench_run, &ctx, 0);
+        pcbench_add_counter("failures", ctx.nr_failures);
+
+        free(ctx.hvml);
+    }
+
+    purc_cleanup();
+    return pcbench_finish();
+}
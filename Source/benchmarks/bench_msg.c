@@ -0,0 +1,163 @@
+/*
+ * @file bench_msg.c
+ * @date 2026/10/19
+ * @brief The benchmarks of the message queue and the move buffer.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include "purc/purc.h"
+#include "private/msg-queue.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NR_QUEUED_MSGS          64
+#define NR_PAYLOAD_MEMBERS      16
+
+struct context {
+    struct pcinst_msg_queue *queue;
+    purc_atom_t     self;
+    purc_variant_t  payload;
+};
+
+static pcrdr_msg *
+make_event(purc_variant_t payload)
+{
+    pcrdr_msg *msg = pcrdr_make_event_message(PCRDR_MSG_TARGET_COROUTINE, 0,
+            "change", NULL, PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
+            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+    if (msg && payload) {
+        msg->dataType = PCRDR_MSG_DATA_TYPE_JSON;
+        msg->data = purc_variant_ref(payload);
+    }
+    return msg;
+}
+
+/* Appends a message to the queue with some messages waiting, and gets
+   the oldest one; the messages are recycled so only the queue counts. */
+static void
+bench_queue_append_get(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    pcrdr_msg *msg = pcinst_msg_queue_get_msg(ctx->queue);
+    for (size_t i = 0; i < nr_iters; i++) {
+        pcinst_msg_queue_append(ctx->queue, msg);
+        msg = pcinst_msg_queue_get_msg(ctx->queue);
+    }
+    pcinst_msg_queue_append(ctx->queue, msg);
+}
+
+static void
+bench_make_release(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        pcrdr_msg *msg = make_event(ctx->payload);
+        pcrdr_release_message(msg);
+    }
+}
+
+/* Moves an event message carrying a container to the move buffer of this
+   instance and takes it away; the variants go to the move heap and back. */
+static void
+bench_move_take_away(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        pcrdr_msg *msg = make_event(ctx->payload);
+        purc_inst_move_message(ctx->self, msg);
+        pcrdr_msg *taken = purc_inst_take_away_message(0);
+        if (taken)
+            pcrdr_release_message(taken);
+    }
+}
+
+static void
+bench_move_void(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        pcrdr_msg *msg = make_event(PURC_VARIANT_INVALID);
+        purc_inst_move_message(ctx->self, msg);
+        pcrdr_msg *taken = purc_inst_take_away_message(0);
+        if (taken)
+            pcrdr_release_message(taken);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (!pcbench_init(argc, argv, "msg"))
+        return EXIT_FAILURE;
+
+    int ret = purc_init_ex(PURC_MODULE_EJSON, "cn.fmsoft.hvml.benchmarks",
+            "msg", NULL);
+    if (ret != PURC_ERROR_OK) {
+        fprintf(stderr, "Failed to initialize PurC: %d\n", ret);
+        return EXIT_FAILURE;
+    }
+
+    struct context ctx;
+    ctx.payload = purc_variant_make_object_0();
+    for (int i = 0; i < NR_PAYLOAD_MEMBERS; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "member%d", i);
+        purc_variant_t k = purc_variant_make_string(key, false);
+        purc_variant_t v = purc_variant_make_string("payload", false);
+        purc_variant_object_set(ctx.payload, k, v);
+        purc_variant_unref(k);
+        purc_variant_unref(v);
+    }
+
+    ctx.queue = pcinst_msg_queue_create();
+    for (int i = 0; i < NR_QUEUED_MSGS; i++)
+        pcinst_msg_queue_append(ctx.queue, make_event(ctx.payload));
+
+    pcbench_run("queue/append_get", bench_queue_append_get, &ctx, 0);
+    pcbench_add_counter("queued", NR_QUEUED_MSGS);
+    pcbench_run("message/make_release", bench_make_release, &ctx, 0);
+
+    /* the instance may have its move buffer already */
+    ctx.self = purc_inst_create_move_buffer(PCINST_MOVE_BUFFER_FLAG_NONE,
+            NR_QUEUED_MSGS);
+    bool created = (ctx.self != 0);
+    if (!created)
+        purc_get_endpoint(&ctx.self);
+
+    if (ctx.self) {
+        pcbench_run("move/void", bench_move_void, &ctx, 0);
+        pcbench_run("move/container", bench_move_take_away, &ctx, 0);
+        pcbench_add_counter("members", NR_PAYLOAD_MEMBERS);
+        if (created)
+            purc_inst_destroy_move_buffer();
+    }
+    else {
+        pcbench_skip("move/void", "no move buffer");
+        pcbench_skip("move/container", "no move buffer");
+    }
+
+    pcinst_msg_queue_destroy(ctx.queue);
+    purc_variant_unref(ctx.payload);
+
+    purc_cleanup();
+    return pcbench_finish();
+}
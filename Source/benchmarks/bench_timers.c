@@ -0,0 +1,121 @@
+/*
+ * @file bench_timers.c
+ * @date 2026/10/19
+ * @brief The benchmarks of the timers: the timer wheel used by $TIMERS
+ *      and the timers driven by the run loop one by one.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include "purc/purc.h"
+#include "private/timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NR_TIMERS               100000
+
+struct context {
+    pcintr_timer_t *timers;
+    size_t          nr_fired;
+};
+
+static void
+on_fire(pcintr_timer_t timer, const char *id, void *data)
+{
+    (void)timer;
+    (void)id;
+    struct context *ctx = data;
+    ctx->nr_fired++;
+}
+
+/* Starts the timers with the intervals spread over a minute, so they never
+   fire during the benchmark, then cancels them. */
+static void
+bench_wheel_start_cancel(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    pcintr_timer_wheel_t wheel = pcintr_timer_wheel_create(NULL);
+    if (wheel == NULL)
+        return;
+
+    for (size_t i = 0; i < nr_iters; i++) {
+        ctx->timers[i] = pcintr_timer_create_in_wheel(wheel, NULL,
+                on_fire, ctx);
+        pcintr_timer_set_interval(ctx->timers[i], 100 + i % 60000);
+        pcintr_timer_start(ctx->timers[i]);
+    }
+
+    for (size_t i = 0; i < nr_iters; i++) {
+        pcintr_timer_destroy(ctx->timers[i]);
+    }
+
+    pcintr_timer_wheel_destroy(wheel);
+}
+
+static void
+bench_runloop_start_cancel(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        ctx->timers[i] = pcintr_timer_create(NULL, NULL, on_fire, ctx);
+        pcintr_timer_set_interval(ctx->timers[i], 100 + i % 60000);
+        pcintr_timer_start(ctx->timers[i]);
+    }
+
+    for (size_t i = 0; i < nr_iters; i++) {
+        pcintr_timer_destroy(ctx->timers[i]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (!pcbench_init(argc, argv, "timers"))
+        return EXIT_FAILURE;
+
+    int ret = purc_init_ex(PURC_MODULE_HVML, "cn.fmsoft.hvml.benchmarks",
+            "timers", NULL);
+    if (ret != PURC_ERROR_OK) {
+        fprintf(stderr, "Failed to initialize PurC: %d\n", ret);
+        return EXIT_FAILURE;
+    }
+
+    struct context ctx = { NULL, 0 };
+    ctx.timers = calloc(NR_TIMERS, sizeof(pcintr_timer_t));
+    if (ctx.timers == NULL) {
+        purc_cleanup();
+        return EXIT_FAILURE;
+    }
+
+    pcbench_run_fixed("wheel/start_cancel", bench_wheel_start_cancel,
+            &ctx, NR_TIMERS);
+    pcbench_add_counter("timers", NR_TIMERS);
+    pcbench_run_fixed("runloop/start_cancel", bench_runloop_start_cancel,
+            &ctx, NR_TIMERS);
+    pcbench_add_counter("timers", NR_TIMERS);
+
+    if (ctx.nr_fired)
+        fprintf(stderr, "%u timers fired unexpectedly\n",
+                (unsigned)ctx.nr_fired);
+
+    free(ctx.timers);
+    purc_cleanup();
+    return pcbench_finish();
+}
@@ -0,0 +1,333 @@
+/*
+ * @file bench_variant.c
+ * @date 2026/10/19
+ * @brief The benchmarks of variants, containers, and atoms.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include "purc/purc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NR_KEYS                 64
+#define NR_MEMBERS              1000
+#define NR_RECORDS              1000
+#define NR_ATOMS                1024
+
+static const char long_string[] =
+    "HVML is a descriptive programming language proposed and designed by "
+    "Vincent Wei, the author of MiniGUI.";
+
+struct context {
+    char            keys[NR_KEYS][16];
+    purc_variant_t  object;
+
+    purc_variant_t  array;
+    purc_variant_t  nested;
+    purc_variant_t  records[NR_RECORDS];
+
+    purc_variant_t  cmp_a[3];
+    purc_variant_t  cmp_b[3];
+
+    char            atoms[NR_ATOMS][24];
+};
+
+static void
+bench_make_number(void *ctxt, size_t nr_iters)
+{
+    (void)ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t v = purc_variant_make_number((double)i);
+        pcbench_use(v);
+        purc_variant_unref(v);
+    }
+}
+
+static void
+bench_make_string_short(void *ctxt, size_t nr_iters)
+{
+    (void)ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t v = purc_variant_make_string("hello", false);
+        pcbench_use(v);
+        purc_variant_unref(v);
+    }
+}
+
+static void
+bench_make_string_long(void *ctxt, size_t nr_iters)
+{
+    (void)ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t v = purc_variant_make_string(long_string, true);
+        pcbench_use(v);
+        purc_variant_unref(v);
+    }
+}
+
+static void
+bench_make_object(void *ctxt, size_t nr_iters)
+{
+    (void)ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t x = purc_variant_make_longint(i);
+        purc_variant_t y = purc_variant_make_number(0.5);
+        purc_variant_t name = purc_variant_make_string_static("point", false);
+        purc_variant_t v = purc_variant_make_object_by_static_ckey(3,
+                "x", x, "y", y, "name", name);
+        purc_variant_unref(x);
+        purc_variant_unref(y);
+        purc_variant_unref(name);
+        pcbench_use(v);
+        purc_variant_unref(v);
+    }
+}
+
+static void
+bench_compare(void *ctxt, size_t nr_iters, int which)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        int r = purc_variant_compare_ex(ctx->cmp_a[which], ctx->cmp_b[which],
+                PCVRNT_COMPARE_METHOD_AUTO);
+        pcbench_use(&r);
+    }
+}
+
+static void
+bench_compare_number(void *ctxt, size_t nr_iters)
+{
+    bench_compare(ctxt, nr_iters, 0);
+}
+
+static void
+bench_compare_string(void *ctxt, size_t nr_iters)
+{
+    bench_compare(ctxt, nr_iters, 1);
+}
+
+static void
+bench_compare_object(void *ctxt, size_t nr_iters)
+{
+    bench_compare(ctxt, nr_iters, 2);
+}
+
+static void
+bench_clone_array(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t v = purc_variant_container_clone(ctx->array);
+        pcbench_use(v);
+        purc_variant_unref(v);
+    }
+}
+
+static void
+bench_clone_nested(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t v =
+            purc_variant_container_clone_recursively(ctx->nested);
+        pcbench_use(v);
+        purc_variant_unref(v);
+    }
+}
+
+static void
+bench_object_get(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t v = purc_variant_object_get_by_ckey(ctx->object,
+                ctx->keys[i % NR_KEYS]);
+        pcbench_use(v);
+    }
+}
+
+static void
+bench_object_set(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t v = purc_variant_make_longint(i);
+        purc_variant_object_set_by_static_ckey(ctx->object,
+                ctx->keys[i % NR_KEYS], v);
+        purc_variant_unref(v);
+    }
+}
+
+static void
+bench_set_insert_unique(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t set = purc_variant_make_set_by_ckey(0, "id", NULL);
+        for (size_t j = 0; j < NR_RECORDS; j++) {
+            purc_variant_set_add(set, ctx->records[j],
+                    PCVRNT_CR_METHOD_OVERWRITE);
+        }
+        pcbench_use(set);
+        purc_variant_unref(set);
+    }
+}
+
+static void
+bench_atom_lookup_hit(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_atom_t atom = purc_atom_try_string_ex(PURC_ATOM_BUCKET_DEF,
+                ctx->atoms[i % NR_ATOMS]);
+        pcbench_use(&atom);
+    }
+}
+
+static void
+bench_atom_lookup_miss(void *ctxt, size_t nr_iters)
+{
+    (void)ctxt;
+    char buf[32];
+    for (size_t i = 0; i < nr_iters; i++) {
+        snprintf(buf, sizeof(buf), "bench-miss-%zu", i % NR_ATOMS);
+        purc_atom_t atom = purc_atom_try_string_ex(PURC_ATOM_BUCKET_DEF, buf);
+        pcbench_use(&atom);
+    }
+}
+
+static void
+bench_atom_from_string(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_atom_t atom = purc_atom_from_string_ex(PURC_ATOM_BUCKET_DEF,
+                ctx->atoms[i % NR_ATOMS]);
+        pcbench_use(&atom);
+    }
+}
+
+static void
+setup(struct context *ctx)
+{
+    ctx->object = purc_variant_make_object_0();
+    for (int i = 0; i < NR_KEYS; i++) {
+        snprintf(ctx->keys[i], sizeof(ctx->keys[i]), "key%03d", i);
+        purc_variant_t v = purc_variant_make_longint(random());
+        purc_variant_object_set_by_static_ckey(ctx->object, ctx->keys[i], v);
+        purc_variant_unref(v);
+    }
+
+    ctx->array = purc_variant_make_array_0();
+    for (int i = 0; i < NR_MEMBERS; i++) {
+        purc_variant_t v = purc_variant_make_number(random() / 7.0);
+        purc_variant_array_append(ctx->array, v);
+        purc_variant_unref(v);
+    }
+
+    ctx->nested = purc_variant_make_array_0();
+    for (int i = 0; i < NR_RECORDS; i++) {
+        purc_variant_t id = purc_variant_make_longint(i);
+        purc_variant_t name = purc_variant_make_string(
+                ctx->keys[random() % NR_KEYS], false);
+        purc_variant_t tags = purc_variant_make_array(2, id, name);
+        ctx->records[i] = purc_variant_make_object_by_static_ckey(3,
+                "id", id, "name", name, "tags", tags);
+        purc_variant_array_append(ctx->nested, ctx->records[i]);
+        purc_variant_unref(id);
+        purc_variant_unref(name);
+        purc_variant_unref(tags);
+    }
+
+    ctx->cmp_a[0] = purc_variant_make_number(3.1415926);
+    ctx->cmp_b[0] = purc_variant_make_number(2.7182818);
+    ctx->cmp_a[1] = purc_variant_make_string(long_string, false);
+    ctx->cmp_b[1] = purc_variant_make_string(long_string, false);
+    ctx->cmp_a[2] = purc_variant_container_clone_recursively(ctx->records[0]);
+    ctx->cmp_b[2] = purc_variant_container_clone_recursively(ctx->records[0]);
+
+    for (int i = 0; i < NR_ATOMS; i++) {
+        snprintf(ctx->atoms[i], sizeof(ctx->atoms[i]), "bench-atom-%d", i);
+        purc_atom_from_string_ex(PURC_ATOM_BUCKET_DEF, ctx->atoms[i]);
+    }
+}
+
+static void
+teardown(struct context *ctx)
+{
+    for (int i = 0; i < 3; i++) {
+        purc_variant_unref(ctx->cmp_a[i]);
+        purc_variant_unref(ctx->cmp_b[i]);
+    }
+
+    for (int i = 0; i < NR_RECORDS; i++)
+        purc_variant_unref(ctx->records[i]);
+    purc_variant_unref(ctx->nested);
+    purc_variant_unref(ctx->array);
+    purc_variant_unref(ctx->object);
+}
+
+int main(int argc, char **argv)
+{
+    if (!pcbench_init(argc, argv, "variant"))
+        return EXIT_FAILURE;
+
+    int ret = purc_init_ex(PURC_MODULE_VARIANT, "cn.fmsoft.hvml.benchmarks",
+            "variant", NULL);
+    if (ret != PURC_ERROR_OK) {
+        fprintf(stderr, "Failed to initialize PurC: %d\n", ret);
+        return EXIT_FAILURE;
+    }
+
+    static struct context ctx;
+    setup(&ctx);
+
+    pcbench_run("make/number", bench_make_number, &ctx, 0);
+    pcbench_run("make/string_short", bench_make_string_short, &ctx, 0);
+    pcbench_run("make/string_long", bench_make_string_long, &ctx,
+            sizeof(long_string) - 1);
+    pcbench_run("make/object", bench_make_object, &ctx, 0);
+
+    pcbench_run("compare/number", bench_compare_number, &ctx, 0);
+    pcbench_run("compare/string", bench_compare_string, &ctx, 0);
+    pcbench_run("compare/object", bench_compare_object, &ctx, 0);
+
+    pcbench_run("clone/array", bench_clone_array, &ctx, 0);
+    pcbench_add_counter("members", NR_MEMBERS);
+    pcbench_run("clone/nested", bench_clone_nested, &ctx, 0);
+    pcbench_add_counter("records", NR_RECORDS);
+
+    pcbench_run("object/get", bench_object_get, &ctx, 0);
+    pcbench_run("object/set", bench_object_set, &ctx, 0);
+
+    pcbench_run("set/insert_unique", bench_set_insert_unique, &ctx, 0);
+    pcbench_add_counter("records", NR_RECORDS);
+
+    pcbench_run("atom/lookup_hit", bench_atom_lookup_hit, &ctx, 0);
+    pcbench_run("atom/lookup_miss", bench_atom_lookup_miss, &ctx, 0);
+    pcbench_run("atom/from_string", bench_atom_from_string, &ctx, 0);
+
+    teardown(&ctx);
+    purc_cleanup();
+    return pcbench_finish();
+}
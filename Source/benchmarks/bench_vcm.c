@@ -0,0 +1,180 @@
+/*
+ * @file bench_vcm.c
+ * @date 2026/10/19
+ * @brief The benchmarks of parsing and evaluating typical VCM expressions.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include "purc/purc.h"
+#include "private/ejson.h"
+#include "private/vcm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const struct expression {
+    const char *name;
+    const char *expr;
+} expressions[] = {
+    { "member",     "$obj.name" },
+    { "index",      "$arr[5]" },
+    { "arith",      "$DATA.arith('+', $obj.count, 1)" },
+    { "logical",    "$L.lt($obj.count, 100)" },
+    { "string",     "$STR.join($obj.name, '-', $arr[1])" },
+    { "container",  "{ \"x\": $obj.count, \"y\": [$arr[0], $arr[1]] }" },
+};
+
+struct variables {
+    purc_variant_t  obj;
+    purc_variant_t  arr;
+    purc_variant_t  data;
+    purc_variant_t  logical;
+    purc_variant_t  str;
+};
+
+struct context {
+    const char         *expr;
+    size_t              len;
+    struct pcvcm_node  *tree;
+    struct variables   *vars;
+};
+
+static purc_variant_t
+find_var(void *ctxt, const char *name)
+{
+    struct variables *vars = ctxt;
+
+    if (strcmp(name, "obj") == 0)
+        return vars->obj;
+    else if (strcmp(name, "arr") == 0)
+        return vars->arr;
+    else if (strcmp(name, "DATA") == 0)
+        return vars->data;
+    else if (strcmp(name, "L") == 0)
+        return vars->logical;
+    else if (strcmp(name, "STR") == 0)
+        return vars->str;
+    return PURC_VARIANT_INVALID;
+}
+
+static struct pcvcm_node *
+parse_expr(const char *expr, size_t len)
+{
+    struct pcvcm_node *tree = NULL;
+    struct pcejson *parser = NULL;
+
+    /* read the terminating null character as the end of the input */
+    purc_rwstream_t rws = purc_rwstream_new_from_mem((void *)expr, len + 1);
+    if (pcejson_parse(&tree, &parser, rws, 32) != 0 && tree) {
+        pcvcm_node_destroy(tree);
+        tree = NULL;
+    }
+    pcejson_destroy(parser);
+    purc_rwstream_destroy(rws);
+    return tree;
+}
+
+static void
+bench_parse(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        struct pcvcm_node *tree = parse_expr(ctx->expr, ctx->len);
+        pcbench_use(tree);
+        if (tree)
+            pcvcm_node_destroy(tree);
+    }
+}
+
+static void
+bench_eval(void *ctxt, size_t nr_iters)
+{
+    struct context *ctx = ctxt;
+    for (size_t i = 0; i < nr_iters; i++) {
+        purc_variant_t v = pcvcm_eval_ex(ctx->tree, NULL,
+                find_var, ctx->vars, true);
+        pcbench_use(v);
+        if (v)
+            purc_variant_unref(v);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (!pcbench_init(argc, argv, "vcm"))
+        return EXIT_FAILURE;
+
+    int ret = purc_init_ex(PURC_MODULE_HVML, "cn.fmsoft.hvml.benchmarks",
+            "vcm", NULL);
+    if (ret != PURC_ERROR_OK) {
+        fprintf(stderr, "Failed to initialize PurC: %d\n", ret);
+        return EXIT_FAILURE;
+    }
+
+    struct variables vars;
+    purc_variant_t count = purc_variant_make_longint(42);
+    purc_variant_t name = purc_variant_make_string("benchmark", false);
+    vars.obj = purc_variant_make_object_by_static_ckey(2,
+            "count", count, "name", name);
+    purc_variant_unref(count);
+    purc_variant_unref(name);
+
+    vars.arr = purc_variant_make_array_0();
+    for (int i = 0; i < 10; i++) {
+        purc_variant_t v = purc_variant_make_number(i * 1.5);
+        purc_variant_array_append(vars.arr, v);
+        purc_variant_unref(v);
+    }
+
+    vars.data = purc_dvobj_data_new();
+    vars.logical = purc_dvobj_logical_new();
+    vars.str = purc_dvobj_string_new();
+
+    char buf[64];
+    for (size_t i = 0; i < sizeof(expressions) / sizeof(expressions[0]); i++) {
+        struct context ctx;
+        ctx.expr = expressions[i].expr;
+        ctx.len = strlen(ctx.expr);
+        ctx.vars = &vars;
+        ctx.tree = parse_expr(ctx.expr, ctx.len);
+
+        snprintf(buf, sizeof(buf), "parse/%s", expressions[i].name);
+        pcbench_run(buf, bench_parse, &ctx, ctx.len);
+
+        snprintf(buf, sizeof(buf), "eval/%s", expressions[i].name);
+        if (ctx.tree == NULL) {
+            pcbench_skip(buf, "bad expression");
+            continue;
+        }
+        pcbench_run(buf, bench_eval, &ctx, 0);
+        pcvcm_node_destroy(ctx.tree);
+    }
+
+    purc_variant_unref(vars.str);
+    purc_variant_unref(vars.logical);
+    purc_variant_unref(vars.data);
+    purc_variant_unref(vars.arr);
+    purc_variant_unref(vars.obj);
+
+    purc_cleanup();
+    return pcbench_finish();
+}
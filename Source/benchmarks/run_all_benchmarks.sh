@@ -0,0 +1,57 @@
+#!/bin/sh
+
+# Runs all benchmarks and merges their reports into one JSON file.
+#
+# Usage: run_all_benchmarks.sh [<output file>] [<options of the benchmarks>]
+#
+# For example, to compare two builds:
+#   ./run_all_benchmarks.sh before.json --repetitions=10
+#   ./run_all_benchmarks.sh after.json --repetitions=10
+
+export PURC_EXECUTOR_PATH=`pwd`/lib
+export PURC_DVOBJS_PATH=`pwd`/lib
+
+OUTPUT=${1:-purc-benchmarks.json}
+test $# -gt 0 && shift
+
+BENCH_PROGS=`find ${BENCH_DIR:-Source/benchmarks} -name bench_* -perm -0111 -type f | sort`
+REPORT_DIR=`mktemp -d /tmp/purc-benchmarks.XXXXXX`
+
+total_failed=0
+bench_failed=""
+
+for x in $BENCH_PROGS; do
+    suite=`basename $x | sed 's/^bench_//'`
+    echo ">> Start of $x"
+    ./$x -o ${REPORT_DIR}/${suite}.json "$@"
+    RESULT=$?
+    echo "<< End of $x"
+    echo ""
+
+    if test $RESULT -ne 0; then
+        total_failed=$((total_failed + 1))
+        bench_failed="$bench_failed $x"
+    fi
+done
+
+# merge the reports: { "suites": [ <report>, ... ] }
+{
+    echo '{"suites":['
+    first=1
+    for f in ${REPORT_DIR}/*.json; do
+        test -f $f || continue
+        test $first -eq 1 || echo ','
+        cat $f
+        first=0
+    done
+    echo ']}'
+} > $OUTPUT
+rm -rf $REPORT_DIR
+
+echo "#### The results have been written to $OUTPUT"
+if test $total_failed -ne 0; then
+    echo "#### Failed benchmarks:$bench_failed"
+    exit 1
+fi
+
+exit 0
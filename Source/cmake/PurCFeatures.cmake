@@ -95,6 +95,8 @@ macro(PURC_OPTION_BEGIN)
     PURC_OPTION_DEFINE(ENABLE_WEB_SOCKET "Toggle support for WebSocket protocol" PUBLIC ON)
     PURC_OPTION_DEFINE(ENABLE_SSL "Toggle support for SSL" PUBLIC OFF)
     PURC_OPTION_DEFINE(ENABLE_API_TESTS "Enable public API unit tests" PUBLIC ON)
+    PURC_OPTION_DEFINE(ENABLE_BENCHMARKS "Build the benchmarks of the hot paths" PUBLIC OFF)
+    PURC_OPTION_DEFINE(ENABLE_RUNTIME_STATS "Toggle the runtime performance counters of instances" PUBLIC ON)
     PURC_OPTION_DEFINE(ENABLE_DEVELOPER_MODE "Toggle developer mode" PUBLIC OFF)
     PURC_OPTION_DEFINE(ENABLE_RDR_FOIL "Toggle the built-in `foil` renderer in `purc`" PUBLIC ON)
 
@@ -43,3 +43,56 @@ TEST(dvobjs, channel)
     tester.run_testcases_in_file("channel");
 }
 
+
+TEST(dvobjs, stats)
+{
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_HVML, "cn.fmsoft.hvml.test",
+            "dvobjs", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    purc_variant_t stats = purc_get_instance_stats();
+    if (stats == PURC_VARIANT_INVALID) {
+        /* the runtime statistics is disabled */
+        ASSERT_EQ(purc_get_last_error(), PURC_ERROR_NOT_SUPPORTED);
+        purc_cleanup();
+        return;
+    }
+
+    ASSERT_EQ(purc_variant_is_object(stats), true);
+    const char *keys[] = { "scheduler", "messages", "vcm_eval",
+        "fetcher", "renderer" };
+    for (size_t i = 0; i < PCA_TABLESIZE(keys); i++) {
+        purc_variant_t v = purc_variant_object_get_by_ckey(stats, keys[i]);
+        ASSERT_NE(v, nullptr) << keys[i];
+        ASSERT_EQ(purc_variant_is_object(v), true) << keys[i];
+    }
+
+    purc_variant_t hist = purc_variant_object_get_by_ckey(stats, "vcm_eval");
+    purc_variant_t buckets = purc_variant_object_get_by_ckey(hist, "buckets");
+    ASSERT_EQ(purc_variant_is_array(buckets), true);
+
+    purc_variant_t crtns = purc_variant_object_get_by_ckey(stats,
+            "coroutines");
+    ASSERT_EQ(purc_variant_is_array(crtns), true);
+    purc_variant_unref(stats);
+
+    /* $RUNNER.stats gives the same */
+    purc_variant_t runner = purc_dvobj_runner_new();
+    purc_variant_t getter = purc_variant_object_get_by_ckey(runner, "stats");
+    ASSERT_NE(getter, nullptr);
+    purc_dvariant_method method = purc_variant_dynamic_get_getter(getter);
+    ASSERT_NE(method, nullptr);
+    stats = method(runner, 0, NULL, 0);
+    ASSERT_NE(stats, nullptr);
+    ASSERT_EQ(purc_variant_is_object(stats), true);
+    purc_variant_t sched = purc_variant_object_get_by_ckey(stats, "scheduler");
+    uint64_t rounds;
+    ASSERT_EQ(purc_variant_cast_to_ulongint(
+                purc_variant_object_get_by_ckey(sched, "rounds"),
+                &rounds, false), true);
+    purc_variant_unref(stats);
+    purc_variant_unref(runner);
+
+    purc_cleanup();
+}
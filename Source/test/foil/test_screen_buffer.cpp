@@ -0,0 +1,153 @@
+/*
+ * @file test_screen_buffer.cpp
+ * @date 2026/10/19
+ * @brief The program to test the screen buffer of the Foil renderer:
+ *      the coalescing of the exposures into frames and of the changed
+ *      cells into runs.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "screen-buffer.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <string.h>
+#include <unistd.h>
+
+#define NR_ROWS         4
+#define NR_COLS         40
+#define MAX_FPS         20      /* a frame per 50ms */
+
+static ssize_t write_to_string(void *ctxt, const void *buf, size_t len)
+{
+    std::string *out = (std::string *)ctxt;
+    out->append((const char *)buf, len);
+    return len;
+}
+
+static void fill_cells(struct foil_tty_cell *cells, int nr, char c)
+{
+    memset(cells, 0, sizeof(struct foil_tty_cell) * nr);
+    for (int i = 0; i < nr; i++)
+        cells[i].uc = c;
+}
+
+/* the number of the cursor movements in the escape sequences */
+static size_t count_moves(const std::string &out)
+{
+    size_t n = 0;
+    for (size_t pos = out.find("\x1b["); pos != std::string::npos;
+            pos = out.find("\x1b[", pos + 2)) {
+        size_t end = out.find_first_not_of("0123456789;", pos + 2);
+        if (end != std::string::npos && out[end] == 'H')
+            n++;
+    }
+    return n;
+}
+
+TEST(screen_buffer, coalesce_exposures)
+{
+    std::string out;
+    foil_scrbuf *scrbuf = foil_scrbuf_new(NR_ROWS, NR_COLS, MAX_FPS,
+            write_to_string, &out);
+    ASSERT_NE(scrbuf, nullptr);
+
+    /* the whole screen is written in the first frame */
+    ASSERT_TRUE(foil_scrbuf_flush(scrbuf, false));
+    ASSERT_EQ(foil_scrbuf_pending_usec(scrbuf), -1);
+    const struct foil_scrbuf_stats *stats = foil_scrbuf_get_stats(scrbuf);
+    ASSERT_EQ(stats->nr_frames, 1);
+    ASSERT_EQ(stats->nr_cells, NR_ROWS * NR_COLS);
+
+    /* the exposures in the interval of a frame are held back */
+    struct foil_tty_cell cells[NR_COLS];
+    fill_cells(cells, 4, 'a');
+    for (int y = 0; y < NR_ROWS; y++) {
+        foil_scrbuf_put_cells(scrbuf, 0, y, cells, 4);
+        ASSERT_FALSE(foil_scrbuf_flush(scrbuf, false));
+    }
+
+    long pending = foil_scrbuf_pending_usec(scrbuf);
+    ASSERT_GT(pending, 0);
+    ASSERT_LE(pending, 1000000 / MAX_FPS);
+    ASSERT_EQ(stats->nr_frames, 1);
+
+    /* and written in a frame once it is due */
+    usleep(pending);
+    ASSERT_EQ(foil_scrbuf_pending_usec(scrbuf), 0);
+    out.clear();
+    ASSERT_TRUE(foil_scrbuf_flush(scrbuf, false));
+    ASSERT_EQ(stats->nr_frames, 2);
+    ASSERT_EQ(stats->nr_coalesced, NR_ROWS);
+    ASSERT_EQ(stats->nr_cells, NR_ROWS * NR_COLS + NR_ROWS * 4);
+    ASSERT_EQ(count_moves(out), NR_ROWS);
+    ASSERT_EQ(foil_scrbuf_pending_usec(scrbuf), -1);
+
+    /* the cells not changed are not written */
+    foil_scrbuf_put_cells(scrbuf, 0, 0, cells, 4);
+    ASSERT_FALSE(foil_scrbuf_flush(scrbuf, true));
+    ASSERT_EQ(stats->nr_frames, 2);
+    ASSERT_EQ(stats->nr_coalesced, NR_ROWS + 1);
+
+    foil_scrbuf_delete(scrbuf);
+}
+
+TEST(screen_buffer, coalesce_runs)
+{
+    std::string out;
+    foil_scrbuf *scrbuf = foil_scrbuf_new(NR_ROWS, NR_COLS, 0,
+            write_to_string, &out);
+    ASSERT_NE(scrbuf, nullptr);
+    ASSERT_TRUE(foil_scrbuf_flush(scrbuf, false));
+
+    struct foil_tty_cell cell;
+    fill_cells(&cell, 1, 'x');
+
+    /* the changes separated by a few cells are written in a run,
+       overwriting the cells between them */
+    out.clear();
+    foil_scrbuf_put_cells(scrbuf, 2, 1, &cell, 1);
+    foil_scrbuf_put_cells(scrbuf, 6, 1, &cell, 1);
+    ASSERT_TRUE(foil_scrbuf_flush(scrbuf, false));
+    ASSERT_EQ(count_moves(out), 1);
+    ASSERT_NE(out.find("x   x"), std::string::npos);
+
+    /* the changes far away from each other are written separately */
+    fill_cells(&cell, 1, 'y');
+    out.clear();
+    foil_scrbuf_put_cells(scrbuf, 2, 2, &cell, 1);
+    foil_scrbuf_put_cells(scrbuf, 30, 2, &cell, 1);
+    ASSERT_TRUE(foil_scrbuf_flush(scrbuf, false));
+    ASSERT_EQ(count_moves(out), 2);
+    ASSERT_EQ(out.find("y "), std::string::npos);
+
+    /* the cells out of the screen are clipped */
+    out.clear();
+    struct foil_tty_cell cells[NR_COLS];
+    fill_cells(cells, 8, 'z');
+    foil_scrbuf_put_cells(scrbuf, NR_COLS - 4, 3, cells, 8);
+    foil_scrbuf_put_cells(scrbuf, 0, NR_ROWS, cells, 8);
+    ASSERT_TRUE(foil_scrbuf_flush(scrbuf, false));
+    ASSERT_EQ(count_moves(out), 1);
+    ASSERT_NE(out.find("zzzz"), std::string::npos);
+    ASSERT_EQ(out.find("zzzzz"), std::string::npos);
+
+    foil_scrbuf_delete(scrbuf);
+}
+
@@ -0,0 +1,242 @@
+/*
+ * @file test_udom_update.cpp
+ * @date 2026/10/19
+ * @brief The program to test the updates of the uDOM of the Foil renderer:
+ *      the boxes along the chain of the containing blocks are laid out and
+ *      rendered again, and the elements generating no box are updated.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "purc/purc.h"
+
+/* the headers of CSSEng use the C99 keyword */
+#define restrict __restrict__
+
+#include "foil.h"
+#include "workspace.h"
+#include "widget.h"
+#include "page.h"
+#include "udom.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <string.h>
+
+#define NR_ROWS         24
+#define NR_COLS         80
+
+static const char *html_contents = ""
+"<html>"
+"<head><style>.hidden { display: none }</style></head>"
+"<body>"
+"<div>alpha</div>"
+"<div>beta</div>"
+"<div>gamma</div>"
+"<div class=\"hidden\">delta</div>"
+"</body>"
+"</html>";
+
+enum {
+    ELEM_ALPHA = 0,
+    ELEM_BETA,
+    ELEM_GAMMA,
+    ELEM_DELTA,
+};
+
+class udom_update : public testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(purc_init_ex(PURC_MODULE_HTML, "cn.fmsoft.hvml.test",
+                    "udom_update", NULL), PURC_ERROR_OK);
+
+        /* the pages are printed to stdout in the line mode */
+        memset(&rdr_data, 0, sizeof(rdr_data));
+        rdr_data.term_mode = FOIL_TERM_MODE_LINE;
+        rdr_data.rows = NR_ROWS;
+        rdr_data.cols = NR_COLS;
+        memset(&rdr, 0, sizeof(rdr));
+        rdr.impl = &rdr_data;
+        ASSERT_EQ(foil_page_module_init(&rdr), 0);
+
+        foil_rect rc;
+        foil_rect_set(&rc, 0, 0, NR_COLS, NR_ROWS);
+        memset(&workspace, 0, sizeof(workspace));
+        workspace.rdr = &rdr;
+        workspace.root = foil_widget_new(WSP_WIDGET_TYPE_ROOT,
+                WSP_WIDGET_BORDER_NONE, "root", NULL, &rc);
+        ASSERT_NE(workspace.root, nullptr);
+        workspace.root->user_data = &workspace;
+
+        win = foil_widget_new(WSP_WIDGET_TYPE_PLAINWINDOW,
+                WSP_WIDGET_BORDER_NONE, "main", NULL, &rc);
+        ASSERT_NE(win, nullptr);
+        foil_widget_append_child(workspace.root, win);
+
+        doc = purc_document_load(PCDOC_K_TYPE_HTML, html_contents,
+                strlen(html_contents));
+        ASSERT_NE(doc, nullptr);
+        edom = purc_variant_make_native(doc, NULL);
+        ASSERT_NE(edom, PURC_VARIANT_INVALID);
+
+        int retv = 0;
+        udom = foil_udom_load_edom(&win->page, edom, &retv);
+        ASSERT_NE(udom, nullptr);
+    }
+
+    void TearDown() override {
+        if (udom)
+            foil_udom_delete(udom);
+        if (edom)
+            purc_variant_unref(edom);
+        if (doc)
+            purc_document_delete(doc);
+        if (workspace.root)
+            foil_widget_delete_deep(workspace.root);
+        foil_page_module_cleanup(&rdr);
+        purc_cleanup();
+    }
+
+    pcdoc_element_t element(size_t idx) {
+        return pcdoc_element_get_child_element(doc,
+                purc_document_body(doc), idx);
+    }
+
+    foil_rdrbox *rdrbox(size_t idx) {
+        return foil_udom_find_rdrbox(udom, PTR2U64(element(idx)));
+    }
+
+    int update(size_t idx, int op, const char *property) {
+        foil_rdrbox *box = rdrbox(idx);
+        if (box)
+            return foil_udom_update_rdrbox(udom, box, op, property,
+                    PURC_VARIANT_INVALID);
+        return foil_udom_update_boxless_element(udom, PTR2U64(element(idx)),
+                op, property, PURC_VARIANT_INVALID);
+    }
+
+    /* the characters in the row of the page */
+    std::string row(int y) {
+        std::string text;
+        for (int x = 0; x < win->page.cols; x++)
+            text += (char)win->page.cells[y][x].uc;
+        return text;
+    }
+
+    static int row_of(const foil_rdrbox *box) {
+        return box->ctnt_rect.top / FOIL_PX_GRID_CELL_H;
+    }
+
+    struct pcmcth_rdr_data rdr_data;
+    pcmcth_renderer rdr;
+    pcmcth_workspace workspace;
+    foil_widget *win = nullptr;
+
+    purc_document_t doc = nullptr;
+    purc_variant_t edom = PURC_VARIANT_INVALID;
+    pcmcth_udom *udom = nullptr;
+};
+
+TEST_F(udom_update, relayout_in_place)
+{
+    foil_rdrbox *alpha = rdrbox(ELEM_ALPHA);
+    foil_rdrbox *gamma = rdrbox(ELEM_GAMMA);
+    ASSERT_NE(alpha, nullptr);
+    ASSERT_NE(gamma, nullptr);
+
+    foil_rect beta_rc = rdrbox(ELEM_BETA)->ctnt_rect;
+    foil_rect gamma_rc = gamma->ctnt_rect;
+
+    /* mark a cell out of the changed box */
+    int y = row_of(alpha);
+    ASSERT_NE(row(y).find("alpha"), std::string::npos);
+    win->page.cells[y][0].uc = '#';
+
+    /* the new content has the same size */
+    ASSERT_NE(pcdoc_element_new_text_content(doc, element(ELEM_BETA),
+                PCDOC_OP_DISPLACE, "BETA", 4), nullptr);
+    ASSERT_EQ(update(ELEM_BETA, PCRDR_K_OPERATION_DISPLACE, NULL),
+            PCRDR_SC_OK);
+
+    /* the box is laid out at its old position... */
+    foil_rdrbox *beta = rdrbox(ELEM_BETA);
+    ASSERT_NE(beta, nullptr);
+    ASSERT_TRUE(foil_rect_is_equal(&beta->ctnt_rect, &beta_rc));
+    ASSERT_NE(row(row_of(beta)).find("BETA"), std::string::npos);
+
+    /* ...and the other boxes and cells are left alone */
+    ASSERT_EQ(rdrbox(ELEM_GAMMA), gamma);
+    ASSERT_TRUE(foil_rect_is_equal(&gamma->ctnt_rect, &gamma_rc));
+    ASSERT_EQ(win->page.cells[y][0].uc, (uint32_t)'#');
+}
+
+TEST_F(udom_update, relayout_containing_block)
+{
+    foil_rdrbox *gamma = rdrbox(ELEM_GAMMA);
+    ASSERT_NE(gamma, nullptr);
+    int gamma_row = row_of(gamma);
+
+    /* the box is higher by a row, so the following boxes move down */
+    const char *content = "<div>one</div><div>two</div>";
+    pcdoc_node node = pcdoc_element_new_content(doc, element(ELEM_BETA),
+            PCDOC_OP_DISPLACE, content, strlen(content));
+    ASSERT_NE(node.type, PCDOC_NODE_VOID);
+    ASSERT_EQ(update(ELEM_BETA, PCRDR_K_OPERATION_DISPLACE, NULL),
+            PCRDR_SC_OK);
+
+    foil_rdrbox *beta = rdrbox(ELEM_BETA);
+    ASSERT_NE(beta, nullptr);
+    ASSERT_EQ(beta->height, 2 * FOIL_PX_GRID_CELL_H);
+    ASSERT_NE(row(row_of(beta)).find("one"), std::string::npos);
+    ASSERT_NE(row(row_of(beta) + 1).find("two"), std::string::npos);
+
+    gamma = rdrbox(ELEM_GAMMA);
+    ASSERT_EQ(row_of(gamma), gamma_row + 1);
+    ASSERT_NE(row(gamma_row + 1).find("gamma"), std::string::npos);
+}
+
+TEST_F(udom_update, display_none)
+{
+    pcdoc_element_t delta = element(ELEM_DELTA);
+    ASSERT_NE(delta, nullptr);
+    ASSERT_EQ(rdrbox(ELEM_DELTA), nullptr);
+
+    /* the changed content of the element generates no box */
+    ASSERT_NE(pcdoc_element_new_text_content(doc, delta,
+                PCDOC_OP_DISPLACE, "DELTA", 5), nullptr);
+    ASSERT_EQ(update(ELEM_DELTA, PCRDR_K_OPERATION_DISPLACE, NULL),
+            PCRDR_SC_OK);
+    ASSERT_EQ(rdrbox(ELEM_DELTA), nullptr);
+
+    /* but the element is rendered once the class is removed */
+    ASSERT_EQ(pcdoc_element_set_attribute(doc, delta, PCDOC_OP_ERASE,
+                "class", NULL, 0), 0);
+    ASSERT_EQ(update(ELEM_DELTA, PCRDR_K_OPERATION_ERASE, "attr.class"),
+            PCRDR_SC_OK);
+
+    foil_rdrbox *box = rdrbox(ELEM_DELTA);
+    ASSERT_NE(box, nullptr);
+    ASSERT_NE(row(row_of(box)).find("DELTA"), std::string::npos);
+
+    /* an element not in the document */
+    int dummy;
+    ASSERT_EQ(foil_udom_update_boxless_element(udom, PTR2U64(&dummy),
+                PCRDR_K_OPERATION_UPDATE, "attr.class", PURC_VARIANT_INVALID),
+            PCRDR_SC_NOT_FOUND);
+}
+
@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <gtest/gtest.h>
+#include <string>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -1069,3 +1070,129 @@ TEST(html, html_parser_specialchars)
 
     printf(" OK\n");
 }
+
+/* the characters which may need escaping, and how they are escaped in the
+   contents and in the attribute values */
+static const struct special_char {
+    const char *chr;
+    const char *in_text;
+    const char *in_attr;
+} special_chars[] = {
+    { "&",              "&amp;",            "&amp;" },
+    { "<",              "&lt;",             "&lt;" },
+    { ">",              "&gt;",             "&gt;" },
+    { "\"",             "\"",               "&quot;" },
+    { "'",              "'",                "&#039;" },
+    { "\t",             "&#9;",             "\t" },
+    { "\xc2\xa0",       "&nbsp;",           "&nbsp;" },
+    { "\xc2\xa9",       "\xc2\xa9",         "\xc2\xa9" },
+    { "\xc3\xa9",       "\xc3\xa9",         "\xc3\xa9" },
+    { "\xe2\x80\x8b",   "&ZeroWidthSpace;", "&ZeroWidthSpace;" },
+    { "\xe2\x80\x94",   "\xe2\x80\x94",     "\xe2\x80\x94" },
+};
+
+/* the lengths around the blocks of 16 bytes scanned at once */
+static const size_t scan_lengths[] = { 1, 15, 16, 17, 31, 32, 33, 48 };
+
+static std::string
+replace_char(char first, size_t len, size_t pos, const char *chr)
+{
+    std::string str;
+    for (size_t i = 0; i < len; i++) {
+        if (i == pos)
+            str += chr;
+        else
+            str += (char)(first + i % 26);
+    }
+    return str;
+}
+
+static std::string
+repeat_char(size_t len, const char *chr)
+{
+    std::string str;
+    for (size_t i = 0; i < len; i++)
+        str += chr;
+    return str;
+}
+
+static std::string
+serialize_body(purc_document_t doc)
+{
+    std::string result;
+    purc_rwstream_t out = purc_rwstream_new_buffer(1024, 1024 * 1024);
+    if (out == NULL)
+        return result;
+
+    if (pcdoc_serialize_descendants_to_stream(doc, purc_document_body(doc),
+                PCDOC_SERIALIZE_OPT_WITHOUT_TEXT_INDENT |
+                PCDOC_SERIALIZE_OPT_READABLE_C0CTRLS, out) == 0) {
+        size_t sz_content = 0;
+        const char *buf = (const char *)purc_rwstream_get_mem_buffer(out,
+                &sz_content);
+        result.assign(buf, sz_content);
+    }
+
+    purc_rwstream_destroy(out);
+    return result;
+}
+
+static void
+check_escaping(purc_document_t doc, pcdoc_element_t elem,
+        const std::string &text, const std::string &attr,
+        const std::string &escaped_text, const std::string &escaped_attr)
+{
+    /* the brackets delimit the contents in the result */
+    std::string delimited = "[" + text + "]";
+    ASSERT_NE(pcdoc_element_new_text_content(doc, elem, PCDOC_OP_DISPLACE,
+                delimited.c_str(), delimited.length()), nullptr);
+    ASSERT_EQ(pcdoc_element_set_attribute(doc, elem, PCDOC_OP_UPDATE,
+                "title", attr.c_str(), attr.length()), 0);
+
+    std::string result = serialize_body(doc);
+    ASSERT_NE(result.find("title=\"" + escaped_attr + "\""),
+            std::string::npos) << result;
+    ASSERT_NE(result.find("[" + escaped_text + "]"),
+            std::string::npos) << result;
+}
+
+TEST(html, html_serialize_special_chars)
+{
+    static const char html[] = "<html><body><p>text</p></body></html>";
+
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex (PURC_MODULE_HTML, "cn.fmsoft.hybridos.test",
+            "test_init", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    purc_document_t doc = purc_document_load(PCDOC_K_TYPE_HTML,
+            html, sizeof(html) - 1);
+    ASSERT_NE(doc, nullptr);
+    pcdoc_element_t elem = pcdoc_element_get_child_element(doc,
+            purc_document_body(doc), 0);
+    ASSERT_NE(elem, nullptr);
+
+    for (size_t i = 0; i < PCA_TABLESIZE(special_chars); i++) {
+        const struct special_char *sc = special_chars + i;
+
+        for (size_t j = 0; j < PCA_TABLESIZE(scan_lengths); j++) {
+            size_t len = scan_lengths[j];
+
+            for (size_t pos = 0; pos < len; pos++) {
+                check_escaping(doc, elem,
+                        replace_char('A', len, pos, sc->chr),
+                        replace_char('a', len, pos, sc->chr),
+                        replace_char('A', len, pos, sc->in_text),
+                        replace_char('a', len, pos, sc->in_attr));
+            }
+
+            std::string run = repeat_char(len, sc->chr);
+            check_escaping(doc, elem, run, run,
+                    repeat_char(len, sc->in_text),
+                    repeat_char(len, sc->in_attr));
+        }
+    }
+
+    purc_document_delete(doc);
+    purc_cleanup ();
+}
@@ -895,3 +895,56 @@ TEST(interpreter, basic)
     purc_run(NULL);
 }
 
+
+TEST(interpreter, profiler)
+{
+    PurCInstance purc("cn.fmsoft.hybridos.test", "interpreter", false);
+
+    ASSERT_TRUE(purc);
+
+    int ret = purc_profiler_start(10000);
+    if (ret == PURC_ERROR_NOT_SUPPORTED)
+        return;
+    ASSERT_EQ(ret, PURC_ERROR_OK);
+
+    for (int i = 0; i < 20; ++i) {
+        purc_vdom_t vdom = purc_load_hvml_from_string(fibonacci_3);
+        ASSERT_NE(vdom, nullptr);
+        purc_schedule_vdom_null(vdom);
+    }
+
+    purc_run(NULL);
+    ASSERT_EQ(purc_profiler_stop(), PURC_ERROR_OK);
+
+    purc_rwstream_t stm = purc_rwstream_new_buffer(0, 0);
+    ASSERT_NE(stm, nullptr);
+
+    ssize_t nr_stacks = purc_profiler_dump(stm, true);
+    ASSERT_GE(nr_stacks, 0);
+
+    size_t sz = 0;
+    const char *folded = (const char *)purc_rwstream_get_mem_buffer(stm, &sz);
+    if (nr_stacks > 0) {
+        // every line is a collapsed stack followed by the count
+        std::string text(folded, sz);
+        size_t lines = 0, pos = 0, eol;
+        while ((eol = text.find('\n', pos)) != std::string::npos) {
+            std::string line = text.substr(pos, eol - pos);
+            size_t sp = line.rfind(' ');
+            ASSERT_NE(sp, std::string::npos);
+            ASSERT_GT(atoi(line.c_str() + sp + 1), 0);
+            if (line.find("[scheduler]") != 0) {
+                ASSERT_NE(line.find(";hvml@1:"), std::string::npos);
+            }
+            lines++;
+            pos = eol + 1;
+        }
+        ASSERT_EQ(lines, (size_t)nr_stacks);
+    }
+    purc_rwstream_destroy(stm);
+
+    // the samples have been reset
+    stm = purc_rwstream_new_buffer(0, 0);
+    ASSERT_EQ(purc_profiler_dump(stm, false), 0);
+    purc_rwstream_destroy(stm);
+}
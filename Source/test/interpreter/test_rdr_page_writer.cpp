@@ -0,0 +1,239 @@
+/*
+ * @file test_rdr_page_writer.cpp
+ * @date 2026/10/19
+ * @brief The program to test the loading of the page contents to the
+ *      renderer: the large contents are sent in chunks cut at the
+ *      boundaries of the UTF-8 characters.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG
+
+#include "purc/purc.h"
+#include "private/interpreter.h"
+#include "private/pcrdr.h"
+#include "../helpers.h"
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#define LOG_FILE            "/tmp/" APP_NAME ".rdr_page_writer.log"
+#define LEN_ONE_WRITE       (1024 * 10)
+#define NR_PARAGRAPHS       100
+
+/* U+6C49, three bytes in UTF-8 */
+#define HAN_CHAR            "\xe6\xb1\x89"
+
+#define SERIALIZE_OPTS  (PCDOC_SERIALIZE_OPT_SKIP_WS_NODES |                \
+        PCDOC_SERIALIZE_OPT_WITHOUT_TEXT_INDENT |                           \
+        PCDOC_SERIALIZE_OPT_FULL_DOCTYPE)
+
+struct rdr_request {
+    std::string operation;
+    std::string data;
+};
+
+/* the requests loading the contents in the log of the headless renderer */
+static std::vector<rdr_request> read_load_requests(const char *log_file)
+{
+    std::vector<rdr_request> requests;
+    std::ifstream in(log_file, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string log = ss.str();
+
+    size_t pos = 0;
+    while ((pos = log.find("operation:", pos)) != std::string::npos) {
+        pos += sizeof("operation:") - 1;
+        size_t eol = log.find('\n', pos);
+        if (eol == std::string::npos)
+            break;
+
+        rdr_request request;
+        request.operation = log.substr(pos, eol - pos);
+
+        size_t len_pos = log.find("dataLen:", eol);
+        if (len_pos == std::string::npos)
+            break;
+        size_t len = strtoul(log.c_str() + len_pos + sizeof("dataLen:") - 1,
+                NULL, 10);
+        pos = log.find('\n', len_pos) + 1;
+        if (log.compare(pos, 2, " \n") != 0)
+            break;
+        pos += 2;
+        request.data = log.substr(pos, len);
+        pos += len;
+
+        if (request.operation == "load" ||
+                request.operation == "writeBegin" ||
+                request.operation == "writeMore" ||
+                request.operation == "writeEnd")
+            requests.push_back(request);
+    }
+
+    return requests;
+}
+
+static std::string serialize(purc_document_t doc)
+{
+    purc_rwstream_t out = purc_rwstream_new_buffer(1024, 1024 * 1024);
+    if (out == NULL)
+        return "";
+
+    std::string contents;
+    if (purc_document_serialize_contents_to_stream(doc,
+                SERIALIZE_OPTS, out) == 0) {
+        size_t sz_content = 0;
+        const char *buf = (const char *)purc_rwstream_get_mem_buffer(out,
+                &sz_content);
+        contents.assign(buf, sz_content);
+    }
+
+    purc_rwstream_destroy(out);
+    return contents;
+}
+
+static uint64_t create_plain_window(pcrdr_conn *conn)
+{
+    pcrdr_msg *request, *response = NULL;
+    uint64_t handle = 0;
+
+    request = pcrdr_make_request_message(PCRDR_MSG_TARGET_WORKSPACE, 0,
+            PCRDR_OPERATION_CREATEPLAINWINDOW, NULL, NULL,
+            PCRDR_MSG_ELEMENT_TYPE_VOID, NULL, NULL,
+            PCRDR_MSG_DATA_TYPE_VOID, NULL, 0);
+    if (request == NULL)
+        return 0;
+
+    if (pcrdr_send_request_and_wait_response(conn, request,
+                PCRDR_TIME_DEF_EXPECTED, &response) == 0 && response) {
+        if (response->retCode == PCRDR_SC_OK)
+            handle = response->resultValue;
+        pcrdr_release_message(response);
+    }
+
+    pcrdr_release_message(request);
+    return handle;
+}
+
+static int load_page(pcrdr_conn *conn, uint64_t page, purc_document_t doc)
+{
+    pcrdr_msg *response;
+    int ret_code;
+
+    response = pcintr_rdr_load_page_contents(conn,
+            PCRDR_MSG_TARGET_PLAINWINDOW, page, PCRDR_MSG_DATA_TYPE_HTML,
+            doc, SERIALIZE_OPTS);
+    if (response == NULL)
+        return -1;
+
+    ret_code = response->retCode;
+    pcrdr_release_message(response);
+    return ret_code;
+}
+
+TEST(interpreter, rdr_page_writer)
+{
+    struct purc_instance_extra_info info = { };
+    info.renderer_comm = PURC_RDRCOMM_HEADLESS;
+    info.renderer_uri = "file://" LOG_FILE;
+
+    /* the multibyte characters are shifted by the leading bytes, so the
+       chunks have to be cut at different offsets to keep them whole */
+    std::string large = "<html><body>";
+    for (int i = 0; i < NR_PARAGRAPHS; i++) {
+        large += "<p>";
+        large += std::string(i % 7 + 1, 'a');
+        for (int j = 0; j < 100; j++)
+            large += HAN_CHAR;
+        large += "</p>";
+    }
+    large += "</body></html>";
+
+    const char *small = "<html><body><p>small</p></body></html>";
+
+    std::string large_contents, small_contents;
+
+    unlink(LOG_FILE);
+    {
+        PurCInstance purc(PURC_MODULE_HVML, APP_NAME, "rdr_page_writer",
+                &info);
+        ASSERT_TRUE(purc);
+
+        pcrdr_conn *conn = purc_get_conn_to_renderer();
+        ASSERT_NE(conn, nullptr);
+        uint64_t page = create_plain_window(conn);
+        ASSERT_NE(page, (uint64_t)0);
+
+        purc_document_t doc = purc_document_load(PCDOC_K_TYPE_HTML,
+                large.c_str(), large.length());
+        ASSERT_NE(doc, nullptr);
+        large_contents = serialize(doc);
+        ASSERT_GT(large_contents.length(), 2U * LEN_ONE_WRITE);
+        ASSERT_EQ(load_page(conn, page, doc), PCRDR_SC_OK);
+        purc_document_delete(doc);
+
+        doc = purc_document_load(PCDOC_K_TYPE_HTML, small, strlen(small));
+        ASSERT_NE(doc, nullptr);
+        small_contents = serialize(doc);
+        ASSERT_EQ(load_page(conn, page, doc), PCRDR_SC_OK);
+        purc_document_delete(doc);
+    }
+
+    /* the log is complete once the connection is closed */
+    std::vector<rdr_request> requests = read_load_requests(LOG_FILE);
+    ASSERT_GE(requests.size(), 4U);
+
+    /* the large contents are written in the chunks... */
+    size_t nr_chunks = requests.size() - 1;
+    std::string written;
+    for (size_t i = 0; i < nr_chunks; i++) {
+        const std::string &chunk = requests[i].data;
+        if (i == 0) {
+            ASSERT_EQ(requests[i].operation, "writeBegin");
+        }
+        else if (i == nr_chunks - 1) {
+            ASSERT_EQ(requests[i].operation, "writeEnd");
+        }
+        else {
+            ASSERT_EQ(requests[i].operation, "writeMore");
+        }
+
+        ASSERT_LE(chunk.length(), (size_t)LEN_ONE_WRITE);
+        if (i < nr_chunks - 1) {
+            ASSERT_GT(chunk.length(), (size_t)LEN_ONE_WRITE - 3);
+        }
+
+        /* no chunk starts in the middle of a character */
+        ASSERT_FALSE(chunk.empty());
+        ASSERT_NE((unsigned char)chunk[0] & 0xC0, 0x80);
+        written += chunk;
+    }
+    ASSERT_EQ(written, large_contents);
+
+    /* ...and the small ones are loaded at once */
+    ASSERT_EQ(requests[nr_chunks].operation, "load");
+    ASSERT_EQ(requests[nr_chunks].data, small_contents);
+
+    unlink(LOG_FILE);
+}
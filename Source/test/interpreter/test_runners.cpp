@@ -8,6 +8,7 @@
  *      - purc_get_rid_by_cid()
  *      - purc_inst_ask_to_shutdown()
  *      - purc_schedule_vdom()
+ *      - purc_inst_prewarm()
  *      - Instance Manager/Move Buffer
  *
  * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
@@ -223,3 +224,82 @@ TEST(interpreter, runners)
     purc_variant_unref(toolkit_style);
 }
 
+/* waits for the instance of the runner to come up or go away */
+static bool wait_for_runner(const char *runner_name, bool up)
+{
+    char endpoint[PURC_LEN_ENDPOINT_NAME + 1];
+    purc_assemble_endpoint_name(PCRDR_LOCALHOST, APP_NAME, runner_name,
+            endpoint);
+
+    for (unsigned int seconds = 0; seconds < 10; seconds++) {
+        purc_atom_t atom = purc_atom_try_string_ex(PURC_ATOM_BUCKET_DEF,
+                endpoint);
+        if ((atom != 0) == up)
+            return true;
+        purc_log_info("Wait for the instance %s...\n", runner_name);
+        sleep(1);
+    }
+
+    return false;
+}
+
+TEST(interpreter, prewarmed_runners)
+{
+    struct purc_instance_extra_info inst_info = { };
+    inst_info.renderer_comm = PURC_RDRCOMM_HEADLESS;
+    inst_info.workspace_name = "main";
+
+    PurCInstance purc(PURC_MODULE_HVML, APP_NAME, "main", &inst_info);
+    ASSERT_TRUE(purc);
+
+    ASSERT_EQ(purc_inst_prewarm(APP_NAME, 2, NULL, &worker_info), 2);
+
+    /* only one app can have the pre-warmed instances */
+    ASSERT_EQ(purc_inst_prewarm("cn.fmsoft.hvml.other", 1, NULL, NULL), -1);
+
+    /* the instances are pre-warmed when the instance manager is idle */
+    ASSERT_TRUE(wait_for_runner("_spare0", true));
+    ASSERT_TRUE(wait_for_runner("_spare1", true));
+
+    /* one of the pre-warmed instances is handed out */
+    purc_atom_t inst = purc_inst_create_or_get(APP_NAME,
+            PURC_RUNNER_NAME_SPARE, NULL, NULL);
+    ASSERT_NE(inst, 0);
+
+    char runner_name[PURC_LEN_RUNNER_NAME + 1];
+    purc_extract_runner_name(purc_atom_to_string(inst), runner_name);
+    ASSERT_TRUE(strcmp(runner_name, "_spare0") == 0 ||
+            strcmp(runner_name, "_spare1") == 0);
+
+    /* the other one exits before being handed out */
+    const char *other = strcmp(runner_name, "_spare0") ? "_spare0" : "_spare1";
+    char endpoint[PURC_LEN_ENDPOINT_NAME + 1];
+    purc_assemble_endpoint_name(PCRDR_LOCALHOST, APP_NAME, other, endpoint);
+    purc_atom_t dead = purc_atom_try_string_ex(PURC_ATOM_BUCKET_DEF,
+            endpoint);
+    ASSERT_NE(dead, 0);
+    purc_inst_ask_to_shutdown(dead);
+    ASSERT_TRUE(wait_for_runner(other, false));
+
+    /* stop refilling; the next one is not the dead instance */
+    ASSERT_EQ(purc_inst_prewarm(APP_NAME, 0, NULL, NULL), 0);
+
+    purc_atom_t insts[2] = { inst, 0 };
+    insts[1] = purc_inst_create_or_get(APP_NAME,
+            PURC_RUNNER_NAME_SPARE, NULL, &worker_info);
+    ASSERT_NE(insts[1], 0);
+    ASSERT_NE(insts[1], dead);
+    ASSERT_NE(purc_atom_to_string(insts[1]), nullptr);
+
+    for (int i = 0; i < 2; i++) {
+        purc_inst_ask_to_shutdown(insts[i]);
+
+        unsigned int seconds = 0;
+        while (purc_atom_to_string(insts[i])) {
+            purc_log_info("Wait for termination of instance %d...\n", i);
+            sleep(1);
+            seconds++;
+            ASSERT_LT(seconds, 10);
+        }
+    }
+}
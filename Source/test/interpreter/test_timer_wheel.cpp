@@ -0,0 +1,195 @@
+/*
+ * @file test_timer_wheel.cpp
+ * @date 2026/10/19
+ * @brief The test for the timer wheel used by $TIMERS; see also
+ *      Source/benchmarks/bench_timers.c.
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG
+
+#include "purc/purc.h"
+#include "purc/purc-runloop.h"
+#include "private/timer.h"
+#include "../helpers.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+#include <unistd.h>
+
+#define NR_MANY_TIMERS      100000
+#define NR_FIRE_TIMERS      1000
+#define FAR_INTERVAL        (3U * 24 * 3600 * 1000)    // three days
+
+struct fire_ctxt {
+    size_t      nr_fired;
+    size_t      nr_expected;
+};
+
+static void
+on_fire(pcintr_timer_t timer, const char *id, void *data)
+{
+    (void)timer;
+    (void)id;
+    struct fire_ctxt *ctxt = (struct fire_ctxt *)data;
+    ctxt->nr_fired++;
+    if (ctxt->nr_fired == ctxt->nr_expected) {
+        purc_runloop_stop(purc_runloop_get_current());
+    }
+}
+
+TEST(timer_wheel, fire)
+{
+    PurCInstance purc(false);
+    ASSERT_TRUE(purc);
+
+    pcintr_timer_wheel_t wheel = pcintr_timer_wheel_create(NULL);
+    ASSERT_NE(wheel, nullptr);
+
+    struct fire_ctxt ctxt = { 0, NR_FIRE_TIMERS };
+    std::vector<pcintr_timer_t> timers;
+    for (size_t i = 0; i < NR_FIRE_TIMERS; i++) {
+        pcintr_timer_t timer = pcintr_timer_create_in_wheel(wheel, NULL,
+                on_fire, &ctxt);
+        ASSERT_NE(timer, nullptr);
+        pcintr_timer_set_interval(timer, 1 + i % 50);
+        pcintr_timer_start_oneshot(timer);
+        timers.push_back(timer);
+    }
+    ASSERT_EQ(pcintr_timer_wheel_count(wheel), NR_FIRE_TIMERS);
+
+    purc_runloop_run();
+
+    ASSERT_EQ(ctxt.nr_fired, NR_FIRE_TIMERS);
+    ASSERT_EQ(pcintr_timer_wheel_count(wheel), 0);
+
+    for (size_t i = 0; i < timers.size(); i++) {
+        ASSERT_FALSE(pcintr_timer_is_active(timers[i]));
+        pcintr_timer_destroy(timers[i]);
+    }
+    pcintr_timer_wheel_destroy(wheel);
+}
+
+TEST(timer_wheel, repeat_and_stop)
+{
+    PurCInstance purc(false);
+    ASSERT_TRUE(purc);
+
+    pcintr_timer_wheel_t wheel = pcintr_timer_wheel_create(NULL);
+    ASSERT_NE(wheel, nullptr);
+
+    struct fire_ctxt ctxt = { 0, 10 };
+    pcintr_timer_t timer = pcintr_timer_create_in_wheel(wheel, "repeat",
+            on_fire, &ctxt);
+    pcintr_timer_set_interval(timer, 5);
+    pcintr_timer_start(timer);
+
+    /* a stopped timer must never fire */
+    struct fire_ctxt stopped = { 0, 1 };
+    pcintr_timer_t other = pcintr_timer_create_in_wheel(wheel, "stopped",
+            on_fire, &stopped);
+    pcintr_timer_set_interval(other, 1);
+    pcintr_timer_start(other);
+    pcintr_timer_stop(other);
+
+    purc_runloop_run();
+
+    ASSERT_EQ(ctxt.nr_fired, 10);
+    ASSERT_EQ(stopped.nr_fired, 0);
+    ASSERT_TRUE(pcintr_timer_is_active(timer));
+
+    pcintr_timer_destroy(timer);
+    pcintr_timer_destroy(other);
+    ASSERT_EQ(pcintr_timer_wheel_count(wheel), 0);
+    pcintr_timer_wheel_destroy(wheel);
+}
+
+/* A timer days away must not make the wheel step over the empty ticks,
+   and a timer started after the wheel slept must fire on time. */
+TEST(timer_wheel, far_future)
+{
+    PurCInstance purc(false);
+    ASSERT_TRUE(purc);
+
+    pcintr_timer_wheel_t wheel = pcintr_timer_wheel_create(NULL);
+    ASSERT_NE(wheel, nullptr);
+
+    struct fire_ctxt far = { 0, 1 };
+    pcintr_timer_t far_timer = pcintr_timer_create_in_wheel(wheel, "far",
+            on_fire, &far);
+    pcintr_timer_set_interval(far_timer, FAR_INTERVAL);
+    pcintr_timer_start_oneshot(far_timer);
+
+    struct fire_ctxt near = { 0, 1 };
+    pcintr_timer_t near_timer = pcintr_timer_create_in_wheel(wheel, "near",
+            on_fire, &near);
+    for (int i = 0; i < 3; i++) {
+        /* the wheel is not driven while sleeping */
+        usleep(100000);
+
+        auto start = std::chrono::steady_clock::now();
+        near.nr_fired = 0;
+        pcintr_timer_set_interval(near_timer, 20);
+        pcintr_timer_start_oneshot(near_timer);
+        purc_runloop_run();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        ASSERT_EQ(near.nr_fired, 1);
+        ASSERT_GE(elapsed, 19);
+        ASSERT_LT(elapsed, 500);
+    }
+
+    ASSERT_EQ(far.nr_fired, 0);
+    ASSERT_TRUE(pcintr_timer_is_active(far_timer));
+    ASSERT_EQ(pcintr_timer_wheel_count(wheel), 1);
+
+    pcintr_timer_destroy(near_timer);
+    pcintr_timer_destroy(far_timer);
+    ASSERT_EQ(pcintr_timer_wheel_count(wheel), 0);
+    pcintr_timer_wheel_destroy(wheel);
+}
+
+TEST(timer_wheel, start_cancel_many)
+{
+    PurCInstance purc(false);
+    ASSERT_TRUE(purc);
+
+    struct fire_ctxt ctxt = { 0, 0 };
+    std::vector<pcintr_timer_t> timers(NR_MANY_TIMERS);
+
+    pcintr_timer_wheel_t wheel = pcintr_timer_wheel_create(NULL);
+    ASSERT_NE(wheel, nullptr);
+
+    for (size_t i = 0; i < NR_MANY_TIMERS; i++) {
+        timers[i] = pcintr_timer_create_in_wheel(wheel, NULL, on_fire, &ctxt);
+        ASSERT_NE(timers[i], nullptr);
+        pcintr_timer_set_interval(timers[i], 100 + i % 60000);
+        pcintr_timer_start(timers[i]);
+    }
+    ASSERT_EQ(pcintr_timer_wheel_count(wheel), NR_MANY_TIMERS);
+
+    for (size_t i = 0; i < NR_MANY_TIMERS; i++) {
+        pcintr_timer_destroy(timers[i]);
+    }
+    ASSERT_EQ(pcintr_timer_wheel_count(wheel), 0);
+    ASSERT_EQ(ctxt.nr_fired, 0);
+    pcintr_timer_wheel_destroy(wheel);
+}
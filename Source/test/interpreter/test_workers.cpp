@@ -0,0 +1,143 @@
+/*
+ * @file test_workers.cpp
+ * @date 2026/10/19
+ * @brief The program to test the pool of worker runners; the following
+ *      APIs covered:
+ *      - purc_inst_create_workers()
+ *      - purc_inst_get_nr_workers()
+ *      - pcrun_workers_pick()
+ *
+ * Copyright (C) 2022 FMSoft <https://www.fmsoft.cn>
+ *
+ * This file is a part of PurC (short for Purring Cat), an HVML interpreter.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#undef NDEBUG
+
+#include "purc/purc.h"
+#include "private/runners.h"
+#include "../helpers.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#define NR_WORKERS      3
+#define NR_PLACEMENTS   4
+
+#define OTHER_APP_NAME  "cn.fmsoft.hvml.test.workers"
+
+static int shutdown_workers(purc_atom_t *rids, size_t nr)
+{
+    for (size_t i = 0; i < nr; i++) {
+        purc_inst_ask_to_shutdown(rids[i]);
+
+        unsigned int seconds = 0;
+        while (purc_atom_to_string(rids[i])) {
+            purc_log_info("Wait for termination of worker %u...\n",
+                    (unsigned)i);
+            sleep(1);
+            seconds++;
+            if (seconds >= 10)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int worker_index(const char *runner_name)
+{
+    size_t len = sizeof("_worker") - 1;
+    if (strncmp(runner_name, "_worker", len))
+        return -1;
+    return atoi(runner_name + len);
+}
+
+TEST(interpreter, workers)
+{
+    struct purc_instance_extra_info inst_info = { };
+    inst_info.renderer_comm = PURC_RDRCOMM_HEADLESS;
+    inst_info.workspace_name = "main";
+
+    char runner_name[PURC_LEN_RUNNER_NAME + 1];
+    purc_atom_t rids[NR_WORKERS] = { };
+
+    {
+        PurCInstance purc(PURC_MODULE_HVML, APP_NAME, "main", &inst_info);
+        ASSERT_TRUE(purc);
+
+        ASSERT_EQ(purc_inst_get_nr_workers(), 0);
+        ASSERT_EQ(purc_inst_create_workers(NR_WORKERS), NR_WORKERS);
+        ASSERT_EQ(purc_inst_get_nr_workers(), NR_WORKERS);
+
+        /* the existing pool is returned */
+        ASSERT_EQ(purc_inst_create_workers(1), NR_WORKERS);
+
+        /* not for another app */
+        ASSERT_EQ(pcrun_workers_pick(OTHER_APP_NAME,
+                    runner_name, sizeof(runner_name)), 0);
+
+        /* a burst of placements is spread over the workers evenly; the
+           idle workers report their loads meanwhile, which must not
+           forget the coroutines placed but not arrived yet */
+        size_t counts[NR_WORKERS] = { };
+        for (int i = 0; i < NR_WORKERS * NR_PLACEMENTS; i++) {
+            purc_atom_t rid = pcrun_workers_pick(APP_NAME,
+                    runner_name, sizeof(runner_name));
+            ASSERT_NE(rid, 0);
+
+            int idx = worker_index(runner_name);
+            ASSERT_GE(idx, 0);
+            ASSERT_LT(idx, NR_WORKERS);
+            ASSERT_TRUE(rids[idx] == 0 || rids[idx] == rid);
+            rids[idx] = rid;
+            counts[idx]++;
+
+            if (i % NR_WORKERS == 0)
+                usleep(20000);
+        }
+
+        for (int i = 0; i < NR_WORKERS; i++) {
+            ASSERT_EQ(counts[i], NR_PLACEMENTS);
+        }
+
+        ASSERT_EQ(shutdown_workers(rids, NR_WORKERS), 0);
+    }
+
+    /* the pool is reset when the instance created it is cleaned up */
+    {
+        PurCInstance purc(PURC_MODULE_HVML, OTHER_APP_NAME, "main",
+                &inst_info);
+        ASSERT_TRUE(purc);
+
+        ASSERT_EQ(purc_inst_get_nr_workers(), 0);
+        ASSERT_EQ(pcrun_workers_pick(APP_NAME,
+                    runner_name, sizeof(runner_name)), 0);
+
+        ASSERT_EQ(purc_inst_create_workers(2), 2);
+        for (int i = 0; i < 2; i++) {
+            rids[i] = pcrun_workers_pick(OTHER_APP_NAME,
+                    runner_name, sizeof(runner_name));
+            ASSERT_NE(rids[i], 0);
+            ASSERT_STREQ(purc_atom_to_string(rids[i]) +
+                    strlen(purc_atom_to_string(rids[i])) -
+                    strlen(runner_name), runner_name);
+        }
+        ASSERT_NE(rids[0], rids[1]);
+
+        ASSERT_EQ(shutdown_workers(rids, 2), 0);
+    }
+}
@@ -21,6 +21,7 @@
 
 #include "purc/purc-rwstream.h"
 #include "purc/purc-utils.h"
+#include "private/rwstream.h"
 #include "config.h"
 
 #include <stdio.h>
@@ -1353,3 +1354,100 @@ TEST(dump_rwstream, mem_buffer)
     ret = purc_rwstream_destroy (rws);
     ASSERT_EQ(ret, 0);
 }
+
+struct chunked_source {
+    const char *data;
+    size_t len;
+    size_t pos;
+    bool released;
+};
+
+static ssize_t chunked_read(void *ctxt, void *buf, size_t count)
+{
+    struct chunked_source *src = (struct chunked_source *)ctxt;
+    /* deliver at most 3 bytes per read, like a body being received */
+    size_t n = src->len - src->pos;
+    if (n > 3)
+        n = 3;
+    if (n > count)
+        n = count;
+    memcpy(buf, src->data + src->pos, n);
+    src->pos += n;
+    return n;
+}
+
+static void chunked_release(void *ctxt)
+{
+    struct chunked_source *src = (struct chunked_source *)ctxt;
+    src->released = true;
+}
+
+TEST(read_rwstream, release)
+{
+    const char json[] = "{\"a\":[1,2,3],\"b\":\"这是测试\"}";
+    struct chunked_source src = { json, strlen(json), 0, false };
+
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_EJSON, "cn.fmsoft.hybridos.test",
+            "read_rwstream", &info);
+    ASSERT_EQ(ret, PURC_ERROR_OK);
+
+    purc_rwstream_t rws = pcrwstream_new_for_read_ex(&src,
+            chunked_read, chunked_release);
+    ASSERT_NE(rws, nullptr);
+
+    purc_variant_t v = purc_variant_load_from_json_stream(rws);
+    ASSERT_NE(v, PURC_VARIANT_INVALID);
+    ASSERT_TRUE(purc_variant_is_object(v));
+    ASSERT_EQ(purc_rwstream_tell(rws), (off_t)strlen(json));
+    purc_variant_unref(v);
+
+    ASSERT_FALSE(src.released);
+    ret = purc_rwstream_destroy(rws);
+    ASSERT_EQ(ret, 0);
+    ASSERT_TRUE(src.released);
+
+    purc_cleanup();
+}
+
+static void mem_release(void *ctxt)
+{
+    *(bool *)ctxt = true;
+}
+
+TEST(mem_rwstream, new_from_mem_ex)
+{
+    const char buf[] = "read-only memory";
+    bool released = false;
+    char out[32] = {};
+    size_t sz_content = 0;
+
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_EJSON, "cn.fmsoft.hybridos.test",
+            "mem_rwstream", &info);
+    ASSERT_EQ(ret, PURC_ERROR_OK);
+
+    purc_rwstream_t rws = pcrwstream_new_from_mem_ex(buf, strlen(buf),
+            &released, mem_release);
+    ASSERT_NE(rws, nullptr);
+
+    void *mem = purc_rwstream_get_mem_buffer(rws, &sz_content);
+    ASSERT_EQ(mem, (void *)buf);
+    ASSERT_EQ(sz_content, strlen(buf));
+
+    ssize_t n = purc_rwstream_read(rws, out, sizeof(out));
+    ASSERT_EQ(n, (ssize_t)strlen(buf));
+    ASSERT_STREQ(out, buf);
+
+    /* the memory is not writable through the stream */
+    ASSERT_EQ(purc_rwstream_seek(rws, 0, SEEK_SET), 0);
+    ASSERT_EQ(purc_rwstream_write(rws, "x", 1), -1);
+    ASSERT_EQ(buf[0], 'r');
+
+    ASSERT_FALSE(released);
+    ret = purc_rwstream_destroy(rws);
+    ASSERT_EQ(ret, 0);
+    ASSERT_TRUE(released);
+
+    purc_cleanup();
+}
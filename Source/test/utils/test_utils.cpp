@@ -28,6 +28,8 @@
 #include "private/atom-buckets.h"
 #include "private/sorted-array.h"
 #include "private/url.h"
+#include "private/utils.h"
+#include "private/cpu.h"
 
 #include "../helpers.h"
 
@@ -36,6 +38,9 @@
 #include <stdio.h>
 #include <errno.h>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #define ATOM_BUCKET     1
 
@@ -180,6 +185,51 @@ TEST(utils, atom_ex)
     purc_cleanup ();
 }
 
+#define NR_ATOM_THREADS         8
+#define NR_ATOMS_PER_THREAD     1000
+
+static void
+lookup_atoms(int id, std::atomic<int> *nr_errors)
+{
+    char buf[64];
+
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < NR_ATOMS_PER_THREAD; i++) {
+            /* the even atoms are shared, the odd ones are per thread */
+            snprintf(buf, sizeof(buf), "atom-%d-%d", (i & 1) ? id : 0, i);
+            purc_atom_t atom = purc_atom_from_string_ex(ATOM_BUCKET_DEF, buf);
+            if (atom == 0 ||
+                    purc_atom_try_string_ex(ATOM_BUCKET_DEF, buf) != atom ||
+                    strcmp(purc_atom_to_string(atom), buf))
+                (*nr_errors)++;
+        }
+    }
+}
+
+// to test the lookups from multiple threads
+TEST(utils, atom_threads)
+{
+    int ret = purc_init_ex(PURC_MODULE_UTILS, "cn.fmsoft.hybridos.test",
+            "utils", NULL);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    std::atomic<int> nr_errors(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NR_ATOM_THREADS; i++)
+        threads.push_back(std::thread(lookup_atoms, i + 1, &nr_errors));
+    for (auto &t : threads)
+        t.join();
+    ASSERT_EQ(nr_errors, 0);
+
+    /* the removed atom must not be returned from the cache */
+    purc_atom_t atom = purc_atom_try_string_ex(ATOM_BUCKET_DEF, "atom-0-0");
+    ASSERT_NE(atom, 0);
+    ASSERT_TRUE(purc_atom_remove_string_ex(ATOM_BUCKET_DEF, "atom-0-0"));
+    ASSERT_EQ(purc_atom_try_string_ex(ATOM_BUCKET_DEF, "atom-0-0"), 0);
+
+    purc_cleanup ();
+}
+
 enum {
     ID_EXCEPT_BusError = 0,
     ID_EXCEPT_SegFault,
@@ -1316,6 +1366,162 @@ TEST(utils, error)
     ASSERT_STREQ(s, "Timeout");
 }
 
+struct digests {
+    uint32_t        crc32[PURC_K_ALGO_CRC32Q + 1];
+    unsigned char   sha1[SHA1_DIGEST_SIZE];
+    std::string     b64;
+    std::string     hex;
+    std::string     decoded;
+    std::string     unhexed;
+};
+
+static digests
+compute_digests(const unsigned char *data, size_t len)
+{
+    digests d;
+
+    for (int algo = 0; algo <= PURC_K_ALGO_CRC32Q; algo++) {
+        pcutils_crc32_ctxt ctxt;
+        pcutils_crc32_begin(&ctxt, (purc_crc32_algo_t)algo);
+        pcutils_crc32_update(&ctxt, data, len / 3);
+        pcutils_crc32_update(&ctxt, data + len / 3, len - len / 3);
+        pcutils_crc32_end(&ctxt, &d.crc32[algo]);
+    }
+
+    pcutils_sha1_ctxt sha1;
+    pcutils_sha1_begin(&sha1);
+    pcutils_sha1_hash(&sha1, data, len);
+    pcutils_sha1_end(&sha1, d.sha1);
+
+    std::vector<char> b64(pcutils_b64_encoded_length(len));
+    pcutils_b64_encode(data, len, b64.data(), b64.size());
+    d.b64 = b64.data();
+
+    std::vector<unsigned char> decoded(pcutils_b64_decoded_length(d.b64.size()));
+    ssize_t n = pcutils_b64_decode_ex(d.b64.c_str(), d.b64.size(),
+            decoded.data(), decoded.size());
+    if (n >= 0)
+        d.decoded.assign((const char *)decoded.data(), n);
+
+    std::vector<char> hex(len * 2 + 1);
+    pcutils_bin2hex(data, len, hex.data(), true);
+    d.hex = hex.data();
+
+    std::vector<unsigned char> unhexed(len + 1);
+    size_t converted = 0;
+    pcutils_hex2bin_ex(d.hex.c_str(), d.hex.size(), unhexed.data(), &converted);
+    d.unhexed.assign((const char *)unhexed.data(), converted);
+
+    return d;
+}
+
+// the accelerated kernels must give the same results as the portable code
+TEST(utils, checksums_and_codecs)
+{
+    static const uint32_t checks[] = {
+        0xCBF43926, 0xFC891918, 0x0376E6E7, 0x765E7680, 0xBD0BE338,
+        0xE3069283, 0xE3069283, 0x87315576, 0x87315576, 0x340BC6D9,
+        0x3010BF7F, 0x3010BF7F,
+    };
+
+    digests d = compute_digests((const unsigned char *)"123456789", 9);
+    for (int algo = 0; algo <= PURC_K_ALGO_CRC32Q; algo++)
+        ASSERT_EQ(d.crc32[algo], checks[algo]) << "algo: " << algo;
+
+    std::vector<unsigned char> data(4096 + 3);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (unsigned char)(i * 131 + (i >> 7));
+
+    for (size_t len = 0; len < 4096; len += (len < 300) ? 1 : 97) {
+        for (size_t offset = 0; offset < 3; offset++) {
+            const unsigned char *p = data.data() + offset;
+            digests fast = compute_digests(p, len);
+
+            unsigned features = pcutils_cpu_disable_features(~0U);
+            digests slow = compute_digests(p, len);
+            pcutils_cpu_disable_features(0);
+            ASSERT_EQ(pcutils_cpu_features(), features);
+
+            for (int algo = 0; algo <= PURC_K_ALGO_CRC32Q; algo++) {
+                ASSERT_EQ(fast.crc32[algo], slow.crc32[algo])
+                    << "algo: " << algo << ", length: " << len;
+            }
+            ASSERT_EQ(memcmp(fast.sha1, slow.sha1, SHA1_DIGEST_SIZE), 0)
+                << "length: " << len;
+            ASSERT_EQ(fast.b64, slow.b64);
+            ASSERT_EQ(fast.hex, slow.hex);
+            ASSERT_EQ(fast.decoded, std::string((const char *)p, len));
+            ASSERT_EQ(fast.unhexed, std::string((const char *)p, len));
+        }
+    }
+}
+
+TEST(utils, utf8_check_and_count)
+{
+    static const char *chars[] = {
+        "a", "Z", "\xc3\xa9", "\xe4\xb8\xad", "\xf0\x9f\x98\x80",
+        "\xed\x9f\xbf", "\xf4\x8f\xbf\xbf",
+    };
+    static const char *broken[] = {
+        "\x80", "\xc0\x80", "\xe0\x80\x80", "\xed\xa0\x80", "\xf4\x90\x80\x80",
+        "\xf5\x80\x80\x80", "\xc3", "\xe4\xb8", "\xe4\x41", "",
+    };
+
+    srandom(2022);
+    for (int i = 0; i < 2000; i++) {
+        std::string str;
+        size_t len = random() % 300;
+        while (str.length() < len) {
+            /* mostly ASCII, like the most strings in the wild */
+            size_t idx = random() % ((random() % 4) ? 2 : 7);
+            str += chars[idx];
+        }
+        if (i % 2) {
+            size_t idx = random() % 10;
+            size_t pos = random() % (str.length() + 1);
+            /* the empty one stands for a null byte */
+            str.insert(pos, broken[idx], broken[idx][0] ? strlen(broken[idx]) : 1);
+        }
+
+        const char *s = str.c_str();
+        for (ssize_t max : { (ssize_t)str.length(), (ssize_t)-1 }) {
+            size_t fast_chars = 0, slow_chars = 0;
+            const char *fast_end, *slow_end;
+            bool fast_ok = pcutils_string_check_utf8(s, max, &fast_chars,
+                    &fast_end);
+            size_t fast_nr = pcutils_string_utf8_chars(s, max);
+
+            unsigned features = pcutils_cpu_disable_features(~0U);
+            bool slow_ok = pcutils_string_check_utf8(s, max, &slow_chars,
+                    &slow_end);
+            size_t slow_nr = pcutils_string_utf8_chars(s, max);
+            pcutils_cpu_disable_features(0);
+            ASSERT_EQ(pcutils_cpu_features(), features);
+
+            ASSERT_EQ(fast_ok, slow_ok) << "string: " << i;
+            ASSERT_EQ(fast_chars, slow_chars) << "string: " << i;
+            ASSERT_EQ(fast_end, slow_end) << "string: " << i;
+            ASSERT_EQ(fast_nr, slow_nr) << "string: " << i;
+        }
+    }
+
+    size_t len_new;
+    char *lower = pcutils_strtolower("Hello, World! 0123456789 @[`{", -1,
+            &len_new);
+    ASSERT_STREQ(lower, "hello, world! 0123456789 @[`{");
+    ASSERT_EQ(len_new, strlen(lower));
+    free(lower);
+
+    char *upper = pcutils_strtoupper("Hello, World!\0ignored", 20, &len_new);
+    ASSERT_STREQ(upper, "HELLO, WORLD!");
+    ASSERT_EQ(len_new, (size_t)13);
+    free(upper);
+
+    ASSERT_EQ(pcutils_strcasecmp("Content-Type", "content-type"), 0);
+    ASSERT_LT(pcutils_strcasecmp("ABC", "abd"), 0);
+    ASSERT_GT(pcutils_strcasecmp("abd", "ABC"), 0);
+}
+
 TEST(utils, hvml_uri)
 {
     const char *bad_hvml_uri[] = {
@@ -597,3 +597,88 @@ TEST(variant, clone)
     PURC_VARIANT_SAFE_CLEAR(set);
 }
 
+
+static purc_variant_t
+make_number_array(size_t n, size_t modulo)
+{
+    purc_variant_t arr = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+    for (size_t i = 0; i < n; i++) {
+        purc_variant_t v = purc_variant_make_number(i % modulo);
+        purc_variant_array_append(arr, v);
+        purc_variant_unref(v);
+    }
+    return arr;
+}
+
+TEST(variant, container_ops_large)
+{
+    PurCInstance purc("cn.fmsoft.hybridos.test", "purc_variant", false);
+
+    // numbers: every member of src removes one matched member of dst
+    purc_variant_t dst = make_number_array(2000, 1000);
+    purc_variant_t src = make_number_array(1500, 1000);
+    ASSERT_TRUE(pcvariant_container_remove(dst, src, true));
+    ASSERT_EQ(purc_variant_array_get_size(dst), 500);
+    for (size_t i = 0; i < 500; i++) {
+        double d;
+        purc_variant_t v = purc_variant_array_get(dst, i);
+        ASSERT_TRUE(purc_variant_cast_to_number(v, &d, false));
+        ASSERT_EQ(d, 500 + i);
+    }
+    purc_variant_unref(src);
+    purc_variant_unref(dst);
+
+    // strings
+    dst = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+    for (int i = 0; i < 1000; i++) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "s%d", i);
+        purc_variant_t v = purc_variant_make_string(buf, false);
+        purc_variant_array_append(dst, v);
+        purc_variant_unref(v);
+    }
+    src = pcejson_parser_parse_string("['s10', 's10', 's20', 'x']", 0, 0);
+    ASSERT_NE(src, nullptr);
+    ASSERT_TRUE(pcvariant_container_remove(dst, src, true));
+    ASSERT_EQ(purc_variant_array_get_size(dst), 998);
+    ASSERT_STREQ(purc_variant_get_string_const(
+                purc_variant_array_get(dst, 10)), "s11");
+    ASSERT_STREQ(purc_variant_get_string_const(
+                purc_variant_array_get(dst, 19)), "s21");
+    purc_variant_unref(src);
+    purc_variant_unref(dst);
+
+    // numbers against strings fall back to the nested loops
+    dst = make_number_array(100, 100);
+    src = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+    for (int i = 0; i < 20; i++) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%d", i);
+        purc_variant_t v = purc_variant_make_string(buf, false);
+        purc_variant_array_append(src, v);
+        purc_variant_unref(v);
+    }
+    ASSERT_TRUE(pcvariant_container_remove(dst, src, true));
+    ASSERT_EQ(purc_variant_array_get_size(dst), 80);
+    purc_variant_unref(src);
+    purc_variant_unref(dst);
+
+    // intersect a generic set with the even numbers
+    purc_variant_t set = purc_variant_make_set_by_ckey(0, NULL,
+            PURC_VARIANT_INVALID);
+    ASSERT_NE(set, nullptr);
+    for (int i = 0; i < 2000; i++) {
+        purc_variant_t v = purc_variant_make_number(i);
+        purc_variant_set_add(set, v, PCVRNT_CR_METHOD_IGNORE);
+        purc_variant_unref(v);
+    }
+    src = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+    for (int i = 0; i < 4000; i += 2) {
+        purc_variant_t v = purc_variant_make_number(i);
+        purc_variant_array_append(src, v);
+        purc_variant_unref(v);
+    }
+    ASSERT_EQ(purc_variant_set_intersect(set, src), 1000);
+    purc_variant_unref(src);
+    purc_variant_unref(set);
+}
@@ -631,6 +631,106 @@ TEST(variant, serialize_string)
     purc_cleanup ();
 }
 
+static std::string serialize_to_string(purc_variant_t v, unsigned int flags)
+{
+    purc_rwstream_t rws = purc_rwstream_new_buffer(32, 1024 * 1024);
+    ssize_t n = purc_variant_serialize(v, rws, 0, flags, NULL);
+
+    size_t sz = 0;
+    const char *buf = (const char *)purc_rwstream_get_mem_buffer(rws, &sz);
+    std::string str = (n >= 0) ? std::string(buf, sz) : "<failed>";
+    purc_rwstream_destroy(rws);
+    return str;
+}
+
+// to test: the numbers, the integers, and the long strings
+TEST(variant, serialize_fast_paths)
+{
+    int ret = purc_init_ex (PURC_MODULE_VARIANT, "cn.fmsoft.hybridos.test",
+            "variant", NULL);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    static const double reals[] = {
+        0.1, -0.3, 1.0 / 3, 2.5e-5, -1.25e-7, 123.456, 12345.678,
+        1234567890123.25, 5e-324,
+    };
+    for (size_t i = 0; i < sizeof(reals) / sizeof(reals[0]); i++) {
+        char expected[64];
+        snprintf(expected, sizeof(expected), "%.17g", reals[i]);
+
+        purc_variant_t v = purc_variant_make_number(reals[i]);
+        ASSERT_EQ(serialize_to_string(v, PCVRNT_SERIALIZE_OPT_PLAIN),
+                expected);
+        purc_variant_unref(v);
+    }
+
+    static const struct {
+        double d;
+        const char *expected;
+    } integers[] = {
+        { 0.0, "0" },
+        { -0.0, "-0" },
+        { 1e18, "1000000000000000000" },
+        { -9007199254740993.0, "-9007199254740992" },
+        { 1.0 + 2.2204460492503131e-16, "1" },
+    };
+    for (size_t i = 0; i < sizeof(integers) / sizeof(integers[0]); i++) {
+        purc_variant_t v = purc_variant_make_number(integers[i].d);
+        ASSERT_EQ(serialize_to_string(v, PCVRNT_SERIALIZE_OPT_PLAIN),
+                integers[i].expected);
+        purc_variant_unref(v);
+    }
+
+    purc_variant_t v = purc_variant_make_longint(INT64_MIN);
+    ASSERT_EQ(serialize_to_string(v, PCVRNT_SERIALIZE_OPT_REAL_EJSON),
+            "-9223372036854775808L");
+    purc_variant_unref(v);
+
+    v = purc_variant_make_ulongint(UINT64_MAX);
+    ASSERT_EQ(serialize_to_string(v, PCVRNT_SERIALIZE_OPT_REAL_EJSON),
+            "18446744073709551615UL");
+    ASSERT_EQ(serialize_to_string(v, PCVRNT_SERIALIZE_OPT_PLAIN),
+            "18446744073709551615");
+    purc_variant_unref(v);
+
+    /* longer than the output buffer of the serializer */
+    std::string str, expected = "\"";
+    for (int i = 0; i < 10000; i++) {
+        char c = "abc/\"\n\x01\xe4\xb8\xad"[i % 10];
+        str += c;
+        if (c == '/' || c == '"')
+            expected += std::string("\\") + c;
+        else if (c == '\n')
+            expected += "\\n";
+        else if (c == '\x01')
+            expected += "\\u0001";
+        else
+            expected += c;
+    }
+    expected += "\"";
+
+    v = purc_variant_make_string_ex(str.c_str(), str.length(), false);
+    ASSERT_EQ(serialize_to_string(v, PCVRNT_SERIALIZE_OPT_PLAIN), expected);
+
+    /* the stream takes the first bytes only */
+    char buf[100];
+    purc_rwstream_t rws = purc_rwstream_new_from_mem(buf, sizeof(buf));
+    size_t len_expected = 0;
+    ssize_t n = purc_variant_serialize(v, rws, 0,
+            PCVRNT_SERIALIZE_OPT_IGNORE_ERRORS, &len_expected);
+    ASSERT_EQ(n, (ssize_t)sizeof(buf));
+    ASSERT_EQ(len_expected, expected.length());
+    ASSERT_EQ(memcmp(buf, expected.c_str(), sizeof(buf)), 0);
+
+    purc_rwstream_seek(rws, 0, SEEK_SET);
+    n = purc_variant_serialize(v, rws, 0, PCVRNT_SERIALIZE_OPT_PLAIN, NULL);
+    ASSERT_EQ(n, -1);
+    purc_rwstream_destroy(rws);
+    purc_variant_unref(v);
+
+    purc_cleanup ();
+}
+
 // to test: serialize a byte sequence
 TEST(variant, serialize_bsequence)
 {
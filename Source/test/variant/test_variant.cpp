@@ -1589,3 +1589,152 @@ TEST(variant, reuse_buff)
     purc_cleanup ();
 }
 
+
+TEST(variant, slab_stat)
+{
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_VARIANT, "cn.fmsfot.hvml.test",
+            "variant", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    const struct purc_variant_stat *stat = purc_variant_usage_stat();
+    size_t nr_chunks = stat->nr_slab_chunks;
+
+    purc_variant_t arr = purc_variant_make_array_0();
+    for (int i = 0; i < 10000; i++) {
+        purc_variant_t v = purc_variant_make_number(i);
+        purc_variant_array_append(arr, v);
+        purc_variant_unref(v);
+    }
+
+    stat = purc_variant_usage_stat();
+    /* a variant for every member */
+    ASSERT_GE(stat->nr_slab_chunks, nr_chunks + 10000);
+    ASSERT_GT(stat->nr_slabs, 0);
+    ASSERT_GT(stat->sz_slabs, 0);
+
+    purc_variant_unref(arr);
+    stat = purc_variant_usage_stat();
+    /* some variants may be kept as reserved ones */
+    ASSERT_LE(stat->nr_slab_chunks, nr_chunks + MAX_RESERVED_VARIANTS);
+
+    purc_cleanup ();
+}
+
+TEST(variant, string_slice)
+{
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_VARIANT, "cn.fmsfot.hvml.test",
+            "variant", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    const char *text = "The quick brown fox jumps over the lazy dog, "
+        "\xe4\xb8\x80\xe4\xba\x8c\xe4\xb8\x89";     // 一二三
+    purc_variant_t parent = purc_variant_make_string(text, true);
+    const char *buf = purc_variant_get_string_const(parent);
+    size_t len = strlen(text);
+
+    // a slice to the end of the parent refers to the buffer of the parent
+    purc_variant_t v = pcvariant_make_string_slice(parent, buf + 4,
+            len - 4, false);
+    ASSERT_NE(v, nullptr);
+    size_t nr;
+    ASSERT_TRUE(purc_variant_string_chars(v, &nr));
+    ASSERT_EQ(nr, 44);
+    ASSERT_TRUE(purc_variant_string_bytes(v, &nr));
+    ASSERT_EQ(nr, len - 4 + 1);
+    ASSERT_EQ(purc_variant_get_string_const(v), buf + 4);
+
+    // a slice of a slice
+    purc_variant_t w = pcvariant_make_string_slice(v, buf + 10, 20, false);
+    ASSERT_NE(w, nullptr);
+    purc_variant_unref(v);
+
+    purc_variant_t expected = purc_variant_make_string_ex(buf + 10, 20, false);
+    ASSERT_TRUE(purc_variant_is_equal_to(w, expected));
+
+    char out[64];
+    pcvariant_serialize(out, sizeof(out), w);
+    ASSERT_STREQ(out, "\"brown fox jumps over\"");
+
+    // the slice is copied when it has to be null-terminated
+    ASSERT_STREQ(purc_variant_get_string_const(w), "brown fox jumps over");
+    ASSERT_TRUE(purc_variant_is_equal_to(w, expected));
+    purc_variant_unref(expected);
+    purc_variant_unref(w);
+
+    // a broken character at the end is dropped
+    v = pcvariant_make_string_slice(parent, buf + 30, len - 30 - 1, false);
+    ASSERT_NE(v, nullptr);
+    ASSERT_STREQ(purc_variant_get_string_const(v),
+            "the lazy dog, \xe4\xb8\x80\xe4\xba\x8c");
+    purc_variant_unref(v);
+
+    v = pcvariant_make_string_slice(parent, buf + 30, len - 30 - 1, true);
+    ASSERT_EQ(v, nullptr);
+    ASSERT_EQ(purc_get_last_error(), PURC_ERROR_BAD_ENCODING);
+
+    // out of the range of the parent
+    v = pcvariant_make_string_slice(parent, buf + 4, len, false);
+    ASSERT_EQ(v, nullptr);
+
+    v = pcvariant_make_byte_sequence_slice(parent, buf, len);
+    ASSERT_NE(v, nullptr);
+    const unsigned char *bytes = purc_variant_get_bytes_const(v, &nr);
+    ASSERT_EQ((const char *)bytes, buf);
+    ASSERT_EQ(nr, len);
+    purc_variant_unref(v);
+
+    purc_variant_unref(parent);
+    purc_cleanup ();
+}
+
+TEST(variant, string_slice_as_interned_key)
+{
+    purc_instance_extra_info info = {};
+    int ret = purc_init_ex(PURC_MODULE_VARIANT, "cn.fmsfot.hvml.test",
+            "variant", &info);
+    ASSERT_EQ (ret, PURC_ERROR_OK);
+
+    purc_variant_object_intern_keys(true);
+
+    const char *text = "line:a-key-long-enough-to-be-a-slice";
+    purc_variant_t parent = purc_variant_make_string(text, false);
+    const char *buf = purc_variant_get_string_const(parent);
+    size_t len = strlen(text);
+
+    // a null-terminated slice, like a line of $STREAM.readlines
+    purc_variant_t key = pcvariant_make_string_slice(parent, buf + 5,
+            len - 5, false);
+    ASSERT_NE(key, nullptr);
+    ASSERT_TRUE(key->flags & PCVRNT_FLAG_STRING_SLICE);
+    ASSERT_EQ(parent->refc, 2);
+
+    purc_variant_t objs[3];
+    for (int i = 0; i < 3; i++) {
+        objs[i] = purc_variant_make_object_0();
+        ASSERT_NE(objs[i], nullptr);
+        ASSERT_TRUE(purc_variant_object_set(objs[i], key,
+                    purc_variant_make_null()));
+    }
+
+    // the interned key is a copy of its own
+    struct pcvrnt_object_iterator *it;
+    it = pcvrnt_object_iterator_create_begin(objs[2]);
+    ASSERT_NE(it, nullptr);
+    purc_variant_t k = pcvrnt_object_iterator_get_key(it);
+    ASSERT_TRUE(k->flags & PCVRNT_FLAG_INTERNED);
+    ASSERT_FALSE(k->flags & PCVRNT_FLAG_STRING_SLICE);
+    ASSERT_TRUE(purc_variant_is_equal_to(k, key));
+    pcvrnt_object_iterator_release(it);
+
+    // the parent is not pinned by the interned keys
+    for (int i = 0; i < 3; i++)
+        purc_variant_unref(objs[i]);
+    purc_variant_unref(key);
+    ASSERT_EQ(parent->refc, 1);
+
+    purc_variant_unref(parent);
+    purc_variant_object_intern_keys(false);
+    purc_cleanup ();
+}
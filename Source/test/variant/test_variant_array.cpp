@@ -23,11 +23,16 @@
 #include "private/hashtable.h"
 #include "purc/purc-variant.h"
 #include "private/variant.h"
+#include "../helpers.h"
 
 #include <stdio.h>
 #include <errno.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 TEST(variant_array, init_with_1_str)
 {
     purc_instance_extra_info info = {};
@@ -533,3 +538,211 @@ TEST(variant_array, sort)
     ASSERT_STREQ(inbuf, outbuf);
 }
 
+
+static void
+check_members(purc_variant_t arr, const std::vector<int64_t> &expected)
+{
+    ASSERT_EQ(purc_variant_array_get_size(arr), (ssize_t)expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        int64_t i64 = 0;
+        purc_variant_t v = purc_variant_array_get(arr, i);
+        ASSERT_NE(v, nullptr);
+        ASSERT_TRUE(purc_variant_cast_to_longint(v, &i64, false));
+        ASSERT_EQ(i64, expected[i]);
+    }
+}
+
+TEST(variant_array, insert_set_remove)
+{
+    PurCInstance purc("cn.fmsoft.hybridos.test", "variant_array", false);
+
+    purc_variant_t arr = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+    ASSERT_NE(arr, nullptr);
+    std::vector<int64_t> expected;
+
+    srandom(2022);
+    for (int i = 0; i < 1000; i++) {
+        purc_variant_t v = purc_variant_make_longint(i);
+        size_t idx = expected.empty() ? 0 : random() % (expected.size() + 1);
+        switch (random() % 4) {
+        case 0:
+            ASSERT_TRUE(purc_variant_array_append(arr, v));
+            expected.push_back(i);
+            break;
+        case 1:
+            ASSERT_TRUE(purc_variant_array_prepend(arr, v));
+            expected.insert(expected.begin(), i);
+            break;
+        case 2:
+            ASSERT_TRUE(purc_variant_array_insert_before(arr, idx, v));
+            expected.insert(expected.begin() + idx, i);
+            break;
+        default:
+            if (idx < expected.size()) {
+                ASSERT_TRUE(purc_variant_array_set(arr, idx, v));
+                expected[idx] = i;
+            }
+            break;
+        }
+        purc_variant_unref(v);
+    }
+    check_members(arr, expected);
+
+    // remove the even members while iterating the array reversely
+    purc_variant_t val;
+    size_t curr;
+    foreach_value_in_variant_array_reverse_safe(arr, val, curr)
+        int64_t i64 = 0;
+        purc_variant_cast_to_longint(val, &i64, false);
+        if (i64 % 2 == 0) {
+            ASSERT_TRUE(purc_variant_array_remove(arr, curr));
+            expected.erase(expected.begin() + curr);
+        }
+    end_foreach;
+    check_members(arr, expected);
+
+    // the same with a forward iteration
+    foreach_value_in_variant_array_safe(arr, val, curr)
+        int64_t i64 = 0;
+        purc_variant_cast_to_longint(val, &i64, false);
+        if (i64 % 3 == 0) {
+            ASSERT_TRUE(purc_variant_array_remove(arr, curr));
+            expected.erase(expected.begin() + curr);
+        }
+    end_foreach;
+    check_members(arr, expected);
+
+    pcvariant_array_sort(arr, NULL, NULL);
+    std::sort(expected.begin(), expected.end());
+    check_members(arr, expected);
+
+    purc_variant_unref(arr);
+}
+
+static std::string
+serialize(purc_variant_t v, unsigned int flags)
+{
+    purc_rwstream_t rws = purc_rwstream_new_buffer(32, 0);
+    purc_variant_serialize(v, rws, 0, flags, NULL);
+
+    size_t sz = 0;
+    const char *buf = (const char *)purc_rwstream_get_mem_buffer(rws, &sz);
+    std::string s(buf, sz);
+    purc_rwstream_destroy(rws);
+    return s;
+}
+
+TEST(variant_array, packed)
+{
+    PurCInstance purc("cn.fmsoft.hybridos.test", "variant_array", false);
+
+    // a packed array and an ordinary one with the same members
+    std::string json = "[";
+    purc_variant_t ordinary = purc_variant_make_array(0, PURC_VARIANT_INVALID);
+    double sum = 0;
+    for (int i = 0; i < 100; i++) {
+        double d = i * 0.25 - 3;
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%s%g", i ? "," : "", d);
+        json += buf;
+
+        purc_variant_t v = purc_variant_make_number(d);
+        purc_variant_array_append(ordinary, v);
+        purc_variant_unref(v);
+        sum += d;
+    }
+    json += "]";
+
+    purc_variant_t arr = purc_variant_make_from_json_string(json.c_str(),
+            json.length());
+    ASSERT_NE(arr, nullptr);
+
+    purc_variant_type type;
+    size_t nr;
+    ASSERT_NE(pcvariant_array_get_packed(arr, &type, &nr), nullptr);
+    ASSERT_EQ(type, PURC_VARIANT_TYPE_NUMBER);
+    ASSERT_EQ(nr, 100);
+    ASSERT_EQ(pcvariant_array_get_packed(ordinary, NULL, NULL), nullptr);
+
+    // the same output as the ordinary array
+    const unsigned int flags[] = {
+        PCVRNT_SERIALIZE_OPT_PLAIN,
+        PCVRNT_SERIALIZE_OPT_SPACED | PCVRNT_SERIALIZE_OPT_PRETTY,
+        PCVRNT_SERIALIZE_OPT_REAL_EJSON,
+    };
+    for (size_t i = 0; i < PCA_TABLESIZE(flags); i++) {
+        ASSERT_EQ(serialize(arr, flags[i]), serialize(ordinary, flags[i]));
+    }
+    ASSERT_TRUE(purc_variant_is_equal_to(arr, ordinary));
+    ASSERT_EQ(purc_variant_numerify(arr), sum);
+
+    // the members are summed in order like the ordinary array
+    {
+        purc_variant_t big = purc_variant_make_from_json_string(
+                "[1e17,3,3,3,3,-1e17,5,7]", 24);
+        ASSERT_NE(pcvariant_array_get_packed(big, NULL, NULL), nullptr);
+        ASSERT_EQ(purc_variant_numerify(big), 12.0);
+        purc_variant_unref(big);
+    }
+
+    // the members are materialized as temporaries, and the array is kept
+    // packed when they are iterated
+    purc_variant_t v = pcvariant_array_get_member(arr, 10);
+    ASSERT_NE(v, nullptr);
+    ASSERT_TRUE(purc_variant_is_number(v));
+    ASSERT_EQ(v->refc, 1);
+    purc_variant_unref(v);
+    {
+        size_t idx, nr_equal = 0;
+        foreach_value_in_variant_array(arr, v, idx)
+            purc_variant_t m = purc_variant_array_get(ordinary, idx);
+            if (purc_variant_is_equal_to(v, m))
+                nr_equal++;
+        end_foreach;
+        ASSERT_EQ(nr_equal, 100);
+    }
+    ASSERT_NE(pcvariant_array_get_packed(arr, NULL, NULL), nullptr);
+
+    // appending a number keeps the array packed
+    v = purc_variant_make_number(100);
+    ASSERT_TRUE(purc_variant_array_append(arr, v));
+    ASSERT_TRUE(purc_variant_array_append(ordinary, v));
+    purc_variant_unref(v);
+    ASSERT_NE(pcvariant_array_get_packed(arr, NULL, &nr), nullptr);
+    ASSERT_EQ(nr, 101);
+
+    // setting and removing in place
+    v = purc_variant_make_number(-1);
+    ASSERT_TRUE(purc_variant_array_set(arr, 5, v));
+    ASSERT_TRUE(purc_variant_array_set(ordinary, 5, v));
+    purc_variant_unref(v);
+    ASSERT_TRUE(purc_variant_array_remove(arr, 7));
+    ASSERT_TRUE(purc_variant_array_remove(ordinary, 7));
+    ASSERT_NE(pcvariant_array_get_packed(arr, NULL, NULL), nullptr);
+    ASSERT_EQ(serialize(arr, PCVRNT_SERIALIZE_OPT_PLAIN),
+            serialize(ordinary, PCVRNT_SERIALIZE_OPT_PLAIN));
+
+    // a string makes it an ordinary array
+    v = purc_variant_make_string("foo", false);
+    ASSERT_TRUE(purc_variant_array_append(arr, v));
+    ASSERT_TRUE(purc_variant_array_append(ordinary, v));
+    purc_variant_unref(v);
+    ASSERT_EQ(pcvariant_array_get_packed(arr, NULL, NULL), nullptr);
+    ASSERT_EQ(purc_variant_array_get_size(arr), 101);
+    ASSERT_TRUE(purc_variant_is_equal_to(arr, ordinary));
+
+    // a borrowed member needs a slot, which makes it an ordinary array
+    purc_variant_t other = purc_variant_make_from_json_string(json.c_str(),
+            json.length());
+    ASSERT_NE(pcvariant_array_get_packed(other, NULL, NULL), nullptr);
+    v = purc_variant_array_get(other, 10);
+    ASSERT_NE(v, nullptr);
+    ASSERT_TRUE(purc_variant_is_number(v));
+    ASSERT_EQ(v, purc_variant_array_get(other, 10));
+    ASSERT_EQ(pcvariant_array_get_packed(other, NULL, NULL), nullptr);
+    ASSERT_EQ(purc_variant_array_get_size(other), 100);
+
+    purc_variant_unref(other);
+    purc_variant_unref(arr);
+    purc_variant_unref(ordinary);
+}
@@ -466,3 +466,81 @@ TEST(object, compare)
     purc_variant_unref(obj2);
 }
 
+
+TEST(object, intern_keys)
+{
+    PurCInstance purc;
+
+    ASSERT_EQ(purc_variant_object_intern_keys(true), false);
+
+    const char *s = "[{id:'1',name:'a'},{name:'b',id:'2'},{id:'3',name:'c'}]";
+    purc_variant_t arr = pcejson_parser_parse_string(s, 0, 0);
+    ASSERT_NE(arr, PURC_VARIANT_INVALID);
+
+    /* a key is interned from its second use on, so all objects but
+       the first one share the same key variants */
+    purc_variant_t k0 = PURC_VARIANT_INVALID, k;
+    for (ssize_t i = 1; i < purc_variant_array_get_size(arr); i++) {
+        purc_variant_t obj = purc_variant_array_get(arr, i);
+        struct pcvrnt_object_iterator *it;
+        it = pcvrnt_object_iterator_create_begin(obj);
+        ASSERT_NE(it, nullptr);
+        k = pcvrnt_object_iterator_get_key(it);
+        ASSERT_STREQ(purc_variant_get_string_const(k), "id");
+        ASSERT_TRUE(k->flags & PCVRNT_FLAG_INTERNED);
+        if (k0 == PURC_VARIANT_INVALID)
+            k0 = k;
+        ASSERT_EQ(k, k0);
+        pcvrnt_object_iterator_release(it);
+
+        purc_variant_t v = purc_variant_object_get_by_ckey(obj,
+                purc_variant_get_string_const(k0));
+        ASSERT_NE(v, PURC_VARIANT_INVALID);
+    }
+
+    /* the order of keys and the serialized result are not changed */
+    char buf[128];
+    purc_rwstream_t out = purc_rwstream_new_from_mem(buf, sizeof(buf) - 1);
+    ssize_t n = purc_variant_serialize(arr, out, 0,
+            PCVRNT_SERIALIZE_OPT_PLAIN, NULL);
+    ASSERT_GT(n, 0);
+    buf[n] = 0;
+    ASSERT_STREQ(buf, "[{\"id\":\"1\",\"name\":\"a\"},"
+            "{\"id\":\"2\",\"name\":\"b\"},{\"id\":\"3\",\"name\":\"c\"}]");
+    purc_rwstream_destroy(out);
+
+    purc_variant_t obj = purc_variant_make_object_by_static_ckey(1,
+            "name", purc_variant_make_null());
+    ASSERT_NE(obj, PURC_VARIANT_INVALID);
+    ASSERT_TRUE(purc_variant_object_remove_by_static_ckey(obj, "name", false));
+    ASSERT_EQ(purc_variant_object_get_size(obj), 0);
+    purc_variant_unref(obj);
+
+    /* the key given by the caller is copied, never flagged nor kept */
+    purc_variant_t key = purc_variant_make_string_static("label", false);
+    purc_variant_t objs[2];
+    for (int i = 0; i < 2; i++) {
+        objs[i] = purc_variant_make_object_0();
+        ASSERT_NE(objs[i], PURC_VARIANT_INVALID);
+        ASSERT_TRUE(purc_variant_object_set(objs[i], key,
+                    purc_variant_make_null()));
+        ASSERT_FALSE(key->flags & PCVRNT_FLAG_INTERNED);
+    }
+
+    struct pcvrnt_object_iterator *it;
+    it = pcvrnt_object_iterator_create_begin(objs[1]);
+    ASSERT_NE(it, nullptr);
+    k = pcvrnt_object_iterator_get_key(it);
+    ASSERT_NE(k, key);
+    ASSERT_TRUE(k->flags & PCVRNT_FLAG_INTERNED);
+    ASSERT_STREQ(purc_variant_get_string_const(k), "label");
+    pcvrnt_object_iterator_release(it);
+
+    purc_variant_unref(objs[0]);
+    purc_variant_unref(objs[1]);
+    ASSERT_EQ(key->refc, 1);
+    purc_variant_unref(key);
+
+    purc_variant_unref(arr);
+    ASSERT_EQ(purc_variant_object_intern_keys(false), true);
+}
@@ -338,3 +338,106 @@ TEST(vcm, again_ex)
 
     purc_cleanup();
 }
+
+static purc_variant_t
+getter_a(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
+        unsigned call_flags)
+{
+    UNUSED_PARAM(root);
+    UNUSED_PARAM(nr_args);
+    UNUSED_PARAM(argv);
+    UNUSED_PARAM(call_flags);
+    return purc_variant_make_string("a", false);
+}
+
+static purc_variant_t
+getter_b(purc_variant_t root, size_t nr_args, purc_variant_t *argv,
+        unsigned call_flags)
+{
+    UNUSED_PARAM(root);
+    UNUSED_PARAM(nr_args);
+    UNUSED_PARAM(argv);
+    UNUSED_PARAM(call_flags);
+    return purc_variant_make_string("b", false);
+}
+
+static struct pcvcm_node *
+parse_vcm(const char *ejson)
+{
+    purc_rwstream_t rws = purc_rwstream_new_from_mem((void*)ejson,
+            strlen(ejson));
+    struct purc_ejson_parsing_tree *tree = purc_variant_ejson_parse_stream(rws);
+    purc_rwstream_destroy(rws);
+    return (struct pcvcm_node *)tree;
+}
+
+/* evaluates the tree with `obj` as any variable; "" if not a string */
+static std::string
+eval_to_string(struct pcvcm_node *tree, purc_variant_t obj)
+{
+    std::string result;
+    purc_variant_t v = pcvcm_eval_ex(tree, NULL, find_var, obj, true);
+    if (v) {
+        if (purc_variant_is_string(v))
+            result = purc_variant_get_string_const(v);
+        purc_variant_unref(v);
+    }
+    return result;
+}
+
+static void
+set_dynamic(purc_variant_t obj, const char *key, purc_dvariant_method getter)
+{
+    purc_variant_t v = purc_variant_make_dynamic(getter, NULL);
+    purc_variant_object_set_by_static_ckey(obj, key, v);
+    purc_variant_unref(v);
+}
+
+TEST(vcm, method_cache)
+{
+    purc_init_ex(PURC_MODULE_EJSON, "cn.fmsoft.hybridos.test",
+            "vcm_eval", NULL);
+
+    purc_variant_t obj = purc_variant_make_object_0();
+    ASSERT_NE(obj, nullptr);
+    set_dynamic(obj, "key", getter_a);
+    set_dynamic(obj, "other", getter_b);
+
+    struct pcvcm_node *tree = parse_vcm("$OBJ.key");
+    ASSERT_NE(tree, nullptr);
+
+    /* the second evaluation hits the cache */
+    ASSERT_EQ(eval_to_string(tree, obj), "a");
+    ASSERT_EQ(eval_to_string(tree, obj), "a");
+
+    /* set: a new dynamic value for the key */
+    set_dynamic(obj, "key", getter_b);
+    ASSERT_EQ(eval_to_string(tree, obj), "b");
+
+    /* remove: the cached value is released with the property */
+    ASSERT_TRUE(purc_variant_object_remove_by_static_ckey(obj, "key", false));
+    ASSERT_EQ(eval_to_string(tree, obj), "");
+
+    /* replace with an ordinary value, then with a dynamic one again */
+    purc_variant_t c = purc_variant_make_string("c", false);
+    purc_variant_object_set_by_static_ckey(obj, "key", c);
+    purc_variant_unref(c);
+    ASSERT_EQ(eval_to_string(tree, obj), "c");
+
+    set_dynamic(obj, "key", getter_a);
+    ASSERT_EQ(eval_to_string(tree, obj), "a");
+
+    /* a tree allocated where a destroyed one was must not hit the entries
+       of the destroyed one, even though the object is not changed */
+    for (int i = 0; i < 8; i++) {
+        pcvcm_node_destroy(tree);
+        tree = parse_vcm((i % 2) ? "$OBJ.key" : "$OBJ.other");
+        ASSERT_NE(tree, nullptr);
+        ASSERT_EQ(eval_to_string(tree, obj), (i % 2) ? "a" : "b");
+        ASSERT_EQ(eval_to_string(tree, obj), (i % 2) ? "a" : "b");
+    }
+
+    pcvcm_node_destroy(tree);
+    purc_variant_unref(obj);
+    purc_cleanup();
+}